@@ -21,6 +21,7 @@ AppConfig::AppConfig(const QString& configFilePath)
 void AppConfig::loadDefaults() {
     // Reset internal 'current' values to defaults before loading/saving
     m_currentWeights = m_defaultWeights;
+    m_currentEvalWeights = EvalWeights();
     m_currentMctsTimeLimit = m_defaultMctsTimeLimit;
     // Other defaults are read directly when needed using value() with fallback
 }
@@ -42,6 +43,15 @@ void AppConfig::load() {
     m_currentWeights.pickRate = m_settings.value("PickRate", m_defaultWeights.pickRate).toDouble();
     m_settings.endGroup();
 
+    // Older configs have no [EvalWeights]; the model used to read [Weights], so fall back to those
+    m_settings.beginGroup("EvalWeights");
+    m_currentEvalWeights.winRate = m_settings.value("WinRate", m_currentWeights.winRate).toDouble();
+    m_currentEvalWeights.synergy = m_settings.value("Synergy", m_currentWeights.synergy).toDouble();
+    m_currentEvalWeights.counter = m_settings.value("Counter", m_currentWeights.counter).toDouble();
+    m_currentEvalWeights.peakCounter = m_settings.value("PeakCounter", m_currentWeights.pickRate).toDouble();
+    m_currentEvalWeights.slope = m_settings.value("Slope", EvalWeights().slope).toDouble();
+    m_settings.endGroup();
+
     qInfo() << "Configuration loaded from" << m_settings.fileName();
 }
 
@@ -60,6 +70,30 @@ void AppConfig::save() {
     m_settings.setValue("MctsExplorationParam", mctsExplorationParam());
     m_settings.setValue("MctsResultCount", mctsResultCount());
     m_settings.setValue("MctsUpdateIntervalIters", mctsUpdateIntervalIters());
+    m_settings.setValue("CompFinderTopK", compFinderTopK());
+    m_settings.setValue("UsePolicyRollouts", usePolicyRollouts());
+    m_settings.setValue("MctsWorkerProcesses", mctsWorkerProcesses());
+    m_settings.setValue("MctsSharedTreeNodes", mctsSharedTreeNodes());
+    m_settings.setValue("MctsSnapshotInterval", mctsSnapshotInterval());
+    m_settings.setValue("MctsResumeSnapshots", mctsResumeSnapshots());
+    m_settings.setValue("UseCompactStats", useCompactStats());
+    m_settings.setValue("CompactPlaysThreshold", compactPlaysThreshold());
+    m_settings.setValue("ActiveRosterPruning", activeRosterPruning());
+    m_settings.setValue("ActiveRosterMinPickRate", activeRosterMinPickRate());
+    m_settings.setValue("ActiveRosterMinPlays", activeRosterMinPlays());
+    m_settings.setValue("MctsClusterSelection", mctsClusterSelection());
+    m_settings.setValue("MctsClusterCount", mctsClusterCount());
+    m_settings.setValue("BuildPlayerIndex", buildPlayerIndex());
+    m_settings.setValue("LiveIngest", liveIngest());
+    m_settings.setValue("LiveIngestPollSeconds", liveIngestPollSeconds());
+    m_settings.setValue("LivePublishSeconds", livePublishSeconds());
+    m_settings.setValue("LiveDedupWindow", liveDedupWindow());
+    m_settings.setValue("MemoryCapSearchTreesMB", memoryCapSearchTreesMb());
+    m_settings.setValue("MemoryCapLoaderBuffersMB", memoryCapLoaderBuffersMb());
+    m_settings.setValue("MemoryCapHistoryMB", memoryCapHistoryMb());
+    m_settings.setValue("SearchFocusShare", searchFocusShare());
+    m_settings.setValue("BootstrapReplicas", bootstrapReplicas());
+    m_settings.setValue("FallbackShrinkage", fallbackShrinkage());
     m_settings.endGroup();
 
     m_settings.beginGroup("Weights");
@@ -70,6 +104,14 @@ void AppConfig::save() {
     m_settings.setValue("PickRate", m_currentWeights.pickRate);
     m_settings.endGroup();
 
+    m_settings.beginGroup("EvalWeights");
+    m_settings.setValue("WinRate", m_currentEvalWeights.winRate);
+    m_settings.setValue("Synergy", m_currentEvalWeights.synergy);
+    m_settings.setValue("Counter", m_currentEvalWeights.counter);
+    m_settings.setValue("PeakCounter", m_currentEvalWeights.peakCounter);
+    m_settings.setValue("Slope", m_currentEvalWeights.slope);
+    m_settings.endGroup();
+
     m_settings.sync(); // Ensure changes are written to disk
 }
 
@@ -109,6 +151,10 @@ HeuristicWeights AppConfig::heuristicWeights() const {
     return m_currentWeights;
 }
 
+EvalWeights AppConfig::evalWeights() const {
+    return m_currentEvalWeights;
+}
+
 double AppConfig::mctsTimeLimit() const {
     // Return the 'current' time limit loaded/defaulted/set
     return m_currentMctsTimeLimit;
@@ -126,6 +172,119 @@ int AppConfig::mctsUpdateIntervalIters() const {
      return m_settings.value("Settings/MctsUpdateIntervalIters", m_defaultMctsUpdateIntervalIters).toInt();
 }
 
+int AppConfig::compFinderTopK() const {
+    int topK = m_settings.value("Settings/CompFinderTopK", m_defaultCompFinderTopK).toInt();
+    return (topK <= 0) ? m_defaultCompFinderTopK : topK;
+}
+
+bool AppConfig::usePolicyRollouts() const {
+    return m_settings.value("Settings/UsePolicyRollouts", m_defaultUsePolicyRollouts).toBool();
+}
+
+int AppConfig::mctsWorkerProcesses() const {
+    int processes = m_settings.value("Settings/MctsWorkerProcesses", m_defaultMctsWorkerProcesses).toInt();
+    return std::max(0, processes);
+}
+
+quint32 AppConfig::mctsSharedTreeNodes() const {
+    quint32 nodes = m_settings.value("Settings/MctsSharedTreeNodes", m_defaultMctsSharedTreeNodes).toUInt();
+    return (nodes < 1024) ? m_defaultMctsSharedTreeNodes : nodes;
+}
+
+int AppConfig::mctsSnapshotInterval() const {
+    int seconds = m_settings.value("Settings/MctsSnapshotInterval", m_defaultMctsSnapshotInterval).toInt();
+    return std::max(0, seconds);
+}
+
+bool AppConfig::mctsResumeSnapshots() const {
+    return m_settings.value("Settings/MctsResumeSnapshots", m_defaultMctsResumeSnapshots).toBool();
+}
+
+bool AppConfig::useCompactStats() const {
+    return m_settings.value("Settings/UseCompactStats", m_defaultUseCompactStats).toBool();
+}
+
+double AppConfig::compactPlaysThreshold() const {
+    double threshold = m_settings.value("Settings/CompactPlaysThreshold", m_defaultCompactPlaysThreshold).toDouble();
+    return std::max(0.0, threshold);
+}
+
+bool AppConfig::activeRosterPruning() const {
+    return m_settings.value("Settings/ActiveRosterPruning", m_defaultActiveRosterPruning).toBool();
+}
+
+double AppConfig::activeRosterMinPickRate() const {
+    double rate = m_settings.value("Settings/ActiveRosterMinPickRate", m_defaultActiveRosterMinPickRate).toDouble();
+    return std::max(0.0, rate);
+}
+
+double AppConfig::activeRosterMinPlays() const {
+    double plays = m_settings.value("Settings/ActiveRosterMinPlays", m_defaultActiveRosterMinPlays).toDouble();
+    return std::max(0.0, plays);
+}
+
+bool AppConfig::mctsClusterSelection() const {
+    return m_settings.value("Settings/MctsClusterSelection", m_defaultMctsClusterSelection).toBool();
+}
+
+int AppConfig::mctsClusterCount() const {
+    int count = m_settings.value("Settings/MctsClusterCount", m_defaultMctsClusterCount).toInt();
+    return std::max(2, count);
+}
+
+bool AppConfig::buildPlayerIndex() const {
+    return m_settings.value("Settings/BuildPlayerIndex", m_defaultBuildPlayerIndex).toBool();
+}
+
+bool AppConfig::liveIngest() const {
+    return m_settings.value("Settings/LiveIngest", m_defaultLiveIngest).toBool();
+}
+
+int AppConfig::liveIngestPollSeconds() const {
+    int seconds = m_settings.value("Settings/LiveIngestPollSeconds", m_defaultLiveIngestPollSeconds).toInt();
+    return std::max(1, seconds);
+}
+
+int AppConfig::livePublishSeconds() const {
+    int seconds = m_settings.value("Settings/LivePublishSeconds", m_defaultLivePublishSeconds).toInt();
+    return std::max(1, seconds);
+}
+
+int AppConfig::liveDedupWindow() const {
+    int keys = m_settings.value("Settings/LiveDedupWindow", m_defaultLiveDedupWindow).toInt();
+    return std::max(0, keys);
+}
+
+int AppConfig::memoryCapSearchTreesMb() const {
+    int mb = m_settings.value("Settings/MemoryCapSearchTreesMB", m_defaultMemoryCapSearchTreesMb).toInt();
+    return std::max(0, mb);
+}
+
+int AppConfig::memoryCapLoaderBuffersMb() const {
+    int mb = m_settings.value("Settings/MemoryCapLoaderBuffersMB", m_defaultMemoryCapLoaderBuffersMb).toInt();
+    return std::max(0, mb);
+}
+
+int AppConfig::memoryCapHistoryMb() const {
+    int mb = m_settings.value("Settings/MemoryCapHistoryMB", m_defaultMemoryCapHistoryMb).toInt();
+    return std::max(0, mb);
+}
+
+double AppConfig::searchFocusShare() const {
+    double share = m_settings.value("Settings/SearchFocusShare", m_defaultSearchFocusShare).toDouble();
+    return std::clamp(share, 0.0, 1.0);
+}
+
+int AppConfig::bootstrapReplicas() const {
+    int replicas = m_settings.value("Settings/BootstrapReplicas", m_defaultBootstrapReplicas).toInt();
+    return std::clamp(replicas, 0, 1000);
+}
+
+double AppConfig::fallbackShrinkage() const {
+    double plays = m_settings.value("Settings/FallbackShrinkage", m_defaultFallbackShrinkage).toDouble();
+    return std::max(0.0, plays);
+}
+
 // --- Setters ---
 // void AppConfig::setHeuristicWeights(const HeuristicWeights& weights) {
 //     // This is now unused if UI is removed
@@ -142,6 +301,11 @@ void AppConfig::setMctsTimeLimit(double limit) {
      // save() needs to be called explicitly later (e.g., on window close)
 }
 
+void AppConfig::setEvalWeights(const EvalWeights& weights) {
+    m_currentEvalWeights = weights;
+    // save() needs to be called explicitly
+}
+
 
 // --- Helper ---
 double AppConfig::getRankWeight(int rank) const {
@@ -23,15 +23,41 @@ public:
     double lowPickRateThreshold() const;
     double lowConfidenceWinRateTarget() const;
     HeuristicWeights heuristicWeights() const; // Reads from m_currentWeights
+    EvalWeights evalWeights() const; // Win model weights, reads from m_currentEvalWeights
     double mctsTimeLimit() const;
     double mctsExplorationParam() const;
     int mctsResultCount() const;
     int mctsUpdateIntervalIters() const;
+    int compFinderTopK() const;
+    bool usePolicyRollouts() const; // MCTS rollouts sample the distilled policy table when available
+    int mctsWorkerProcesses() const; // > 0: interactive MCTS runs in worker processes over a shared-memory tree
+    quint32 mctsSharedTreeNodes() const; // Node capacity of the shared-memory tree
+    int mctsSnapshotInterval() const; // Seconds between tree snapshots of a running search (0 = only when it stops)
+    bool mctsResumeSnapshots() const; // Continue from a saved tree of the same position
+    bool useCompactStats() const; // Serve stats from quantized uint16 tables (see CompactStats)
+    double compactPlaysThreshold() const; // Synergy/counter pairs with fewer weighted plays read as 0.5
+    bool activeRosterPruning() const; // Below the root, MCTS only branches over each map's active roster
+    double activeRosterMinPickRate() const; // Active: pick rate at least this...
+    double activeRosterMinPlays() const; // ...or at least this many weighted plays on the map/mode
+    bool mctsClusterSelection() const; // Two-level MCTS selection over per-map brawler clusters
+    int mctsClusterCount() const; // k of the k-medoids clustering
+    bool buildPlayerIndex() const; // Write players.index (tag -> brawler pool) when games are ingested
+    bool liveIngest() const; // Follow the games file and publish updated stats while the app runs
+    int liveIngestPollSeconds() const; // Seconds between checks for appended games
+    int livePublishSeconds() const; // Seconds between stats snapshots (and checkpoints) of new games
+    int liveDedupWindow() const; // Recent battle keys remembered to drop re-scraped battles
+    int memoryCapSearchTreesMb() const; // MCTS trees stop growing at this size (0 = no cap)
+    int memoryCapLoaderBuffersMb() const; // Raw JSON the loader buffers before processing it (0 = no cap)
+    int memoryCapHistoryMb() const; // Follow mode's recent battle keys (0 = no cap)
+    double searchFocusShare() const; // Share of the search threads the focused draft tab gets while others search
+    int bootstrapReplicas() const; // Poisson replicas behind exact packs' cell errors and suggestions' P(best) (0 = off)
+    double fallbackShrinkage() const; // Weighted plays of the mode-wide (and global) score each map cell is shrunk toward (0 = off)
 
     // Setters primarily for GUI updates -> save
     // setHeuristicWeights is now only used internally if needed, UI doesn't set it
     // void setHeuristicWeights(const HeuristicWeights& weights);
     void setMctsTimeLimit(double limit);
+    void setEvalWeights(const EvalWeights& weights); // Written by the 'tune' command
 
     // Helper for rank weighting
     double getRankWeight(int rank) const;
@@ -53,9 +79,34 @@ private:
     double m_defaultMctsExplorationParam = 1.414;
     int m_defaultMctsResultCount = 10;
     int m_defaultMctsUpdateIntervalIters = 250;
+    int m_defaultCompFinderTopK = 10;
+    bool m_defaultUsePolicyRollouts = false;
+    int m_defaultMctsWorkerProcesses = 0;
+    quint32 m_defaultMctsSharedTreeNodes = 2000000;
+    int m_defaultMctsSnapshotInterval = 60;
+    bool m_defaultMctsResumeSnapshots = true;
+    bool m_defaultUseCompactStats = false;
+    double m_defaultCompactPlaysThreshold = 2.0;
+    bool m_defaultActiveRosterPruning = true;
+    double m_defaultActiveRosterMinPickRate = 0.01;
+    double m_defaultActiveRosterMinPlays = 50.0;
+    bool m_defaultMctsClusterSelection = false;
+    int m_defaultMctsClusterCount = 12;
+    bool m_defaultBuildPlayerIndex = false;
+    bool m_defaultLiveIngest = false;
+    int m_defaultLiveIngestPollSeconds = 5;
+    int m_defaultLivePublishSeconds = 30;
+    int m_defaultLiveDedupWindow = 200000;
+    int m_defaultMemoryCapSearchTreesMb = 2048;
+    int m_defaultMemoryCapLoaderBuffersMb = 1024;
+    int m_defaultMemoryCapHistoryMb = 64;
+    double m_defaultSearchFocusShare = 0.75;
+    int m_defaultBootstrapReplicas = 100;
+    double m_defaultFallbackShrinkage = 0.0; // Off: unchanged packs score as before; 10 is recommended
 
     // Current values (loaded from settings, potentially updated by setters)
     HeuristicWeights m_currentWeights;
+    EvalWeights m_currentEvalWeights;
     double m_currentMctsTimeLimit;
 
 };
@@ -0,0 +1,325 @@
+#include "Arena.h"
+#include "Heuristics.h"
+#include "TaskExecutor.h"
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+struct ArenaGame {
+    QString mapName;
+    QString modeName;
+    QSet<QString> bans;
+    quint32 seed = 0;
+    bool aIsTeam1 = true;
+};
+
+struct ArenaGameResult {
+    double scoreA = 0.5; // Judged win probability of policy A
+    qint64 moveUsA = 0;
+    qint64 moveUsB = 0;
+    int movesA = 0;
+    int movesB = 0;
+};
+
+HeuristicWeights parseWeights(const QString& text) {
+    QStringList parts = text.split('/');
+    if (parts.size() != 4) throw std::invalid_argument("Weights must be WR/SYN/CTR/PR.");
+    HeuristicWeights weights;
+    double* fields[] = {&weights.winRate, &weights.synergy, &weights.counter, &weights.pickRate};
+    for (int i = 0; i < 4; ++i) {
+        bool ok = false;
+        *fields[i] = parts[i].toDouble(&ok);
+        if (!ok) throw std::invalid_argument("Invalid weight: " + parts[i].toStdString());
+    }
+    return weights;
+}
+
+EvalWeights parseEvalWeights(const QString& text) {
+    QStringList parts = text.split('/');
+    if (parts.size() != 5) throw std::invalid_argument("Eval weights must be WR/SYN/CTR/PEAK/SLOPE.");
+    EvalWeights weights;
+    double* fields[] = {&weights.winRate, &weights.synergy, &weights.counter, &weights.peakCounter, &weights.slope};
+    for (int i = 0; i < 5; ++i) {
+        bool ok = false;
+        *fields[i] = parts[i].toDouble(&ok);
+        if (!ok) throw std::invalid_argument("Invalid eval weight: " + parts[i].toStdString());
+    }
+    return weights;
+}
+
+double eloFromScore(double score) {
+    score = std::clamp(score, 0.001, 0.999);
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+} // namespace
+
+
+Arena::Arena(const StatsCalculator& statsCalculator,
+             const QSet<QString>& allBrawlers,
+             const QHash<QString, QSet<QString>>& mapModeData,
+             const AppConfig& config,
+             const MCTSManager& mctsManager)
+    : m_statsCalculator(statsCalculator),
+      m_allBrawlers(allBrawlers),
+      m_mapModeData(mapModeData),
+      m_config(config),
+      m_mctsManager(mctsManager)
+{
+}
+
+ArenaPolicy Arena::parsePolicy(const QString& spec, const HeuristicWeights& defaultWeights,
+                               const EvalWeights& defaultEvalWeights) {
+    ArenaPolicy policy;
+    policy.spec = spec;
+    policy.weights = defaultWeights;
+    policy.evalWeights = defaultEvalWeights;
+
+    QString name = spec.section(':', 0, 0).trimmed().toLower();
+    QString params = spec.section(':', 1).trimmed();
+    if (name == "heuristic") policy.kind = ArenaPolicy::Kind::Heuristic;
+    else if (name == "mcts") policy.kind = ArenaPolicy::Kind::Mcts;
+    else if (name == "alphabeta") policy.kind = ArenaPolicy::Kind::AlphaBeta;
+    else throw std::invalid_argument("Unknown policy: " + spec.toStdString());
+
+    for (const QString& param : params.split(',', Qt::SkipEmptyParts)) {
+        QString key = param.section('=', 0, 0).trimmed().toLower();
+        QString value = param.contains('=') ? param.section('=', 1).trimmed() : key;
+        bool ok = true;
+        if (!param.contains('=')) {
+            // Bare number: iterations for MCTS, depth for alpha-beta
+            if (policy.kind == ArenaPolicy::Kind::Mcts) policy.iterations = value.toInt(&ok);
+            else if (policy.kind == ArenaPolicy::Kind::AlphaBeta) policy.depth = value.toInt(&ok);
+            else ok = false;
+        } else if (key == "w") {
+            policy.weights = parseWeights(value);
+        } else if (key == "e" && policy.kind != ArenaPolicy::Kind::Heuristic) {
+            policy.evalWeights = parseEvalWeights(value);
+        } else if (key == "iters" && policy.kind == ArenaPolicy::Kind::Mcts) {
+            policy.iterations = value.toInt(&ok);
+        } else if (key == "c" && policy.kind == ArenaPolicy::Kind::Mcts) {
+            policy.exploration = value.toDouble(&ok);
+        } else if (key == "depth" && policy.kind == ArenaPolicy::Kind::AlphaBeta) {
+            policy.depth = value.toInt(&ok);
+        } else if (key == "beam" && policy.kind == ArenaPolicy::Kind::AlphaBeta) {
+            policy.beam = value.toInt(&ok);
+        } else {
+            ok = false;
+        }
+        if (!ok) throw std::invalid_argument("Invalid policy parameter '" + param.toStdString() + "' in " + spec.toStdString());
+    }
+
+    if (policy.iterations <= 0 || policy.depth <= 0 || policy.beam <= 0) {
+        throw std::invalid_argument("Policy budgets must be positive: " + spec.toStdString());
+    }
+    return policy;
+}
+
+// --- Policies ---
+
+QString Arena::chooseMove(const ArenaPolicy& policy, const DraftState& state, quint32 seed) const {
+    switch (policy.kind) {
+    case ArenaPolicy::Kind::Heuristic:
+        return suggestPickHeuristic(state, m_statsCalculator, policy.weights).first;
+
+    case ArenaPolicy::Kind::Mcts: {
+        QVector<MCTSResult> results = m_mctsManager.runFixedBudget(state, policy.weights, policy.evalWeights,
+                                                                   policy.iterations, seed, policy.exploration);
+        // Most visited child is the robust choice for a fixed budget
+        auto best = std::max_element(results.begin(), results.end(), [](const MCTSResult& a, const MCTSResult& b) {
+            return a.visits < b.visits;
+        });
+        return best != results.end() ? best->move : QString();
+    }
+
+    case ArenaPolicy::Kind::AlphaBeta: {
+        bool maximizing = state.currentTurn() == "team1";
+        QString bestMove;
+        double bestValue = maximizing ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+        double alpha = -std::numeric_limits<double>::infinity();
+        double beta = std::numeric_limits<double>::infinity();
+        for (const QString& move : orderedMoves(state, policy.weights, policy.beam)) {
+            double value = alphaBeta(policy, state.applyMove(move), policy.depth - 1, alpha, beta);
+            if (maximizing ? value > bestValue : value < bestValue) {
+                bestValue = value;
+                bestMove = move;
+            }
+            if (maximizing) alpha = std::max(alpha, value);
+            else beta = std::min(beta, value);
+        }
+        return bestMove;
+    }
+    }
+    return QString();
+}
+
+// Minimax over the best 'beam' heuristic moves; values are team1 win probabilities.
+// Leaves below the depth limit are completed greedily with the heuristic and then judged.
+double Arena::alphaBeta(const ArenaPolicy& policy, const DraftState& state, int depth,
+                        double alpha, double beta) const {
+    if (state.isComplete()) {
+        return judge(state, policy.evalWeights);
+    }
+    if (depth <= 0) {
+        DraftState rollout = state;
+        while (!rollout.isComplete()) {
+            QString move = suggestPickHeuristic(rollout, m_statsCalculator, policy.weights).first;
+            if (move.isEmpty()) return 0.5;
+            rollout = rollout.applyMove(move);
+        }
+        return judge(rollout, policy.evalWeights);
+    }
+
+    bool maximizing = state.currentTurn() == "team1";
+    double best = maximizing ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+    for (const QString& move : orderedMoves(state, policy.weights, policy.beam)) {
+        double value = alphaBeta(policy, state.applyMove(move), depth - 1, alpha, beta);
+        if (maximizing) {
+            best = std::max(best, value);
+            alpha = std::max(alpha, value);
+        } else {
+            best = std::min(best, value);
+            beta = std::min(beta, value);
+        }
+        if (beta <= alpha) break; // Cutoff
+    }
+    return best;
+}
+
+QVector<QString> Arena::orderedMoves(const DraftState& state, const HeuristicWeights& weights, int limit) const {
+    auto [bestPick, scores] = suggestPickHeuristic(state, m_statsCalculator, weights);
+    Q_UNUSED(bestPick);
+
+    QVector<QPair<QString, double>> ranked;
+    ranked.reserve(scores.size());
+    for (auto it = scores.constBegin(); it != scores.constEnd(); ++it) {
+        ranked.append({it.key(), it.value().totalScore});
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const QPair<QString, double>& a, const QPair<QString, double>& b) {
+        if (a.second != b.second) return a.second > b.second;
+        return a.first < b.first;
+    });
+
+    QVector<QString> moves;
+    for (int i = 0; i < ranked.size() && i < limit; ++i) moves.append(ranked[i].first);
+    return moves;
+}
+
+double Arena::judge(const DraftState& finalState, const EvalWeights& evalWeights) const {
+    return predictWinProbabilityModel(finalState.team1Picks(), finalState.team2Picks(),
+                                      finalState.mapName(), finalState.modeName(),
+                                      m_statsCalculator, evalWeights);
+}
+
+// --- Match Runner ---
+
+ArenaReport Arena::run(const ArenaSettings& settings) const {
+    QVector<QPair<QString, QString>> maps;
+    for (auto modeIt = m_mapModeData.constBegin(); modeIt != m_mapModeData.constEnd(); ++modeIt) {
+        if (!settings.modeFilter.isEmpty() && modeIt.key() != settings.modeFilter) continue;
+        for (const QString& mapName : modeIt.value()) maps.append({mapName, modeIt.key()});
+    }
+    if (maps.isEmpty()) throw std::invalid_argument("Arena has no maps to play on.");
+    if (settings.pairings <= 0) throw std::invalid_argument("Arena needs at least one pairing.");
+    std::sort(maps.begin(), maps.end()); // Deterministic schedule for a given seed
+
+    // --- Build Schedule: each position is played with A on both sides ---
+    std::mt19937 scheduleEngine(settings.seed);
+    QVector<QString> roster(m_allBrawlers.begin(), m_allBrawlers.end());
+    std::sort(roster.begin(), roster.end());
+    int bansPerDraft = std::clamp(settings.bansPerDraft, 0, 6);
+
+    QVector<ArenaGame> games;
+    games.reserve(settings.pairings * 2);
+    for (int i = 0; i < settings.pairings; ++i) {
+        ArenaGame game;
+        game.mapName = maps[i % maps.size()].first;
+        game.modeName = maps[i % maps.size()].second;
+        std::shuffle(roster.begin(), roster.end(), scheduleEngine);
+        for (int b = 0; b < bansPerDraft && b < roster.size(); ++b) game.bans.insert(roster[b]);
+        game.seed = scheduleEngine();
+        game.aIsTeam1 = true;
+        games.append(game);
+        game.aIsTeam1 = false;
+        games.append(game);
+    }
+
+    // --- Play All Drafts Concurrently ---
+    QElapsedTimer timer;
+    timer.start();
+    qInfo() << "Arena:" << settings.policyA.spec << "vs" << settings.policyB.spec << "-" << games.size() << "drafts";
+
+    QList<ArenaGameResult> results = TaskExecutor::instance().mapped(games, [this, &settings](const ArenaGame& game) {
+        ArenaGameResult result;
+        try {
+            DraftState state(game.mapName, game.modeName, m_allBrawlers, game.bans);
+            quint32 moveSeed = game.seed;
+            QElapsedTimer moveTimer;
+            while (!state.isComplete()) {
+                bool aToMove = (state.currentTurn() == "team1") == game.aIsTeam1;
+                const ArenaPolicy& policy = aToMove ? settings.policyA : settings.policyB;
+                moveTimer.start();
+                QString move = chooseMove(policy, state, moveSeed++);
+                qint64 moveUs = moveTimer.nsecsElapsed() / 1000;
+                if (aToMove) { result.moveUsA += moveUs; result.movesA++; }
+                else { result.moveUsB += moveUs; result.movesB++; }
+                if (move.isEmpty()) throw std::logic_error("Policy returned no move.");
+                state = state.applyMove(move);
+            }
+            double team1WinProb = judge(state, settings.judgeWeights);
+            result.scoreA = game.aIsTeam1 ? team1WinProb : 1.0 - team1WinProb;
+        } catch (const std::exception& e) {
+            qWarning() << "Arena draft failed on" << game.mapName << ":" << e.what();
+            result.scoreA = 0.5;
+        }
+        return result;
+    }, TaskPriority::Batch);
+
+    // --- Aggregate ---
+    // The two sides of a pairing share a position, so the pairing mean is the independent sample
+    ArenaReport report;
+    report.drafts = results.size();
+    qint64 totalUsA = 0, totalUsB = 0;
+    int totalMovesA = 0, totalMovesB = 0;
+    QVector<double> pairScores;
+    pairScores.reserve(settings.pairings);
+    for (int i = 0; i < results.size(); ++i) {
+        const ArenaGameResult& r = results[i];
+        if (r.scoreA > 0.5) report.winsA++;
+        else if (r.scoreA < 0.5) report.winsB++;
+        else report.draws++;
+        totalUsA += r.moveUsA; totalUsB += r.moveUsB;
+        totalMovesA += r.movesA; totalMovesB += r.movesB;
+        if (i % 2 == 1) pairScores.append((results[i - 1].scoreA + r.scoreA) / 2.0);
+    }
+
+    double n = pairScores.size();
+    double mean = 0.0;
+    for (double s : pairScores) mean += s;
+    mean /= n;
+    double variance = 0.0;
+    for (double s : pairScores) variance += (s - mean) * (s - mean);
+    variance = n > 1 ? variance / (n - 1) : 0.0;
+    double halfWidth = 1.96 * std::sqrt(variance / n);
+
+    report.scoreA = mean;
+    report.scoreCiLow = mean - halfWidth;
+    report.scoreCiHigh = mean + halfWidth;
+    report.eloDiff = eloFromScore(mean);
+    report.eloCiLow = eloFromScore(report.scoreCiLow);
+    report.eloCiHigh = eloFromScore(report.scoreCiHigh);
+    report.avgMoveMsA = totalMovesA > 0 ? totalUsA / 1000.0 / totalMovesA : 0.0;
+    report.avgMoveMsB = totalMovesB > 0 ? totalUsB / 1000.0 / totalMovesB : 0.0;
+    report.elapsedMs = timer.elapsed();
+
+    qInfo() << "Arena finished in" << report.elapsedMs << "ms. Score A:" << report.scoreA
+            << "Elo:" << report.eloDiff;
+    return report;
+}
@@ -0,0 +1,91 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <QString>
+#include <QVector>
+#include <QSet>
+#include <QHash>
+#include "DataStructures.h"
+#include "DraftState.h"
+#include "StatsCalculator.h"
+#include "AppConfig.h"
+#include "MCTS.h"
+
+// One drafting engine configuration. Parsed from a spec string:
+//   heuristic[:w=WR/SYN/CTR/PR]
+//   mcts:ITERS  or  mcts:iters=N,c=EXPLORATION[,w=...][,e=...]
+//   alphabeta:DEPTH  or  alphabeta:depth=D,beam=B[,w=...][,e=...]
+// e=WR/SYN/CTR/PEAK/SLOPE sets the win model the engine searches with.
+struct ArenaPolicy {
+    enum class Kind { Heuristic, Mcts, AlphaBeta };
+    Kind kind = Kind::Heuristic;
+    QString spec;              // As given, for reports
+    HeuristicWeights weights;  // Move ordering / rollout weights
+    EvalWeights evalWeights;   // Win model used inside the search (MCTS results, alpha-beta leaves)
+    int iterations = 1000;     // Mcts
+    double exploration = 0.0;  // Mcts, <= 0 uses the configured value
+    int depth = 2;             // AlphaBeta plies
+    int beam = 6;              // AlphaBeta moves searched per node (best heuristic moves)
+};
+
+struct ArenaSettings {
+    ArenaPolicy policyA;
+    ArenaPolicy policyB;
+    int pairings = 200;         // Each pairing is played twice with sides swapped
+    int bansPerDraft = 2;       // Random bans per position, for opening diversity
+    quint32 seed = 1;
+    QString modeFilter;         // Only maps of this mode (empty = all)
+    EvalWeights judgeWeights;   // predictWinProbabilityModel weights used to score final drafts
+};
+
+struct ArenaReport {
+    int drafts = 0;
+    double winsA = 0;           // Drafts judged > 50% for A
+    double winsB = 0;
+    double draws = 0;
+    double scoreA = 0.5;        // Mean judged win probability of A
+    double scoreCiLow = 0.5;    // 95% confidence interval of scoreA
+    double scoreCiHigh = 0.5;
+    double eloDiff = 0.0;       // Elo of A relative to B (from scoreA)
+    double eloCiLow = 0.0;
+    double eloCiHigh = 0.0;
+    double avgMoveMsA = 0.0;    // Mean thinking time per move
+    double avgMoveMsB = 0.0;
+    qint64 elapsedMs = 0;
+};
+
+// Headless self-play: plays complete drafts between two policies across all maps in parallel,
+// and judges each final draft with predictWinProbabilityModel. Both sides of every position are
+// played by each policy, so first-pick advantage cancels out.
+class Arena {
+public:
+    Arena(const StatsCalculator& statsCalculator,
+          const QSet<QString>& allBrawlers,
+          const QHash<QString, QSet<QString>>& mapModeData,
+          const AppConfig& config,
+          const MCTSManager& mctsManager);
+
+    // Throws std::invalid_argument on an unparsable spec
+    static ArenaPolicy parsePolicy(const QString& spec, const HeuristicWeights& defaultWeights,
+                                   const EvalWeights& defaultEvalWeights);
+
+    // Throws std::invalid_argument if there are no maps to play on
+    ArenaReport run(const ArenaSettings& settings) const;
+
+    // Picks a move for the side to move in 'state'
+    QString chooseMove(const ArenaPolicy& policy, const DraftState& state, quint32 seed) const;
+
+private:
+    double alphaBeta(const ArenaPolicy& policy, const DraftState& state, int depth,
+                     double alpha, double beta) const;
+    QVector<QString> orderedMoves(const DraftState& state, const HeuristicWeights& weights, int limit) const;
+    double judge(const DraftState& finalState, const EvalWeights& evalWeights) const;
+
+    const StatsCalculator& m_statsCalculator;
+    const QSet<QString>& m_allBrawlers;
+    const QHash<QString, QSet<QString>>& m_mapModeData;
+    const AppConfig& m_config;
+    const MCTSManager& m_mctsManager;
+};
+
+#endif // ARENA_H
@@ -0,0 +1,272 @@
+#include "Bootstrap.h"
+#include "AppConfig.h"
+#include "DraftState.h"
+#include "GameTable.h"
+#include "StatsCalculator.h"
+#include "TaskExecutor.h"
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+constexpr int N = GameTable::TEAM_SIZE;
+
+// Poisson(1) CDF at 0..6 scaled to 2^32: a uniform 32-bit u counts u >= t over the thresholds
+// (a draw of 7 or more is 1 in 100000 and counts as 7)
+constexpr std::array<quint32, 7> POISSON_CDF = {
+    1580030169u, 3160060337u, 3950075422u, 4213413783u, 4279248374u, 4292415292u, 4294609778u,
+};
+
+quint64 splitmix64(quint64& state) {
+    quint64 z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Times game 'row' counts in each replica
+void poissonWeights(quint32 seed, int row, float* weights, int replicas) {
+    quint64 state = (quint64(seed) << 32) ^ (quint64(row) * 0xD1B54A32D192ED03ull);
+    for (int b = 0; b < replicas; b += 2) {
+        const quint64 bits = splitmix64(state);
+        const quint32 uniforms[2] = {quint32(bits), quint32(bits >> 32)};
+        for (int k = 0; k < 2 && b + k < replicas; ++k) {
+            int count = 0;
+            for (quint32 threshold : POISSON_CDF) count += uniforms[k] >= threshold;
+            weights[b + k] = float(count);
+        }
+    }
+}
+
+// One cell's replicas: plays (and wins) += weight * replica weight
+inline void addPlays(float* plays, const float* weights, float weight, int replicas) {
+    for (int b = 0; b < replicas; ++b) plays[b] += weight * weights[b];
+}
+inline void addWinsAndPlays(float* wins, float* plays, const float* weights, float weight, int replicas) {
+    for (int b = 0; b < replicas; ++b) {
+        const float w = weight * weights[b];
+        wins[b] += w;
+        plays[b] += w;
+    }
+}
+
+// Standard deviation of wins / plays over the replicas that played the cell
+std::optional<float> replicaError(const float* wins, const float* plays, int replicas) {
+    double sum = 0.0, sumSq = 0.0;
+    int n = 0;
+    for (int b = 0; b < replicas; ++b) {
+        if (plays[b] <= 0.0f) continue;
+        const double rate = double(wins[b]) / plays[b];
+        sum += rate;
+        sumSq += rate * rate;
+        ++n;
+    }
+    if (n < 2) return std::nullopt;
+    const double mean = sum / n;
+    return float(std::sqrt(std::max(0.0, (sumSq - n * mean * mean) / (n - 1))));
+}
+
+struct MapModeRows {
+    int mapId = 0;
+    int modeId = 0;
+    QVector<int> rows;
+};
+
+// Every replica of one map/mode in one pass over its games. Cells are dense over the brawlers
+// seen on the map/mode: [0, n) brawlers, then n * n synergy (low, high) and n * n counter (us, them).
+MapModeErrorData mapModeErrors(const GameTable& table, const MapModeRows& group, const QVector<float>& rankWeights,
+                               int replicas, quint32 seed) {
+    const QVector<int>& winners = table.winnerBrawlerIds();
+    const QVector<int>& losers = table.loserBrawlerIds();
+    const QVector<int>& winnerRanks = table.winnerRanks();
+    const QVector<int>& loserRanks = table.loserRanks();
+    auto rankWeight = [&rankWeights](int rank) {
+        return rankWeights[std::clamp(rank, 0, int(rankWeights.size()) - 1)];
+    };
+
+    QVector<int> local(table.brawlerNames().size(), -1);
+    QVector<int> global;
+    for (int row : group.rows) {
+        for (int p = row * N; p < (row + 1) * N; ++p) {
+            for (int id : {winners[p], losers[p]}) {
+                if (local[id] >= 0) continue;
+                local[id] = global.size();
+                global.append(id);
+            }
+        }
+    }
+    const qsizetype n = global.size();
+    const qsizetype synergyBase = n;
+    const qsizetype counterBase = n + n * n;
+    const qsizetype cells = n + 2 * n * n;
+    QVector<float> wins(cells * replicas, 0.0f);
+    QVector<float> plays(cells * replicas, 0.0f);
+    float* w = wins.data();
+    float* p = plays.data();
+    auto cell = [replicas](qsizetype index) { return index * replicas; };
+
+    QVector<float> weights(replicas);
+    for (int row : group.rows) {
+        poissonWeights(seed, row, weights.data(), replicas);
+        const float* rw = weights.constData();
+        int win[N], lose[N];
+        float winWeight[N], loseWeight[N];
+        for (int i = 0; i < N; ++i) {
+            win[i] = local[winners[row * N + i]];
+            lose[i] = local[losers[row * N + i]];
+            winWeight[i] = rankWeight(winnerRanks[row * N + i]);
+            loseWeight[i] = rankWeight(loserRanks[row * N + i]);
+            addWinsAndPlays(w + cell(win[i]), p + cell(win[i]), rw, winWeight[i], replicas);
+            addPlays(p + cell(lose[i]), rw, loseWeight[i], replicas);
+        }
+        // Synergy pairs weigh the rounded average rank of the two players, as StatsCalculator does
+        for (int i = 0; i < N; ++i) {
+            for (int k = i + 1; k < N; ++k) {
+                const float winPair = rankWeight(int(std::round((winnerRanks[row * N + i] + winnerRanks[row * N + k]) / 2.0)));
+                const qsizetype winCell = synergyBase + qsizetype(std::min(win[i], win[k])) * n + std::max(win[i], win[k]);
+                addWinsAndPlays(w + cell(winCell), p + cell(winCell), rw, winPair, replicas);
+                const float losePair = rankWeight(int(std::round((loserRanks[row * N + i] + loserRanks[row * N + k]) / 2.0)));
+                const qsizetype loseCell = synergyBase + qsizetype(std::min(lose[i], lose[k])) * n + std::max(lose[i], lose[k]);
+                addPlays(p + cell(loseCell), rw, losePair, replicas);
+            }
+        }
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                const qsizetype winLose = counterBase + qsizetype(win[i]) * n + lose[j];
+                addWinsAndPlays(w + cell(winLose), p + cell(winLose), rw, winWeight[i], replicas);
+                const qsizetype loseWin = counterBase + qsizetype(lose[j]) * n + win[i];
+                addPlays(p + cell(loseWin), rw, loseWeight[j], replicas);
+            }
+        }
+    }
+
+    const QVector<QString>& names = table.brawlerNames();
+    MapModeErrorData errors;
+    for (qsizetype a = 0; a < n; ++a) {
+        const QString& nameA = names[global[a]];
+        if (auto error = replicaError(w + cell(a), p + cell(a), replicas)) errors.brawlerStats.insert(nameA, *error);
+        for (qsizetype b = 0; b < n; ++b) {
+            const QString& nameB = names[global[b]];
+            const qsizetype counterCell = counterBase + a * n + b;
+            if (auto error = replicaError(w + cell(counterCell), p + cell(counterCell), replicas)) {
+                errors.counterStats.insert(counterPairKey(nameA, nameB), *error);
+            }
+            if (b < a) continue;
+            const qsizetype synergyCell = synergyBase + a * n + b;
+            if (auto error = replicaError(w + cell(synergyCell), p + cell(synergyCell), replicas)) {
+                errors.synergyStats.insert(sortedPairKey(nameA, nameB), *error);
+            }
+        }
+    }
+    return errors;
+}
+
+} // namespace
+
+
+ErrorContainer Bootstrap::cellErrors(const GameTable& table, const AppConfig& config, int replicas, quint32 seed) {
+    if (replicas < 2) throw std::invalid_argument("A bootstrap needs at least 2 replicas.");
+    QElapsedTimer timer;
+    timer.start();
+
+    // Rank weights once, not per player and replica
+    QVector<float> rankWeights(config.maxRankConsidered() + 1);
+    for (int rank = 0; rank < rankWeights.size(); ++rank) rankWeights[rank] = float(config.getRankWeight(rank));
+
+    QHash<QPair<int, int>, int> groupIndex;
+    QVector<MapModeRows> groups;
+    for (int row = 0; row < table.size(); ++row) {
+        const QPair<int, int> key(table.mapIds()[row], table.modeIds()[row]);
+        auto it = groupIndex.constFind(key);
+        if (it == groupIndex.constEnd()) {
+            it = groupIndex.insert(key, groups.size());
+            groups.append({key.first, key.second, {}});
+        }
+        groups[it.value()].rows.append(row);
+    }
+
+    QList<MapModeErrorData> perMapMode = TaskExecutor::instance().mapped(groups, [&](const MapModeRows& group) {
+        return mapModeErrors(table, group, rankWeights, replicas, seed);
+    }, TaskPriority::Background);
+
+    ErrorContainer errors;
+    for (int i = 0; i < groups.size(); ++i) {
+        errors[table.mapNames()[groups[i].mapId]][table.modeNames()[groups[i].modeId]] = perMapMode[i];
+    }
+    qInfo() << "Bootstrap:" << replicas << "replicas over" << table.size() << "games and" << groups.size()
+            << "map/modes in" << timer.elapsed() << "ms.";
+    return errors;
+}
+
+QHash<QString, double> Bootstrap::firstPlaceShares(const DraftState& state, const StatsCalculator& stats,
+                                                   const HeuristicWeights& weights,
+                                                   const QHash<QString, HeuristicScoreComponents>& scores,
+                                                   int replicas, quint32 seed) {
+    const QString& mapName = state.mapName();
+    const QString& mode = state.modeName();
+    const bool team1 = state.currentTurn() == "team1";
+    const QVector<QString>& teammates = team1 ? state.team1Picks() : state.team2Picks();
+    const QVector<QString>& opponents = team1 ? state.team2Picks() : state.team1Picks();
+
+    // The score is a weighted sum of independent cells, so each redraw of a candidate's cells
+    // moves its score by one normal draw with the combined spread
+    QVector<QString> candidates;
+    QVector<double> means;
+    QVector<double> spreads;
+    bool anyError = false;
+    for (auto it = scores.constBegin(); it != scores.constEnd(); ++it) {
+        if (!std::isfinite(it.value().totalScore)) continue;
+        const QString& brawler = it.key();
+        double variance = 0.0;
+        if (std::optional<double> error = stats.getWinRateError(brawler, mapName, mode)) {
+            variance += std::pow(weights.winRate * *error, 2);
+            anyError = true;
+        }
+        double synergyVariance = 0.0;
+        for (const QString& teammate : teammates) {
+            if (std::optional<double> error = stats.getSynergyError(brawler, teammate, mapName, mode)) {
+                synergyVariance += *error * *error;
+                anyError = true;
+            }
+        }
+        if (!teammates.isEmpty()) variance += std::pow(weights.synergy / teammates.size(), 2) * synergyVariance;
+        double counterVariance = 0.0;
+        for (const QString& opponent : opponents) {
+            if (std::optional<double> error = stats.getCounterError(brawler, opponent, mapName, mode)) {
+                counterVariance += *error * *error;
+                anyError = true;
+            }
+        }
+        if (!opponents.isEmpty()) variance += std::pow(weights.counter / opponents.size(), 2) * counterVariance;
+        candidates.append(brawler);
+        means.append(it.value().totalScore);
+        spreads.append(std::sqrt(variance));
+    }
+    if (!anyError || candidates.isEmpty() || replicas < 1) return {};
+
+    std::mt19937 randomEngine(seed);
+    std::normal_distribution<double> normal;
+    QVector<int> firsts(candidates.size(), 0);
+    for (int r = 0; r < replicas; ++r) {
+        int best = 0;
+        double bestScore = -std::numeric_limits<double>::infinity();
+        for (int c = 0; c < candidates.size(); ++c) {
+            const double score = means[c] + spreads[c] * normal(randomEngine);
+            if (score > bestScore) {
+                bestScore = score;
+                best = c;
+            }
+        }
+        ++firsts[best];
+    }
+    QHash<QString, double> shares;
+    for (int c = 0; c < candidates.size(); ++c) shares.insert(candidates[c], double(firsts[c]) / replicas);
+    return shares;
+}
@@ -0,0 +1,37 @@
+#ifndef BOOTSTRAP_H
+#define BOOTSTRAP_H
+
+#include <QHash>
+#include <QString>
+#include "DataStructures.h"
+
+class GameTable;
+class AppConfig;
+class StatsCalculator;
+class DraftState;
+
+// --- Bootstrap Errors ---
+// Standard errors of an exact pack's raw win rates (wins / plays) from Poisson bootstrap replicas:
+// each replica counts every game Poisson(1) times, and a cell's error is the spread of its win rate
+// across replicas. Each map/mode is one streaming pass over its games on the task executor. The
+// replicas' wins and plays sit side by side per cell, so one game updates every replica in one
+// contiguous (vectorized) loop. A game's weights come from a hash of the seed and its row, so the
+// errors do not depend on the thread count.
+namespace Bootstrap {
+
+    // Keyed like the pack's cells; maps without 3v3 games get none (GameTable keeps 3v3 only).
+    // Throws std::invalid_argument if replicas < 2.
+    ErrorContainer cellErrors(const GameTable& table, const AppConfig& config, int replicas, quint32 seed = 1);
+
+    // Share of 'replicas' redraws of the stats in which each candidate of 'scores' (from
+    // suggestPickHeuristic on 'state') has the top score. A redraw moves every win rate, synergy
+    // and counter cell behind a score by a normal draw with that cell's standard error; cells
+    // without one stay put. Empty if none of the candidates' cells has an error.
+    QHash<QString, double> firstPlaceShares(const DraftState& state, const StatsCalculator& stats,
+                                            const HeuristicWeights& weights,
+                                            const QHash<QString, HeuristicScoreComponents>& scores,
+                                            int replicas, quint32 seed = 1);
+
+} // namespace Bootstrap
+
+#endif // BOOTSTRAP_H
@@ -27,12 +27,16 @@ namespace CacheUtils {
         // Optional: Add a version number for future compatibility
         out.setVersion(QDataStream::Qt_6_0); // Or your target Qt version
         quint32 magicNumber = 0xACEDBABE; // Simple magic number
-        qint16 version = 1;
+        qint16 version = 4; // 2: name index appended, 3: sampling metadata and errors, 4: merge sources
         out << magicNumber;
         out << version;
 
         // Serialize the main data structure
         out << data; // Uses the overloaded operator<< for CacheData
+        // Perfect hashes for name -> id, built once here so readers never rebuild them
+        out << (data.names.isEmpty() ? NameIndex::build(data.allBrawlers, data.discoveredMapModes) : data.names);
+        out << data.metadata.sampleFraction << data.metadata.sampledGames << data.errors;
+        out << data.metadata.mergedFrom;
 
         file.close();
 
@@ -73,14 +77,23 @@ namespace CacheUtils {
             return std::nullopt;
         }
         in >> version;
-         if (in.status() != QDataStream::Ok || version != 1) { // Check version compatibility
-            qWarning() << "Cache file version mismatch (expected 1, got" << version << "):" << filepath;
+         if (in.status() != QDataStream::Ok || version < 1 || version > 4) { // Check version compatibility
+            qWarning() << "Cache file version mismatch (expected 1 to 4, got" << version << "):" << filepath;
             return std::nullopt;
         }
 
 
         CacheData loadedData;
         in >> loadedData; // Uses the overloaded operator>> for CacheData
+        if (version >= 2) {
+            in >> loadedData.names;
+        }
+        if (version >= 3) {
+            in >> loadedData.metadata.sampleFraction >> loadedData.metadata.sampledGames >> loadedData.errors;
+        }
+        if (version >= 4) {
+            in >> loadedData.metadata.mergedFrom;
+        }
 
         file.close();
 
@@ -96,8 +109,72 @@ namespace CacheUtils {
         }
 
 
+        // Version 1 packs have no name index; a stale or damaged one is rebuilt too
+        if (!loadedData.names.brawlers.isConsistent() || !loadedData.names.maps.isConsistent() ||
+            !loadedData.names.modes.isConsistent() ||
+            !loadedData.names.matches(loadedData.allBrawlers, loadedData.discoveredMapModes)) {
+            if (version >= 2) qWarning() << "Cache name index is inconsistent; rebuilding it.";
+            loadedData.names = NameIndex::build(loadedData.allBrawlers, loadedData.discoveredMapModes);
+        }
+
         qInfo() << "Cache file loaded successfully:" << filepath;
         return loadedData;
     }
 
+
+    // --- Map Sweep Cache ---
+    const quint32 SWEEP_CACHE_MAGIC = 0xACED5EEB;
+    const qint16 SWEEP_CACHE_VERSION = 1;
+
+    bool saveSweepCache(const QString& filepath, const QHash<QString, SweepReport>& reports) {
+        QFile file(filepath);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qWarning() << "Error opening sweep cache for writing:" << filepath << file.errorString();
+            return false;
+        }
+
+        QDataStream out(&file);
+        out.setVersion(QDataStream::Qt_6_0);
+        out << SWEEP_CACHE_MAGIC << SWEEP_CACHE_VERSION << reports;
+        file.close();
+
+        if (out.status() != QDataStream::Ok) {
+            qWarning() << "Error writing sweep cache:" << filepath;
+            file.remove();
+            return false;
+        }
+        return true;
+    }
+
+    QHash<QString, SweepReport> loadSweepCache(const QString& filepath, qint64 packVersion) {
+        QHash<QString, SweepReport> reports;
+        QFile file(filepath);
+        if (!file.exists() || !file.open(QIODevice::ReadOnly)) {
+            return reports;
+        }
+
+        QDataStream in(&file);
+        in.setVersion(QDataStream::Qt_6_0);
+        quint32 magicNumber = 0;
+        qint16 version = 0;
+        in >> magicNumber >> version;
+        if (in.status() != QDataStream::Ok || magicNumber != SWEEP_CACHE_MAGIC || version != SWEEP_CACHE_VERSION) {
+            qWarning() << "Ignoring sweep cache with invalid header:" << filepath;
+            return reports;
+        }
+
+        in >> reports;
+        if (in.status() != QDataStream::Ok) {
+            qWarning() << "Ignoring corrupted sweep cache:" << filepath;
+            return {};
+        }
+
+        // Results from an older stats pack are stale
+        for (auto it = reports.begin(); it != reports.end(); ) {
+            if (it.value().packVersion != packVersion) it = reports.erase(it);
+            else ++it;
+        }
+        return reports;
+    }
+
 } // namespace CacheUtils
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define CACHEUTILS_H
 
 #include <QString>
+#include <QHash>
 #include <optional>
 #include "DataStructures.h" // For CacheData
 
@@ -13,6 +14,11 @@ namespace CacheUtils {
     // Loads CacheData from a file. Returns std::nullopt if file doesn't exist or fails to load.
     std::optional<CacheData> loadCache(const QString& filepath);
 
+    // Map sweep results keyed by SweepReport::paramsKey. Reports built from a different
+    // stats pack (packVersion) are dropped on load, so a new stats.pack invalidates them.
+    bool saveSweepCache(const QString& filepath, const QHash<QString, SweepReport>& reports);
+    QHash<QString, SweepReport> loadSweepCache(const QString& filepath, qint64 packVersion);
+
 } // namespace CacheUtils
 
 #endif // CACHEUTILS_H
\ No newline at end of file
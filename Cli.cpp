@@ -0,0 +1,1236 @@
+#include "Cli.h"
+#include "Arena.h"
+#include "CacheUtils.h"
+#include "CompactStats.h"
+#include "CompFinder.h"
+#include "DataLoader.h"
+#include "DataStructures.h"
+#include "GameTable.h"
+#include "Bootstrap.h"
+#include "MapSweep.h"
+#include "MCTS.h"
+#include "MemoryLedger.h"
+#include "MoveClusters.h"
+#include "PackMerge.h"
+#include "PlayerIndex.h"
+#include "PolicyTable.h"
+#include "SampledStats.h"
+#include "ScaleBench.h"
+#include "SearchBench.h"
+#include "ShardPartials.h"
+#include "SharedTree.h"
+#include "TaskExecutor.h"
+#include "StatsCalculator.h"
+#include "SyntheticData.h"
+#include "WeightTuner.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTextStream>
+#include <QThread>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+
+namespace {
+
+const QString SWEEP_CACHE_FILE_NAME = "sweep_cache.dat";
+const QString POLICY_FILE_NAME = "policy.table";
+const QString DATA_FILE_NAME = "high_level_ranked_games.jsonl";
+const QString SNAPSHOT_DIR_NAME = "mcts_snapshots";
+const QString COMPACT_FILE_NAME = "stats.compact";
+const QString PLAYER_INDEX_FILE_NAME = "players.index";
+const QString SAMPLE_PACK_FILE_NAME = "stats.sample.pack";
+const QString BENCH_CORPUS_FILE_NAME = "bench.corpus";
+const QString MERGED_PACK_FILE_NAME = "merged.pack";
+const QString PARTIALS_DIR_NAME = "pack_partials";
+
+QTextStream& out() {
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream& err() {
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+// --- Shared helpers ---
+
+struct LoadedPack {
+    CacheData data;
+    std::optional<StatsCalculator> stats;
+};
+
+// Reads a stats pack or a compact pack (see CompactStats). With UseCompactStats a full pack is
+// quantized on load; 'allowCompact' = false keeps the double path (e.g. to measure against it).
+bool loadPack(const QString& cacheFilePath, const AppConfig& config, LoadedPack& pack, bool allowCompact = true) {
+    if (CompactStats::isCompactFile(cacheFilePath)) {
+        if (!allowCompact) {
+            err() << "This command needs a full stats pack, not a compact one: " << cacheFilePath << Qt::endl;
+            return false;
+        }
+        std::shared_ptr<const CompactStats> compact = CompactStats::load(cacheFilePath);
+        if (!compact) {
+            err() << "Failed to load compact stats pack: " << cacheFilePath << Qt::endl;
+            return false;
+        }
+        compact->checkSettings(config);
+        pack.data = compact->cacheData();
+        pack.stats.emplace(config);
+        pack.stats->setCompactStats(compact);
+        return true;
+    }
+
+    auto cachedDataOpt = CacheUtils::loadCache(cacheFilePath);
+    if (!cachedDataOpt.has_value()) {
+        err() << "Failed to load stats pack: " << cacheFilePath << Qt::endl;
+        return false;
+    }
+    pack.data = std::move(cachedDataOpt.value());
+    if (pack.data.metadata.isApproximate()) {
+        err() << QString("Approximate pack: estimated from %1% of the games (%2 sampled).")
+                     .arg(pack.data.metadata.sampleFraction * 100.0, 0, 'f', 1)
+                     .arg(pack.data.metadata.sampledGames) << Qt::endl;
+    }
+    pack.stats.emplace(config);
+    pack.stats->setStatsFromCacheData(pack.data);
+    if (allowCompact && config.useCompactStats()) {
+        pack.stats->setCompactStats(CompactStats::build(*pack.stats, pack.data, config, config.compactPlaysThreshold()));
+        pack.data.stats.clear(); // Only the compact tables are read from here on
+    }
+    return true;
+}
+
+// Splits "A, B,C" into trimmed, non-empty names
+QVector<QString> parseTeam(const QString& csv) {
+    QVector<QString> team;
+    for (const QString& part : csv.split(',', Qt::SkipEmptyParts)) {
+        QString name = part.trimmed();
+        if (!name.isEmpty()) team.append(name);
+    }
+    return team;
+}
+
+// Resolved through the pack's perfect hash: one hash and one compare per name
+bool validateNames(const QVector<QString>& names, const NameIndex& index) {
+    for (const QString& name : names) {
+        if (!index.brawlers.contains(name)) {
+            err() << "Unknown brawler: " << name << Qt::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool validateMapMode(const QString& mapName, const QString& modeName, const CacheData& data) {
+    if (!data.names.maps.contains(mapName) || !data.names.modes.contains(modeName) ||
+        !data.discoveredMapModes.value(modeName).contains(mapName)) {
+        err() << "Unknown map/mode: " << mapName << " (" << modeName << ")" << Qt::endl;
+        return false;
+    }
+    return true;
+}
+
+// Parses command options; argv[0] is kept so QCommandLineParser sees a normal command line
+bool parseOptions(QCommandLineParser& parser, const QStringList& arguments) {
+    parser.addHelpOption();
+    QStringList commandLine = QStringList{arguments.value(0)} + arguments.mid(2);
+    if (!parser.parse(commandLine)) {
+        err() << parser.errorText() << Qt::endl;
+        return false;
+    }
+    if (parser.isSet("help")) {
+        out() << parser.helpText();
+        return false;
+    }
+    return true;
+}
+
+// --- Commands ---
+
+int runCounter(const QStringList& arguments, AppConfig& config, const QString& cacheFilePath) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Best-response search: top teams against a known enemy team.");
+    QCommandLineOption mapOpt("map", "Map name.", "map");
+    QCommandLineOption modeOpt("mode", "Mode name.", "mode");
+    QCommandLineOption enemyOpt("enemy", "Enemy team, comma-separated (3 brawlers).", "names");
+    QCommandLineOption lockOpt("lock", "Our locked picks, comma-separated.", "names");
+    QCommandLineOption banOpt("ban", "Excluded brawlers, comma-separated.", "names");
+    QCommandLineOption topOpt("top", "Number of teams to report.", "k", QString::number(config.compFinderTopK()));
+    QCommandLineOption packOpt("pack", "Stats pack to read.", "file", cacheFilePath);
+    parser.addOptions({mapOpt, modeOpt, enemyOpt, lockOpt, banOpt, topOpt, packOpt});
+    if (!parseOptions(parser, arguments)) return 1;
+
+    QString mapName = parser.value(mapOpt);
+    QString modeName = parser.value(modeOpt);
+    QVector<QString> enemy = parseTeam(parser.value(enemyOpt));
+    QVector<QString> locked = parseTeam(parser.value(lockOpt));
+    QVector<QString> bans = parseTeam(parser.value(banOpt));
+    int topK = parser.value(topOpt).toInt();
+
+    if (enemy.size() != 3) { err() << "--enemy needs exactly 3 brawlers." << Qt::endl; return 1; }
+    if (locked.size() > 3) { err() << "--lock takes at most 3 brawlers." << Qt::endl; return 1; }
+    if (topK <= 0) { err() << "--top must be positive." << Qt::endl; return 1; }
+
+    LoadedPack pack;
+    if (!loadPack(parser.value(packOpt), config, pack)) return 1;
+    if (!validateMapMode(mapName, modeName, pack.data)) return 1;
+    if (!validateNames(enemy, pack.data.names) || !validateNames(locked, pack.data.names) ||
+        !validateNames(bans, pack.data.names)) {
+        return 1;
+    }
+
+    QSet<QString> excluded(bans.begin(), bans.end());
+    QString conflict = bestResponseConflict(enemy, locked, excluded);
+    if (!conflict.isEmpty()) { err() << conflict << Qt::endl; return 1; }
+    CompSearchResult result = findBestResponse(enemy, locked, excluded, pack.data.allBrawlers,
+                                               mapName, modeName, *pack.stats, config.evalWeights(), topK);
+
+    out() << "Best response on " << mapName << " (" << modeName << ") vs "
+          << QStringList::fromVector(enemy).join(", ") << Qt::endl;
+    if (!locked.isEmpty()) out() << "Locked: " << QStringList::fromVector(locked).join(", ") << Qt::endl;
+    out() << QString("%1 | %2 | %3").arg("#", 3).arg("Team", -48).arg("Win %", 7) << Qt::endl;
+    out() << QString("-").repeated(64) << Qt::endl;
+    int rank = 1;
+    for (const CompResult& comp : result.topComps) {
+        out() << QString("%1 | %2 | %3")
+                     .arg(rank++, 3)
+                     .arg(QStringList::fromVector(comp.team).join(", "), -48)
+                     .arg(comp.winProbability * 100.0, 7, 'f', 2)
+              << Qt::endl;
+    }
+    out() << QString("Evaluated %1 teams, pruned %2 branches in %3 ms")
+                 .arg(result.teamsEvaluated)
+                 .arg(result.branchesPruned)
+                 .arg(result.elapsedUs / 1000.0, 0, 'f', 2)
+          << Qt::endl;
+    return result.topComps.isEmpty() ? 1 : 0;
+}
+
+int runSweep(const QStringList& arguments, AppConfig& config, const QString& cacheFilePath) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs one analysis across every map and ranks the maps.");
+    QCommandLineOption kindOpt("kind", "tiers (heuristic tier lists), team (team strength) or mcts.", "kind", "tiers");
+    QCommandLineOption modeOpt("mode", "Only sweep maps of this mode.", "mode");
+    QCommandLineOption poolOpt("pool", "tiers: brawler pool used to rank maps, comma-separated.", "names");
+    QCommandLineOption teamOpt("team", "team: our team, comma-separated (3 brawlers).", "names");
+    QCommandLineOption banOpt("ban", "Brawlers banned on every map, comma-separated.", "names");
+    QCommandLineOption topOpt("top", "Entries listed per map.", "k", "10");
+    QCommandLineOption itersOpt("iterations", "mcts: iteration budget per map.", "n", "2000");
+    QCommandLineOption noCacheOpt("no-cache", "Ignore and do not update the sweep cache.");
+    QCommandLineOption packOpt("pack", "Stats pack to read.", "file", cacheFilePath);
+    parser.addOptions({kindOpt, modeOpt, poolOpt, teamOpt, banOpt, topOpt, itersOpt, noCacheOpt, packOpt});
+    if (!parseOptions(parser, arguments)) return 1;
+
+    SweepRequest request;
+    QString kind = parser.value(kindOpt);
+    if (kind == "tiers") request.kind = SweepKind::TierList;
+    else if (kind == "team") request.kind = SweepKind::TeamStrength;
+    else if (kind == "mcts") request.kind = SweepKind::Mcts;
+    else { err() << "Unknown --kind: " << kind << Qt::endl; return 1; }
+    request.modeFilter = parser.value(modeOpt);
+    request.pool = parseTeam(parser.value(poolOpt));
+    request.team = parseTeam(parser.value(teamOpt));
+    QVector<QString> bans = parseTeam(parser.value(banOpt));
+    request.bans = QSet<QString>(bans.begin(), bans.end());
+    request.topK = parser.value(topOpt).toInt();
+    request.mctsIterations = parser.value(itersOpt).toInt();
+
+    LoadedPack pack;
+    QString packPath = parser.value(packOpt);
+    if (!loadPack(packPath, config, pack)) return 1;
+    if (!validateNames(request.pool, pack.data.names) || !validateNames(request.team, pack.data.names) ||
+        !validateNames(bans, pack.data.names)) {
+        return 1;
+    }
+
+    MCTSManager mctsManager(*pack.stats, config);
+    MapSweeper sweeper(*pack.stats, pack.data.allBrawlers, pack.data.discoveredMapModes, config, &mctsManager);
+    QString sweepCachePath = parser.isSet(noCacheOpt) ? QString()
+                                                      : QFileInfo(packPath).dir().filePath(SWEEP_CACHE_FILE_NAME);
+    SweepReport report;
+    try {
+        report = sweeper.run(request, sweepCachePath);
+    } catch (const std::exception& e) {
+        err() << e.what() << Qt::endl;
+        return 1;
+    }
+
+    QString scoreTitle = request.kind == SweepKind::TeamStrength ? "Worst-case win %"
+                       : request.kind == SweepKind::Mcts         ? "First-pick win %"
+                                                                 : "Pool score";
+    out() << QString("%1 | %2 | %3").arg("Map", -28).arg("Mode", -14).arg(scoreTitle) << Qt::endl;
+    out() << QString("-").repeated(64) << Qt::endl;
+    for (const MapSweepResult& map : report.maps) {
+        double shown = request.kind == SweepKind::TierList ? map.mapScore : map.mapScore * 100.0;
+        out() << QString("%1 | %2 | %3").arg(map.mapName, -28).arg(map.modeName, -14).arg(shown, 0, 'f', 3) << Qt::endl;
+        for (const SweepEntry& entry : map.entries) {
+            QString value = request.kind == SweepKind::TierList ? QString::number(entry.score, 'f', 3)
+                                                                : QString::number(entry.score * 100.0, 'f', 1) + "%";
+            out() << QString("    %1 %2 %3").arg(entry.tier, 1).arg(entry.label, -40).arg(value) << Qt::endl;
+        }
+    }
+    out() << QString("%1 maps, %2 ms%3").arg(report.maps.size()).arg(report.elapsedMs)
+                 .arg(report.fromCache ? " (cached)" : "") << Qt::endl;
+    return 0;
+}
+
+int runArena(const QStringList& arguments, AppConfig& config, const QString& cacheFilePath) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Self-play arena: complete drafts between two policies, judged by the win model.\n"
+                                     "Policies: heuristic[:w=WR/SYN/CTR/PR], mcts:ITERS[,c=C,w=...,e=...], alphabeta:DEPTH[,beam=B,w=...,e=...]\n"
+                                     "e=WR/SYN/CTR/PEAK/SLOPE sets the engine's win model weights");
+    QCommandLineOption aOpt("a", "Policy A.", "policy", "mcts:1000");
+    QCommandLineOption bOpt("b", "Policy B.", "policy", "heuristic");
+    QCommandLineOption pairingsOpt("pairings", "Positions played (each twice, sides swapped).", "n", "200");
+    QCommandLineOption bansOpt("bans", "Random bans per position.", "n", "2");
+    QCommandLineOption seedOpt("seed", "Schedule seed.", "n", "1");
+    QCommandLineOption modeOpt("mode", "Only play maps of this mode.", "mode");
+    QCommandLineOption packOpt("pack", "Stats pack to read.", "file", cacheFilePath);
+    parser.addOptions({aOpt, bOpt, pairingsOpt, bansOpt, seedOpt, modeOpt, packOpt});
+    if (!parseOptions(parser, arguments)) return 1;
+
+    LoadedPack pack;
+    if (!loadPack(parser.value(packOpt), config, pack)) return 1;
+
+    ArenaSettings settings;
+    settings.judgeWeights = config.evalWeights();
+    settings.pairings = parser.value(pairingsOpt).toInt();
+    settings.bansPerDraft = parser.value(bansOpt).toInt();
+    settings.seed = parser.value(seedOpt).toUInt();
+    settings.modeFilter = parser.value(modeOpt);
+
+    MCTSManager mctsManager(*pack.stats, config);
+    Arena arena(*pack.stats, pack.data.allBrawlers, pack.data.discoveredMapModes, config, mctsManager);
+    ArenaReport report;
+    try {
+        settings.policyA = Arena::parsePolicy(parser.value(aOpt), config.heuristicWeights(), config.evalWeights());
+        settings.policyB = Arena::parsePolicy(parser.value(bOpt), config.heuristicWeights(), config.evalWeights());
+        report = arena.run(settings);
+    } catch (const std::exception& e) {
+        err() << e.what() << Qt::endl;
+        return 1;
+    }
+
+    out() << "A: " << settings.policyA.spec << "   B: " << settings.policyB.spec << Qt::endl;
+    out() << QString("Drafts: %1   A wins: %2   B wins: %3   Even: %4")
+                 .arg(report.drafts).arg(report.winsA).arg(report.winsB).arg(report.draws) << Qt::endl;
+    out() << QString("Score A: %1%  (95% CI %2% .. %3%)")
+                 .arg(report.scoreA * 100.0, 0, 'f', 2)
+                 .arg(report.scoreCiLow * 100.0, 0, 'f', 2)
+                 .arg(report.scoreCiHigh * 100.0, 0, 'f', 2) << Qt::endl;
+    out() << QString("Elo A-B: %1  (95% CI %2 .. %3)")
+                 .arg(report.eloDiff, 0, 'f', 1).arg(report.eloCiLow, 0, 'f', 1).arg(report.eloCiHigh, 0, 'f', 1) << Qt::endl;
+    out() << QString("Avg move time: A %1 ms, B %2 ms   Total: %3 ms")
+                 .arg(report.avgMoveMsA, 0, 'f', 2).arg(report.avgMoveMsB, 0, 'f', 2).arg(report.elapsedMs) << Qt::endl;
+    return 0;
+}
+
+int runDistill(const QStringList& arguments, AppConfig& config, const QString& cacheFilePath) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Distills fixed-budget MCTS on sampled positions into an instant per-map pick policy.");
+    QCommandLineOption positionsOpt("positions", "Sampled positions per map.", "n", "200");
+    QCommandLineOption itersOpt("iterations", "MCTS iterations per position.", "n", "1500");
+    QCommandLineOption epochsOpt("epochs", "Gradient steps per map.", "n", "300");
+    QCommandLineOption seedOpt("seed", "Sampling seed.", "n", "1");
+    QCommandLineOption modeOpt("mode", "Only distill maps of this mode.", "mode");
+    QCommandLineOption outOpt("out", "Output file (default: policy.table next to the pack).", "file");
+    QCommandLineOption packOpt("pack", "Stats pack to read.", "file", cacheFilePath);
+    parser.addOptions({positionsOpt, itersOpt, epochsOpt, seedOpt, modeOpt, outOpt, packOpt});
+    if (!parseOptions(parser, arguments)) return 1;
+
+    DistillSettings settings;
+    settings.positionsPerMap = parser.value(positionsOpt).toInt();
+    settings.mctsIterations = parser.value(itersOpt).toInt();
+    settings.epochs = parser.value(epochsOpt).toInt();
+    settings.seed = parser.value(seedOpt).toUInt();
+    settings.modeFilter = parser.value(modeOpt);
+    if (settings.positionsPerMap <= 0 || settings.mctsIterations <= 0 || settings.epochs <= 0) {
+        err() << "--positions, --iterations and --epochs must be positive." << Qt::endl;
+        return 1;
+    }
+
+    LoadedPack pack;
+    QString packPath = parser.value(packOpt);
+    if (!loadPack(packPath, config, pack)) return 1;
+    QString outPath = parser.isSet(outOpt) ? parser.value(outOpt)
+                                           : QFileInfo(packPath).dir().filePath(POLICY_FILE_NAME);
+
+    MCTSManager mctsManager(*pack.stats, config); // Teacher: heuristic rollouts, never the old table
+    PolicyTable table = PolicyTable::distill(*pack.stats, pack.data.allBrawlers, pack.data.discoveredMapModes,
+                                             mctsManager, config.heuristicWeights(), config.evalWeights(), settings);
+
+    QStringList keys = table.modelKeys();
+    keys.sort();
+    out() << QString("%1 | %2 | %3 | %4").arg("Map|Mode", -40).arg("Positions", 9).arg("Loss", 7).arg("Top-1 agree") << Qt::endl;
+    out() << QString("-").repeated(76) << Qt::endl;
+    for (const QString& key : keys) {
+        const PolicyMapModel* m = table.model(key.section('|', 0, 0), key.section('|', 1));
+        out() << QString("%1 | %2 | %3 | %4%").arg(key, -40).arg(m->positions, 9)
+                     .arg(m->crossEntropy, 7, 'f', 3).arg(m->top1Agreement * 100.0, 0, 'f', 1) << Qt::endl;
+    }
+
+    if (!table.save(outPath)) {
+        err() << "Failed to write " << outPath << Qt::endl;
+        return 1;
+    }
+    out() << "Wrote " << keys.size() << " map models to " << outPath << Qt::endl;
+    return 0;
+}
+
+int runTune(const QStringList& arguments, AppConfig& config, const QString& cacheFilePath) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Fits the win model weights and slope to real games by minimizing log-loss,\n"
+                                     "then writes them to the [EvalWeights] group of draft_config.ini.");
+    QCommandLineOption dataOpt("data", "Games file (default: high_level_ranked_games.jsonl next to the pack).", "file");
+    QCommandLineOption valOpt("validation", "Held-out share of games.", "fraction", "0.2");
+    QCommandLineOption seedOpt("seed", "Train/validation split seed.", "n", "1");
+    QCommandLineOption itersOpt("iterations", "Maximum Newton steps.", "n", "25");
+    QCommandLineOption dryRunOpt("dry-run", "Report only, do not update the config.");
+    QCommandLineOption sampleOpt("sample", "Fit on a stratified sample of this share of each map/mode's games.",
+                                 "fraction", "1");
+    QCommandLineOption packOpt("pack", "Stats pack whose directory holds the games file.", "file", cacheFilePath);
+    parser.addOptions({dataOpt, valOpt, seedOpt, itersOpt, dryRunOpt, sampleOpt, packOpt});
+    if (!parseOptions(parser, arguments)) return 1;
+
+    TuneSettings settings;
+    settings.validationFraction = parser.value(valOpt).toDouble();
+    settings.seed = parser.value(seedOpt).toUInt();
+    settings.maxIterations = parser.value(itersOpt).toInt();
+    QString dataPath = parser.isSet(dataOpt) ? parser.value(dataOpt)
+                                             : QFileInfo(parser.value(packOpt)).dir().filePath(DATA_FILE_NAME);
+
+    DataLoader loader(dataPath, config);
+    try {
+        loader.setSampleFraction(parser.value(sampleOpt).toDouble(), settings.seed);
+    } catch (const std::exception& e) {
+        err() << e.what() << Qt::endl;
+        return 1;
+    }
+    if (!loader.loadAndProcess()) {
+        err() << "Failed to load games from " << dataPath << Qt::endl;
+        return 1;
+    }
+    GameTable table(loader.getProcessedGames());
+
+    WeightTuner tuner(table, config);
+    TuneReport report;
+    try {
+        report = tuner.run(config.evalWeights(), settings);
+    } catch (const std::exception& e) {
+        err() << e.what() << Qt::endl;
+        return 1;
+    }
+
+    auto weightsText = [](const EvalWeights& w) {
+        return QString("WR %1  SYN %2  CTR %3  PEAK %4  slope %5")
+            .arg(w.winRate, 0, 'f', 3).arg(w.synergy, 0, 'f', 3).arg(w.counter, 0, 'f', 3)
+            .arg(w.peakCounter, 0, 'f', 3).arg(w.slope, 0, 'f', 3);
+    };
+    auto metricsRow = [](const QString& label, const TuneMetrics& train, const TuneMetrics& validation) {
+        return QString("%1 | %2 | %3 | %4 | %5").arg(label, -9)
+            .arg(train.logLoss, 10, 'f', 5).arg(train.accuracy * 100.0, 9, 'f', 2)
+            .arg(validation.logLoss, 10, 'f', 5).arg(validation.accuracy * 100.0, 9, 'f', 2);
+    };
+
+    out() << QString("Games: %1 train, %2 validation").arg(report.trainGames).arg(report.validationGames) << Qt::endl;
+    out() << "Baseline: " << weightsText(report.baseline) << Qt::endl;
+    out() << "Fitted:   " << weightsText(report.fitted) << Qt::endl << Qt::endl;
+    out() << QString("%1 | %2 | %3 | %4 | %5").arg("", -9).arg("Train loss", 10).arg("Train acc", 9)
+                 .arg("Val loss", 10).arg("Val acc", 9) << Qt::endl;
+    out() << QString("-").repeated(58) << Qt::endl;
+    out() << metricsRow("Baseline", report.trainBaseline, report.validationBaseline) << Qt::endl;
+    out() << metricsRow("Fitted", report.trainFitted, report.validationFitted) << Qt::endl << Qt::endl;
+    out() << QString("%1 Newton steps%2. Stats %3 ms, features %4 ms, fit %5 ms, total %6 ms")
+                 .arg(report.iterations).arg(report.converged ? " (converged)" : "")
+                 .arg(report.statsMs).arg(report.featuresMs).arg(report.fitMs).arg(report.elapsedMs) << Qt::endl;
+
+    if (parser.isSet(dryRunOpt)) return 0;
+    if (report.validationFitted.logLoss > report.validationBaseline.logLoss) {
+        out() << "Fitted weights do not improve validation log-loss; config left unchanged." << Qt::endl;
+        return 0;
+    }
+    config.setEvalWeights(report.fitted);
+    config.save();
+    out() << "Saved fitted weights to [EvalWeights] in the config file." << Qt::endl;
+    return 0;
+}
+
+int runSearch(const QStringList& arguments, AppConfig& config, const QString& cacheFilePath) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Timed MCTS from a draft position, in-process threads or worker processes.\n"
+                                     "Prints the best moves and iterations per second, for comparing the two modes.");
+    QCommandLineOption mapOpt("map", "Map name.", "map");
+    QCommandLineOption modeOpt("mode", "Mode name.", "mode");
+    QCommandLineOption team1Opt("team1", "Team 1 picks so far, comma-separated.", "names");
+    QCommandLineOption team2Opt("team2", "Team 2 picks so far, comma-separated.", "names");
+    QCommandLineOption banOpt("ban", "Banned brawlers, comma-separated.", "names");
+    QCommandLineOption secondsOpt("seconds", "Search time.", "s", QString::number(config.mctsTimeLimit()));
+    QCommandLineOption processesOpt("processes", "Worker processes over a shared-memory tree (0 = threads).", "n",
+                                    QString::number(config.mctsWorkerProcesses()));
+    QCommandLineOption topOpt("top", "Moves listed.", "k", "10");
+    QCommandLineOption resumeOpt("resume", "Continue from (and save to) the position's tree snapshot next to the pack.");
+    QCommandLineOption noPruneOpt("no-prune", "Branch over every legal move below the root, not just the active roster.");
+    QCommandLineOption team1PlayersOpt("team1-players", "Team 1 player tags: its picks come from their pools.", "tags");
+    QCommandLineOption team2PlayersOpt("team2-players", "Team 2 player tags: its picks come from their pools.", "tags");
+    QCommandLineOption minGamesOpt("min-games", "Games a player needs on a brawler for it to be in their pool.", "n", "1");
+    QCommandLineOption clustersOpt("clusters", "Two-level selection over k brawler clusters per map (0 = off; threads only).",
+                                   "k", QString::number(config.mctsClusterSelection() ? config.mctsClusterCount() : 0));
+    QCommandLineOption packOpt("pack", "Stats pack to read.", "file", cacheFilePath);
+    parser.addOptions({mapOpt, modeOpt, team1Opt, team2Opt, banOpt, secondsOpt, processesOpt, topOpt, resumeOpt,
+                       noPruneOpt, team1PlayersOpt, team2PlayersOpt, minGamesOpt, clustersOpt, packOpt});
+    if (!parseOptions(parser, arguments)) return 1;
+
+    QString mapName = parser.value(mapOpt);
+    QString modeName = parser.value(modeOpt);
+    QVector<QString> team1 = parseTeam(parser.value(team1Opt));
+    QVector<QString> team2 = parseTeam(parser.value(team2Opt));
+    QVector<QString> bans = parseTeam(parser.value(banOpt));
+    double seconds = parser.value(secondsOpt).toDouble();
+    int processes = parser.value(processesOpt).toInt();
+    int topK = parser.value(topOpt).toInt();
+    int clusterCount = parser.value(clustersOpt).toInt();
+    if (seconds <= 0.0 || processes < 0 || topK <= 0 || clusterCount < 0 || clusterCount == 1) {
+        err() << "--seconds and --top must be positive, --processes non-negative, --clusters 0 or at least 2." << Qt::endl;
+        return 1;
+    }
+    if (team1.size() > 3 || team2.size() > 3 || team1.size() < team2.size() || team1.size() > team2.size() + 1) {
+        err() << "--team1/--team2 must be a reachable draft position (team 1 picks first)." << Qt::endl;
+        return 1;
+    }
+
+    LoadedPack pack;
+    QString packPath = parser.value(packOpt);
+    if (!loadPack(packPath, config, pack)) return 1;
+    if (!validateMapMode(mapName, modeName, pack.data)) return 1;
+    if (!validateNames(team1, pack.data.names) || !validateNames(team2, pack.data.names) ||
+        !validateNames(bans, pack.data.names)) {
+        return 1;
+    }
+
+    int picks = team1.size() + team2.size();
+    DraftState rootState(mapName, modeName, pack.data.allBrawlers, QSet<QString>(bans.begin(), bans.end()),
+                         team1, team2, team1.size() == team2.size() ? "team1" : "team2", picks + 1);
+    if (parser.isSet(team1PlayersOpt) || parser.isSet(team2PlayersOpt)) {
+        std::optional<PlayerIndex> players = PlayerIndex::load(QFileInfo(packPath).dir().filePath(PLAYER_INDEX_FILE_NAME));
+        if (!players.has_value()) {
+            err() << "No player index next to the pack; run 'players --build' first." << Qt::endl;
+            return 1;
+        }
+        QStringList team1Tags = QStringList::fromVector(parseTeam(parser.value(team1PlayersOpt)));
+        QStringList team2Tags = QStringList::fromVector(parseTeam(parser.value(team2PlayersOpt)));
+        for (const QString& tag : team1Tags + team2Tags) {
+            if (!players->contains(tag)) err() << "Unknown player tag (no pool): " << tag << Qt::endl;
+        }
+        std::shared_ptr<const TeamPools> pools = players->teamPools(team1Tags, team2Tags, parser.value(minGamesOpt).toInt());
+        rootState = rootState.withTeamPools(pools);
+        out() << QString("Pools: team 1 %1 brawlers, team 2 %2 (0 = unrestricted)")
+                     .arg(pools->team1.size()).arg(pools->team2.size()) << Qt::endl;
+    }
+
+    config.setMctsTimeLimit(seconds); // Not saved
+    MCTSManager mctsManager(*pack.stats, config);
+    mctsManager.setWorkerProcesses(processes, packPath);
+    mctsManager.setActiveRosterPruning(!parser.isSet(noPruneOpt));
+    if (clusterCount > 0) {
+        mctsManager.setMoveClusters(MoveClusters::build(*pack.stats, pack.data.allBrawlers, pack.data.discoveredMapModes,
+                                                        clusterCount));
+    }
+    if (parser.isSet(resumeOpt)) {
+        mctsManager.setSnapshotDirectory(QFileInfo(packPath).dir().filePath(SNAPSHOT_DIR_NAME));
+    }
+
+    QVector<MCTSResult> results;
+    QEventLoop loop;
+    QObject::connect(&mctsManager, &MCTSManager::mctsFinalResult, &loop,
+                     [&results](const QVector<MCTSResult>& r) { results = r; }, Qt::DirectConnection);
+    QObject::connect(&mctsManager, &MCTSManager::mctsError, &loop,
+                     [](const QString& message) { err() << message << Qt::endl; }, Qt::DirectConnection);
+    QObject::connect(&mctsManager, &MCTSManager::mctsFinished, &loop, &QEventLoop::quit, Qt::QueuedConnection);
+    QElapsedTimer timer;
+    timer.start();
+    mctsManager.startMcts(rootState, config.heuristicWeights());
+    if (mctsManager.isRunning()) loop.exec();
+    qint64 elapsedMs = std::max<qint64>(1, timer.elapsed());
+
+    out() << rootState.toString() << Qt::endl;
+    out() << QString("%1 | %2 | %3").arg("Move", -20).arg("Visits", 9).arg("Win %") << Qt::endl;
+    out() << QString("-").repeated(42) << Qt::endl;
+    for (const MCTSResult& result : results.mid(0, topK)) {
+        out() << QString("%1 | %2 | %3").arg(result.move, -20).arg(result.visits, 9)
+                     .arg(result.winRate * 100.0, 0, 'f', 2) << Qt::endl;
+    }
+    long long iterations = mctsManager.iterationsDone();
+    out() << QString("%1 iterations in %2 ms (%3 /s) using %4")
+                 .arg(iterations).arg(elapsedMs).arg(iterations * 1000.0 / elapsedMs, 0, 'f', 0)
+                 .arg(processes > 0 ? QString("%1 worker processes").arg(processes)
+                                    : QString("%1 threads").arg(QThread::idealThreadCount()))
+          << Qt::endl;
+    std::shared_ptr<const QSet<QString>> activeRoster = mctsManager.activeRosterFor(rootState);
+    int legalMoves = rootState.getLegalMoves().size();
+    out() << QString("Branching: %1 moves at the root, %2 below it (%3)")
+                 .arg(legalMoves).arg(rootState.getLegalMoves(activeRoster.get()).size())
+                 .arg(activeRoster ? QString("active roster of %1").arg(activeRoster->size()) : QString("no pruning"))
+          << Qt::endl;
+    std::shared_ptr<const MCTSSearchSpace> space = mctsManager.searchSpaceFor(rootState);
+    if (space && space->clusters && processes == 0) {
+        out() << QString("Selection: two-level over %1 clusters").arg(space->clusters->clusters.size()) << Qt::endl;
+    }
+    return results.isEmpty() ? 1 : 0;
+}
+
+int runCompact(const QStringList& arguments, AppConfig& config, const QString& cacheFilePath) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Writes a compact stats pack (uint16 fixed-point scores, sparse pairs) and\n"
+                                     "measures its error against the full double-precision pack.\n"
+                                     "Any command reads it via --pack; the GUI uses it as stats.pack.");
+    QCommandLineOption packOpt("pack", "Full stats pack to compact.", "file", cacheFilePath);
+    QCommandLineOption outOpt("out", "Output file (default: stats.compact next to the pack).", "file");
+    QCommandLineOption thresholdOpt("threshold", "Drop synergy/counter pairs with fewer weighted plays.", "plays",
+                                    QString::number(config.compactPlaysThreshold()));
+    QCommandLineOption draftsOpt("drafts", "Random drafts for the win probability error.", "n", "20000");
+    QCommandLineOption seedOpt("seed", "Draft sampling seed.", "n", "1");
+    parser.addOptions({packOpt, outOpt, thresholdOpt, draftsOpt, seedOpt});
+    if (!parseOptions(parser, arguments)) return 1;
+
+    QString packPath = parser.value(packOpt);
+    QString outPath = parser.isSet(outOpt) ? parser.value(outOpt)
+                                           : QFileInfo(packPath).dir().filePath(COMPACT_FILE_NAME);
+    LoadedPack pack;
+    if (!loadPack(packPath, config, pack, false)) return 1;
+
+    std::shared_ptr<const CompactStats> compact;
+    try {
+        compact = CompactStats::build(*pack.stats, pack.data, config, parser.value(thresholdOpt).toDouble());
+    } catch (const std::exception& e) {
+        err() << e.what() << Qt::endl;
+        return 1;
+    }
+    if (!compact->save(outPath)) return 1;
+
+    StatsCalculator compactStats(config);
+    compactStats.setCompactStats(compact);
+    CompactErrorReport report = measureCompactError(*pack.stats, compactStats, pack.data, config.evalWeights(),
+                                                    parser.value(draftsOpt).toInt(), parser.value(seedOpt).toUInt());
+
+    qint64 fullBytes = QFileInfo(packPath).size();
+    qint64 compactBytes = QFileInfo(outPath).size();
+    int tables = 0;
+    for (const auto& modes : pack.data.stats) tables += modes.size();
+    out() << QString("Wrote %1").arg(outPath) << Qt::endl;
+    out() << QString("Pack size: %1 KB -> %2 KB (%3x smaller)")
+                 .arg(fullBytes / 1024).arg(compactBytes / 1024)
+                 .arg(compactBytes > 0 ? double(fullBytes) / compactBytes : 0.0, 0, 'f', 1) << Qt::endl;
+    out() << QString("Pairs: %1 kept, %2 dropped below %3 weighted plays")
+                 .arg(compact->pairsKept()).arg(compact->pairsDropped()).arg(compact->playsThreshold()) << Qt::endl;
+    out() << QString("In-memory tables: %1 KB total, %2 KB per map/mode (%3 brawlers)")
+                 .arg(compact->tableBytes() / 1024)
+                 .arg(tables > 0 ? compact->tableBytes() / tables / 1024 : 0).arg(compact->roster().size()) << Qt::endl << Qt::endl;
+    out() << QString("Max abs error vs double path (quantization bound %1):").arg(CompactFixed::MAX_ERROR, 0, 'g', 3) << Qt::endl;
+    out() << QString("  win rate  %1").arg(report.maxWinRateError, 0, 'g', 3) << Qt::endl;
+    out() << QString("  pick rate %1").arg(report.maxPickRateError, 0, 'g', 3) << Qt::endl;
+    out() << QString("  synergy   %1 (includes pruning)").arg(report.maxSynergyError, 0, 'g', 3) << Qt::endl;
+    out() << QString("  counter   %1 (includes pruning)").arg(report.maxCounterError, 0, 'g', 3) << Qt::endl;
+    out() << QString("Win probability over %1 random drafts: mean %2, max %3")
+                 .arg(report.draftsSampled).arg(report.meanWinProbError, 0, 'g', 3)
+                 .arg(report.maxWinProbError, 0, 'g', 3) << Qt::endl;
+    return 0;
+}
+
+int runPlayers(const QStringList& arguments, AppConfig& config, const QString& cacheFilePath) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Builds the per-player index (tag -> brawlers played, games, wins) from the games\n"
+                                     "file, or prints players' pools. 'search --team1-players/--team2-players' uses it.");
+    QCommandLineOption buildOpt("build", "Rebuild players.index from the games file.");
+    QCommandLineOption dataOpt("data", "Games file (default: high_level_ranked_games.jsonl next to the pack).", "file");
+    QCommandLineOption tagOpt("tag", "Player tags to print, comma-separated.", "tags");
+    QCommandLineOption minGamesOpt("min-games", "Only list brawlers with at least this many games.", "n", "1");
+    QCommandLineOption packOpt("pack", "Stats pack whose directory holds the index.", "file", cacheFilePath);
+    parser.addOptions({buildOpt, dataOpt, tagOpt, minGamesOpt, packOpt});
+    if (!parseOptions(parser, arguments)) return 1;
+    if (!parser.isSet(buildOpt) && !parser.isSet(tagOpt)) {
+        err() << "Pass --build and/or --tag." << Qt::endl;
+        return 1;
+    }
+
+    QDir packDir = QFileInfo(parser.value(packOpt)).dir();
+    QString indexPath = packDir.filePath(PLAYER_INDEX_FILE_NAME);
+    std::optional<PlayerIndex> players;
+    if (parser.isSet(buildOpt)) {
+        QString dataPath = parser.isSet(dataOpt) ? parser.value(dataOpt) : packDir.filePath(DATA_FILE_NAME);
+        DataLoader loader(dataPath, config);
+        loader.setBuildPlayerIndex(true);
+        if (!loader.loadAndProcess()) {
+            err() << "Failed to load games from " << dataPath << Qt::endl;
+            return 1;
+        }
+        players = loader.getPlayerIndex();
+        if (!players->save(indexPath)) return 1;
+        out() << QString("%1 players, %2 KB -> %3").arg(players->playerCount()).arg(players->byteSize() / 1024)
+                     .arg(indexPath) << Qt::endl;
+    } else {
+        players = PlayerIndex::load(indexPath);
+        if (!players.has_value()) {
+            err() << "No player index at " << indexPath << "; run with --build first." << Qt::endl;
+            return 1;
+        }
+    }
+
+    int minGames = parser.value(minGamesOpt).toInt();
+    for (const QString& tag : parseTeam(parser.value(tagOpt))) {
+        if (!players->contains(tag)) {
+            err() << "Unknown player tag: " << tag << Qt::endl;
+            continue;
+        }
+        out() << Qt::endl << tag << Qt::endl;
+        out() << QString("%1 | %2 | %3").arg("Brawler", -20).arg("Games", 7).arg("Win %") << Qt::endl;
+        out() << QString("-").repeated(40) << Qt::endl;
+        for (const PlayerBrawlerStats& played : players->brawlersOf(tag)) {
+            if (played.games < quint32(std::max(1, minGames))) continue;
+            out() << QString("%1 | %2 | %3").arg(played.brawler, -20).arg(played.games, 7)
+                         .arg(played.winRate() * 100.0, 0, 'f', 1) << Qt::endl;
+        }
+    }
+    return 0;
+}
+
+int runBuildPack(const QStringList& arguments, AppConfig& config, const QString& cacheFilePath) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Builds a stats pack from the games file. With --sample, only a stratified random\n"
+                                     "share of each map/mode's games is parsed; counts are scaled up, every cell gets a\n"
+                                     "standard error, and the pack is marked approximate. Exact packs get their cells'\n"
+                                     "standard errors from Poisson bootstrap replicas of the games. With --shards, the\n"
+                                     "pack is summed from cached per-shard counts, and only new or changed shards are read.");
+    QCommandLineOption dataOpt("data", "Games file (default: high_level_ranked_games.jsonl next to the pack).", "file");
+    QCommandLineOption sampleOpt("sample", "Share of each map/mode's games to use (1 = all, exact).", "fraction", "1");
+    QCommandLineOption groupsOpt("groups", "Random groups for the error estimates.", "n", "10");
+    QCommandLineOption replicasOpt("replicas", "Bootstrap replicas for an exact pack's errors (0 = none).", "n",
+                                   QString::number(config.bootstrapReplicas()));
+    QCommandLineOption seedOpt("seed", "Sampling and bootstrap seed.", "n", "1");
+    QCommandLineOption compareOpt("compare", "Exact pack to check the sampled estimates and errors against.", "file");
+    QCommandLineOption packOpt("pack", "Stats pack whose directory holds the games file.", "file", cacheFilePath);
+    QCommandLineOption outOpt("out", "Output file (default: the pack, or stats.sample.pack next to it when sampling).", "file");
+    QCommandLineOption shardsOpt("shards", "Directory of JSONL shards (*.jsonl) to build from instead of the games file.", "dir");
+    QCommandLineOption partialsOpt("partials", "Per-shard count cache (default: pack_partials next to the pack).", "dir");
+    parser.addOptions({dataOpt, sampleOpt, groupsOpt, replicasOpt, seedOpt, compareOpt, packOpt, outOpt, shardsOpt, partialsOpt});
+    if (!parseOptions(parser, arguments)) return 1;
+
+    QDir packDir = QFileInfo(parser.value(packOpt)).dir();
+    if (parser.isSet(shardsOpt)) {
+        if (parser.isSet(sampleOpt) || parser.isSet(dataOpt)) {
+            err() << "--shards cannot be combined with --sample or --data." << Qt::endl;
+            return 1;
+        }
+        QDir shardDir(parser.value(shardsOpt));
+        QStringList shards;
+        for (const QString& name : shardDir.entryList({"*.jsonl"}, QDir::Files, QDir::Name)) shards.append(shardDir.filePath(name));
+        QString outPath = parser.isSet(outOpt) ? parser.value(outOpt) : parser.value(packOpt);
+        QString partialsDir = parser.isSet(partialsOpt) ? parser.value(partialsOpt) : packDir.filePath(PARTIALS_DIR_NAME);
+
+        QElapsedTimer timer;
+        timer.start();
+        ShardBuildReport report;
+        CacheData data;
+        try {
+            data = ShardPartials::buildPack(shards, partialsDir, config, &report);
+        } catch (const std::exception& e) {
+            err() << e.what() << Qt::endl;
+            return 1;
+        }
+        if (!CacheUtils::saveCache(outPath, data)) return 1;
+        out() << QString("Wrote %1 from %2 games in %3 shards in %4 ms").arg(outPath).arg(report.games)
+                     .arg(report.shards).arg(timer.elapsed()) << Qt::endl;
+        out() << QString("Shards: %1 read, %2 cached; %3 (%4 partials added, %5 subtracted)")
+                     .arg(report.parsed).arg(report.reused)
+                     .arg(report.incremental ? "updated the last build" : "summed every partial")
+                     .arg(report.added).arg(report.subtracted) << Qt::endl;
+        return 0;
+    }
+    QString dataPath = parser.isSet(dataOpt) ? parser.value(dataOpt) : packDir.filePath(DATA_FILE_NAME);
+    double fraction = parser.value(sampleOpt).toDouble();
+    bool sampling = fraction < 1.0;
+    QString outPath = parser.isSet(outOpt) ? parser.value(outOpt)
+                                           : (sampling ? packDir.filePath(SAMPLE_PACK_FILE_NAME) : parser.value(packOpt));
+    quint32 seed = parser.value(seedOpt).toUInt();
+
+    QElapsedTimer timer;
+    timer.start();
+    DataLoader loader(dataPath, config);
+    CacheData data;
+    try {
+        loader.setSampleFraction(fraction, seed);
+        if (!loader.loadAndProcess()) {
+            err() << "Failed to load games from " << dataPath << Qt::endl;
+            return 1;
+        }
+        data = sampling ? SampledStats::buildPack(loader.getProcessedGames(), loader.getStrata(), config, seed,
+                                                  parser.value(groupsOpt).toInt())
+                        : StatsCalculator(loader.getProcessedGames(), config).getStatsForCache();
+        const int replicas = parser.value(replicasOpt).toInt();
+        if (!sampling && replicas > 0) {
+            data.errors = Bootstrap::cellErrors(GameTable(loader.getProcessedGames()), config, replicas, seed);
+        }
+    } catch (const std::exception& e) {
+        err() << e.what() << Qt::endl;
+        return 1;
+    }
+    data.allBrawlers = loader.getAllBrawlers();
+    data.discoveredMapModes = loader.getDiscoveredMapModes();
+    if (!CacheUtils::saveCache(outPath, data)) return 1;
+
+    out() << QString("Wrote %1 from %2 games in %3 ms").arg(outPath).arg(loader.getProcessedGames().size())
+                 .arg(timer.elapsed()) << Qt::endl;
+    if (data.errors.isEmpty()) return 0;
+
+    QVector<double> errors;
+    for (const auto& modes : data.errors) {
+        for (const MapModeErrorData& cells : modes) {
+            for (float error : cells.brawlerStats) errors.append(error);
+        }
+    }
+    std::sort(errors.begin(), errors.end());
+    auto percentile = [&errors](double p) { return errors.isEmpty() ? 0.0 : errors[int(p * (errors.size() - 1))]; };
+    const QString errorSource = sampling ? QString("Sampled %1% of lines").arg(data.metadata.sampleFraction * 100.0, 0, 'f', 1)
+                                         : QString("%1 bootstrap replicas").arg(parser.value(replicasOpt));
+    out() << QString("%1; brawler win rate standard error: median %2 pp, 90th pct %3 pp").arg(errorSource)
+                 .arg(percentile(0.5) * 100.0, 0, 'f', 2).arg(percentile(0.9) * 100.0, 0, 'f', 2) << Qt::endl;
+    if (!sampling) return 0;
+
+    if (parser.isSet(compareOpt)) {
+        std::optional<CacheData> exact = CacheUtils::loadCache(parser.value(compareOpt));
+        if (!exact.has_value()) {
+            err() << "Failed to load stats pack: " << parser.value(compareOpt) << Qt::endl;
+            return 1;
+        }
+        // Raw win rates: how far off the sample is, and how often the exact value lies within 2 SE
+        int cells = 0, covered = 0;
+        double absError = 0.0;
+        for (auto mapIt = data.stats.constBegin(); mapIt != data.stats.constEnd(); ++mapIt) {
+            for (auto modeIt = mapIt.value().constBegin(); modeIt != mapIt.value().constEnd(); ++modeIt) {
+                const MapModeErrorData errorCells = data.errors.value(mapIt.key()).value(modeIt.key());
+                const MapModeStatsData exactCells = exact->stats.value(mapIt.key()).value(modeIt.key());
+                for (auto cellIt = modeIt.value().brawlerStats.constBegin(); cellIt != modeIt.value().brawlerStats.constEnd(); ++cellIt) {
+                    auto errorIt = errorCells.brawlerStats.constFind(cellIt.key());
+                    auto exactIt = exactCells.brawlerStats.constFind(cellIt.key());
+                    if (errorIt == errorCells.brawlerStats.constEnd() || exactIt == exactCells.brawlerStats.constEnd() ||
+                        cellIt.value().plays <= 0.0 || exactIt.value().plays <= 0.0) continue;
+                    double diff = std::abs(cellIt.value().wins / cellIt.value().plays - exactIt.value().wins / exactIt.value().plays);
+                    absError += diff;
+                    if (diff <= 2.0 * errorIt.value()) covered++;
+                    cells++;
+                }
+            }
+        }
+        out() << QString("Against %1: mean |win rate error| %2 pp over %3 brawler cells, %4% within 2 SE")
+                     .arg(parser.value(compareOpt)).arg(cells > 0 ? absError / cells * 100.0 : 0.0, 0, 'f', 2)
+                     .arg(cells).arg(cells > 0 ? 100.0 * covered / cells : 0.0, 0, 'f', 1) << Qt::endl;
+    }
+    return 0;
+}
+
+int runMergePacks(const QStringList& arguments, AppConfig& config, const QString& cacheFilePath) {
+    Q_UNUSED(config);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Sums stats packs built from separate games (days, regions, machines) into one\n"
+                                     "pack, without the raw games. Map/mode sections are merged in parallel; rosters and\n"
+                                     "maps are unioned and the source packs are recorded in the result.");
+    parser.addPositionalArgument("packs", "Stats packs to merge (at least 2).", "<pack> <pack> [...]");
+    QCommandLineOption outOpt("out", "Output file (default: merged.pack next to the default pack).", "file");
+    parser.addOptions({outOpt});
+    if (!parseOptions(parser, arguments)) return 1;
+
+    const QStringList paths = parser.positionalArguments();
+    if (paths.size() < 2) {
+        err() << "Pass at least 2 packs to merge." << Qt::endl;
+        return 1;
+    }
+    for (const QString& path : paths) {
+        if (CompactStats::isCompactFile(path)) {
+            err() << "Compact packs are quantized and pruned and cannot be merged: " << path << Qt::endl;
+            return 1;
+        }
+    }
+    QString outPath = parser.isSet(outOpt) ? parser.value(outOpt)
+                                           : QFileInfo(cacheFilePath).dir().filePath(MERGED_PACK_FILE_NAME);
+
+    QElapsedTimer timer;
+    timer.start();
+    QList<std::optional<CacheData>> loaded = TaskExecutor::instance().mapped(paths, [](const QString& path) {
+        return CacheUtils::loadCache(path);
+    }, TaskPriority::Batch);
+    QVector<CacheData> packs;
+    QStringList names;
+    for (int i = 0; i < paths.size(); ++i) {
+        if (!loaded[i].has_value()) {
+            err() << "Failed to load stats pack: " << paths[i] << Qt::endl;
+            return 1;
+        }
+        packs.append(std::move(*loaded[i]));
+        names.append(QFileInfo(paths[i]).fileName());
+    }
+    const qint64 loadMs = timer.restart();
+
+    CacheData merged;
+    try {
+        merged = PackMerge::merge(packs, names);
+    } catch (const std::exception& e) {
+        err() << e.what() << Qt::endl;
+        return 1;
+    }
+    const qint64 mergeMs = timer.restart();
+    if (!CacheUtils::saveCache(outPath, merged)) return 1;
+
+    int sections = 0;
+    for (const auto& modes : merged.stats) sections += modes.size();
+    out() << QString("Wrote %1: %2 packs, %3 map/modes, %4 brawlers (load %5 ms, merge %6 ms, save %7 ms)")
+                 .arg(outPath).arg(packs.size()).arg(sections).arg(merged.allBrawlers.size())
+                 .arg(loadMs).arg(mergeMs).arg(timer.elapsed()) << Qt::endl;
+    out() << QString("Sources (%1):").arg(merged.metadata.mergedFrom.size()) << Qt::endl;
+    for (const PackSource& source : merged.metadata.mergedFrom) {
+        out() << QString("  %1, created %2%3").arg(source.name)
+                     .arg(QDateTime::fromMSecsSinceEpoch(source.cacheCreationTime).toString(Qt::ISODate))
+                     .arg(source.sampleFraction < 1.0 ? QString(", sampled %1%").arg(source.sampleFraction * 100.0, 0, 'f', 1)
+                                                      : QString()) << Qt::endl;
+    }
+    return 0;
+}
+
+int runBench(const QStringList& arguments, AppConfig& config, const QString& cacheFilePath) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Decision quality of MCTS against time and threads on a fixed corpus of positions.\n"
+                                     "References: exact enumeration when few picks are left, else one long search.\n"
+                                     "The corpus and references are cached as bench.corpus next to the pack.");
+    QCommandLineOption positionsOpt("positions", "Corpus positions (across maps and pick numbers).", "n", "40");
+    QCommandLineOption budgetsOpt("budgets", "Search times in seconds, comma-separated.", "list", "0.1,0.25,0.5,1");
+    QCommandLineOption threadsOpt("threads", "Thread counts, comma-separated.", "list",
+                                  QString("1,2,4,%1").arg(QThread::idealThreadCount()));
+    QCommandLineOption referenceOpt("reference-seconds", "Reference search time per non-exact position.", "s", "10");
+    QCommandLineOption exactOpt("exact-picks", "Enumerate positions with at most this many picks left exactly.", "n", "2");
+    QCommandLineOption seedOpt("seed", "Corpus seed.", "n", "1");
+    QCommandLineOption rebuildOpt("rebuild", "Sample and solve the corpus again even if it is cached.");
+    QCommandLineOption packOpt("pack", "Stats pack to read.", "file", cacheFilePath);
+    parser.addOptions({positionsOpt, budgetsOpt, threadsOpt, referenceOpt, exactOpt, seedOpt, rebuildOpt, packOpt});
+    if (!parseOptions(parser, arguments)) return 1;
+
+    BenchSettings settings;
+    settings.positions = parser.value(positionsOpt).toInt();
+    settings.referenceSeconds = parser.value(referenceOpt).toDouble();
+    settings.exactPicks = parser.value(exactOpt).toInt();
+    settings.seed = parser.value(seedOpt).toUInt();
+    settings.budgets.clear();
+    for (const QString& budget : parseTeam(parser.value(budgetsOpt))) settings.budgets.append(budget.toDouble());
+    settings.threads.clear();
+    for (const QString& threads : parseTeam(parser.value(threadsOpt))) {
+        int count = threads.toInt();
+        if (count > 0 && !settings.threads.contains(count)) settings.threads.append(count);
+    }
+
+    LoadedPack pack;
+    QString packPath = parser.value(packOpt);
+    if (!loadPack(packPath, config, pack)) return 1;
+
+    QString corpusPath = QFileInfo(packPath).dir().filePath(BENCH_CORPUS_FILE_NAME);
+    if (parser.isSet(rebuildOpt)) QFile::remove(corpusPath);
+    MCTSManager mctsManager(*pack.stats, config);
+    SearchBench bench(*pack.stats, pack.data.allBrawlers, pack.data.discoveredMapModes, config, mctsManager);
+    BenchReport report;
+    try {
+        QVector<BenchPosition> positions = bench.corpus(settings, corpusPath, pack.data.metadata.cacheCreationTime);
+        report = bench.run(positions, settings);
+    } catch (const std::exception& e) {
+        err() << e.what() << Qt::endl;
+        return 1;
+    }
+
+    out() << QString("Corpus: %1 positions (%2 exact, %3 against a %4 s search)")
+                 .arg(report.exactPositions + report.searchedPositions).arg(report.exactPositions)
+                 .arg(report.searchedPositions).arg(settings.referenceSeconds) << Qt::endl << Qt::endl;
+    out() << QString("%1 | %2 | %3 | %4 | %5 | %6").arg("Threads", 7).arg("Time s", 7).arg("Agree %", 8)
+                 .arg("Regret %", 8).arg("Max %", 7).arg("Iter/s", 10) << Qt::endl;
+    out() << QString("-").repeated(64) << Qt::endl;
+    for (const BenchCell& cell : report.cells) {
+        out() << QString("%1 | %2 | %3 | %4 | %5 | %6").arg(cell.threads, 7).arg(cell.seconds, 7, 'f', 2)
+                     .arg(cell.agreement * 100.0, 8, 'f', 1).arg(cell.meanRegret * 100.0, 8, 'f', 2)
+                     .arg(cell.maxRegret * 100.0, 7, 'f', 2).arg(cell.iterationsPerSecond, 10, 'f', 0) << Qt::endl;
+    }
+    out() << QString("Total: %1 ms").arg(report.elapsedMs) << Qt::endl;
+    return 0;
+}
+
+// Synthetic data options shared by 'synth' and 'scale' (the swept ones are lists in 'scale')
+struct SyntheticOptions {
+    QCommandLineOption modes{"modes", "Modes used, first N of the synthetic list (1-6 are 3v3, then 5v5 and 2v2).", "n", "6"};
+    QCommandLineOption spread{"spread", "Std dev of brawler strength in logits.", "x", "0.3"};
+    QCommandLineOption rankMean{"rank-mean", "Mean brawler rank.", "r", "18"};
+    QCommandLineOption rankSpread{"rank-spread", "Std dev of brawler rank.", "r", "5"};
+    QCommandLineOption players{"players", "Distinct player tags.", "n", "100000"};
+    QCommandLineOption seed{"seed", "Generator seed.", "n", "1"};
+
+    QList<QCommandLineOption> all() const { return {modes, spread, rankMean, rankSpread, players, seed}; }
+    SyntheticSettings read(const QCommandLineParser& parser) const {
+        SyntheticSettings settings;
+        settings.modes = parser.value(modes).toInt();
+        settings.strengthSpread = parser.value(spread).toDouble();
+        settings.rankMean = parser.value(rankMean).toDouble();
+        settings.rankSpread = parser.value(rankSpread).toDouble();
+        settings.players = parser.value(players).toInt();
+        settings.seed = parser.value(seed).toUInt();
+        return settings;
+    }
+};
+
+int runSynth(const QStringList& arguments, AppConfig& config, const QString& cacheFilePath) {
+    Q_UNUSED(cacheFilePath);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generates synthetic battles (JSONL, as the scraper writes them) and/or a stats pack\n"
+                                     "built straight from them, for testing at rosters, map counts and volumes beyond ours.");
+    SyntheticOptions synthetic;
+    QCommandLineOption brawlersOpt("brawlers", "Roster size.", "n", "90");
+    QCommandLineOption mapsOpt("maps", "Maps (spread over the modes).", "n", "40");
+    QCommandLineOption gamesOpt("games", "Battles.", "n", "100000");
+    QCommandLineOption skewOpt("skew", "Zipf exponent of pick popularity (0 = uniform).", "x", "1");
+    QCommandLineOption outOpt("out", "JSONL file to write.", "file");
+    QCommandLineOption packOutOpt("pack-out", "Stats pack to build directly (no JSONL; any game count).", "file");
+    parser.addOptions(synthetic.all());
+    parser.addOptions({brawlersOpt, mapsOpt, gamesOpt, skewOpt, outOpt, packOutOpt});
+    if (!parseOptions(parser, arguments)) return 1;
+    if (!parser.isSet(outOpt) && !parser.isSet(packOutOpt)) {
+        err() << "Give --out, --pack-out or both." << Qt::endl;
+        return 1;
+    }
+
+    SyntheticSettings settings = synthetic.read(parser);
+    settings.brawlers = parser.value(brawlersOpt).toInt();
+    settings.maps = parser.value(mapsOpt).toInt();
+    settings.games = parser.value(gamesOpt).toLongLong();
+    settings.skew = parser.value(skewOpt).toDouble();
+    QElapsedTimer timer;
+    timer.start();
+    try {
+        SyntheticGenerator generator(settings);
+        if (parser.isSet(outOpt)) {
+            qint64 bytes = generator.writeJsonl(parser.value(outOpt));
+            if (bytes < 0) return 1;
+            out() << QString("Wrote %1 games (%2 MB) to %3").arg(settings.games).arg(bytes / (1024 * 1024))
+                         .arg(parser.value(outOpt)) << Qt::endl;
+        }
+        if (parser.isSet(packOutOpt)) {
+            if (!CacheUtils::saveCache(parser.value(packOutOpt), generator.buildPack(config))) return 1;
+            out() << QString("Wrote %1 (%2 brawlers, %3 maps)").arg(parser.value(packOutOpt))
+                         .arg(settings.brawlers).arg(settings.maps) << Qt::endl;
+        }
+    } catch (const std::exception& e) {
+        err() << e.what() << Qt::endl;
+        return 1;
+    }
+    out() << QString("Done in %1 ms").arg(timer.elapsed()) << Qt::endl;
+    return 0;
+}
+
+int runScale(const QStringList& arguments, AppConfig& config, const QString& cacheFilePath) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs the whole pipeline on synthetic data for every combination of the lists and\n"
+                                     "reports time and memory (RSS after, peak during) per stage.");
+    SyntheticOptions synthetic;
+    QCommandLineOption brawlersOpt("brawlers", "Roster sizes, comma-separated.", "list", "90,300");
+    QCommandLineOption mapsOpt("maps", "Map counts, comma-separated.", "list", "40,1000");
+    QCommandLineOption gamesOpt("games", "Game counts, comma-separated.", "list", "100000,1000000");
+    QCommandLineOption skewOpt("skew", "Popularity skews, comma-separated.", "list", "1");
+    QCommandLineOption jsonlLimitOpt("jsonl-limit", "Above this many games, skip JSONL and aggregate while generating.",
+                                     "n", "2000000");
+    QCommandLineOption mctsOpt("iterations", "MCTS iterations per point.", "n", "2000");
+    QCommandLineOption workOpt("work-dir", "Directory for the generated files (default: scale_work next to the pack).", "dir");
+    parser.addOptions(synthetic.all());
+    parser.addOptions({brawlersOpt, mapsOpt, gamesOpt, skewOpt, jsonlLimitOpt, mctsOpt, workOpt});
+    if (!parseOptions(parser, arguments)) return 1;
+
+    ScaleSettings settings;
+    settings.base = synthetic.read(parser);
+    settings.brawlers.clear();
+    for (const QString& value : parseTeam(parser.value(brawlersOpt))) settings.brawlers.append(value.toInt());
+    settings.maps.clear();
+    for (const QString& value : parseTeam(parser.value(mapsOpt))) settings.maps.append(value.toInt());
+    settings.games.clear();
+    for (const QString& value : parseTeam(parser.value(gamesOpt))) settings.games.append(value.toLongLong());
+    settings.skews.clear();
+    for (const QString& value : parseTeam(parser.value(skewOpt))) settings.skews.append(value.toDouble());
+    settings.jsonlLimit = parser.value(jsonlLimitOpt).toLongLong();
+    settings.mctsIterations = parser.value(mctsOpt).toInt();
+    settings.workDirectory = parser.isSet(workOpt) ? parser.value(workOpt)
+                                                   : QFileInfo(cacheFilePath).dir().filePath("scale_work");
+
+    QVector<ScalePoint> points;
+    try {
+        points = ScaleBench(config).run(settings);
+    } catch (const std::exception& e) {
+        err() << e.what() << Qt::endl;
+        return 1;
+    }
+    QDir(settings.workDirectory).removeRecursively();
+
+    for (const ScalePoint& point : points) {
+        out() << QString("== %1 brawlers, %2 maps, %3 games, skew %4").arg(point.settings.brawlers)
+                     .arg(point.settings.maps).arg(point.settings.games).arg(point.settings.skew) << Qt::endl;
+        out() << QString("%1 | %2 | %3 | %4 | %5").arg("Stage", -18).arg("ms", 9).arg("RSS MB", 8)
+                     .arg("Peak MB", 8).arg("Detail") << Qt::endl;
+        for (const ScaleStage& stage : point.stages) {
+            out() << QString("%1 | %2 | %3 | %4 | %5").arg(stage.name, -18).arg(stage.elapsedMs, 9)
+                         .arg(stage.rssMb, 8, 'f', 0).arg(stage.peakMb, 8, 'f', 0).arg(stage.detail) << Qt::endl;
+        }
+        out() << Qt::endl;
+    }
+    return 0;
+}
+
+int runStats(const QStringList& arguments, AppConfig& config, const QString& cacheFilePath) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Loads the pack as the GUI does (policy table, move clusters) and prints the memory\n"
+                                     "held per subsystem against the MemoryCap* settings. With --map and --mode a timed\n"
+                                     "search runs first and the report is taken while its tree is alive.");
+    QCommandLineOption mapOpt("map", "Map to search from an empty draft.", "map");
+    QCommandLineOption modeOpt("mode", "Mode of --map.", "mode");
+    QCommandLineOption secondsOpt("seconds", "Search time.", "s", "2");
+    QCommandLineOption packOpt("pack", "Stats pack to read.", "file", cacheFilePath);
+    parser.addOptions({mapOpt, modeOpt, secondsOpt, packOpt});
+    if (!parseOptions(parser, arguments)) return 1;
+
+    LoadedPack pack;
+    QString packPath = parser.value(packOpt);
+    if (!loadPack(packPath, config, pack)) return 1;
+    pack.data.stats.clear(); // The GUI keeps only the calculator's tables
+
+    MCTSManager mctsManager(*pack.stats, config);
+    std::optional<PolicyTable> policyTable =
+        PolicyTable::load(QFileInfo(packPath).dir().filePath(POLICY_FILE_NAME), pack.stats->packVersion());
+    if (policyTable.has_value() && config.usePolicyRollouts()) mctsManager.setRolloutPolicy(&*policyTable);
+    if (config.mctsClusterSelection()) {
+        mctsManager.setMoveClusters(MoveClusters::build(*pack.stats, pack.data.allBrawlers, pack.data.discoveredMapModes,
+                                                        config.mctsClusterCount()));
+    }
+
+    QString report;
+    if (parser.isSet(mapOpt) || parser.isSet(modeOpt)) {
+        QString mapName = parser.value(mapOpt);
+        QString modeName = parser.value(modeOpt);
+        if (!validateMapMode(mapName, modeName, pack.data)) return 1;
+        double seconds = parser.value(secondsOpt).toDouble();
+        if (seconds <= 0.0) {
+            err() << "--seconds must be positive." << Qt::endl;
+            return 1;
+        }
+        DraftState rootState(mapName, modeName, pack.data.allBrawlers);
+        QVector<long long> iterations;
+        // The tree is freed when the search returns, so the report is taken at its last checkpoint
+        mctsManager.runTimed(rootState, config.heuristicWeights(), config.evalWeights(), {seconds},
+                             QThread::idealThreadCount(), 1, &iterations,
+                             [&report, &config](const QVector<MCTSResult>&, long long) {
+                                 report = MemoryLedger::report(config);
+                                 return true;
+                             });
+        out() << QString("After %1 iterations on %2 (%3):").arg(iterations.value(0)).arg(mapName, modeName) << Qt::endl;
+    }
+    if (report.isEmpty()) report = MemoryLedger::report(config);
+    out() << report << Qt::endl;
+    return 0;
+}
+
+// Hidden: started by SharedTreeSearch, never by hand
+int runMctsWorker(const QStringList& arguments, AppConfig& config, const QString& cacheFilePath) {
+    QCommandLineParser parser;
+    QCommandLineOption segmentOpt("segment", "Shared-memory segment name.", "name");
+    QCommandLineOption slotOpt("slot", "Worker slot.", "n");
+    QCommandLineOption packOpt("pack", "Stats pack to read.", "file", cacheFilePath);
+    parser.addOptions({segmentOpt, slotOpt, packOpt});
+    if (!parseOptions(parser, arguments)) return 1;
+
+    LoadedPack pack;
+    QString packPath = parser.value(packOpt);
+    if (!loadPack(packPath, config, pack)) return 1;
+
+    MCTSManager mctsManager(*pack.stats, config);
+    std::optional<PolicyTable> policyTable;
+    if (config.usePolicyRollouts()) {
+        policyTable = PolicyTable::load(QFileInfo(packPath).dir().filePath(POLICY_FILE_NAME), pack.stats->packVersion());
+        if (policyTable.has_value()) mctsManager.setRolloutPolicy(&*policyTable);
+    }
+    return SharedTreeSearch::runWorker(parser.value(segmentOpt), parser.value(slotOpt).toInt(), mctsManager, *pack.stats);
+}
+
+// --- Command table ---
+
+using CommandHandler = int (*)(const QStringList&, AppConfig&, const QString&);
+
+struct Command {
+    const char* name;
+    const char* description;
+    CommandHandler handler;
+};
+
+const Command COMMANDS[] = {
+    {"counter", "Best-response teams against a known enemy team", &runCounter},
+    {"sweep", "Tier lists / team strength / MCTS across every map", &runSweep},
+    {"arena", "Self-play match between two drafting policies", &runArena},
+    {"distill", "Build the instant pick policy table from offline MCTS", &runDistill},
+    {"tune", "Fit the win model weights to real games (log-loss)", &runTune},
+    {"search", "Timed MCTS from a position (threads or worker processes)", &runSearch},
+    {"compact", "Write a quantized, pruned stats pack and measure its error", &runCompact},
+    {"players", "Build or query the per-player brawler pool index", &runPlayers},
+    {"build-pack", "Build a stats pack from the games file, optionally from a sample", &runBuildPack},
+    {"merge-packs", "Sum stats packs from separate games into one pack", &runMergePacks},
+    {"bench", "MCTS decision quality vs. time and threads on a fixed corpus", &runBench},
+    {"synth", "Generate synthetic battles and/or a stats pack for scaling tests", &runSynth},
+    {"scale", "Time and memory of every pipeline stage over synthetic data sizes", &runScale},
+    {"stats", "Memory held per subsystem (stats, names, caches, search trees) against the caps", &runStats},
+    {"mcts-worker", nullptr, &runMctsWorker}, // Internal, no description = not listed
+};
+
+const Command* findCommand(const QString& name) {
+    for (const Command& command : COMMANDS) {
+        if (name == command.name) return &command;
+    }
+    return nullptr;
+}
+
+void printUsage() {
+    out() << "Usage: GlizzyDraft <command> [options]" << Qt::endl;
+    out() << "Run without arguments to start the GUI." << Qt::endl << Qt::endl;
+    out() << "Commands:" << Qt::endl;
+    for (const Command& command : COMMANDS) {
+        if (!command.description) continue;
+        out() << QString("  %1 %2").arg(command.name, -14).arg(command.description) << Qt::endl;
+    }
+    out() << Qt::endl << "Run 'GlizzyDraft <command> --help' for command options." << Qt::endl;
+}
+
+} // namespace
+
+
+namespace Cli {
+
+bool isCliInvocation(int argc, char *argv[]) {
+    if (argc < 2) return false;
+    QString first = QString::fromLocal8Bit(argv[1]);
+    return first == "help" || findCommand(first) != nullptr;
+}
+
+int run(const QStringList& arguments, AppConfig& config, const QString& cacheFilePath) {
+    QString name = arguments.value(1);
+    const Command* command = findCommand(name);
+    if (!command) {
+        printUsage();
+        return name == "help" ? 0 : 1;
+    }
+    qInfo() << "Running headless command:" << name;
+    return command->handler(arguments, config, cacheFilePath);
+}
+
+} // namespace Cli
@@ -0,0 +1,21 @@
+#ifndef CLI_H
+#define CLI_H
+
+#include <QString>
+#include <QStringList>
+#include "AppConfig.h"
+
+// Headless command-line entry points (no GUI is created).
+// Usage: GlizzyDraft <command> [options]   (run "GlizzyDraft help" for the list)
+namespace Cli {
+
+    // True if the first argument names a headless command
+    bool isCliInvocation(int argc, char *argv[]);
+
+    // Runs the command in 'arguments' (as returned by QCoreApplication::arguments()).
+    // Returns the process exit code.
+    int run(const QStringList& arguments, AppConfig& config, const QString& cacheFilePath);
+
+} // namespace Cli
+
+#endif // CLI_H
@@ -0,0 +1,322 @@
+#include "CompFinder.h"
+#include "Heuristics.h"
+#include "TaskExecutor.h"
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <queue>
+
+namespace {
+
+// One candidate brawler with its precomputed row against the enemy team.
+struct Candidate {
+    QString name;
+    double unary = 0.0;     // WR term + avg counter term + synergy with locked picks
+    double peakUs = -1.0;   // max(counter(us, enemy) - 0.5) over the enemy team
+    double peakThem = -1.0; // max(counter(enemy, us) - 0.5) over the enemy team
+};
+
+struct ScoredTeam {
+    double score = -std::numeric_limits<double>::infinity(); // Logit (before slope), higher is better
+    std::array<int, 3> members{{-1, -1, -1}};                // Candidate indices, -1 for unused slots
+};
+
+struct ScoredTeamGreater {
+    bool operator()(const ScoredTeam& a, const ScoredTeam& b) const { return a.score > b.score; }
+};
+
+// Raises 'target' to 'value' if it is larger (lock-free max)
+void atomicMax(std::atomic<double>& target, double value) {
+    double current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        // compare_exchange_weak refreshed 'current', loop re-checks
+    }
+}
+
+// Shared, read-only search tables plus the cross-task pruning threshold
+struct SearchContext {
+    QVector<Candidate> candidates; // Sorted by unary descending
+    QVector<double> pair;          // n*n synergy terms, pair[i*n+j]
+    QVector<double> suffixMaxUs, suffixMinUs, suffixMaxThem, suffixMinThem; // Over candidates[i..n)
+    int n = 0;
+    int freeSlots = 0;             // Free slots on our team (3 - locked)
+    double baseScore = 0.0;        // Enemy-only terms + locked-only terms
+    double lockedPeakUs = -1.0;
+    double lockedPeakThem = -1.0;
+    double maxPair = 0.0;
+    double peakWeight = 0.0;
+    int topK = 10;
+    std::atomic<double> threshold{-std::numeric_limits<double>::infinity()}; // Best known K-th score
+    std::atomic<long long> evaluated{0};
+    std::atomic<long long> pruned{0};
+};
+
+class TaskSearch {
+public:
+    TaskSearch(SearchContext& ctx) : m_ctx(ctx) {}
+
+    QVector<ScoredTeam> run(int first) {
+        const Candidate& c = m_ctx.candidates[first];
+        std::array<int, 3> members{{first, -1, -1}};
+        recurse(members, 1, first + 1, c.unary, std::max(m_ctx.lockedPeakUs, c.peakUs),
+                std::max(m_ctx.lockedPeakThem, c.peakThem));
+
+        QVector<ScoredTeam> out;
+        out.reserve(static_cast<int>(m_heap.size()));
+        while (!m_heap.empty()) { out.append(m_heap.top()); m_heap.pop(); }
+        return out;
+    }
+
+private:
+    double currentThreshold() const {
+        double shared = m_ctx.threshold.load(std::memory_order_relaxed);
+        if (static_cast<int>(m_heap.size()) >= m_ctx.topK) return std::max(shared, m_heap.top().score);
+        return shared;
+    }
+
+    // Upper bound on the final score of any completion of a partial team
+    double upperBound(int chosen, int next, double partial, double peakUs, double peakThem) const {
+        int remaining = m_ctx.freeSlots - chosen;
+        double bound = m_ctx.baseScore + partial;
+        for (int k = 0; k < remaining; ++k) bound += m_ctx.candidates[next + k].unary; // Sorted desc
+        int newPairs = chosen * remaining + remaining * (remaining - 1) / 2;
+        bound += newPairs * m_ctx.maxPair;
+        if (m_ctx.peakWeight >= 0.0) {
+            double hiUs = std::max(peakUs, m_ctx.suffixMaxUs[next]);
+            double loThem = std::max(peakThem, m_ctx.suffixMinThem[next]);
+            bound += m_ctx.peakWeight * (hiUs - loThem);
+        } else {
+            double loUs = std::max(peakUs, m_ctx.suffixMinUs[next]);
+            double hiThem = std::max(peakThem, m_ctx.suffixMaxThem[next]);
+            bound += m_ctx.peakWeight * (loUs - hiThem);
+        }
+        return bound;
+    }
+
+    void recurse(std::array<int, 3>& members, int chosen, int next,
+                 double partial, double peakUs, double peakThem) {
+        if (chosen == m_ctx.freeSlots) {
+            double score = m_ctx.baseScore + partial + m_ctx.peakWeight * (peakUs - peakThem);
+            m_ctx.evaluated.fetch_add(1, std::memory_order_relaxed);
+            offer(score, members);
+            return;
+        }
+        int remaining = m_ctx.freeSlots - chosen;
+        for (int i = next; i <= m_ctx.n - remaining; ++i) {
+            if (upperBound(chosen, i, partial, peakUs, peakThem) < currentThreshold()) {
+                // Cannot beat the K-th best team found so far
+                // The bound only shrinks as 'i' grows (candidates are sorted), so no later one can either
+                m_ctx.pruned.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+            const Candidate& c = m_ctx.candidates[i];
+            double added = c.unary;
+            for (int k = 0; k < chosen; ++k) added += m_ctx.pair[members[k] * m_ctx.n + i];
+            members[chosen] = i;
+            recurse(members, chosen + 1, i + 1, partial + added,
+                    std::max(peakUs, c.peakUs), std::max(peakThem, c.peakThem));
+            members[chosen] = -1;
+        }
+    }
+
+    void offer(double score, const std::array<int, 3>& members) {
+        if (static_cast<int>(m_heap.size()) < m_ctx.topK) {
+            m_heap.push({score, members});
+        } else if (score > m_heap.top().score) {
+            m_heap.pop();
+            m_heap.push({score, members});
+        } else {
+            return;
+        }
+        if (static_cast<int>(m_heap.size()) >= m_ctx.topK) {
+            atomicMax(m_ctx.threshold, m_heap.top().score);
+        }
+    }
+
+    SearchContext& m_ctx;
+    std::priority_queue<ScoredTeam, std::vector<ScoredTeam>, ScoredTeamGreater> m_heap; // Min-heap on score
+};
+
+} // namespace
+
+
+QString bestResponseConflict(const QVector<QString>& enemyTeam,
+                             const QVector<QString>& lockedPicks,
+                             const QSet<QString>& excluded) {
+    QSet<QString> enemies;
+    for (const QString& name : enemyTeam) {
+        if (enemies.contains(name)) return QString("%1 is in the enemy team twice.").arg(name);
+        if (excluded.contains(name)) return QString("%1 is both an enemy pick and banned.").arg(name);
+        enemies.insert(name);
+    }
+    QSet<QString> ours;
+    for (const QString& name : lockedPicks) {
+        if (ours.contains(name)) return QString("%1 is locked twice.").arg(name);
+        if (enemies.contains(name)) return QString("%1 is both an enemy pick and a locked pick.").arg(name);
+        if (excluded.contains(name)) return QString("%1 is both a locked pick and banned.").arg(name);
+        ours.insert(name);
+    }
+    return QString();
+}
+
+CompSearchResult
+findBestResponse(const QVector<QString>& enemyTeam,
+                 const QVector<QString>& lockedPicks,
+                 const QSet<QString>& excluded,
+                 const QSet<QString>& allBrawlers,
+                 const QString& mapName,
+                 const QString& modeName,
+                 const StatsCalculator& statsCalculator,
+                 const EvalWeights& evalWeights,
+                 int topK)
+{
+    QElapsedTimer timer;
+    timer.start();
+    CompSearchResult result;
+
+    if (enemyTeam.size() != 3 || lockedPicks.size() > 3 || topK <= 0) {
+        qWarning() << "findBestResponse called with invalid input. Enemy:" << enemyTeam << "Locked:" << lockedPicks;
+        return result;
+    }
+
+    SearchContext ctx;
+    ctx.topK = topK;
+    ctx.freeSlots = 3 - lockedPicks.size();
+    ctx.peakWeight = evalWeights.peakCounter; // See predictWinProbabilityModel
+
+    auto winRate = [&](const QString& b) {
+        return statsCalculator.getWinRate(b, mapName, modeName).value_or(0.5);
+    };
+    auto synergyTerm = [&](const QString& a, const QString& b) {
+        return evalWeights.synergy * (statsCalculator.getSynergyScore(a, b, mapName, modeName) - 0.5) / 3.0;
+    };
+    // Per-brawler term of our team plus its counter row against the enemy team
+    auto rowFor = [&](const QString& b) {
+        Candidate c;
+        c.name = b;
+        double counterSum = 0.0;
+        for (const QString& e : enemyTeam) {
+            double us = statsCalculator.getCounterScore(b, e, mapName, modeName) - 0.5;
+            double them = statsCalculator.getCounterScore(e, b, mapName, modeName) - 0.5;
+            counterSum += us;
+            c.peakUs = std::max(c.peakUs, us);
+            c.peakThem = std::max(c.peakThem, them);
+        }
+        c.unary = evalWeights.winRate * winRate(b) / 3.0 + evalWeights.counter * counterSum / 9.0;
+        return c;
+    };
+
+    // --- Enemy-only and locked-only constants ---
+    double enemyWr = 0.0;
+    for (const QString& e : enemyTeam) enemyWr += winRate(e);
+    double enemySynergy = 0.0;
+    for (int i = 0; i < 3; ++i)
+        for (int j = i + 1; j < 3; ++j)
+            enemySynergy += synergyTerm(enemyTeam[i], enemyTeam[j]);
+    ctx.baseScore = -evalWeights.winRate * enemyWr / 3.0 - enemySynergy;
+
+    for (int i = 0; i < lockedPicks.size(); ++i) {
+        Candidate row = rowFor(lockedPicks[i]);
+        ctx.baseScore += row.unary;
+        ctx.lockedPeakUs = std::max(ctx.lockedPeakUs, row.peakUs);
+        ctx.lockedPeakThem = std::max(ctx.lockedPeakThem, row.peakThem);
+        for (int j = i + 1; j < lockedPicks.size(); ++j) ctx.baseScore += synergyTerm(lockedPicks[i], lockedPicks[j]);
+    }
+
+    // --- Candidate rows ---
+    QSet<QString> blocked = excluded;
+    for (const QString& e : enemyTeam) blocked.insert(e);
+    for (const QString& l : lockedPicks) blocked.insert(l);
+
+    for (const QString& b : allBrawlers) {
+        if (blocked.contains(b)) continue;
+        Candidate c = rowFor(b);
+        for (const QString& l : lockedPicks) c.unary += synergyTerm(b, l); // Fold locked pairs into the row
+        ctx.candidates.append(c);
+    }
+    std::sort(ctx.candidates.begin(), ctx.candidates.end(), [](const Candidate& a, const Candidate& b) {
+        if (a.unary != b.unary) return a.unary > b.unary;
+        return a.name < b.name; // Deterministic order for ties
+    });
+    ctx.n = ctx.candidates.size();
+
+    if (ctx.freeSlots == 0) {
+        // Nothing to search, just score the locked team
+        double wp = predictWinProbabilityModel(lockedPicks, enemyTeam, mapName, modeName, statsCalculator, evalWeights);
+        result.topComps.append({lockedPicks, wp});
+        result.teamsEvaluated = 1;
+        result.elapsedUs = timer.nsecsElapsed() / 1000;
+        return result;
+    }
+    if (ctx.n < ctx.freeSlots) {
+        qWarning() << "findBestResponse: not enough candidates (" << ctx.n << ") for" << ctx.freeSlots << "slots.";
+        return result;
+    }
+
+    // --- Pair matrix and suffix bounds ---
+    const int n = ctx.n;
+    ctx.pair.fill(0.0, n * n);
+    ctx.maxPair = -std::numeric_limits<double>::infinity();
+    if (ctx.freeSlots > 1) {
+        for (int i = 0; i < n; ++i) {
+            for (int j = i + 1; j < n; ++j) {
+                double p = synergyTerm(ctx.candidates[i].name, ctx.candidates[j].name);
+                ctx.pair[i * n + j] = p;
+                ctx.pair[j * n + i] = p;
+                ctx.maxPair = std::max(ctx.maxPair, p);
+            }
+        }
+    } else {
+        ctx.maxPair = 0.0; // No new pairs can form with one free slot
+    }
+
+    ctx.suffixMaxUs.fill(-std::numeric_limits<double>::infinity(), n + 1);
+    ctx.suffixMinUs.fill(std::numeric_limits<double>::infinity(), n + 1);
+    ctx.suffixMaxThem.fill(-std::numeric_limits<double>::infinity(), n + 1);
+    ctx.suffixMinThem.fill(std::numeric_limits<double>::infinity(), n + 1);
+    for (int i = n - 1; i >= 0; --i) {
+        const Candidate& c = ctx.candidates[i];
+        ctx.suffixMaxUs[i] = std::max(ctx.suffixMaxUs[i + 1], c.peakUs);
+        ctx.suffixMinUs[i] = std::min(ctx.suffixMinUs[i + 1], c.peakUs);
+        ctx.suffixMaxThem[i] = std::max(ctx.suffixMaxThem[i + 1], c.peakThem);
+        ctx.suffixMinThem[i] = std::min(ctx.suffixMinThem[i + 1], c.peakThem);
+    }
+
+    // --- Parallel branch-and-bound, one task per first candidate ---
+    QVector<int> firstIndices;
+    for (int i = 0; i <= n - ctx.freeSlots; ++i) firstIndices.append(i);
+
+    QList<QVector<ScoredTeam>> partials = TaskExecutor::instance().mapped(firstIndices, [&ctx](int first) {
+        TaskSearch search(ctx);
+        return search.run(first);
+    }, TaskPriority::Interactive);
+
+    // --- Merge local top-K lists ---
+    QVector<ScoredTeam> merged;
+    for (const auto& local : partials) merged += local;
+    std::sort(merged.begin(), merged.end(), ScoredTeamGreater());
+    if (merged.size() > topK) merged.resize(topK);
+
+    for (const ScoredTeam& st : merged) {
+        QVector<QString> team = lockedPicks;
+        for (int idx : st.members) {
+            if (idx >= 0) team.append(ctx.candidates[idx].name);
+        }
+        // Re-score through the reference model so reported numbers match every other view
+        double wp = predictWinProbabilityModel(team, enemyTeam, mapName, modeName, statsCalculator, evalWeights);
+        result.topComps.append({team, wp});
+    }
+    std::stable_sort(result.topComps.begin(), result.topComps.end(), [](const CompResult& a, const CompResult& b) {
+        return a.winProbability > b.winProbability;
+    });
+
+    result.teamsEvaluated = ctx.evaluated.load();
+    result.branchesPruned = ctx.pruned.load();
+    result.elapsedUs = timer.nsecsElapsed() / 1000;
+    qInfo() << "Best-response search on" << mapName << modeName << "evaluated" << result.teamsEvaluated
+            << "teams, pruned" << result.branchesPruned << "branches in" << result.elapsedUs << "us.";
+    return result;
+}
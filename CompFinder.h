@@ -0,0 +1,35 @@
+#ifndef COMPFINDER_H
+#define COMPFINDER_H
+
+#include "DataStructures.h"
+#include "StatsCalculator.h"
+#include <QString>
+#include <QVector>
+#include <QSet>
+
+// Best-response search: finds our top-K teams against a fixed enemy team on a map,
+// ranked by predictWinProbabilityModel. Locked picks are always part of our team,
+// excluded brawlers (e.g. bans) are never considered. Enemy brawlers are excluded too.
+//
+// Each candidate gets a precomputed counter row against the enemy team, so the
+// model score decomposes into per-brawler and per-pair terms; partial teams are then
+// cut with a branch-and-bound over candidates sorted by their per-brawler term.
+// The search is split by first candidate across the global thread pool.
+CompSearchResult
+findBestResponse(const QVector<QString>& enemyTeam,
+                 const QVector<QString>& lockedPicks,
+                 const QSet<QString>& excluded,
+                 const QSet<QString>& allBrawlers,
+                 const QString& mapName,
+                 const QString& modeName,
+                 const StatsCalculator& statsCalculator,
+                 const EvalWeights& evalWeights,
+                 int topK = 10);
+
+// Why the inputs cannot come from one draft (a brawler twice in a team, on both teams, or picked
+// and banned); an empty string if they can. Callers reject such input before searching.
+QString bestResponseConflict(const QVector<QString>& enemyTeam,
+                             const QVector<QString>& lockedPicks,
+                             const QSet<QString>& excluded);
+
+#endif // COMPFINDER_H
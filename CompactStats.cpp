@@ -0,0 +1,377 @@
+#include "CompactStats.h"
+#include "StatsCalculator.h"
+#include "AppConfig.h"
+#include "Heuristics.h"
+#include "DraftFormat.h"
+#include <QSaveFile>
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+const quint32 COMPACT_MAGIC = 0xACEDC0DE;
+const qint16 COMPACT_VERSION = 2; // 2: perfect-hash name index instead of a sorted roster
+
+// Splits a "A|B" synergy/counter key into roster indices; false if either name is not in the roster
+bool pairIndices(const QString& key, const PerfectHash& roster, int& a, int& b) {
+    int separator = key.indexOf('|');
+    if (separator < 0) return false;
+    QStringView view(key);
+    a = roster.indexOf(view.left(separator));
+    b = roster.indexOf(view.mid(separator + 1));
+    return a >= 0 && b >= 0;
+}
+
+} // namespace
+
+
+quint16 CompactFixed::encode(double score) {
+    return static_cast<quint16>(std::lround(std::clamp(score, 0.0, 1.0) * SCALE));
+}
+
+// --- Build ---
+
+std::shared_ptr<const CompactStats> CompactStats::build(const StatsCalculator& stats, const CacheData& data,
+                                                        const AppConfig& config, double playsThreshold) {
+    if (playsThreshold < 0.0) {
+        throw std::invalid_argument("Compact stats plays threshold must not be negative.");
+    }
+    if (data.allBrawlers.size() > 65535) {
+        throw std::invalid_argument("Roster too large for 16-bit brawler indices.");
+    }
+
+    auto compact = std::make_shared<CompactStats>();
+    compact->m_metadata = data.metadata;
+    compact->m_metadata.cacheCreationTime = stats.packVersion();
+    compact->m_names = data.names.isEmpty() ? NameIndex::build(data.allBrawlers, data.discoveredMapModes) : data.names;
+    compact->m_mapModes = data.discoveredMapModes;
+    compact->m_playsThreshold = playsThreshold;
+    compact->m_smoothingK = config.smoothingK();
+    compact->m_lowPickRateThreshold = config.lowPickRateThreshold();
+    compact->m_lowConfidenceWinRateTarget = config.lowConfidenceWinRateTarget();
+
+    const NameIndex& names = compact->m_names;
+    const QStringList& roster = names.brawlers.keys();
+    const int n = roster.size();
+    compact->m_tables.resize(names.maps.size() * names.modes.size());
+    for (auto mapIt = data.stats.constBegin(); mapIt != data.stats.constEnd(); ++mapIt) {
+        const QString& mapName = mapIt.key();
+        for (auto modeIt = mapIt.value().constBegin(); modeIt != mapIt.value().constEnd(); ++modeIt) {
+            const QString& mode = modeIt.key();
+            int mapId = names.maps.indexOf(mapName);
+            int modeId = names.modes.indexOf(mode);
+            if (mapId < 0 || modeId < 0) {
+                qWarning() << "Compact stats: skipping map/mode missing from the name index:" << mapName << mode;
+                continue;
+            }
+            const MapModeStatsData& source = modeIt.value();
+            CompactMapModeTable& table = compact->m_tables[mapId * names.modes.size() + modeId];
+            table.hasPlays = source.totalWeightedPlays > 0.0;
+            table.winRate.resize(n);
+            table.pickRate.resize(n);
+            table.synergy.fill(CompactFixed::HALF, n * n);
+            table.counter.fill(CompactFixed::HALF, n * n);
+
+            for (int i = 0; i < n; ++i) {
+                const QString& brawler = roster[i];
+                table.winRate[i] = CompactFixed::encode(stats.getWinRate(brawler, mapName, mode).value_or(0.5));
+                table.pickRate[i] = CompactFixed::encode(stats.getPickRate(brawler, mapName, mode).value_or(0.0));
+            }
+
+            // Pairs under the threshold keep the 0.5 fill
+            for (auto it = source.synergyStats.constBegin(); it != source.synergyStats.constEnd(); ++it) {
+                int a = -1, b = -1;
+                if (it.value().plays < playsThreshold || !pairIndices(it.key(), names.brawlers, a, b)) {
+                    compact->m_pairsDropped++;
+                    continue;
+                }
+                quint16 score = CompactFixed::encode(
+                    stats.getSynergyScore(roster[a], roster[b], mapName, mode));
+                table.synergy[a * n + b] = score;
+                table.synergy[b * n + a] = score;
+                compact->m_pairsKept++;
+            }
+            for (auto it = source.counterStats.constBegin(); it != source.counterStats.constEnd(); ++it) {
+                int us = -1, them = -1;
+                if (it.value().plays < playsThreshold || !pairIndices(it.key(), names.brawlers, us, them)) {
+                    compact->m_pairsDropped++;
+                    continue;
+                }
+                table.counter[us * n + them] = CompactFixed::encode(
+                    stats.getCounterScore(roster[us], roster[them], mapName, mode));
+                compact->m_pairsKept++;
+            }
+        }
+    }
+
+    qInfo() << "Built compact stats:" << compact->m_pairsKept << "pairs kept," << compact->m_pairsDropped
+            << "dropped below" << playsThreshold << "plays," << compact->tableBytes() / 1024 << "KB of tables.";
+    compact->chargeMemory();
+    return compact;
+}
+
+// --- Accessors ---
+
+const CompactMapModeTable* CompactStats::table(const QString& mapName, const QString& mode) const {
+    int mapId = m_names.maps.indexOf(mapName);
+    int modeId = m_names.modes.indexOf(mode);
+    if (mapId < 0 || modeId < 0) return nullptr;
+    const CompactMapModeTable& t = m_tables[mapId * m_names.modes.size() + modeId];
+    return t.winRate.isEmpty() ? nullptr : &t;
+}
+
+std::optional<double> CompactStats::winRate(const QString& brawler, const QString& mapName, const QString& mode) const {
+    const CompactMapModeTable* t = table(mapName, mode);
+    if (!t) return std::nullopt;
+    int i = brawlerIndex(brawler);
+    if (i < 0) return m_lowConfidenceWinRateTarget; // Same as an unseen brawler on the double path
+    return CompactFixed::decode(t->winRate[i]);
+}
+
+std::optional<double> CompactStats::pickRate(const QString& brawler, const QString& mapName, const QString& mode) const {
+    const CompactMapModeTable* t = table(mapName, mode);
+    if (!t || !t->hasPlays) return std::nullopt;
+    int i = brawlerIndex(brawler);
+    if (i < 0) return 0.0;
+    return CompactFixed::decode(t->pickRate[i]);
+}
+
+double CompactStats::synergyScore(const QString& brawler1, const QString& brawler2, const QString& mapName, const QString& mode) const {
+    const CompactMapModeTable* t = table(mapName, mode);
+    int a = brawlerIndex(brawler1);
+    int b = brawlerIndex(brawler2);
+    if (!t || a < 0 || b < 0) return 0.5;
+    return CompactFixed::decode(t->synergy[a * m_names.brawlers.size() + b]);
+}
+
+double CompactStats::counterScore(const QString& brawlerUs, const QString& brawlerThem, const QString& mapName, const QString& mode) const {
+    const CompactMapModeTable* t = table(mapName, mode);
+    int us = brawlerIndex(brawlerUs);
+    int them = brawlerIndex(brawlerThem);
+    if (!t || us < 0 || them < 0) return 0.5;
+    return CompactFixed::decode(t->counter[us * m_names.brawlers.size() + them]);
+}
+
+void CompactStats::chargeMemory() {
+    m_tablesCharge.set(tableBytes() + MemoryLedger::vectorBytes(m_tables));
+    m_namesCharge.set(m_names.memoryBytes());
+}
+
+qint64 CompactStats::tableBytes() const {
+    qint64 bytes = 0;
+    for (const CompactMapModeTable& t : m_tables) {
+        bytes += qint64(t.winRate.size() + t.pickRate.size() + t.synergy.size() + t.counter.size()) * sizeof(quint16);
+    }
+    return bytes;
+}
+
+CacheData CompactStats::cacheData() const {
+    CacheData data;
+    data.allBrawlers = QSet<QString>(roster().begin(), roster().end());
+    data.discoveredMapModes = m_mapModes;
+    data.metadata = m_metadata;
+    data.names = m_names;
+    return data;
+}
+
+void CompactStats::checkSettings(const AppConfig& config) const {
+    if (config.smoothingK() != m_smoothingK || config.lowPickRateThreshold() != m_lowPickRateThreshold ||
+        config.lowConfidenceWinRateTarget() != m_lowConfidenceWinRateTarget) {
+        qWarning() << "Compact stats were finalized with SmoothingK" << m_smoothingK << "LowPickRateThreshold"
+                   << m_lowPickRateThreshold << "LowConfidenceWinRateTarget" << m_lowConfidenceWinRateTarget
+                   << "; the current config differs and is not applied to them.";
+    }
+}
+
+// --- Persistence ---
+
+bool CompactStats::save(const QString& filePath) const {
+    QDir dir = QFileInfo(filePath).dir();
+    if (!dir.exists() && !dir.mkpath(".")) {
+        qCritical() << "Failed to create compact stats directory:" << dir.path();
+        return false;
+    }
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCritical() << "Error opening compact stats for writing:" << filePath << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << COMPACT_MAGIC << COMPACT_VERSION << m_metadata << m_names << m_mapModes
+        << m_playsThreshold << m_smoothingK << m_lowPickRateThreshold << m_lowConfidenceWinRateTarget
+        << qint32(m_pairsKept) << qint32(m_pairsDropped);
+
+    const int n = m_names.brawlers.size();
+    const int modeCount = m_names.modes.size();
+    qint32 tableCount = 0;
+    for (const CompactMapModeTable& t : m_tables) {
+        if (!t.winRate.isEmpty()) tableCount++;
+    }
+    out << tableCount;
+    for (int index = 0; index < m_tables.size(); ++index) {
+        const CompactMapModeTable& t = m_tables[index];
+        if (t.winRate.isEmpty()) continue;
+        out << qint32(index / modeCount) << qint32(index % modeCount) << t.hasPlays << t.winRate << t.pickRate;
+
+        // Sparse: only pairs that differ from 0.5, as (a, b, score)
+        QVector<quint16> synergyTriples;
+        for (int a = 0; a < n; ++a) {
+            for (int b = a + 1; b < n; ++b) {
+                quint16 score = t.synergy[a * n + b];
+                if (score != CompactFixed::HALF) synergyTriples << quint16(a) << quint16(b) << score;
+            }
+        }
+        QVector<quint16> counterTriples;
+        for (int us = 0; us < n; ++us) {
+            for (int them = 0; them < n; ++them) {
+                quint16 score = t.counter[us * n + them];
+                if (score != CompactFixed::HALF) counterTriples << quint16(us) << quint16(them) << score;
+            }
+        }
+        out << synergyTriples << counterTriples;
+    }
+
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        qCritical() << "Error writing compact stats:" << filePath;
+        return false;
+    }
+    qInfo() << "Saved compact stats to" << filePath;
+    return true;
+}
+
+bool CompactStats::isCompactFile(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magicNumber = 0;
+    in >> magicNumber;
+    return in.status() == QDataStream::Ok && magicNumber == COMPACT_MAGIC;
+}
+
+std::shared_ptr<const CompactStats> CompactStats::load(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Error opening compact stats for reading:" << filePath << file.errorString();
+        return nullptr;
+    }
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magicNumber = 0;
+    qint16 version = 0;
+    in >> magicNumber >> version;
+    if (in.status() != QDataStream::Ok || magicNumber != COMPACT_MAGIC || version != COMPACT_VERSION) {
+        qWarning() << "Compact stats file has invalid header:" << filePath;
+        return nullptr;
+    }
+
+    auto compact = std::make_shared<CompactStats>();
+    qint32 pairsKept = 0, pairsDropped = 0, tableCount = 0;
+    in >> compact->m_metadata >> compact->m_names >> compact->m_mapModes
+       >> compact->m_playsThreshold >> compact->m_smoothingK >> compact->m_lowPickRateThreshold
+       >> compact->m_lowConfidenceWinRateTarget >> pairsKept >> pairsDropped >> tableCount;
+    compact->m_pairsKept = pairsKept;
+    compact->m_pairsDropped = pairsDropped;
+    const NameIndex& names = compact->m_names;
+    const int n = names.brawlers.size();
+    if (in.status() != QDataStream::Ok || n == 0 || n > 65535 || tableCount < 0 ||
+        !names.brawlers.isConsistent() || !names.maps.isConsistent() || !names.modes.isConsistent()) {
+        qWarning() << "Compact stats file is corrupted:" << filePath;
+        return nullptr;
+    }
+    compact->m_tables.resize(names.maps.size() * names.modes.size());
+
+    for (qint32 k = 0; k < tableCount; ++k) {
+        qint32 mapId = -1, modeId = -1;
+        CompactMapModeTable t;
+        QVector<quint16> synergyTriples, counterTriples;
+        in >> mapId >> modeId >> t.hasPlays >> t.winRate >> t.pickRate >> synergyTriples >> counterTriples;
+        if (in.status() != QDataStream::Ok || mapId < 0 || mapId >= names.maps.size() ||
+            modeId < 0 || modeId >= names.modes.size() || t.winRate.size() != n || t.pickRate.size() != n ||
+            synergyTriples.size() % 3 != 0 || counterTriples.size() % 3 != 0) {
+            qWarning() << "Compact stats file is corrupted:" << filePath;
+            return nullptr;
+        }
+        t.synergy.fill(CompactFixed::HALF, n * n);
+        t.counter.fill(CompactFixed::HALF, n * n);
+        for (int i = 0; i < synergyTriples.size(); i += 3) {
+            int a = synergyTriples[i], b = synergyTriples[i + 1];
+            if (a >= n || b >= n) { qWarning() << "Compact stats file is corrupted:" << filePath; return nullptr; }
+            t.synergy[a * n + b] = synergyTriples[i + 2];
+            t.synergy[b * n + a] = synergyTriples[i + 2];
+        }
+        for (int i = 0; i < counterTriples.size(); i += 3) {
+            int us = counterTriples[i], them = counterTriples[i + 1];
+            if (us >= n || them >= n) { qWarning() << "Compact stats file is corrupted:" << filePath; return nullptr; }
+            t.counter[us * n + them] = counterTriples[i + 2];
+        }
+        compact->m_tables[mapId * names.modes.size() + modeId] = std::move(t);
+    }
+
+    qInfo() << "Compact stats loaded:" << filePath << "(" << tableCount << "map/modes," << n << "brawlers)";
+    compact->chargeMemory();
+    return compact;
+}
+
+// --- Error Measurement ---
+
+CompactErrorReport measureCompactError(const StatsCalculator& exact, const StatsCalculator& compact,
+                                       const CacheData& data, const EvalWeights& evalWeights,
+                                       int drafts, quint32 seed) {
+    CompactErrorReport report;
+    QStringList roster(data.allBrawlers.begin(), data.allBrawlers.end());
+    roster.sort();
+
+    auto track = [](double& maxError, double a, double b) { maxError = std::max(maxError, std::abs(a - b)); };
+    QVector<QPair<QString, QString>> mapModes;
+    for (auto mapIt = data.stats.constBegin(); mapIt != data.stats.constEnd(); ++mapIt) {
+        for (auto modeIt = mapIt.value().constBegin(); modeIt != mapIt.value().constEnd(); ++modeIt) {
+            const QString& mapName = mapIt.key();
+            const QString& mode = modeIt.key();
+            mapModes.append({mapName, mode});
+            for (const QString& a : roster) {
+                track(report.maxWinRateError, exact.getWinRate(a, mapName, mode).value_or(0.5),
+                      compact.getWinRate(a, mapName, mode).value_or(0.5));
+                track(report.maxPickRateError, exact.getPickRate(a, mapName, mode).value_or(0.0),
+                      compact.getPickRate(a, mapName, mode).value_or(0.0));
+                for (const QString& b : roster) {
+                    if (a == b) continue;
+                    track(report.maxSynergyError, exact.getSynergyScore(a, b, mapName, mode),
+                          compact.getSynergyScore(a, b, mapName, mode));
+                    track(report.maxCounterError, exact.getCounterScore(a, b, mapName, mode),
+                          compact.getCounterScore(a, b, mapName, mode));
+                }
+            }
+        }
+    }
+
+    // Random full drafts: the error that actually reaches the win model
+    if (mapModes.isEmpty() || drafts <= 0) return report;
+    std::mt19937 rng(seed);
+    double errorSum = 0.0;
+    for (int d = 0; d < drafts; ++d) {
+        const auto& [mapName, mode] = mapModes[std::uniform_int_distribution<int>(0, mapModes.size() - 1)(rng)];
+        int teamSize = teamSizeForMode(mode);
+        if (roster.size() < 2 * teamSize) continue;
+        QStringList shuffled = roster;
+        std::shuffle(shuffled.begin(), shuffled.end(), rng);
+        QVector<QString> team1(shuffled.begin(), shuffled.begin() + teamSize);
+        QVector<QString> team2(shuffled.begin() + teamSize, shuffled.begin() + 2 * teamSize);
+        double error = std::abs(predictWinProbabilityModel(team1, team2, mapName, mode, exact, evalWeights) -
+                                predictWinProbabilityModel(team1, team2, mapName, mode, compact, evalWeights));
+        errorSum += error;
+        report.maxWinProbError = std::max(report.maxWinProbError, error);
+        report.draftsSampled++;
+    }
+    if (report.draftsSampled > 0) report.meanWinProbError = errorSum / report.draftsSampled;
+    return report;
+}
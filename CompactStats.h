@@ -0,0 +1,109 @@
+#ifndef COMPACTSTATS_H
+#define COMPACTSTATS_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <memory>
+#include <optional>
+#include "DataStructures.h"
+#include "MemoryLedger.h"
+
+class StatsCalculator;
+class AppConfig;
+
+// Finalized scores in [0, 1] as 16-bit fixed point. The scale is even so 0.5 is exact
+// (pruned and missing pairs decode to exactly 0.5); the rounding error is at most 0.5 / SCALE.
+namespace CompactFixed {
+    constexpr double SCALE = 65534.0;
+    constexpr double MAX_ERROR = 0.5 / SCALE;
+    constexpr quint16 HALF = 32767;
+
+    quint16 encode(double score);
+    inline double decode(quint16 value) { return value / SCALE; }
+}
+
+// One map/mode: scores indexed by roster position, so a draft's working set is a few
+// contiguous arrays (about 2 * N^2 * 2 bytes; ~32 KB for a 90-brawler roster).
+struct CompactMapModeTable {
+    bool hasPlays = false;       // false: getPickRate has no data for this map/mode
+    QVector<quint16> winRate;    // Finalized getWinRate per brawler
+    QVector<quint16> pickRate;   // getPickRate per brawler
+    QVector<quint16> synergy;    // [a * N + b], symmetric
+    QVector<quint16> counter;    // [us * N + them]
+};
+
+// Quantized, pruned copy of a stats pack. Scores are finalized with the smoothing and
+// low-confidence settings at build time (recorded below), and synergy/counter pairs with
+// fewer weighted plays than the threshold are dropped, i.e. read back as 0.5.
+// On disk only kept pairs are stored (two roster indices + score), not hash keys and doubles.
+class CompactStats {
+public:
+    // Throws std::invalid_argument if 'playsThreshold' is negative or the roster exceeds 65535 brawlers
+    static std::shared_ptr<const CompactStats> build(const StatsCalculator& stats, const CacheData& data,
+                                                     const AppConfig& config, double playsThreshold);
+
+    // --- Accessors (same semantics as StatsCalculator's) ---
+    std::optional<double> winRate(const QString& brawler, const QString& mapName, const QString& mode) const;
+    std::optional<double> pickRate(const QString& brawler, const QString& mapName, const QString& mode) const;
+    double synergyScore(const QString& brawler1, const QString& brawler2, const QString& mapName, const QString& mode) const;
+    double counterScore(const QString& brawlerUs, const QString& brawlerThem, const QString& mapName, const QString& mode) const;
+
+    const CompactMapModeTable* table(const QString& mapName, const QString& mode) const;
+    // Roster position = perfect hash id from the pack's name index; -1 if unknown
+    int brawlerIndex(const QString& brawler) const { return m_names.brawlers.indexOf(brawler); }
+    const QStringList& roster() const { return m_names.brawlers.keys(); }
+    const NameIndex& names() const { return m_names; }
+
+    qint64 packVersion() const { return m_metadata.cacheCreationTime; }
+    double playsThreshold() const { return m_playsThreshold; }
+    int pairsKept() const { return m_pairsKept; }
+    int pairsDropped() const { return m_pairsDropped; }
+    qint64 tableBytes() const; // In-memory size of all score arrays
+
+    // Metadata, roster and map/modes, with empty stats (for code that reads the roster from CacheData)
+    CacheData cacheData() const;
+    // Logs if the current config would finalize scores differently than the build did
+    void checkSettings(const AppConfig& config) const;
+
+    bool save(const QString& filePath) const;
+    static bool isCompactFile(const QString& filePath);
+    static std::shared_ptr<const CompactStats> load(const QString& filePath); // nullptr on error
+
+private:
+    void chargeMemory(); // Once the tables are filled (build and load)
+
+    CacheMetadata m_metadata;
+    NameIndex m_names;                   // Brawler ids double as roster positions
+    QHash<QString, QSet<QString>> m_mapModes;
+    QVector<CompactMapModeTable> m_tables; // [mapId * modeCount + modeId]; empty winRate = no stats
+
+    double m_playsThreshold = 0.0;
+    double m_smoothingK = 0.0;
+    double m_lowPickRateThreshold = 0.0;
+    double m_lowConfidenceWinRateTarget = 0.0;
+    int m_pairsKept = 0;
+    int m_pairsDropped = 0;
+    MemoryCharge m_tablesCharge{MemorySubsystem::StatsTables};
+    MemoryCharge m_namesCharge{MemorySubsystem::NamePools};
+};
+
+// Compact-vs-double comparison over every roster entry and pair, plus random full drafts
+struct CompactErrorReport {
+    double maxWinRateError = 0.0;
+    double maxPickRateError = 0.0;
+    double maxSynergyError = 0.0;   // Includes pruning error
+    double maxCounterError = 0.0;
+    double meanWinProbError = 0.0;  // predictWinProbabilityModel over the sampled drafts
+    double maxWinProbError = 0.0;
+    int draftsSampled = 0;
+};
+
+// 'exact' is the double path, 'compact' a calculator serving the same pack from CompactStats
+CompactErrorReport measureCompactError(const StatsCalculator& exact, const StatsCalculator& compact,
+                                       const CacheData& data, const EvalWeights& evalWeights,
+                                       int drafts, quint32 seed);
+
+#endif // COMPACTSTATS_H
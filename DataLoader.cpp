@@ -1,20 +1,86 @@
 #include "DataLoader.h"
+#include "DraftFormat.h"
+#include "MemoryLedger.h"
+#include "TaskExecutor.h"
 #include <QFile>
 #include <QTextStream>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDebug>
-#include <QMessageBox> // For error reporting if needed directly
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+const qint64 MIN_SAMPLE_PER_STRATUM = 30; // Keeps small maps estimable at low fractions
+// A parsed QJsonObject holds its keys and values as CBOR elements: roughly this many bytes per byte of text
+const qint64 RAW_JSON_BYTES_PER_TEXT_BYTE = 3;
+// Lines read before they are parsed together on the task executor
+const int PARSE_CHUNK_LINES = 4096;
+
+// Heap owned by one processed game beyond its slot in the vector
+qint64 processedGameBytes(const ProcessedGame& game) {
+    qint64 bytes = MemoryLedger::stringBytes(game.mode) + MemoryLedger::stringBytes(game.map)
+                 + MemoryLedger::vectorBytes(game.winningTeamData) + MemoryLedger::vectorBytes(game.losingTeamData);
+    for (const PlayerData& player : game.winningTeamData) bytes += MemoryLedger::stringBytes(player.brawlerName);
+    for (const PlayerData& player : game.losingTeamData) bytes += MemoryLedger::stringBytes(player.brawlerName);
+    return bytes;
+}
+
+// Value of the first "key": "..." string field of a raw JSON line, found without parsing the line.
+// Empty if absent; escaped values are decoded by the JSON parser.
+QString scanStringField(const QByteArray& line, const QByteArray& key) {
+    const QByteArray needle = QByteArray("\"").append(key).append('"');
+    qsizetype pos = line.indexOf(needle);
+    if (pos < 0) return {};
+    pos += needle.size();
+    while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t' || line[pos] == ':')) ++pos;
+    if (pos >= line.size() || line[pos] != '"') return {};
+    qsizetype end = pos + 1;
+    bool escaped = false;
+    for (; end < line.size(); ++end) {
+        if (escaped) escaped = false;
+        else if (line[end] == '\\') escaped = true;
+        else if (line[end] == '"') break;
+    }
+    if (end >= line.size()) return {};
+    QByteArray quoted = line.mid(pos, end - pos + 1);
+    if (!quoted.contains('\\')) return QString::fromUtf8(quoted.mid(1, quoted.size() - 2));
+    return QJsonDocument::fromJson(QByteArray("[").append(quoted).append(']')).array().at(0).toString();
+}
+
+} // namespace
+
 
 DataLoader::DataLoader(QString filepath, const AppConfig& config)
-    : m_filepath(filepath), m_config(config) {}
+    : m_filepath(filepath), m_config(config),
+      m_rawBytesCap(MemoryLedger::capBytes(MemorySubsystem::LoaderBuffers, config)) {}
+
+void DataLoader::setBuildPlayerIndex(bool enabled) {
+    m_buildPlayerIndex = enabled;
+}
+
+void DataLoader::setStartOffset(qint64 offset) {
+    m_startOffset = std::max<qint64>(0, offset);
+}
+
+void DataLoader::setSampleFraction(double fraction, quint32 seed) {
+    if (!(fraction > 0.0 && fraction <= 1.0)) throw std::invalid_argument("Sample fraction must be in (0, 1].");
+    m_sampleFraction = fraction;
+    m_sampleSeed = seed;
+}
 
 bool DataLoader::loadAndProcess() {
+    beginPreprocess();
     if (!loadRawData()) {
         return false;
     }
-    preprocessData();
+    preprocessRawGames();
+    finishPreprocess();
     // Check if essential data was discovered
     return !m_allBrawlers.isEmpty() && !m_discoveredMapModes.isEmpty();
 }
@@ -28,51 +94,156 @@ bool DataLoader::loadRawData() {
          return false;
     }
 
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    // Binary, so positions are byte offsets that can be checkpointed
+    if (!file.open(QIODevice::ReadOnly)) {
         qCritical() << "Failed to open data file:" << m_filepath << file.errorString();
         // Optional: QMessageBox::critical(nullptr, "Error", "Failed to open data file:\n" + file.errorString());
         return false;
     }
 
-    qInfo() << "Loading raw data from:" << m_filepath;
-    QTextStream in(&file);
-    int lineNum = 0;
-    while (!in.atEnd()) {
-        lineNum++;
-        QString line = in.readLine();
-        if (line.trimmed().isEmpty()) continue;
-
-        QJsonParseError parseError;
-        QJsonDocument doc = QJsonDocument::fromJson(line.toUtf8(), &parseError);
+    m_endOffset = m_startOffset;
+    if (m_startOffset > 0 && !file.seek(m_startOffset)) {
+        qCritical() << "Failed to seek to offset" << m_startOffset << "in data file:" << m_filepath;
+        return false;
+    }
 
-        if (parseError.error != QJsonParseError::NoError) {
-            qWarning() << "Skipping invalid JSON on line" << lineNum << ":" << parseError.errorString();
-            continue;
+    qInfo() << "Loading raw data from:" << m_filepath << (m_startOffset > 0 ? "from byte" : "") << m_startOffset;
+    QVector<QByteArray> chunk;
+    QVector<int> chunkLineNums;
+    auto addLine = [&](const QByteArray& line, int lineNum) {
+        chunk.append(line);
+        chunkLineNums.append(lineNum);
+        if (chunk.size() < PARSE_CHUNK_LINES) return;
+        parseRawLines(chunk, chunkLineNums);
+        chunk.clear();
+        chunkLineNums.clear();
+    };
+    if (m_sampleFraction < 1.0) {
+        for (const auto& [offset, lineNum] : sampleLines(file)) {
+            file.seek(offset);
+            addLine(file.readLine(), lineNum);
         }
-
-        if (!doc.isObject()) {
-             qWarning() << "Skipping non-object JSON on line" << lineNum;
-             continue;
+    } else {
+        int lineNum = 0;
+        while (!file.atEnd()) {
+            QByteArray line = file.readLine();
+            if (line.endsWith('\n')) {
+                m_endOffset = file.pos();
+            } else if (m_startOffset > 0) {
+                break; // Possibly half-written; read again once its newline arrives
+            }
+            addLine(line, ++lineNum);
         }
-
-        m_rawGames.append(doc.object());
     }
+    parseRawLines(chunk, chunkLineNums);
     file.close();
-    qInfo() << "Loaded" << m_rawGames.size() << "raw game entries.";
+    qInfo() << "Loaded" << m_rawGamesRead << "raw game entries.";
     return true;
 }
 
-void DataLoader::preprocessData() {
-    qInfo() << "Starting data preprocessing...";
-    int skippedCount = 0;
-    int rankIssues = 0;
-    int formatIssues = 0;
-    int missingPlayerTag = 0; // Keep track if needed, Python code had it
-    int processedCount = 0;
+// JSON parsing is the costly part of loading: a chunk of lines is parsed in parallel, then the
+// games are buffered in file order, exactly as if parsed one by one
+void DataLoader::parseRawLines(const QVector<QByteArray>& lines, const QVector<int>& lineNums) {
+    if (lines.isEmpty()) return;
+    QVector<int> indexes(lines.size());
+    std::iota(indexes.begin(), indexes.end(), 0);
+    QList<std::optional<QJsonObject>> games = TaskExecutor::instance().mapped(indexes, [&](int i) {
+        return parseRawLine(lines[i], lineNums[i]);
+    }, TaskPriority::Background);
+
+    for (int i = 0; i < games.size(); ++i) {
+        if (!games[i]) continue;
+        m_rawGames.append(*games[i]);
+        m_rawGamesRead++;
+        m_rawBytes += lines[i].trimmed().size() * RAW_JSON_BYTES_PER_TEXT_BYTE;
+        // Over the cap: process what is buffered now, so raw JSON never holds more than one batch
+        if (m_rawBytesCap > 0 && m_rawBytes >= m_rawBytesCap) preprocessRawGames();
+    }
+}
+
+std::optional<QJsonObject> DataLoader::parseRawLine(const QByteArray& rawLine, int lineNum) {
+    QByteArray line = rawLine.trimmed();
+    if (line.isEmpty()) return std::nullopt;
+
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
 
+    if (parseError.error != QJsonParseError::NoError) {
+        qWarning() << "Skipping invalid JSON on line" << lineNum << ":" << parseError.errorString();
+        return std::nullopt;
+    }
+
+    if (!doc.isObject()) {
+         qWarning() << "Skipping non-object JSON on line" << lineNum;
+         return std::nullopt;
+    }
+    return doc.object();
+}
+
+// One pass over the raw bytes groups line offsets by map/mode; each stratum then keeps a
+// uniform sample of its lines (partial Fisher-Yates), and only those lines are parsed
+QVector<QPair<qint64, int>> DataLoader::sampleLines(QFile& file) {
+    QHash<QString, QHash<QString, QVector<QPair<qint64, int>>>> lines; // Map -> Mode -> lines
+    int lineNum = 0;
+    while (!file.atEnd()) {
+        qint64 offset = file.pos();
+        QByteArray line = file.readLine();
+        if (line.endsWith('\n')) {
+            m_endOffset = file.pos();
+        } else if (m_startOffset > 0) {
+            break;
+        }
+        ++lineNum;
+        if (line.trimmed().isEmpty()) continue;
+        lines[scanStringField(line, "map")][scanStringField(line, "mode")].append({offset, lineNum});
+    }
+
+    m_strata.clear();
+    QVector<QPair<qint64, int>> sampled;
+    qint64 totalLines = 0;
+    for (auto mapIt = lines.begin(); mapIt != lines.end(); ++mapIt) {
+        for (auto modeIt = mapIt.value().begin(); modeIt != mapIt.value().end(); ++modeIt) {
+            QVector<QPair<qint64, int>>& stratum = modeIt.value();
+            const qint64 n = stratum.size();
+            const qint64 k = std::min<qint64>(n, std::max<qint64>(MIN_SAMPLE_PER_STRATUM,
+                                                                   qint64(std::ceil(n * m_sampleFraction))));
+            // Seeded per stratum, so the sample does not depend on hash iteration order
+            std::mt19937 randomEngine(m_sampleSeed ^ static_cast<quint32>(qHash(mapIt.key() + "|" + modeIt.key())));
+            for (qint64 i = 0; i < k; ++i) {
+                std::uniform_int_distribution<qint64> pick(i, n - 1);
+                std::swap(stratum[i], stratum[pick(randomEngine)]);
+            }
+            sampled += stratum.mid(0, k);
+            m_strata[mapIt.key()][modeIt.key()] = {n, k};
+            totalLines += n;
+        }
+    }
+    std::sort(sampled.begin(), sampled.end()); // Read front to back
+    qInfo() << "Sampling" << sampled.size() << "of" << totalLines << "lines over" << m_strata.size() << "maps.";
+    return sampled;
+}
+
+void DataLoader::beginPreprocess() {
+    m_counts = PreprocessCounts();
+    m_rawGames.clear();
+    m_rawGamesRead = 0;
+    m_rawBytes = 0;
+    m_processedBytes = 0;
     m_processedGames.clear();
+    m_battleKeys.clear();
+    m_playerIndexBuilder = PlayerIndexBuilder();
     m_allBrawlers.clear();
     m_discoveredMapModes.clear();
+}
+
+// Turns the buffered raw JSON into processed games and empties the buffer
+void DataLoader::preprocessRawGames() {
+    int& rankIssues = m_counts.rankIssues;
+    int& formatIssues = m_counts.formatIssues;
+    int& missingPlayerTag = m_counts.missingPlayerTag; // Keep track if needed, Python code had it
+    int& processedCount = m_counts.processed;
+    PlayerIndexBuilder& playerIndexBuilder = m_playerIndexBuilder;
+    const qint64 firstIndex = m_rawGamesRead - m_rawGames.size(); // Of the batch, for warnings
 
     for (int idx = 0; idx < m_rawGames.size(); ++idx) {
         const QJsonObject& game = m_rawGames[idx];
@@ -116,11 +287,13 @@ void DataLoader::preprocessData() {
         }
 
         // Extract and validate team data
-        auto [team1Data, team1Valid] = extractTeamData(teamsRaw.at(0));
-        auto [team2Data, team2Valid] = extractTeamData(teamsRaw.at(1));
+        // Team size comes from the mode (3v3 unless a duo or 5v5 mode, see DraftFormat)
+        int teamSize = teamSizeForMode(mode);
+        auto [team1Data, team1Valid] = extractTeamData(teamsRaw.at(0), teamSize);
+        auto [team2Data, team2Valid] = extractTeamData(teamsRaw.at(1), teamSize);
 
         if (!team1Valid || !team2Valid) {
-            rankIssues++; continue; // Covers invalid player/rank data or team size != 3
+            rankIssues++; continue; // Covers invalid player/rank data or a team size that does not match the mode
         }
 
         // Discover brawlers and map/modes
@@ -154,9 +327,11 @@ void DataLoader::preprocessData() {
         QVector<PlayerData> winningTeamData;
         QVector<PlayerData> losingTeamData;
 
+        bool team1Won = false;
         if ((playerInT1 && result == "victory") || (playerInT2 && result == "defeat")) {
             winningTeamData = team1Data;
             losingTeamData = team2Data;
+            team1Won = true;
         } else if ((playerInT1 && result == "defeat") || (playerInT2 && result == "victory")) {
             winningTeamData = team2Data;
             losingTeamData = team1Data;
@@ -165,36 +340,55 @@ void DataLoader::preprocessData() {
         }
         else {
             // This case might indicate player tag missing or inconsistent result/tag data
-            qWarning() << "Skipping game index" << idx << "- inconsistent result/tag:" << result << "T1?" << playerInT1 << "T2?" << playerInT2;
+            qWarning() << "Skipping game index" << firstIndex + idx << "- inconsistent result/tag:" << result << "T1?" << playerInT1 << "T2?" << playerInT2;
             formatIssues++; continue;
         }
 
         // Add processed game
         m_processedGames.append({mode, mapName, winningTeamData, losingTeamData});
+        m_processedBytes += processedGameBytes(m_processedGames.last());
+        m_battleKeys.append(battleKey(game));
         processedCount++;
+        if (m_buildPlayerIndex) {
+            recordPlayers(playerIndexBuilder, teamsRaw.at(0), team1Won);
+            recordPlayers(playerIndexBuilder, teamsRaw.at(1), !team1Won);
+        }
 
     } // End game loop
+    m_rawGames.clear(); // Keeps its capacity for the next batch
+    m_rawBytes = 0;
+    updateMemoryCharge();
+}
+
+void DataLoader::finishPreprocess() {
+    m_rawGames.squeeze();
+    updateMemoryCharge();
+    if (m_buildPlayerIndex) m_playerIndex = m_playerIndexBuilder.build(m_allBrawlers);
+    m_playerIndexBuilder = PlayerIndexBuilder();
 
     qInfo() << "Discovered" << m_discoveredMapModes.size() << "modes and"
             << std::accumulate(m_discoveredMapModes.begin(), m_discoveredMapModes.end(), 0,
                                [](int sum, const QSet<QString>& maps){ return sum + maps.size(); })
             << "unique maps.";
     qInfo() << "Identified" << m_allBrawlers.size() << "unique brawlers.";
-    qInfo() << "Successfully processed" << processedCount << "game entries.";
-    if (skippedCount > 0) qWarning() << "Skipped" << skippedCount << "games due to unexpected processing errors.";
-    if (rankIssues > 0) qWarning() << "Skipped" << rankIssues << "games due to invalid player/rank data or team size.";
-    if (formatIssues > 0) qWarning() << "Skipped" << formatIssues << "games due to other format issues.";
-    if (missingPlayerTag > 0) qWarning() << "Skipped" << missingPlayerTag << "games because queried player tag was missing from teams.";
+    qInfo() << "Successfully processed" << m_counts.processed << "game entries.";
+    if (m_counts.rankIssues > 0) qWarning() << "Skipped" << m_counts.rankIssues << "games due to invalid player/rank data or team size.";
+    if (m_counts.formatIssues > 0) qWarning() << "Skipped" << m_counts.formatIssues << "games due to other format issues.";
+    if (m_counts.missingPlayerTag > 0) qWarning() << "Skipped" << m_counts.missingPlayerTag << "games because queried player tag was missing from teams.";
+}
 
+void DataLoader::updateMemoryCharge() {
+    m_memoryCharge.set(m_rawBytes + MemoryLedger::vectorBytes(m_rawGames) + m_processedBytes
+                       + MemoryLedger::vectorBytes(m_processedGames) + MemoryLedger::vectorBytes(m_battleKeys));
 }
 
 // Helper to extract team data from a QJsonValue (expected to be QJsonArray)
-QPair<QVector<PlayerData>, bool> DataLoader::extractTeamData(const QJsonValue& teamValue) {
+QPair<QVector<PlayerData>, bool> DataLoader::extractTeamData(const QJsonValue& teamValue, int teamSize) {
     QVector<PlayerData> teamData;
     if (!teamValue.isArray()) return {{}, false}; // Check if it's an array
 
     QJsonArray teamArray = teamValue.toArray();
-    if (teamArray.size() != 3) return {{}, false}; // Check team size
+    if (teamArray.size() != teamSize) return {{}, false}; // Check team size
 
     for (const QJsonValue& playerValue : teamArray) {
         if (!playerValue.isObject()) return {{}, false}; // Check if player entry is an object
@@ -222,6 +416,34 @@ QPair<QVector<PlayerData>, bool> DataLoader::extractTeamData(const QJsonValue& t
 }
 
 
+// Every player with a tag in an accepted game (team layout was validated by extractTeamData)
+void DataLoader::recordPlayers(PlayerIndexBuilder& builder, const QJsonValue& teamValue, bool win) const {
+    for (const QJsonValue& playerValue : teamValue.toArray()) {
+        QJsonObject playerObj = playerValue.toObject();
+        QString tag = playerObj.value("tag").toString();
+        if (tag.isEmpty()) continue;
+        builder.add(tag, playerObj.value("brawler").toObject().value("name").toString(), win);
+    }
+}
+
+
+quint64 DataLoader::battleKey(const QJsonObject& game) {
+    QJsonObject event = game.value("event").toObject();
+    QStringList players;
+    for (const QJsonValue& teamValue : game.value("battle").toObject().value("teams").toArray()) {
+        for (const QJsonValue& playerValue : teamValue.toArray()) {
+            QJsonObject playerObj = playerValue.toObject();
+            players.append(playerObj.value("tag").toString() + "/" +
+                           playerObj.value("brawler").toObject().value("name").toString());
+        }
+    }
+    players.sort(); // Team order depends on whose battle log it came from
+    QString key = QStringList{game.value("battleTime").toString(), event.value("mode").toString(),
+                              event.value("map").toString(), players.join(",")}.join("|");
+    return static_cast<quint64>(qHash(key, size_t(0x9E3779B97F4A7C15ull)));
+}
+
+
 // --- Getters ---
 const QVector<ProcessedGame>& DataLoader::getProcessedGames() const {
     return m_processedGames;
@@ -233,4 +455,20 @@ const QSet<QString>& DataLoader::getAllBrawlers() const {
 
 const QHash<QString, QSet<QString>>& DataLoader::getDiscoveredMapModes() const {
     return m_discoveredMapModes;
+}
+
+const PlayerIndex& DataLoader::getPlayerIndex() const {
+    return m_playerIndex;
+}
+
+qint64 DataLoader::getEndOffset() const {
+    return m_endOffset;
+}
+
+const QVector<quint64>& DataLoader::getBattleKeys() const {
+    return m_battleKeys;
+}
+
+const StratumCounts& DataLoader::getStrata() const {
+    return m_strata;
 }
\ No newline at end of file
@@ -9,31 +9,92 @@
 #include <QJsonObject>  // <-- ADD
 #include <QJsonArray>   // <-- ADD
 #include <QJsonValue>   // <-- ADD (Used in extractTeamData signature)
+#include <QFile>
+#include <optional>
 #include "DataStructures.h"
 #include "AppConfig.h"
+#include "PlayerIndex.h"
+#include "MemoryLedger.h"
+
+// Lines of one map/mode in the file, and how many of them a sampled load parsed
+struct StratumSample {
+    qint64 lines = 0;
+    qint64 sampled = 0;
+};
+using StratumCounts = QHash<QString, QHash<QString, StratumSample>>; // Map -> Mode
 
 class DataLoader {
 public:
     DataLoader(QString filepath, const AppConfig& config);
 
+    // Also index every tagged player's brawlers and results (see PlayerIndex). Call before loadAndProcess.
+    void setBuildPlayerIndex(bool enabled);
+    // Start reading at this byte offset (a line boundary) instead of the beginning. With an offset,
+    // an unterminated last line is left for a later read, since the writer may still be appending it.
+    void setStartOffset(qint64 offset);
+    // Parse only a stratified random sample: 'fraction' of each map/mode's lines (at least
+    // MIN_SAMPLE_PER_STRATUM of them), found by a byte scan for the map and mode fields without
+    // parsing the JSON. 1.0 (default) parses every line.
+    void setSampleFraction(double fraction, quint32 seed = 1);
+    // Raw JSON is processed in batches of at most MemoryCapLoaderBuffersMB (estimated), so only the
+    // processed games grow with the file
     bool loadAndProcess();
 
     const QVector<ProcessedGame>& getProcessedGames() const;
     const QSet<QString>& getAllBrawlers() const;
     const QHash<QString, QSet<QString>>& getDiscoveredMapModes() const;
+    const PlayerIndex& getPlayerIndex() const; // Empty unless setBuildPlayerIndex(true)
+    // Byte offset just past the last complete line read; pass it to setStartOffset to continue
+    qint64 getEndOffset() const;
+    const QVector<quint64>& getBattleKeys() const; // battleKey() of each processed game, same order
+    const StratumCounts& getStrata() const; // Sampled loads only
+
+    // Identifies a battle however many of its players it was scraped for: battle time, map, mode
+    // and every player's tag and brawler
+    static quint64 battleKey(const QJsonObject& game);
 
 private:
     bool loadRawData();
-    void preprocessData();
-    QPair<QVector<PlayerData>, bool> extractTeamData(const QJsonValue& teamValue); // Use QJsonValue
+    QVector<QPair<qint64, int>> sampleLines(QFile& file); // (offset, line number) of the sampled lines, ascending
+    void parseRawLines(const QVector<QByteArray>& lines, const QVector<int>& lineNums); // Appends to m_rawGames
+    static std::optional<QJsonObject> parseRawLine(const QByteArray& line, int lineNum); // Thread-safe
+    void beginPreprocess();
+    void preprocessRawGames();
+    void finishPreprocess();
+    void updateMemoryCharge();
+    QPair<QVector<PlayerData>, bool> extractTeamData(const QJsonValue& teamValue, int teamSize); // Use QJsonValue
+    void recordPlayers(PlayerIndexBuilder& builder, const QJsonValue& teamValue, bool win) const;
 
     QString m_filepath;
     const AppConfig& m_config; // Store reference to config
 
-    QVector<QJsonObject> m_rawGames; // Store raw JSON objects initially
+    // Skipped and kept games over every batch
+    struct PreprocessCounts {
+        int rankIssues = 0;
+        int formatIssues = 0;
+        int missingPlayerTag = 0;
+        int processed = 0;
+    };
+
+    QVector<QJsonObject> m_rawGames; // Parsed lines not processed yet (one batch)
+    qint64 m_rawGamesRead = 0;
+    qint64 m_rawBytes = 0;           // Estimated heap of m_rawGames' objects
+    qint64 m_rawBytesCap = 0;        // 0: the whole file is one batch
+    qint64 m_processedBytes = 0;     // Heap owned by the processed games' strings and teams
+    PreprocessCounts m_counts;
+    PlayerIndexBuilder m_playerIndexBuilder;
     QVector<ProcessedGame> m_processedGames;
     QSet<QString> m_allBrawlers;
     QHash<QString, QSet<QString>> m_discoveredMapModes;
+    QVector<quint64> m_battleKeys;
+    bool m_buildPlayerIndex = false;
+    qint64 m_startOffset = 0;
+    qint64 m_endOffset = 0;
+    double m_sampleFraction = 1.0;
+    quint32 m_sampleSeed = 1;
+    StratumCounts m_strata;
+    PlayerIndex m_playerIndex;
+    MemoryCharge m_memoryCharge{MemorySubsystem::LoaderBuffers};
 };
 
 #endif // DATALOADER_H
\ No newline at end of file
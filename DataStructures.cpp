@@ -22,6 +22,27 @@ QDataStream &operator>>(QDataStream &in, MapModeStatsData &stats) {
     return in;
 }
 
+QDataStream &operator<<(QDataStream &out, const MapModeErrorData &errors) {
+    out << errors.brawlerStats << errors.synergyStats << errors.counterStats;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, MapModeErrorData &errors) {
+    in >> errors.brawlerStats >> errors.synergyStats >> errors.counterStats;
+    return in;
+}
+
+
+// --- Serialization for PackSource ---
+QDataStream &operator<<(QDataStream &out, const PackSource &source) {
+    out << source.name << source.cacheCreationTime << source.sampleFraction << source.sampledGames;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, PackSource &source) {
+    in >> source.name >> source.cacheCreationTime >> source.sampleFraction >> source.sampledGames;
+    return in;
+}
 
 // --- Serialization for CacheMetadata ---
 QDataStream &operator<<(QDataStream &out, const CacheMetadata &meta) {
@@ -42,4 +63,52 @@ QDataStream &operator<<(QDataStream &out, const CacheData &data) {
 QDataStream &operator>>(QDataStream &in, CacheData &data) {
     in >> data.stats >> data.allBrawlers >> data.discoveredMapModes >> data.metadata;
     return in;
-}
\ No newline at end of file
+}
+
+
+// --- Serialization for Map Sweep results ---
+QDataStream &operator<<(QDataStream &out, const SweepEntry &entry) {
+    out << entry.label << entry.score << entry.tier;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, SweepEntry &entry) {
+    in >> entry.label >> entry.score >> entry.tier;
+    return in;
+}
+
+QDataStream &operator<<(QDataStream &out, const MapSweepResult &result) {
+    out << result.mapName << result.modeName << result.mapScore << result.entries;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, MapSweepResult &result) {
+    in >> result.mapName >> result.modeName >> result.mapScore >> result.entries;
+    return in;
+}
+
+QDataStream &operator<<(QDataStream &out, const SweepReport &report) {
+    out << static_cast<qint32>(report.kind) << report.paramsKey << report.packVersion << report.maps << report.elapsedMs;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, SweepReport &report) {
+    qint32 kind = 0;
+    in >> kind >> report.paramsKey >> report.packVersion >> report.maps >> report.elapsedMs;
+    report.kind = static_cast<SweepKind>(kind);
+    report.fromCache = false;
+    return in;
+}
+
+// --- Serialization for PolicyMapModel ---
+QDataStream &operator<<(QDataStream &out, const PolicyMapModel &model) {
+    out << model.brawlerBias << model.synergyWeight << model.counterWeight << model.counteredWeight
+        << model.positions << model.crossEntropy << model.top1Agreement;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, PolicyMapModel &model) {
+    in >> model.brawlerBias >> model.synergyWeight >> model.counterWeight >> model.counteredWeight
+       >> model.positions >> model.crossEntropy >> model.top1Agreement;
+    return in;
+}
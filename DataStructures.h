@@ -8,7 +8,9 @@
 #include <QDataStream>
 #include <limits>
 #include <atomic>
+#include <memory>
 #include <QMetaType>
+#include "PerfectHash.h"
 
 // --- Basic Stats Structs ---
 
@@ -17,16 +19,18 @@ void atomic_add_double(std::atomic<double>& atomic_var, double value);
 struct BrawlerStats {
     std::atomic<double> wins{0.0};
     std::atomic<double> plays{0.0};
+    double score = 0.5; // Final score the accessors return, set once the counts are complete
 
     // Need default constructor for QHash/maps
     BrawlerStats() = default;
     // Copy constructor needed for atomic members
-    BrawlerStats(const BrawlerStats& other) : wins(other.wins.load()), plays(other.plays.load()) {}
+    BrawlerStats(const BrawlerStats& other) : wins(other.wins.load()), plays(other.plays.load()), score(other.score) {}
     // Assignment operator needed for atomic members
     BrawlerStats& operator=(const BrawlerStats& other) {
         if (this != &other) {
             wins.store(other.wins.load());
             plays.store(other.plays.load());
+            score = other.score;
         }
         return *this;
     }
@@ -42,12 +46,23 @@ QDataStream &operator<<(QDataStream &out, const BrawlerStatsData &stats);
 QDataStream &operator>>(QDataStream &in, BrawlerStatsData &stats);
 
 
+// Mode-wide or global aggregate of every map's counts, which a map/mode's cells are shrunk toward
+// (StatsCalculator, FallbackShrinkage). Rates are final: already blended with the parent level.
+struct FallbackTable {
+    QHash<QString, double> brawlerRate; // Blended raw win rate (the prior of the level below)
+    QHash<QString, double> winRate;     // As getWinRate returns it, with this level's pick rates
+    QHash<QString, double> synergy;     // Key: Sorted "Brawler1|Brawler2"
+    QHash<QString, double> counter;     // Key: "BrawlerUs|BrawlerThem"
+    std::shared_ptr<const FallbackTable> parent; // Global table of a mode table; keys missing here are read there
+};
+
 struct MapModeStats {
     // Use QHash for faster lookups, similar to Python dict
     QHash<QString, BrawlerStats> brawlerStats;
     QHash<QString, BrawlerStats> synergyStats; // Key: Sorted "Brawler1|Brawler2"
     QHash<QString, BrawlerStats> counterStats; // Key: "BrawlerUs|BrawlerThem"
     std::atomic<double> totalWeightedPlays{0.0};
+    std::shared_ptr<const FallbackTable> fallback; // Mode table for cells missing here; null when off
 
     // Default constructor
     MapModeStats() = default;
@@ -68,6 +83,17 @@ struct MapModeStatsData {
 QDataStream &operator<<(QDataStream &out, const MapModeStatsData &stats);
 QDataStream &operator>>(QDataStream &in, MapModeStatsData &stats);
 
+// Standard errors of the raw weighted win rates (wins / plays) of a sampled pack's cells,
+// keyed like MapModeStatsData
+struct MapModeErrorData {
+    QHash<QString, float> brawlerStats;
+    QHash<QString, float> synergyStats;
+    QHash<QString, float> counterStats;
+};
+
+QDataStream &operator<<(QDataStream &out, const MapModeErrorData &errors);
+QDataStream &operator>>(QDataStream &in, MapModeErrorData &errors);
+
 
 // --- Heuristic Structs ---
 
@@ -79,6 +105,16 @@ struct HeuristicWeights {
 };
 
 Q_DECLARE_METATYPE(HeuristicWeights);
+
+// Win-probability model weights (see predictWinProbabilityModel); defaults match the original hand-picked values
+struct EvalWeights {
+    double winRate = 0.5;
+    double synergy = 0.3;
+    double counter = 0.4;
+    double peakCounter = 0.2; // Previously shared with HeuristicWeights::pickRate
+    double slope = 2.0;       // Logistic steepness
+};
+
 struct HeuristicScoreComponents {
     double totalScore = -std::numeric_limits<double>::infinity();
     double winRate = 0.0;
@@ -103,6 +139,65 @@ struct MCTSResult {
     MCTSResult(QString m, int v, double wr) : move(m), visits(v), winRate(wr) {}
 };
 
+// --- Comp Finder Structs ---
+struct CompResult {
+    QVector<QString> team;       // Our three brawlers (locked picks first)
+    double winProbability = 0.5; // predictWinProbabilityModel for our team vs the enemy team
+};
+
+struct CompSearchResult {
+    QVector<CompResult> topComps; // Sorted by win probability, best first
+    long long teamsEvaluated = 0; // Complete teams scored
+    long long branchesPruned = 0; // Partial teams cut by the bound
+    qint64 elapsedUs = 0;
+};
+
+// --- Map Sweep Structs ---
+enum class SweepKind { TierList = 0, TeamStrength = 1, Mcts = 2 };
+
+struct SweepEntry {
+    QString label;      // Brawler (tier list / MCTS) or comma-joined enemy team (team strength)
+    double score = 0.0; // Heuristic total, enemy win probability or MCTS win rate
+    QString tier;       // S/A/B/C/D for tier lists, empty otherwise
+};
+
+struct MapSweepResult {
+    QString mapName;
+    QString modeName;
+    double mapScore = 0.0;       // Ranking key across maps (higher is better for the queried pool/team)
+    QVector<SweepEntry> entries; // Sorted best first
+};
+
+struct SweepReport {
+    SweepKind kind = SweepKind::TierList;
+    QString paramsKey;             // Canonical parameters (cache key together with packVersion)
+    qint64 packVersion = 0;
+    QVector<MapSweepResult> maps;  // Sorted by mapScore, best first
+    qint64 elapsedMs = 0;
+    bool fromCache = false;        // Runtime only, not serialized
+};
+QDataStream &operator<<(QDataStream &out, const SweepEntry &entry);
+QDataStream &operator>>(QDataStream &in, SweepEntry &entry);
+QDataStream &operator<<(QDataStream &out, const MapSweepResult &result);
+QDataStream &operator>>(QDataStream &in, MapSweepResult &result);
+QDataStream &operator<<(QDataStream &out, const SweepReport &report);
+QDataStream &operator>>(QDataStream &in, SweepReport &report);
+
+// --- Distilled Policy Structs ---
+// Per map/mode linear pick policy: logit(b) = bias[b] + synergy * avg(syn(b, own) - 0.5)
+//   + counter * avg(ctr(b, opp) - 0.5) + countered * avg(ctr(opp, b) - 0.5)
+struct PolicyMapModel {
+    QHash<QString, double> brawlerBias;
+    double synergyWeight = 0.0;
+    double counterWeight = 0.0;
+    double counteredWeight = 0.0;
+    int positions = 0;           // Training positions
+    double crossEntropy = 0.0;   // Final loss against the MCTS visit distributions
+    double top1Agreement = 0.0;  // Fraction of positions where the policy's best move is MCTS's most visited
+};
+QDataStream &operator<<(QDataStream &out, const PolicyMapModel &model);
+QDataStream &operator>>(QDataStream &in, PolicyMapModel &model);
+
 // --- Processed Game Data (Example) ---
 struct PlayerData {
     QString brawlerName;
@@ -120,10 +215,29 @@ struct ProcessedGame {
 // --- Cache Data Structure ---
 // Use QHash for stats as it's efficient for lookups
 using StatsContainer = QHash<QString, QHash<QString, MapModeStatsData>>;
+using ErrorContainer = QHash<QString, QHash<QString, MapModeErrorData>>;
+
+// A pack that went into a merged pack ('merge-packs'); its creation time identifies it
+struct PackSource {
+    QString name; // File name at merge time
+    qint64 cacheCreationTime = 0;
+    double sampleFraction = 1.0;
+    qint64 sampledGames = 0;
+};
+QDataStream &operator<<(QDataStream &out, const PackSource &source);
+QDataStream &operator>>(QDataStream &in, PackSource &source);
 
 struct CacheMetadata {
     qint64 cacheCreationTime = 0;
     // Add config parameters if strict validation is needed later
+    // Approximate packs ('build-pack --sample'): counts are estimated from this fraction of the
+    // games. Stored by CacheUtils (pack version 3), not by operator<<.
+    double sampleFraction = 1.0;
+    qint64 sampledGames = 0;
+    // Packs built from raw games this merged pack sums, empty otherwise (pack version 4)
+    QVector<PackSource> mergedFrom;
+
+    bool isApproximate() const { return sampleFraction < 1.0; }
 };
 QDataStream &operator<<(QDataStream &out, const CacheMetadata &meta);
 QDataStream &operator>>(QDataStream &in, CacheMetadata &meta);
@@ -134,6 +248,8 @@ struct CacheData {
     QSet<QString> allBrawlers;
     QHash<QString, QSet<QString>> discoveredMapModes;
     CacheMetadata metadata;
+    NameIndex names; // Perfect hashes over allBrawlers and the map/mode names (pack version 2+)
+    ErrorContainer errors; // Sampling (approximate packs) or bootstrap errors (pack version 3+)
 };
 
 QDataStream &operator<<(QDataStream &out, const CacheData &data);
@@ -151,7 +267,8 @@ inline QString counterPairKey(const QString& bUs, const QString& bThem) {
 
 // Explicit implementations for copy constructor/assignment for MapModeStats
 inline MapModeStats::MapModeStats(const MapModeStats& other)
-    : totalWeightedPlays(other.totalWeightedPlays.load())
+    : totalWeightedPlays(other.totalWeightedPlays.load()),
+      fallback(other.fallback)
 {
     // Deep copy the maps, handling atomic BrawlerStats
     for (auto it = other.brawlerStats.constBegin(); it != other.brawlerStats.constEnd(); ++it) {
@@ -168,6 +285,7 @@ inline MapModeStats::MapModeStats(const MapModeStats& other)
 inline MapModeStats& MapModeStats::operator=(const MapModeStats& other) {
     if (this != &other) {
         totalWeightedPlays.store(other.totalWeightedPlays.load());
+        fallback = other.fallback;
         brawlerStats.clear();
         synergyStats.clear();
         counterStats.clear();
@@ -0,0 +1,17 @@
+#include "DraftFormat.h"
+
+int teamSizeForMode(const QString& modeName) {
+    if (modeName.endsWith("5v5", Qt::CaseInsensitive)) {
+        return FiveFormat::teamSize;
+    }
+    if (modeName.startsWith("duo", Qt::CaseInsensitive) || modeName.contains("2v2", Qt::CaseInsensitive)) {
+        return DuoFormat::teamSize;
+    }
+    return TrioFormat::teamSize;
+}
+
+DraftFormatInfo draftFormatForMode(const QString& modeName) {
+    return dispatchTeamSize(teamSizeForMode(modeName), [](auto format) {
+        return DraftFormatInfo::of<decltype(format)>();
+    });
+}
@@ -0,0 +1,82 @@
+#ifndef DRAFTFORMAT_H
+#define DRAFTFORMAT_H
+
+#include <QString>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// Compile-time description of a draft: 'TeamSize' picks per side in snake order
+// (team1, team2, team2, team1, team1, team2, ...) and up to one ban per pick.
+template<int TeamSize>
+struct DraftFormat {
+    static_assert(TeamSize >= 2 && TeamSize <= 5, "Unsupported team size");
+
+    static constexpr int teamSize = TeamSize;
+    static constexpr int totalPicks = 2 * TeamSize;
+    static constexpr int maxBans = 2 * TeamSize;
+    static constexpr int pairsPerTeam = TeamSize * (TeamSize - 1) / 2;
+    static constexpr int matchups = TeamSize * TeamSize;
+
+    // Side (1 or 2) making the 1-based pick 'pickNumber'
+    static constexpr int sideForPick(int pickNumber) { return (pickNumber / 2) % 2 == 0 ? 1 : 2; }
+};
+
+using DuoFormat = DraftFormat<2>;
+using TrioFormat = DraftFormat<3>;   // Ranked 3v3, the default
+using FiveFormat = DraftFormat<5>;
+
+static_assert(TrioFormat::sideForPick(1) == 1 && TrioFormat::sideForPick(2) == 2 && TrioFormat::sideForPick(3) == 2 &&
+              TrioFormat::sideForPick(4) == 1 && TrioFormat::sideForPick(5) == 1 && TrioFormat::sideForPick(6) == 2,
+              "3v3 pick order must stay 1-2-2-1-1-2");
+
+// Runtime copy of a DraftFormat, carried by DraftState so one state type serves every format
+struct DraftFormatInfo {
+    int teamSize = TrioFormat::teamSize;
+    int totalPicks = TrioFormat::totalPicks;
+    int maxBans = TrioFormat::maxBans;
+
+    template<typename Format>
+    static constexpr DraftFormatInfo of() { return {Format::teamSize, Format::totalPicks, Format::maxBans}; }
+
+    int sideForPick(int pickNumber) const { return (pickNumber / 2) % 2 == 0 ? 1 : 2; }
+};
+
+// Team size played in a game mode: "...5V5" modes are 5v5, duo/2v2 modes are 2v2, everything else 3v3
+int teamSizeForMode(const QString& modeName);
+DraftFormatInfo draftFormatForMode(const QString& modeName);
+
+inline bool isSupportedTeamSize(int teamSize) {
+    return teamSize == DuoFormat::teamSize || teamSize == TrioFormat::teamSize || teamSize == FiveFormat::teamSize;
+}
+
+// Calls fn(DraftFormat<N>{}) for the supported team sizes; throws std::invalid_argument otherwise.
+// All branches must return the same type.
+template<typename Fn>
+decltype(auto) dispatchTeamSize(int teamSize, Fn&& fn) {
+    switch (teamSize) {
+        case DuoFormat::teamSize: return fn(DuoFormat{});
+        case TrioFormat::teamSize: return fn(TrioFormat{});
+        case FiveFormat::teamSize: return fn(FiveFormat{});
+        default:
+            throw std::invalid_argument("Unsupported team size: " + std::to_string(teamSize));
+    }
+}
+
+// --- Unrolled Loops ---
+
+namespace DraftFormatDetail {
+template<typename Fn, int... I>
+inline void unrolled(Fn& fn, std::integer_sequence<int, I...>) {
+    (fn(std::integral_constant<int, I>{}), ...);
+}
+} // namespace DraftFormatDetail
+
+// fn(std::integral_constant<int, i>) for i in [0, N), expanded at compile time
+template<int N, typename Fn>
+inline void unrolledFor(Fn&& fn) {
+    DraftFormatDetail::unrolled(fn, std::make_integer_sequence<int, N>{});
+}
+
+#endif // DRAFTFORMAT_H
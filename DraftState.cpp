@@ -6,7 +6,7 @@
 DraftState::DraftState(QString map, QString mode, const QSet<QString>& allBrawlers,
                        QSet<QString> bans, QVector<QString> team1Picks,
                        QVector<QString> team2Picks, QString turn, int pickNumber)
-    : m_map(map), m_mode(mode), m_masterBrawlerList(allBrawlers),
+    : m_map(map), m_mode(mode), m_format(draftFormatForMode(mode)), m_masterBrawlerList(allBrawlers),
       m_bans(bans), m_team1Picks(team1Picks), m_team2Picks(team2Picks),
       m_turn(turn), m_pickNumber(pickNumber)
 {
@@ -22,22 +22,25 @@ DraftState::DraftState(QString map, QString mode, const QSet<QString>& allBrawle
 
 QString DraftState::mapName() const { return m_map; }
 QString DraftState::modeName() const { return m_mode; }
+const DraftFormatInfo& DraftState::format() const { return m_format; }
 const QSet<QString>& DraftState::bans() const { return m_bans; }
 const QVector<QString>& DraftState::team1Picks() const { return m_team1Picks; }
 const QVector<QString>& DraftState::team2Picks() const { return m_team2Picks; }
 QString DraftState::currentTurn() const { return m_turn; }
 int DraftState::currentPickNumber() const { return m_pickNumber; }
 const QSet<QString>& DraftState::availableBrawlers() const { return m_available; }
+const QSet<QString>& DraftState::masterBrawlerList() const { return m_masterBrawlerList; }
 
 
 bool DraftState::isComplete() const {
-    // Draft is complete after 6 picks (pickNumber becomes 7)
-    return m_pickNumber > 6;
+    // Draft is complete after every pick is made (pickNumber becomes 7 in 3v3)
+    return m_pickNumber > m_format.totalPicks;
 }
 
 bool DraftState::isValid() const {
     // Basic sanity checks
-    if (m_team1Picks.size() > 3 || m_team2Picks.size() > 3 || m_bans.size() > 6) {
+    if (m_team1Picks.size() > m_format.teamSize || m_team2Picks.size() > m_format.teamSize ||
+        m_bans.size() > m_format.maxBans) {
         return false;
     }
     // Check for duplicate picks/bans
@@ -72,45 +75,39 @@ DraftState DraftState::applyMove(const QString& brawler) const {
 
     // Add the pick to the correct team
     if (m_turn == "team1") {
-        if (nextTeam1.size() >= 3) throw std::logic_error("Illegal move: Team 1 already has 3 picks.");
+        if (nextTeam1.size() >= m_format.teamSize) throw std::logic_error("Illegal move: Team 1 is already full.");
         nextTeam1.append(brawler);
     } else if (m_turn == "team2") {
-         if (nextTeam2.size() >= 3) throw std::logic_error("Illegal move: Team 2 already has 3 picks.");
+         if (nextTeam2.size() >= m_format.teamSize) throw std::logic_error("Illegal move: Team 2 is already full.");
         nextTeam2.append(brawler);
     } else {
          throw std::logic_error("Illegal move: Invalid turn '" + m_turn.toStdString() + "'.");
     }
 
-    // Determine the next turn based on standard draft order (1-2-2-1-1-?)
+    // Determine the next turn from the snake draft order (1-2-2-1-1-2 in 3v3, see DraftFormat)
     // Pick 1 (by T1) -> T2's turn (Pick 2)
     // Pick 2 (by T2) -> T2's turn (Pick 3)
     // Pick 3 (by T2) -> T1's turn (Pick 4)
-    // Pick 4 (by T1) -> T1's turn (Pick 5)
-    // Pick 5 (by T1) -> T2's turn (Pick 6)
-    // Pick 6 (by T2) -> Complete (Turn becomes empty/null, Pick 7)
-    switch (m_pickNumber) {
-        case 1: nextTurn = "team2"; break;
-        case 2: nextTurn = "team2"; break; // Stays T2 for pick 3
-        case 3: nextTurn = "team1"; break;
-        case 4: nextTurn = "team1"; break; // Stays T1 for pick 5
-        case 5: nextTurn = "team2"; break;
-        case 6: nextTurn = ""; break;      // Draft complete after pick 6
-        default:
-             qWarning() << "Unexpected pick number in applyMove:" << m_pickNumber;
-             nextTurn = ""; // Treat as complete
-             break;
+    // ...
+    // Last pick -> Complete (Turn becomes empty/null)
+    if (nextPickNumber > m_format.totalPicks) {
+        nextTurn = ""; // Draft complete after the last pick
+    } else {
+        nextTurn = m_format.sideForPick(nextPickNumber) == 1 ? "team1" : "team2";
     }
 
     // Create and return the new state
-    return DraftState(m_map, m_mode, m_masterBrawlerList, nextBans, nextTeam1, nextTeam2, nextTurn, nextPickNumber);
+    DraftState next(m_map, m_mode, m_masterBrawlerList, nextBans, nextTeam1, nextTeam2, nextTurn, nextPickNumber);
+    next.m_pools = m_pools;
+    return next;
 }
 
 
 DraftState DraftState::applyBan(const QString& brawler) const {
      // Bans usually happen before picks, this assumes banning is allowed during the picking phase if needed
      // Or that this state represents a pre-pick ban phase. Modify logic if bans are fixed upfront.
-    if (m_bans.size() >= 6) {
-         throw std::logic_error("Illegal ban: Maximum number of bans (6) already reached.");
+    if (m_bans.size() >= m_format.maxBans) {
+         throw std::logic_error("Illegal ban: Maximum number of bans (" + std::to_string(m_format.maxBans) + ") already reached.");
     }
      if (!m_available.contains(brawler)) { // Can only ban available brawlers
          throw std::invalid_argument("Illegal ban: Brawler '" + brawler.toStdString() + "' is not available for banning.");
@@ -120,7 +117,15 @@ DraftState DraftState::applyBan(const QString& brawler) const {
     nextBans.insert(brawler);
 
     // Ban does not advance pick number or change turn in this model
-    return DraftState(m_map, m_mode, m_masterBrawlerList, nextBans, m_team1Picks, m_team2Picks, m_turn, m_pickNumber);
+    DraftState next(m_map, m_mode, m_masterBrawlerList, nextBans, m_team1Picks, m_team2Picks, m_turn, m_pickNumber);
+    next.m_pools = m_pools;
+    return next;
+}
+
+DraftState DraftState::withTeamPools(std::shared_ptr<const TeamPools> pools) const {
+    DraftState next = *this;
+    next.m_pools = (pools && (!pools->team1.isEmpty() || !pools->team2.isEmpty())) ? std::move(pools) : nullptr;
+    return next;
 }
 
 
@@ -128,12 +133,30 @@ QVector<QString> DraftState::getLegalMoves() const {
     if (isComplete()) {
         return {}; // No moves if complete
     }
-    // Legal moves are simply the currently available brawlers
-    QVector<QString> legal = QVector<QString>::fromList(m_available.values()); // Convert QSet to QVector
+    // Legal moves are the currently available brawlers, within the side's pool if it has one
+    QVector<QString> legal;
+    const QSet<QString>* pool = m_pools ? &m_pools->forTurn(m_turn) : nullptr;
+    if (pool && !pool->isEmpty()) {
+        for (const QString& brawler : *pool) {
+            if (m_available.contains(brawler)) legal.append(brawler);
+        }
+    }
+    if (legal.isEmpty()) legal = QVector<QString>::fromList(m_available.values()); // Convert QSet to QVector
     std::sort(legal.begin(), legal.end()); // Sort alphabetically for consistency
     return legal;
 }
 
+QVector<QString> DraftState::getLegalMoves(const QSet<QString>* activeRoster) const {
+    QVector<QString> legal = getLegalMoves();
+    if (!activeRoster) return legal;
+    QVector<QString> active;
+    active.reserve(legal.size());
+    for (const QString& brawler : legal) {
+        if (activeRoster->contains(brawler)) active.append(brawler); // Stays sorted
+    }
+    return active.isEmpty() ? legal : active; // Empty: active roster exhausted by picks and bans
+}
+
 
 QString DraftState::toString() const {
     QString t1Str = m_team1Picks.join(", ");
@@ -142,11 +165,12 @@ QString DraftState::toString() const {
     std::sort(banList.begin(), banList.end()); // Sort for consistent output
     QString banStr = QStringList(banList).join(", "); // Use QStringList helper
 
-    return QString("DraftState(Map: %1, Mode: %2, T1: [%3], T2: [%4], Bans: {%5}, Turn: %6, Pick: %7, Avail: %8)")
+    return QString("DraftState(Map: %1, Mode: %2 (%9v%9), T1: [%3], T2: [%4], Bans: {%5}, Turn: %6, Pick: %7, Avail: %8)")
         .arg(m_map).arg(m_mode).arg(t1Str).arg(t2Str).arg(banStr)
         .arg(m_turn.isEmpty() ? "Complete" : m_turn)
         .arg(m_pickNumber)
-        .arg(m_available.size());
+        .arg(m_available.size())
+        .arg(m_format.teamSize);
 }
 
 
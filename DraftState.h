@@ -8,6 +8,17 @@
 #include <QMetaType>
 
 #include "DataStructures.h" // Not directly needed, but good practice
+#include "DraftFormat.h"
+#include <memory>
+
+// Brawlers each side's players can pick (see PlayerIndex); an empty set leaves that side
+// unrestricted. Only picks are restricted: bans and the other side's picks are not.
+struct TeamPools {
+    QSet<QString> team1;
+    QSet<QString> team2;
+
+    const QSet<QString>& forTurn(const QString& turn) const { return turn == "team1" ? team1 : team2; }
+};
 
 class DraftState {
 public:
@@ -22,12 +33,15 @@ public:
     // State properties
     QString mapName() const;
     QString modeName() const;
+    const DraftFormatInfo& format() const; // Team size, pick count and ban cap, from the mode
     const QSet<QString>& bans() const;
     const QVector<QString>& team1Picks() const;
     const QVector<QString>& team2Picks() const;
     QString currentTurn() const;
     int currentPickNumber() const;
     const QSet<QString>& availableBrawlers() const; // Brawlers not picked or banned
+    const QSet<QString>& masterBrawlerList() const; // Full roster the draft was created with
+    const TeamPools* teamPools() const { return m_pools.get(); } // nullptr = unrestricted
 
     // State checks
     bool isComplete() const;
@@ -36,9 +50,16 @@ public:
     // Actions (return a *new* state)
     DraftState applyMove(const QString& brawler) const;
     DraftState applyBan(const QString& brawler) const;
+    // Same position, picks limited to the teams' pools from here on (carried by applyMove/applyBan)
+    DraftState withTeamPools(std::shared_ptr<const TeamPools> pools) const;
 
     // Get possible actions
-    QVector<QString> getLegalMoves() const; // Returns available brawlers sorted
+    // Available brawlers sorted; within the side to move's pool if it has one (all available if
+    // the pool is exhausted)
+    QVector<QString> getLegalMoves() const;
+    // Legal moves inside 'activeRoster' (sorted); all legal moves if it is null or none of them is
+    // in it. Picks and bans already made are part of the state and never pruned.
+    QVector<QString> getLegalMoves(const QSet<QString>* activeRoster) const;
 
     // String representation for debugging
     QString toString() const;
@@ -46,6 +67,7 @@ public:
 private:
     QString m_map;
     QString m_mode;
+    DraftFormatInfo m_format;
     QSet<QString> m_masterBrawlerList;
     QSet<QString> m_bans;
     QVector<QString> m_team1Picks;
@@ -53,6 +75,7 @@ private:
     QString m_turn; // "team1", "team2", or "" (empty/null if complete)
     int m_pickNumber; // 1-based index of the pick *about* to be made
     QSet<QString> m_available;
+    std::shared_ptr<const TeamPools> m_pools;
 
     void updateAvailable(); // Helper to recalculate available brawlers
 };
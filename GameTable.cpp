@@ -0,0 +1,55 @@
+#include "GameTable.h"
+#include <QDebug>
+
+GameTable::GameTable(const QVector<ProcessedGame>& games) {
+    m_mapIds.reserve(games.size());
+    m_modeIds.reserve(games.size());
+    m_winnerBrawlers.reserve(games.size() * TEAM_SIZE);
+    m_loserBrawlers.reserve(games.size() * TEAM_SIZE);
+    m_winnerRanks.reserve(games.size() * TEAM_SIZE);
+    m_loserRanks.reserve(games.size() * TEAM_SIZE);
+
+    int skipped = 0;
+    for (const ProcessedGame& game : games) {
+        if (game.winningTeamData.size() != TEAM_SIZE || game.losingTeamData.size() != TEAM_SIZE) {
+            skipped++;
+            continue;
+        }
+        m_mapIds.append(intern(game.map, m_mapNames, m_mapIdLookup));
+        m_modeIds.append(intern(game.mode, m_modeNames, m_modeIdLookup));
+        for (const PlayerData& player : game.winningTeamData) {
+            m_winnerBrawlers.append(intern(player.brawlerName, m_brawlerNames, m_brawlerIds));
+            m_winnerRanks.append(player.rank);
+        }
+        for (const PlayerData& player : game.losingTeamData) {
+            m_loserBrawlers.append(intern(player.brawlerName, m_brawlerNames, m_brawlerIds));
+            m_loserRanks.append(player.rank);
+        }
+    }
+    if (skipped > 0) qInfo() << "GameTable skipped" << skipped << "games without two full teams.";
+}
+
+int GameTable::intern(const QString& value, QVector<QString>& names, QHash<QString, int>& ids) {
+    auto it = ids.constFind(value);
+    if (it != ids.constEnd()) return it.value();
+    int id = names.size();
+    names.append(value);
+    ids.insert(value, id);
+    return id;
+}
+
+QVector<ProcessedGame> GameTable::rows(const QVector<int>& indices) const {
+    QVector<ProcessedGame> games;
+    games.reserve(indices.size());
+    for (int row : indices) {
+        ProcessedGame game;
+        game.map = m_mapNames[m_mapIds[row]];
+        game.mode = m_modeNames[m_modeIds[row]];
+        for (int i = row * TEAM_SIZE; i < (row + 1) * TEAM_SIZE; ++i) {
+            game.winningTeamData.append({m_brawlerNames[m_winnerBrawlers[i]], m_winnerRanks[i]});
+            game.losingTeamData.append({m_brawlerNames[m_loserBrawlers[i]], m_loserRanks[i]});
+        }
+        games.append(std::move(game));
+    }
+    return games;
+}
@@ -0,0 +1,56 @@
+#ifndef GAMETABLE_H
+#define GAMETABLE_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include "DataStructures.h"
+
+// Column-oriented, interned copy of the processed games, for bulk passes over every game
+// (tuning, resampling) without touching per-game QStrings. Only 3v3 games are kept.
+// Row r's players live at [r * TEAM_SIZE, (r + 1) * TEAM_SIZE) of the team columns.
+class GameTable {
+public:
+    static constexpr int TEAM_SIZE = 3;
+
+    GameTable() = default;
+    explicit GameTable(const QVector<ProcessedGame>& games);
+
+    int size() const { return m_mapIds.size(); }
+    bool isEmpty() const { return m_mapIds.isEmpty(); }
+
+    // --- Columns ---
+    const QVector<int>& mapIds() const { return m_mapIds; }
+    const QVector<int>& modeIds() const { return m_modeIds; }
+    const QVector<int>& winnerBrawlerIds() const { return m_winnerBrawlers; }
+    const QVector<int>& loserBrawlerIds() const { return m_loserBrawlers; }
+    const QVector<int>& winnerRanks() const { return m_winnerRanks; }
+    const QVector<int>& loserRanks() const { return m_loserRanks; }
+
+    // --- Dictionaries ---
+    const QVector<QString>& brawlerNames() const { return m_brawlerNames; }
+    const QVector<QString>& mapNames() const { return m_mapNames; }
+    const QVector<QString>& modeNames() const { return m_modeNames; }
+
+    // Materializes the given rows back into ProcessedGames (e.g. to build a StatsCalculator on a subset)
+    QVector<ProcessedGame> rows(const QVector<int>& indices) const;
+
+private:
+    static int intern(const QString& value, QVector<QString>& names, QHash<QString, int>& ids);
+
+    QVector<int> m_mapIds;
+    QVector<int> m_modeIds;
+    QVector<int> m_winnerBrawlers;
+    QVector<int> m_loserBrawlers;
+    QVector<int> m_winnerRanks;
+    QVector<int> m_loserRanks;
+
+    QVector<QString> m_brawlerNames;
+    QVector<QString> m_mapNames;
+    QVector<QString> m_modeNames;
+    QHash<QString, int> m_brawlerIds;
+    QHash<QString, int> m_mapIdLookup;
+    QHash<QString, int> m_modeIdLookup;
+};
+
+#endif // GAMETABLE_H
@@ -0,0 +1,403 @@
+#include "glizzydraft_c.h"
+#include "AppConfig.h"
+#include "CacheUtils.h"
+#include "CompactStats.h"
+#include "DraftFormat.h"
+#include "DraftState.h"
+#include "Heuristics.h"
+#include "MCTS.h"
+#include "StatsCalculator.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QDebug>
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+
+struct gd_engine {
+    struct MapEntry {
+        QByteArray map;   // UTF-8, for the C side
+        QByteArray mode;
+        QString mapName;  // For DraftState and MCTS
+        QString modeName;
+        const CompactMapModeTable* table = nullptr; // nullptr: no stats for the map/mode
+        DraftFormatInfo format;
+    };
+
+    std::unique_ptr<AppConfig> config;
+    std::shared_ptr<const CompactStats> compact;
+    std::unique_ptr<StatsCalculator> stats;
+    std::unique_ptr<MCTSManager> mcts;
+    HeuristicWeights weights;
+    EvalWeights evalWeights;
+    QSet<QString> allBrawlers;
+    QVector<QString> brawlerNames;       // By id (= compact roster position)
+    QVector<QByteArray> brawlerNamesUtf8;
+    QVector<gd_id> brawlersByName;       // Ids sorted by UTF-8 name, for lookups without allocating
+    QVector<MapEntry> maps;              // Sorted by (map, mode); the position is the id
+};
+
+namespace {
+
+thread_local std::string lastError;
+
+// CompactStats caps the roster at 65535 brawlers, so one bit per id fits on the stack (8 KB)
+using UsedBrawlers = std::bitset<65536>;
+
+int fail(int status, const QString& message) {
+    lastError = message.toStdString();
+    return status;
+}
+
+bool validBrawler(const gd_engine* engine, gd_id id) {
+    return id >= 0 && id < engine->brawlerNames.size();
+}
+
+bool validMap(const gd_engine* engine, gd_id id) {
+    return engine && id >= 0 && id < engine->maps.size();
+}
+
+double score(const QVector<quint16>& values, qsizetype index) {
+    return CompactFixed::decode(values[index]);
+}
+
+// Checks a draft's ids and that its pick counts are reachable in snake order. 'used' gets every
+// picked and banned brawler; returns the side to move (1 or 2), 0 if invalid.
+int checkDraft(const gd_engine* engine, const gd_draft* draft, UsedBrawlers& used) {
+    if (!draft || !validMap(engine, draft->map) || draft->team1_count < 0 || draft->team2_count < 0 ||
+        draft->ban_count < 0 || (draft->team1_count && !draft->team1) || (draft->team2_count && !draft->team2) ||
+        (draft->ban_count && !draft->bans)) {
+        return 0;
+    }
+    const DraftFormatInfo& format = engine->maps[draft->map].format;
+    const int picks = draft->team1_count + draft->team2_count;
+    if (picks >= format.totalPicks || draft->ban_count > format.maxBans) return 0;
+    int team1Expected = 0;
+    for (int pick = 1; pick <= picks; ++pick) team1Expected += format.sideForPick(pick) == 1 ? 1 : 0;
+    if (draft->team1_count != team1Expected) return 0;
+
+    const gd_id* lists[] = {draft->team1, draft->team2, draft->bans};
+    const int counts[] = {draft->team1_count, draft->team2_count, draft->ban_count};
+    for (int list = 0; list < 3; ++list) {
+        for (int i = 0; i < counts[list]; ++i) {
+            gd_id id = lists[list][i];
+            if (!validBrawler(engine, id) || used.test(id)) return 0;
+            used.set(id);
+        }
+    }
+    return format.sideForPick(picks + 1);
+}
+
+// Same features as computeEvalFeaturesFor, read straight from the compact table by id
+EvalFeatures evalFeatures(const gd_engine* engine, const CompactMapModeTable* table,
+                          const gd_id* team1, const gd_id* team2, int teamSize) {
+    const qsizetype n = engine->brawlerNames.size();
+    auto winRate = [&](gd_id id) { return table ? score(table->winRate, id) : 0.5; };
+    auto synergy = [&](gd_id a, gd_id b) { return table ? score(table->synergy, a * n + b) : 0.5; };
+    auto counter = [&](gd_id us, gd_id them) { return table ? score(table->counter, us * n + them) : 0.5; };
+
+    EvalFeatures features;
+    double t1WinRate = 0.0, t2WinRate = 0.0;
+    double t1Synergy = 0.0, t2Synergy = 0.0;
+    for (int i = 0; i < teamSize; ++i) {
+        t1WinRate += winRate(team1[i]);
+        t2WinRate += winRate(team2[i]);
+        for (int j = i + 1; j < teamSize; ++j) {
+            t1Synergy += synergy(team1[i], team1[j]) - 0.5;
+            t2Synergy += synergy(team2[i], team2[j]) - 0.5;
+        }
+    }
+    const int pairs = teamSize * (teamSize - 1) / 2;
+    features.winRateDiff = (t1WinRate - t2WinRate) / teamSize;
+    features.synergyDiff = (t1Synergy - t2Synergy) / pairs;
+
+    double counterSum = 0.0;
+    double t1Peak = -1.0, t2Peak = -1.0;
+    for (int i = 0; i < teamSize; ++i) {
+        for (int j = 0; j < teamSize; ++j) {
+            double t1VsT2 = counter(team1[i], team2[j]) - 0.5;
+            counterSum += t1VsT2;
+            t1Peak = std::max(t1Peak, t1VsT2);
+            t2Peak = std::max(t2Peak, counter(team2[j], team1[i]) - 0.5);
+        }
+    }
+    features.counterAvg = counterSum / (teamSize * teamSize);
+    features.peakCounter = t1Peak - t2Peak;
+    return features;
+}
+
+} // namespace
+
+
+extern "C" {
+
+int gd_api_version(void) {
+    return GD_API_VERSION;
+}
+
+const char* gd_last_error(void) {
+    return lastError.c_str();
+}
+
+// --- Engine ---
+
+gd_engine* gd_engine_open(const char* pack_path, const char* config_path, int* status) {
+    auto report = [status](int code, const QString& message) -> gd_engine* {
+        fail(code, message);
+        if (status) *status = code;
+        return nullptr;
+    };
+    if (!pack_path) return report(GD_ERR_INVALID_ARGUMENT, "pack_path is NULL.");
+
+    try {
+        auto engine = std::make_unique<gd_engine>();
+        const QString packPath = QString::fromUtf8(pack_path);
+        const QString configPath = config_path ? QString::fromUtf8(config_path)
+                                               : QFileInfo(packPath).dir().filePath("draft_config.ini");
+        engine->config = std::make_unique<AppConfig>(configPath);
+
+        if (CompactStats::isCompactFile(packPath)) {
+            engine->compact = CompactStats::load(packPath);
+            if (!engine->compact) return report(GD_ERR_IO, "Failed to load compact stats pack: " + packPath);
+            engine->compact->checkSettings(*engine->config);
+        } else {
+            std::optional<CacheData> data = CacheUtils::loadCache(packPath);
+            if (!data.has_value()) return report(GD_ERR_IO, "Failed to load stats pack: " + packPath);
+            StatsCalculator full(*engine->config);
+            full.setStatsFromCacheData(data.value());
+            // Threshold 0 keeps every pair: only the 16-bit quantization differs from the full pack
+            engine->compact = CompactStats::build(full, data.value(), *engine->config, 0.0);
+        }
+        engine->stats = std::make_unique<StatsCalculator>(*engine->config);
+        engine->stats->setCompactStats(engine->compact);
+        engine->mcts = std::make_unique<MCTSManager>(*engine->stats, *engine->config);
+        engine->weights = engine->config->heuristicWeights();
+        engine->evalWeights = engine->config->evalWeights();
+
+        // --- Id tables ---
+        const QStringList& roster = engine->compact->roster();
+        for (gd_id id = 0; id < roster.size(); ++id) {
+            engine->brawlerNames.append(roster[id]);
+            engine->brawlerNamesUtf8.append(roster[id].toUtf8());
+            engine->brawlersByName.append(id);
+            engine->allBrawlers.insert(roster[id]);
+        }
+        std::sort(engine->brawlersByName.begin(), engine->brawlersByName.end(), [&](gd_id a, gd_id b) {
+            return std::strcmp(engine->brawlerNamesUtf8[a].constData(), engine->brawlerNamesUtf8[b].constData()) < 0;
+        });
+
+        const CacheData names = engine->compact->cacheData();
+        for (auto modeIt = names.discoveredMapModes.constBegin(); modeIt != names.discoveredMapModes.constEnd(); ++modeIt) {
+            for (const QString& mapName : modeIt.value()) {
+                gd_engine::MapEntry entry;
+                entry.map = mapName.toUtf8();
+                entry.mode = modeIt.key().toUtf8();
+                entry.mapName = mapName;
+                entry.modeName = modeIt.key();
+                entry.table = engine->compact->table(mapName, modeIt.key());
+                entry.format = draftFormatForMode(modeIt.key());
+                engine->maps.append(entry);
+            }
+        }
+        auto mapLess = [&](const gd_engine::MapEntry& a, const gd_engine::MapEntry& b) {
+            int byMap = std::strcmp(a.map.constData(), b.map.constData());
+            return byMap != 0 ? byMap < 0 : std::strcmp(a.mode.constData(), b.mode.constData()) < 0;
+        };
+        std::sort(engine->maps.begin(), engine->maps.end(), mapLess);
+
+        if (status) *status = GD_OK;
+        qInfo() << "libglizzydraft: opened" << packPath << "with" << roster.size() << "brawlers and"
+                << engine->maps.size() << "map/modes.";
+        return engine.release();
+    } catch (const std::exception& e) {
+        return report(GD_ERR_INTERNAL, QString::fromUtf8(e.what()));
+    }
+}
+
+void gd_engine_close(gd_engine* engine) {
+    delete engine;
+}
+
+int64_t gd_pack_version(const gd_engine* engine) {
+    return engine ? engine->compact->packVersion() : 0;
+}
+
+// --- Names and ids ---
+
+int32_t gd_brawler_count(const gd_engine* engine) {
+    return engine ? static_cast<int32_t>(engine->brawlerNames.size()) : 0;
+}
+
+gd_id gd_brawler_id(const gd_engine* engine, const char* name) {
+    if (!engine || !name) return -1;
+    auto it = std::lower_bound(engine->brawlersByName.constBegin(), engine->brawlersByName.constEnd(), name,
+                               [engine](gd_id id, const char* key) {
+                                   return std::strcmp(engine->brawlerNamesUtf8[id].constData(), key) < 0;
+                               });
+    if (it == engine->brawlersByName.constEnd() || std::strcmp(engine->brawlerNamesUtf8[*it].constData(), name) != 0) {
+        return -1;
+    }
+    return *it;
+}
+
+const char* gd_brawler_name(const gd_engine* engine, gd_id brawler) {
+    return engine && validBrawler(engine, brawler) ? engine->brawlerNamesUtf8[brawler].constData() : nullptr;
+}
+
+int32_t gd_map_count(const gd_engine* engine) {
+    return engine ? static_cast<int32_t>(engine->maps.size()) : 0;
+}
+
+gd_id gd_map_id(const gd_engine* engine, const char* map, const char* mode) {
+    if (!engine || !map || !mode) return -1;
+    auto it = std::lower_bound(engine->maps.constBegin(), engine->maps.constEnd(), map,
+                               [mode](const gd_engine::MapEntry& entry, const char* key) {
+                                   int byMap = std::strcmp(entry.map.constData(), key);
+                                   return byMap != 0 ? byMap < 0 : std::strcmp(entry.mode.constData(), mode) < 0;
+                               });
+    if (it == engine->maps.constEnd() || std::strcmp(it->map.constData(), map) != 0 ||
+        std::strcmp(it->mode.constData(), mode) != 0) {
+        return -1;
+    }
+    return static_cast<gd_id>(it - engine->maps.constBegin());
+}
+
+const char* gd_map_name(const gd_engine* engine, gd_id map) {
+    return validMap(engine, map) ? engine->maps[map].map.constData() : nullptr;
+}
+
+const char* gd_map_mode(const gd_engine* engine, gd_id map) {
+    return validMap(engine, map) ? engine->maps[map].mode.constData() : nullptr;
+}
+
+int32_t gd_map_team_size(const gd_engine* engine, gd_id map) {
+    return validMap(engine, map) ? engine->maps[map].format.teamSize : 0;
+}
+
+// --- Queries ---
+
+int gd_heuristic_scores(const gd_engine* engine, const gd_draft* draft, float* scores, int32_t capacity) {
+    if (!engine || !scores) return fail(GD_ERR_INVALID_ARGUMENT, "engine or scores is NULL.");
+    const qsizetype n = engine->brawlerNames.size();
+    if (capacity < n) return fail(GD_ERR_BUFFER_TOO_SMALL, QString("Scores need %1 entries.").arg(n));
+
+    UsedBrawlers used;
+    int side = checkDraft(engine, draft, used);
+    if (side == 0) return fail(GD_ERR_INVALID_ARGUMENT, "Invalid draft (ids, duplicates or pick counts).");
+
+    const CompactMapModeTable* table = engine->maps[draft->map].table;
+    const gd_id* own = side == 1 ? draft->team1 : draft->team2;
+    const int ownCount = side == 1 ? draft->team1_count : draft->team2_count;
+    const gd_id* opponents = side == 1 ? draft->team2 : draft->team1;
+    const int opponentCount = side == 1 ? draft->team2_count : draft->team1_count;
+    const HeuristicWeights& w = engine->weights;
+
+    // Same components as suggestPickHeuristic
+    for (qsizetype id = 0; id < n; ++id) {
+        if (used.test(id)) {
+            scores[id] = std::numeric_limits<float>::quiet_NaN();
+            continue;
+        }
+        double winRate = table ? score(table->winRate, id) : 0.5;
+        double total = w.winRate * (winRate - 0.5);
+        if (ownCount > 0) {
+            double synergy = 0.0;
+            for (int i = 0; i < ownCount; ++i) synergy += (table ? score(table->synergy, id * n + own[i]) : 0.5) - 0.5;
+            total += w.synergy * synergy / ownCount;
+        }
+        if (opponentCount > 0) {
+            double counter = 0.0;
+            for (int i = 0; i < opponentCount; ++i) counter += (table ? score(table->counter, id * n + opponents[i]) : 0.5) - 0.5;
+            total += w.counter * counter / opponentCount;
+        }
+        total += w.pickRate * (table && table->hasPlays ? score(table->pickRate, id) : 0.0);
+        scores[id] = static_cast<float>(total);
+    }
+    return GD_OK;
+}
+
+int gd_win_probability_batch(const gd_engine* engine, gd_id map, const gd_id* team1_ids, const gd_id* team2_ids,
+                             int32_t count, double* probabilities) {
+    if (!validMap(engine, map) || count < 0 || (count > 0 && (!team1_ids || !team2_ids || !probabilities))) {
+        return fail(GD_ERR_INVALID_ARGUMENT, "Invalid engine, map, count or buffer.");
+    }
+    const gd_engine::MapEntry& entry = engine->maps[map];
+    const int teamSize = entry.format.teamSize;
+    for (int32_t d = 0; d < count; ++d) {
+        const gd_id* team1 = team1_ids + qsizetype(d) * teamSize;
+        const gd_id* team2 = team2_ids + qsizetype(d) * teamSize;
+        for (int i = 0; i < teamSize; ++i) {
+            if (!validBrawler(engine, team1[i]) || !validBrawler(engine, team2[i])) {
+                return fail(GD_ERR_INVALID_ARGUMENT, QString("Unknown brawler id in draft %1.").arg(d));
+            }
+        }
+        probabilities[d] = predictWinProbabilityFromFeatures(evalFeatures(engine, entry.table, team1, team2, teamSize),
+                                                             engine->evalWeights);
+    }
+    return GD_OK;
+}
+
+// --- Search ---
+
+int gd_search(const gd_engine* engine, const gd_draft* draft, double seconds, int32_t threads, double report_seconds,
+              gd_search_callback callback, void* user_data, gd_move_result* moves, int32_t capacity, int32_t* move_count) {
+    if (!engine || !moves || !move_count || capacity < 0 || !(seconds > 0.0)) {
+        return fail(GD_ERR_INVALID_ARGUMENT, "Invalid engine, time or output buffer.");
+    }
+    *move_count = 0;
+    try {
+        UsedBrawlers used;
+        int side = checkDraft(engine, draft, used);
+        if (side == 0) return fail(GD_ERR_INVALID_ARGUMENT, "Invalid draft (ids, duplicates or pick counts).");
+
+        const gd_engine::MapEntry& entry = engine->maps[draft->map];
+        QVector<QString> team1, team2;
+        QSet<QString> bans;
+        for (int i = 0; i < draft->team1_count; ++i) team1.append(engine->brawlerNames[draft->team1[i]]);
+        for (int i = 0; i < draft->team2_count; ++i) team2.append(engine->brawlerNames[draft->team2[i]]);
+        for (int i = 0; i < draft->ban_count; ++i) bans.insert(engine->brawlerNames[draft->bans[i]]);
+        DraftState root(entry.mapName, entry.modeName, engine->allBrawlers, bans, team1, team2,
+                        side == 1 ? "team1" : "team2", draft->team1_count + draft->team2_count + 1);
+
+        QVector<double> checkpoints;
+        if (report_seconds > 0.0) {
+            for (double t = report_seconds; t < seconds; t += report_seconds) checkpoints.append(t);
+        }
+        checkpoints.append(seconds);
+
+        // Most visited first into the caller's buffer, at every checkpoint and at the end
+        auto publish = [&](const QVector<MCTSResult>& results) {
+            QVector<MCTSResult> ranked = results;
+            std::sort(ranked.begin(), ranked.end(), [](const MCTSResult& a, const MCTSResult& b) {
+                return a.visits != b.visits ? a.visits > b.visits : a.winRate > b.winRate;
+            });
+            int32_t written = 0;
+            for (const MCTSResult& result : ranked) {
+                if (written >= capacity) break;
+                moves[written++] = {static_cast<gd_id>(engine->compact->brawlerIndex(result.move)), result.visits, result.winRate};
+            }
+            *move_count = written;
+        };
+        int checkpoint = 0;
+        MCTSManager::CheckpointCallback onCheckpoint = [&](const QVector<MCTSResult>& results, long long iterations) {
+            publish(results);
+            double elapsed = checkpoints[checkpoint++];
+            return !callback || callback(user_data, moves, *move_count, iterations, elapsed) == 0;
+        };
+        int threadCount = threads > 0 ? threads : QThread::idealThreadCount();
+        QVector<QVector<MCTSResult>> results = engine->mcts->runTimed(root, engine->weights, engine->evalWeights, checkpoints,
+                                                                      threadCount, std::random_device{}(), nullptr,
+                                                                      onCheckpoint);
+        if (!results.isEmpty()) publish(results.last());
+        return GD_OK;
+    } catch (const std::exception& e) {
+        return fail(GD_ERR_INTERNAL, QString::fromUtf8(e.what()));
+    }
+}
+
+} // extern "C"
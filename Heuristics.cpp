@@ -3,6 +3,7 @@
 #include <cmath>
 #include <limits>
 #include <algorithm> // for std::sort
+#include <stdexcept>
 
 QPair<QString, QHash<QString, HeuristicScoreComponents>>
 suggestPickHeuristic(const DraftState& draftState,
@@ -131,87 +132,119 @@ suggestBanHeuristic(const DraftState& draftState,
 }
 
 
-double
-predictWinProbabilityModel(const QVector<QString>& team1Brawlers,
-                           const QVector<QString>& team2Brawlers,
-                           const QString& mapName,
-                           const QString& modeName,
-                           const StatsCalculator& statsCalculator,
-                           const HeuristicWeights& evalWeights) // Use specific eval weights
+template<typename Format>
+EvalFeatures
+computeEvalFeaturesFor(const QString* team1Brawlers,
+                       const QString* team2Brawlers,
+                       const QString& mapName,
+                       const QString& modeName,
+                       const StatsCalculator& statsCalculator)
 {
-    if (team1Brawlers.size() != 3 || team2Brawlers.size() != 3) {
-        qWarning() << "predictWinProbabilityModel called with incomplete teams.";
-        return 0.5; // Default for invalid input
-    }
+    constexpr int N = Format::teamSize;
+    EvalFeatures features;
 
     // 1. Average Win Rate Difference
     double t1AvgWR = 0.0, t2AvgWR = 0.0;
-    for(const auto& b : team1Brawlers) t1AvgWR += statsCalculator.getWinRate(b, mapName, modeName).value_or(0.5);
-    for(const auto& b : team2Brawlers) t2AvgWR += statsCalculator.getWinRate(b, mapName, modeName).value_or(0.5);
-    t1AvgWR /= 3.0;
-    t2AvgWR /= 3.0;
-    double baseWrDiff = t1AvgWR - t2AvgWR;
+    unrolledFor<N>([&](auto i) {
+        t1AvgWR += statsCalculator.getWinRate(team1Brawlers[i], mapName, modeName).value_or(0.5);
+        t2AvgWR += statsCalculator.getWinRate(team2Brawlers[i], mapName, modeName).value_or(0.5);
+    });
+    t1AvgWR /= N;
+    t2AvgWR /= N;
+    features.winRateDiff = t1AvgWR - t2AvgWR;
 
     // 2. Average Synergy Difference
-    auto calculateAvgSynergyDiff = [&](const QVector<QString>& team) {
+    auto calculateAvgSynergyDiff = [&](const QString* team) {
         double synergySumDiff = 0.0;
-        int pairs = 0;
-        for (int i = 0; i < 3; ++i) {
-            for (int j = i + 1; j < 3; ++j) {
-                double synergy = statsCalculator.getSynergyScore(team[i], team[j], mapName, modeName);
+        unrolledFor<N>([&](auto i) {
+            unrolledFor<N - 1 - decltype(i)::value>([&](auto offset) {
+                double synergy = statsCalculator.getSynergyScore(team[i], team[i + 1 + offset], mapName, modeName);
                 synergySumDiff += (synergy - 0.5);
-                pairs++;
-            }
-        }
-        return (pairs > 0) ? synergySumDiff / pairs : 0.0;
+            });
+        });
+        return synergySumDiff / Format::pairsPerTeam;
     };
-    double t1AvgSynDiff = calculateAvgSynergyDiff(team1Brawlers);
-    double t2AvgSynDiff = calculateAvgSynergyDiff(team2Brawlers);
-    double synergyDiff = t1AvgSynDiff - t2AvgSynDiff;
+    features.synergyDiff = calculateAvgSynergyDiff(team1Brawlers) - calculateAvgSynergyDiff(team2Brawlers);
 
 
     // 3. Counter Interaction Difference (Average and Peak)
     double t1_vs_t2_sum_diff = 0.0;
     double max_t1_vs_t2_score_diff = -1.0; // Max (T1[i] vs T2[j] score - 0.5)
     double max_t2_vs_t1_score_diff = -1.0; // Max (T2[j] vs T1[i] score - 0.5)
-    int interactions = 0;
-    for (const auto& b1 : team1Brawlers) {
-        for (const auto& b2 : team2Brawlers) {
+    unrolledFor<N>([&](auto i) {
+        unrolledFor<N>([&](auto j) {
              // T1 vs T2 perspective
-            double t1_vs_t2_score = statsCalculator.getCounterScore(b1, b2, mapName, modeName);
+            double t1_vs_t2_score = statsCalculator.getCounterScore(team1Brawlers[i], team2Brawlers[j], mapName, modeName);
             double current_t1_vs_t2_diff = t1_vs_t2_score - 0.5;
             t1_vs_t2_sum_diff += current_t1_vs_t2_diff;
             max_t1_vs_t2_score_diff = std::max(max_t1_vs_t2_score_diff, current_t1_vs_t2_diff);
 
             // T2 vs T1 perspective (for peak calculation)
-            double t2_vs_t1_score = statsCalculator.getCounterScore(b2, b1, mapName, modeName);
+            double t2_vs_t1_score = statsCalculator.getCounterScore(team2Brawlers[j], team1Brawlers[i], mapName, modeName);
             double current_t2_vs_t1_diff = t2_vs_t1_score - 0.5;
              max_t2_vs_t1_score_diff = std::max(max_t2_vs_t1_score_diff, current_t2_vs_t1_diff);
+        });
+    });
+    features.counterAvg = t1_vs_t2_sum_diff / Format::matchups;
+    // Peak counter advantage: How much better is T1's best matchup vs T2's best matchup?
+    features.peakCounter = max_t1_vs_t2_score_diff - max_t2_vs_t1_score_diff;
 
-            interactions++;
-        }
+    return features;
+}
+
+template EvalFeatures computeEvalFeaturesFor<DuoFormat>(const QString*, const QString*, const QString&, const QString&, const StatsCalculator&);
+template EvalFeatures computeEvalFeaturesFor<TrioFormat>(const QString*, const QString*, const QString&, const QString&, const StatsCalculator&);
+template EvalFeatures computeEvalFeaturesFor<FiveFormat>(const QString*, const QString*, const QString&, const QString&, const StatsCalculator&);
+
+
+EvalFeatures
+computeEvalFeatures(const QVector<QString>& team1Brawlers,
+                    const QVector<QString>& team2Brawlers,
+                    const QString& mapName,
+                    const QString& modeName,
+                    const StatsCalculator& statsCalculator)
+{
+    if (team1Brawlers.size() != team2Brawlers.size()) {
+        throw std::invalid_argument("computeEvalFeatures needs two teams of the same size.");
     }
-    double counterAdvAvg = (interactions > 0) ? t1_vs_t2_sum_diff / interactions : 0.0;
-    // Peak counter advantage: How much better is T1's best matchup vs T2's best matchup?
-    double peakCounterAdv = max_t1_vs_t2_score_diff - max_t2_vs_t1_score_diff;
+    return dispatchTeamSize(team1Brawlers.size(), [&](auto format) {
+        return computeEvalFeaturesFor<decltype(format)>(team1Brawlers.constData(), team2Brawlers.constData(),
+                                                        mapName, modeName, statsCalculator);
+    });
+}
 
 
-    // Combine factors using evaluation weights
-    // Mapping HeuristicWeights fields for evaluation:
-    // evalWeights.winRate -> Weight for base WR diff
-    // evalWeights.synergy -> Weight for synergy diff
-    // evalWeights.counter -> Weight for average counter advantage
-    // evalWeights.pickRate -> Weight for *peak* counter advantage (reusing field)
-    double totalScoreDiff = (evalWeights.winRate * baseWrDiff) +
-                            (evalWeights.synergy * synergyDiff) +
-                            (evalWeights.counter * counterAdvAvg) +
-                            (evalWeights.pickRate * peakCounterAdv); // Using pickRate weight for peak counter
+double
+predictWinProbabilityFromFeatures(const EvalFeatures& features, const EvalWeights& evalWeights)
+{
+    double totalScoreDiff = (evalWeights.winRate * features.winRateDiff) +
+                            (evalWeights.synergy * features.synergyDiff) +
+                            (evalWeights.counter * features.counterAvg) +
+                            (evalWeights.peakCounter * features.peakCounter);
 
     // Logistic function (sigmoid) to map score difference to probability
-    // k controls the steepness of the curve
-    double k = 2.0; // Same factor as Python example
-    double predictedRate = 1.0 / (1.0 + std::exp(-k * totalScoreDiff));
+    // slope controls the steepness of the curve (2.0 by default, fitted by 'tune')
+    double predictedRate = 1.0 / (1.0 + std::exp(-evalWeights.slope * totalScoreDiff));
 
     // Clamp result between 0 and 1
     return std::max(0.0, std::min(1.0, predictedRate));
-}
\ No newline at end of file
+}
+
+
+double
+predictWinProbabilityModel(const QVector<QString>& team1Brawlers,
+                           const QVector<QString>& team2Brawlers,
+                           const QString& mapName,
+                           const QString& modeName,
+                           const StatsCalculator& statsCalculator,
+                           const EvalWeights& evalWeights)
+{
+    int teamSize = teamSizeForMode(modeName);
+    if (team1Brawlers.size() != teamSize || team2Brawlers.size() != teamSize) {
+        qWarning() << "predictWinProbabilityModel called with incomplete teams.";
+        return 0.5; // Default for invalid input
+    }
+
+    EvalFeatures features = computeEvalFeatures(team1Brawlers, team2Brawlers, mapName, modeName, statsCalculator);
+    return predictWinProbabilityFromFeatures(features, evalWeights);
+}
@@ -3,6 +3,7 @@
 
 #include "DataStructures.h"
 #include "DraftState.h"
+#include "DraftFormat.h"
 #include "StatsCalculator.h"
 #include "AppConfig.h" // For weights
 #include <QPair>
@@ -22,15 +23,49 @@ suggestBanHeuristic(const DraftState& draftState,
                     const StatsCalculator& statsCalculator,
                     int numSuggestions = 3);
 
+// Raw inputs of the win model, all from Team 1's perspective
+struct EvalFeatures {
+    double winRateDiff = 0.0; // Avg adjusted WR of team1 - team2
+    double synergyDiff = 0.0; // Avg pair synergy of team1 - team2 (relative to 0.5)
+    double counterAvg = 0.0;  // Avg counter score of team1 vs team2 over all N*N matchups (relative to 0.5)
+    double peakCounter = 0.0; // Best team1 matchup - best team2 matchup
+};
+
+// One instantiation per DraftFormat, with fully unrolled pair/matchup loops.
+// Each team is exactly Format::teamSize brawlers. Instantiated for DuoFormat, TrioFormat and FiveFormat.
+template<typename Format>
+EvalFeatures
+computeEvalFeaturesFor(const QString* team1Brawlers,
+                       const QString* team2Brawlers,
+                       const QString& mapName,
+                       const QString& modeName,
+                       const StatsCalculator& statsCalculator);
+
+extern template EvalFeatures computeEvalFeaturesFor<DuoFormat>(const QString*, const QString*, const QString&, const QString&, const StatsCalculator&);
+extern template EvalFeatures computeEvalFeaturesFor<TrioFormat>(const QString*, const QString*, const QString&, const QString&, const StatsCalculator&);
+extern template EvalFeatures computeEvalFeaturesFor<FiveFormat>(const QString*, const QString*, const QString&, const QString&, const StatsCalculator&);
+
+// Runtime dispatch on the teams' size; throws std::invalid_argument for mismatched or unsupported sizes
+EvalFeatures
+computeEvalFeatures(const QVector<QString>& team1Brawlers,
+                    const QVector<QString>& team2Brawlers,
+                    const QString& mapName,
+                    const QString& modeName,
+                    const StatsCalculator& statsCalculator);
+
+// sigmoid(slope * weighted feature sum)
+double
+predictWinProbabilityFromFeatures(const EvalFeatures& features, const EvalWeights& evalWeights);
+
 // Predicts win probability for Team 1 based on a heuristic model
-// Note: The weights used here might differ from the pick suggestion weights
-// Using the same HeuristicWeights struct for simplicity, but could be separate.
+// Uses its own EvalWeights (config group [EvalWeights]), separate from the pick suggestion weights.
+// Both teams must have the mode's team size (see teamSizeForMode); returns 0.5 otherwise.
 double
 predictWinProbabilityModel(const QVector<QString>& team1Brawlers,
                            const QVector<QString>& team2Brawlers,
                            const QString& mapName,
                            const QString& modeName,
                            const StatsCalculator& statsCalculator,
-                           const HeuristicWeights& evalWeights); // Weights for evaluation
+                           const EvalWeights& evalWeights); // Weights for evaluation
 
 #endif // HEURISTICS_H
\ No newline at end of file
@@ -0,0 +1,267 @@
+#include "LiveIngest.h"
+#include "AppConfig.h"
+#include "CompactStats.h"
+#include "DataLoader.h"
+#include "MemoryLedger.h"
+#include <QtConcurrent/QtConcurrent>
+#include <QSaveFile>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDataStream>
+#include <QDebug>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+const quint32 LIVE_CHECKPOINT_MAGIC = 0x4C495645; // "LIVE"
+const qint16 LIVE_CHECKPOINT_VERSION = 1;
+const qint64 FINGERPRINT_BYTES = 4096;
+
+// Ring slot plus a QSet entry at Qt's load factor
+const qint64 BYTES_PER_REMEMBERED_KEY = 26;
+
+} // namespace
+
+
+LiveIngest::LiveIngest(const QString& dataPath, const QString& checkpointPath, const CacheData& base,
+                       const AppConfig& config, QObject* parent)
+    : QObject(parent),
+      m_dataPath(dataPath),
+      m_checkpointPath(checkpointPath),
+      m_config(config),
+      m_basePackVersion(base.metadata.cacheCreationTime),
+      m_totals(config),
+      m_added(config),
+      m_allBrawlers(base.allBrawlers),
+      m_mapModes(base.discoveredMapModes)
+{
+    m_dedupWindow = m_config.liveDedupWindow();
+    const qint64 historyCap = MemoryLedger::capBytes(MemorySubsystem::HistoryCaches, m_config);
+    if (historyCap > 0 && m_dedupWindow > historyCap / BYTES_PER_REMEMBERED_KEY) {
+        m_dedupWindow = static_cast<int>(historyCap / BYTES_PER_REMEMBERED_KEY);
+        qInfo() << "LiveDedupWindow limited to" << m_dedupWindow << "keys by MemoryCapHistoryMB.";
+    }
+    m_totals.setStatsFromCacheData(base);
+    connect(&m_pollTimer, &QTimer::timeout, this, &LiveIngest::onPollTimer);
+}
+
+LiveIngest::~LiveIngest() {
+    stop();
+}
+
+void LiveIngest::start(qint64 fallbackOffset, const QVector<quint64>& seenKeys) {
+    if (!restoreCheckpoint()) {
+        m_offset = fallbackOffset >= 0 ? fallbackOffset : QFileInfo(m_dataPath).size();
+        // Only the newest keys fit the window
+        qsizetype first = std::max<qsizetype>(0, seenKeys.size() - m_dedupWindow);
+        for (qsizetype i = first; i < seenKeys.size(); ++i) rememberBattle(seenKeys[i]);
+        m_checkpointDirty = !saveCheckpoint();
+        qInfo() << "Following" << m_dataPath << "from byte" << m_offset;
+    }
+    m_sincePublish.start();
+    m_pollTimer.start(m_config.liveIngestPollSeconds() * 1000);
+}
+
+void LiveIngest::stop() {
+    if (!m_pollTimer.isActive()) return;
+    m_pollTimer.stop();
+    m_pollFuture.waitForFinished();
+    poll(true);
+}
+
+std::shared_ptr<const StatsCalculator> LiveIngest::current() const {
+    QMutexLocker lock(&m_currentMutex);
+    return m_current;
+}
+
+void LiveIngest::onPollTimer() {
+    if (m_pollFuture.isRunning()) return; // A slow poll (large append) just delays the next one
+    m_pollFuture = QtConcurrent::run([this]() { poll(false); });
+}
+
+// --- Polling ---
+
+void LiveIngest::poll(bool finalPoll) {
+    try {
+        qint64 size = QFileInfo(m_dataPath).size();
+        if (size < m_offset) {
+            // Truncated or rotated: read it all again; battles still in the window are skipped
+            qWarning() << "Games file is shorter than the live offset; reading it again from the start.";
+            m_offset = 0;
+            m_checkpointDirty = true;
+        }
+        if (size > m_offset) {
+            DataLoader loader(m_dataPath, m_config);
+            loader.setStartOffset(m_offset);
+            loader.loadAndProcess(); // false if no new line held a usable game; the offset still advances
+            const QVector<ProcessedGame>& games = loader.getProcessedGames();
+            const QVector<quint64>& keys = loader.getBattleKeys();
+            QVector<ProcessedGame> fresh;
+            for (int i = 0; i < games.size(); ++i) {
+                if (rememberBattle(keys[i])) fresh.append(games[i]);
+            }
+            if (!fresh.isEmpty()) {
+                m_totals.addGames(fresh);
+                m_added.addGames(fresh);
+                for (const ProcessedGame& game : fresh) addDiscovered(game);
+                m_gamesAdded += fresh.size();
+                m_pendingGames += fresh.size();
+            }
+            if (loader.getEndOffset() != m_offset) {
+                qInfo() << "Live ingest:" << fresh.size() << "new games," << games.size() - fresh.size()
+                        << "already seen, now at byte" << loader.getEndOffset();
+                m_offset = loader.getEndOffset();
+                m_checkpointDirty = true;
+            }
+        }
+
+        if (!finalPoll && m_sincePublish.elapsed() < m_config.livePublishSeconds() * 1000LL) return;
+        m_sincePublish.restart();
+        if (m_pendingGames > 0) publish();
+        // Written after the publish, so a checkpoint never covers games no snapshot had
+        if (m_checkpointDirty) m_checkpointDirty = !saveCheckpoint();
+    } catch (const std::exception& e) {
+        qCritical() << "Live ingest poll failed:" << e.what();
+    }
+}
+
+void LiveIngest::publish() {
+    CacheData data = m_totals.getStatsForCache();
+    data.allBrawlers = m_allBrawlers;
+    data.discoveredMapModes = m_mapModes;
+    auto snapshot = std::make_shared<StatsCalculator>(m_config);
+    snapshot->setStatsFromCacheData(data);
+    if (m_config.useCompactStats()) {
+        snapshot->setCompactStats(CompactStats::build(*snapshot, data, m_config, m_config.compactPlaysThreshold()));
+    }
+    {
+        QMutexLocker lock(&m_currentMutex);
+        m_current = snapshot;
+    }
+    qInfo() << "Published live stats with" << m_pendingGames << "new games (" << m_gamesAdded << "since the pack ).";
+    emit statsPublished(m_pendingGames);
+    m_pendingGames = 0;
+}
+
+bool LiveIngest::rememberBattle(quint64 key) {
+    const int window = m_dedupWindow;
+    if (window == 0) return true;
+    if (m_seenKeys.contains(key)) return false;
+    if (m_recentKeys.size() < window) {
+        m_recentKeys.append(key);
+    } else {
+        m_seenKeys.remove(m_recentKeys[m_nextKeySlot]);
+        m_recentKeys[m_nextKeySlot] = key;
+        m_nextKeySlot = (m_nextKeySlot + 1) % window;
+    }
+    m_seenKeys.insert(key);
+    m_historyCharge.set(MemoryLedger::vectorBytes(m_recentKeys) + MemoryLedger::setBytes(m_seenKeys));
+    return true;
+}
+
+void LiveIngest::addDiscovered(const ProcessedGame& game) {
+    for (const QVector<PlayerData>* team : {&game.winningTeamData, &game.losingTeamData}) {
+        for (const PlayerData& player : *team) {
+            m_allBrawlers.insert(player.brawlerName);
+            m_addedBrawlers.insert(player.brawlerName);
+        }
+    }
+    m_mapModes[game.mode].insert(game.map);
+    m_addedMapModes[game.mode].insert(game.map);
+}
+
+quint64 LiveIngest::fileFingerprint() const {
+    QFile file(m_dataPath);
+    if (!file.open(QIODevice::ReadOnly)) return 0;
+    return static_cast<quint64>(qHash(file.readLine(FINGERPRINT_BYTES)));
+}
+
+// --- Checkpoint ---
+
+bool LiveIngest::saveCheckpoint() const {
+    QDir dir = QFileInfo(m_checkpointPath).dir();
+    if (!dir.exists() && !dir.mkpath(".")) {
+        qCritical() << "Failed to create live checkpoint directory:" << dir.path();
+        return false;
+    }
+    CacheData added = m_added.getStatsForCache();
+    added.allBrawlers = m_addedBrawlers;
+    added.discoveredMapModes = m_addedMapModes;
+    // Oldest first, so a smaller window after a restart keeps the newest
+    QVector<quint64> keys = m_recentKeys.mid(m_nextKeySlot) + m_recentKeys.mid(0, m_nextKeySlot);
+
+    // QSaveFile: offset and counts are replaced together or not at all
+    QSaveFile file(m_checkpointPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCritical() << "Error opening live checkpoint for writing:" << m_checkpointPath << file.errorString();
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << LIVE_CHECKPOINT_MAGIC << LIVE_CHECKPOINT_VERSION << m_basePackVersion << fileFingerprint()
+        << m_offset << m_gamesAdded << keys << added;
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        qCritical() << "Error writing live checkpoint:" << m_checkpointPath;
+        return false;
+    }
+    return true;
+}
+
+bool LiveIngest::restoreCheckpoint() {
+    QFile file(m_checkpointPath);
+    if (!file.exists()) return false;
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Error opening live checkpoint:" << m_checkpointPath << file.errorString();
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    qint16 version = 0;
+    in >> magic >> version;
+    if (in.status() != QDataStream::Ok || magic != LIVE_CHECKPOINT_MAGIC || version != LIVE_CHECKPOINT_VERSION) {
+        qWarning() << "Ignoring live checkpoint with invalid header:" << m_checkpointPath;
+        return false;
+    }
+    qint64 packVersion = 0;
+    quint64 fingerprint = 0;
+    qint64 offset = 0;
+    qint64 gamesAdded = 0;
+    QVector<quint64> keys;
+    CacheData added;
+    in >> packVersion >> fingerprint >> offset >> gamesAdded >> keys >> added;
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "Ignoring corrupted live checkpoint:" << m_checkpointPath;
+        return false;
+    }
+    if (packVersion != m_basePackVersion) {
+        qInfo() << "Live checkpoint was written over another stats pack; not resuming it.";
+        return false;
+    }
+    if (offset > QFileInfo(m_dataPath).size() || (offset > 0 && fingerprint != fileFingerprint())) {
+        qWarning() << "Games file was replaced since the live checkpoint; not resuming it.";
+        return false;
+    }
+
+    m_offset = offset;
+    m_gamesAdded = gamesAdded;
+    for (quint64 key : keys) rememberBattle(key);
+    if (gamesAdded > 0) {
+        m_totals.addStats(added);
+        m_added.addStats(added);
+        m_addedBrawlers = added.allBrawlers;
+        m_addedMapModes = added.discoveredMapModes;
+        m_allBrawlers.unite(added.allBrawlers);
+        for (auto it = added.discoveredMapModes.constBegin(); it != added.discoveredMapModes.constEnd(); ++it) {
+            m_mapModes[it.key()].unite(it.value());
+        }
+        m_pendingGames = gamesAdded;
+        publish();
+    }
+    qInfo() << "Resumed following" << m_dataPath << "at byte" << offset << "with" << gamesAdded
+            << "games added since the pack.";
+    return true;
+}
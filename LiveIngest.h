@@ -0,0 +1,92 @@
+#ifndef LIVEINGEST_H
+#define LIVEINGEST_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QSet>
+#include <QHash>
+#include <QTimer>
+#include <QFuture>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <memory>
+#include "DataStructures.h"
+#include "StatsCalculator.h"
+#include "MemoryLedger.h"
+
+class AppConfig;
+
+// Follow mode for the games file the scraper keeps appending to. Each poll reads the complete
+// lines past the last offset, drops battles already seen (DataLoader::battleKey over a window of
+// recent keys) and adds the rest to running totals. Every LivePublishSeconds a new
+// StatsCalculator is built from the totals and published; holders of the previous one keep it,
+// so a running search is never blocked or changed underneath. Each publish also writes a
+// checkpoint (offset, recent keys, counts added since the pack), so a restart over the same
+// stats pack continues from exactly that offset with those games already counted.
+class LiveIngest : public QObject {
+    Q_OBJECT
+
+public:
+    // 'base' holds the loaded pack's counts; a compact pack cannot be followed
+    LiveIngest(const QString& dataPath, const QString& checkpointPath, const CacheData& base,
+               const AppConfig& config, QObject* parent = nullptr);
+    ~LiveIngest() override; // stop()
+
+    // Resumes from the checkpoint if it was written over the same pack and games file. Otherwise
+    // starts at 'fallbackOffset' (< 0: the current end of the file) with 'seenKeys' as the
+    // recent battles, e.g. the offset and keys of a pack just built from the file.
+    void start(qint64 fallbackOffset = -1, const QVector<quint64>& seenKeys = {});
+    // Reads what is left, publishes it and writes the checkpoint; waits for a running poll
+    void stop();
+
+    // Latest published stats; nullptr until something was published. Safe from any thread.
+    std::shared_ptr<const StatsCalculator> current() const;
+
+signals:
+    // current() changed. Emitted from the polling thread.
+    void statsPublished(qint64 newGames);
+
+private slots:
+    void onPollTimer();
+
+private:
+    void poll(bool finalPoll);
+    void publish();
+    bool rememberBattle(quint64 key); // false if it is in the window already
+    void addDiscovered(const ProcessedGame& game);
+    quint64 fileFingerprint() const;  // Hash of the file's first line: detects a replaced file
+    bool restoreCheckpoint();
+    bool saveCheckpoint() const;
+
+    QString m_dataPath;
+    QString m_checkpointPath;
+    const AppConfig& m_config;
+    qint64 m_basePackVersion = 0;
+
+    // Owned by whichever thread is polling; polls never overlap
+    StatsCalculator m_totals; // Pack plus every ingested game
+    StatsCalculator m_added;  // Ingested games only (checkpointed)
+    QSet<QString> m_allBrawlers;
+    QHash<QString, QSet<QString>> m_mapModes;
+    QSet<QString> m_addedBrawlers;
+    QHash<QString, QSet<QString>> m_addedMapModes;
+    qint64 m_offset = 0;
+    qint64 m_gamesAdded = 0;      // Since the pack
+    qint64 m_pendingGames = 0;    // Since the last publish
+    bool m_checkpointDirty = false;
+    int m_dedupWindow = 0;         // LiveDedupWindow, limited by MemoryCapHistoryMB
+    QVector<quint64> m_recentKeys; // Ring of the last m_dedupWindow keys
+    int m_nextKeySlot = 0;
+    QSet<quint64> m_seenKeys;
+    MemoryCharge m_historyCharge{MemorySubsystem::HistoryCaches};
+    QElapsedTimer m_sincePublish;
+
+    mutable QMutex m_currentMutex;
+    std::shared_ptr<const StatsCalculator> m_current;
+
+    QTimer m_pollTimer;
+    QFuture<void> m_pollFuture;
+};
+
+#endif // LIVEINGEST_H
@@ -1,7 +1,10 @@
 #include "MCTS.h"
 #include <QtConcurrent/QtConcurrent>
 #include <QElapsedTimer>
-#include <QThread> // For msleep and idealThreadCount
+#include <QCoreApplication>
+#include <QDir>
+#include <QThread> // For msleep
+#include <QThreadPool>
 #include <QDebug>
 #include <cmath>
 #include <limits>
@@ -9,26 +12,175 @@
 #include <random>
 #include <functional> // For std::ref used with QtConcurrent with members
 #include "DataStructures.h"
+#include "PolicyTable.h"
+#include "SharedTree.h"
+#include "TreeSnapshot.h"
+#include "MoveClusters.h"
+#include "TaskExecutor.h"
+
+namespace {
+// Cluster mode: once every cluster has a child, a node holds one more per sqrt(visits)
+const double CLUSTER_WIDENING = 1.0;
+// Iterations one executor task runs for the interactive search before queueing the next slice
+const qint64 WORKER_SLICE_MS = 10;
+
+// Node, its own move lists and available set, and the make_shared control block; roster names
+// and the master list are shared with the root
+qint64 nodeBytes(const MCTSNode& node) {
+    return qint64(sizeof(MCTSNode)) + 32 + MemoryLedger::vectorBytes(node.untriedMoves)
+         + MemoryLedger::setBytes(node.state.availableBrawlers())
+         + MemoryLedger::vectorBytes(node.state.team1Picks()) + MemoryLedger::vectorBytes(node.state.team2Picks());
+}
+}
 
 
 // --- MCTSNode Implementation ---
 
-MCTSNode::MCTSNode(DraftState s, std::shared_ptr<MCTSNode> p, QString m)
-    : state(std::move(s)), parent(p), move(std::move(m))
+MCTSNode::MCTSNode(DraftState s, std::shared_ptr<MCTSNode> p, QString m, std::shared_ptr<const MCTSSearchSpace> searchSpace)
+    : state(std::move(s)), parent(p), move(std::move(m)), space(std::move(searchSpace))
 {
     isTerminal = state.isComplete();
     if (!isTerminal) {
-        untriedMoves = state.getLegalMoves();
+        // Root: every legal move (safety valve for pruned brawlers); below it only the active roster
+        untriedMoves = p && space ? state.getLegalMoves(space->activeRoster.get()) : state.getLegalMoves();
         // Optional shuffling could happen here using an engine if needed at creation
+        if (const MoveClusterTable* clusters = clusterTable()) {
+            m_clusterChildren.fill(0, clusters->clusters.size() + 1);
+            QVector<int> movesPerSlot(m_clusterChildren.size(), 0);
+            for (const QString& legal : untriedMoves) movesPerSlot[clusterSlot(legal)]++;
+            m_clustersWithMoves = static_cast<int>(movesPerSlot.size() - std::count(movesPerSlot.begin(), movesPerSlot.end(), 0));
+        }
+    }
+    if (space) {
+        qint64 bytes = nodeBytes(*this);
+        space->treeBytes.fetch_add(bytes, std::memory_order_relaxed);
+        MemoryLedger::charge(MemorySubsystem::SearchTrees, bytes);
     }
 }
 
 bool MCTSNode::isFullyExpanded() {
     QMutexLocker locker(&mutex);
-    return untriedMoves.isEmpty();
+    // Tree at its byte cap: expanded nodes become complete for good, so selection reaches the leaves.
+    // Sticky because the cap is process-wide and can lift when another tree is freed; a node must not
+    // resume appending children once lock-free selection (uctSelectChild) iterates them.
+    if (!untriedMoves.isEmpty() && space && space->atByteCap()) {
+        if (children.isEmpty()) return false;
+        untriedMoves.clear();
+        return true;
+    }
+    if (untriedMoves.isEmpty() || !clusterTable()) return untriedMoves.isEmpty();
+    // Cluster mode: a child per cluster first, then progressive widening
+    if (m_clustersExpanded < m_clustersWithMoves) return false;
+    double allowed = m_clustersWithMoves + CLUSTER_WIDENING * std::sqrt(static_cast<double>(visits.load(std::memory_order_relaxed)));
+    return children.size() >= allowed;
+}
+
+void MCTSNode::addChild(std::shared_ptr<MCTSNode> child) {
+    if (clusterTable()) {
+        int& count = m_clusterChildren[clusterSlot(child->move)];
+        if (count++ == 0) m_clustersExpanded++;
+    }
+    children.append(std::move(child));
+}
+
+int MCTSNode::clusterSlot(const QString& brawler) const {
+    int cluster = clusterTable()->cluster(brawler);
+    return cluster >= 0 ? cluster : m_clusterChildren.size() - 1;
+}
+
+int MCTSNode::takeClusteredMove() {
+    const MoveClusterTable* clusters = clusterTable();
+    const int slotCount = m_clusterChildren.size();
+    QVector<int> candidate(slotCount, -1); // Per slot: the untried move expanded next
+    for (int c = 0; c < clusters->clusters.size(); ++c) {
+        for (const QString& member : clusters->clusters[c]) { // Medoid first
+            int index = untriedMoves.indexOf(member);
+            if (index >= 0) {
+                candidate[c] = index;
+                break;
+            }
+        }
+    }
+    for (int i = 0; i < untriedMoves.size() && candidate[slotCount - 1] < 0; ++i) {
+        if (clusters->cluster(untriedMoves[i]) < 0) candidate[slotCount - 1] = i;
+    }
+
+    // A cluster without a child first; otherwise widen the cluster doing best so far
+    for (int c = 0; c < slotCount; ++c) {
+        if (candidate[c] >= 0 && m_clusterChildren[c] == 0) return candidate[c];
+    }
+    QVector<double> clusterVisits(slotCount, 0.0), clusterWins(slotCount, 0.0);
+    for (const auto& child : children) {
+        int c = clusterSlot(child->move);
+        clusterVisits[c] += child->visits.load(std::memory_order_relaxed);
+        clusterWins[c] += child->wins.load(std::memory_order_relaxed);
+    }
+    int best = -1;
+    double bestMean = -1.0;
+    for (int c = 0; c < slotCount; ++c) {
+        if (candidate[c] < 0) continue;
+        double mean = clusterVisits[c] > 0 ? clusterWins[c] / clusterVisits[c] : 0.5;
+        if (mean > bestMean) {
+            bestMean = mean;
+            best = c;
+        }
+    }
+    return best >= 0 ? candidate[best] : untriedMoves.size() - 1;
+}
+
+// Level 1: UCT over clusters with their members' visits and wins pooled. Level 2: UCT over the
+// chosen cluster's members, against the cluster's visit count.
+std::shared_ptr<MCTSNode> MCTSNode::uctSelectClustered(double explorationParam, std::mt19937& randomEngine) {
+    QMutexLocker locker(&mutex); // Children keep being added while the node widens
+    if (children.isEmpty()) return nullptr;
+
+    const int slotCount = m_clusterChildren.size();
+    QVector<double> clusterVisits(slotCount, 0.0), clusterWins(slotCount, 0.0);
+    for (const auto& child : children) {
+        int c = clusterSlot(child->move);
+        clusterVisits[c] += child->visits.load(std::memory_order_relaxed);
+        clusterWins[c] += child->wins.load(std::memory_order_relaxed);
+    }
+
+    auto uct = [explorationParam](double childWins, double childVisits, double logParentVisits) {
+        if (childVisits <= 0.0) return std::numeric_limits<double>::infinity();
+        return childWins / childVisits + explorationParam * std::sqrt(logParentVisits / childVisits);
+    };
+
+    double logParentVisits = std::log(std::max(1.0, static_cast<double>(visits.load(std::memory_order_relaxed))));
+    int bestCluster = -1;
+    double bestScore = -std::numeric_limits<double>::infinity();
+    for (int c = 0; c < slotCount; ++c) {
+        if (m_clusterChildren[c] == 0) continue;
+        double score = uct(clusterWins[c], clusterVisits[c], logParentVisits);
+        if (score > bestScore) {
+            bestScore = score;
+            bestCluster = c;
+        }
+    }
+    if (bestCluster < 0) {
+        std::uniform_int_distribution<qsizetype> dist(0, children.size() - 1);
+        return children.at(dist(randomEngine));
+    }
+
+    double logClusterVisits = std::log(std::max(1.0, clusterVisits[bestCluster]));
+    std::shared_ptr<MCTSNode> bestChild;
+    bestScore = -std::numeric_limits<double>::infinity();
+    for (const auto& child : children) {
+        if (clusterSlot(child->move) != bestCluster) continue;
+        double score = uct(child->wins.load(std::memory_order_relaxed),
+                           child->visits.load(std::memory_order_relaxed), logClusterVisits);
+        if (score > bestScore) {
+            bestScore = score;
+            bestChild = child;
+        }
+    }
+    return bestChild;
 }
 
 std::shared_ptr<MCTSNode> MCTSNode::uctSelectChild(double explorationParam, std::mt19937& randomEngine) {
+    if (clusterTable()) return uctSelectClustered(explorationParam, randomEngine);
+
     // Selection doesn't modify the node structure (children list), only reads visits/wins.
     // Reads on atomics are safe without external locks.
     // Mutex might only be needed if children *vector itself* could be modified,
@@ -85,12 +237,12 @@ std::shared_ptr<MCTSNode> MCTSNode::uctSelectChild(double explorationParam, std:
 std::shared_ptr<MCTSNode> MCTSNode::expand(/*std::mt19937& randomEngine*/) {
     QMutexLocker locker(&mutex); // Lock untriedMoves and children modification
 
-    if (untriedMoves.isEmpty()) {
+    if (untriedMoves.isEmpty() || (space && space->atByteCap())) {
         return nullptr;
     }
 
-    // --- Take last move (no randomness) ---
-    QString moveToTry = untriedMoves.takeLast();
+    // --- Take last move (no randomness); cluster mode picks per cluster ---
+    QString moveToTry = untriedMoves.takeAt(clusterTable() ? takeClusteredMove() : untriedMoves.size() - 1);
 
     // --- Optional: Random move selection ---
     // if (untriedMoves.isEmpty()) return nullptr;
@@ -101,8 +253,8 @@ std::shared_ptr<MCTSNode> MCTSNode::expand(/*std::mt19937& randomEngine*/) {
     try {
         DraftState nextState = state.applyMove(moveToTry);
         // Use shared_from_this() which is safe now due to inheritance
-        auto newNode = std::make_shared<MCTSNode>(nextState, shared_from_this(), moveToTry);
-        children.append(newNode); // Append is thread-safe for QVector if only one thread appends *after locking*
+        auto newNode = std::make_shared<MCTSNode>(nextState, shared_from_this(), moveToTry, space);
+        addChild(newNode); // Append is thread-safe for QVector if only one thread appends *after locking*
         return newNode;
     } catch (const std::exception& e) {
         qCritical() << "MCTS Expansion Error applying move" << moveToTry << ":" << e.what() << "State:" << state.toString();
@@ -128,9 +280,6 @@ MCTSManager::MCTSManager(const StatsCalculator& statsCalculator, const AppConfig
       m_statsCalculator(statsCalculator),
       m_config(config)
 {
-    // Set max threads for the pool (can be adjusted)
-    m_threadPool.setMaxThreadCount(QThread::idealThreadCount());
-    qInfo() << "MCTSManager using thread pool with max" << m_threadPool.maxThreadCount() << "threads.";
 }
 
 MCTSManager::~MCTSManager() {
@@ -139,8 +288,8 @@ MCTSManager::~MCTSManager() {
     if (m_controllerFuture.isRunning()) {
         m_controllerFuture.waitForFinished();
     }
-    // Wait for worker threads to finish (optional, pool manages them)
-    // m_threadPool.waitForDone(); // Can block if called from main thread with active workers
+    // Slices still queued are skipped (cancelled token); running ones finish their slice
+    m_workerTasks.wait();
 }
 
 bool MCTSManager::isRunning() const {
@@ -163,40 +312,45 @@ void MCTSManager::startMcts(DraftState rootState, HeuristicWeights weights) {
 
     // Reset state variables
     m_stopRequested = false;
+    m_searchToken = CancellationToken(); // Slices of an earlier search keep its cancelled token
     m_totalIterationsDone = 0;
 
-    // Create the shared root node
-    auto rootNode = std::make_shared<MCTSNode>(rootState);
-
-    int numThreads = m_threadPool.maxThreadCount(); // Use configured max threads
-    qInfo() << "Starting MCTS with" << numThreads << "worker threads.";
-
-    // Store needed parameters accessible by workers (capture list or members)
     double explorationParam = m_config.mctsExplorationParam();
+    EvalWeights evalWeights = m_config.evalWeights(); // Final-state evaluation (win model)
+    m_activeWeightsKey = TreeSnapshot::weightsKeyFor(weights, evalWeights);
+    // Worker processes read the pack from disk, so only thread searches take live stats
+    m_searchStats = m_workerProcesses > 0 ? nullptr : m_nextStats;
+
+    // --- Multi-process mode ---
+    if (m_workerProcesses > 0) {
+        if (m_moveClusters) qInfo() << "Worker-process MCTS uses one-level selection; move clusters are ignored.";
+        m_controllerFuture = QtConcurrent::run([this, rootState, weights, evalWeights, explorationParam]() {
+            this->runSharedTreeControllerTask(rootState, weights, evalWeights, explorationParam);
+        });
+        qInfo() << "MCTS shared-tree controller launched with" << m_workerProcesses << "worker processes for state:"
+                << rootState.toString();
+        emit mctsStatusUpdate("MCTS Started...");
+        return;
+    }
 
-    // Launch Worker Threads via Thread Pool
-    for (int i = 0; i < numThreads; ++i) {
-        // Use pool's start() with a lambda
-        m_threadPool.start([this, rootNode, weights, explorationParam, i]() {
-            // Each worker thread gets its own random engine, seeded uniquely
-            std::mt19937 threadRandomEngine(std::random_device{}() + i); // Simple unique seeding
+    // Create the shared root node, continuing a saved search of this position if there is one
+    std::shared_ptr<const MCTSSearchSpace> space = searchSpaceFor(rootState);
+    std::shared_ptr<MCTSNode> rootNode;
+    if (std::optional<TreeSnapshot> snapshot = loadSnapshot(rootState, m_activeWeightsKey)) {
+        rootNode = snapshot->restore(rootState, space);
+        qInfo() << "MCTS resumed from snapshot with" << snapshot->rootVisits() << "visits.";
+    } else {
+        rootNode = std::make_shared<MCTSNode>(rootState, nullptr, QString(), space);
+    }
 
-            try {
-                 // Worker loop: continues as long as stop is not requested
-                while (!m_stopRequested.load(std::memory_order_relaxed)) {
-                    runSingleMctsIteration(rootNode, weights, explorationParam, threadRandomEngine);
-                    // Increment shared iteration counter atomically
-                    m_totalIterationsDone.fetch_add(1, std::memory_order_relaxed);
-                }
-            } catch (const std::exception& e) {
-                 qCritical() << "Exception in MCTS worker thread" << i << ":" << e.what();
-                 // Optionally signal an error from here? Might be tricky with multiple threads.
-                 // Stop might be triggered by controller anyway.
-            } catch (...) {
-                qCritical() << "Unknown exception in MCTS worker thread" << i;
-            }
-             //qDebug() << "MCTS Worker thread" << i << "finished.";
-        });
+    // One chain of slices per executor worker, at interactive priority
+    int numThreads = TaskExecutor::instance().workerCount();
+    qInfo() << "Starting MCTS with" << numThreads << "worker slices on the task executor.";
+    for (int i = 0; i < numThreads; ++i) {
+        m_workerTasks.submit([this, rootNode, weights, evalWeights, explorationParam, stats = m_searchStats,
+                              token = m_searchToken]() {
+            runWorkerSlice(rootNode, weights, evalWeights, explorationParam, stats, token);
+        }, TaskPriority::Interactive, m_searchToken);
     }
 
     // Launch the Controller Task in a separate thread
@@ -209,19 +363,246 @@ void MCTSManager::startMcts(DraftState rootState, HeuristicWeights weights) {
     emit mctsStatusUpdate("MCTS Started...");
 }
 
+QVector<MCTSResult> MCTSManager::runFixedBudget(const DraftState& rootState, const HeuristicWeights& weights,
+                                                const EvalWeights& evalWeights, int iterations, quint32 seed,
+                                                double explorationParam) const {
+    if (rootState.isComplete() || rootState.getLegalMoves().isEmpty()) {
+        return {};
+    }
+
+    auto rootNode = std::make_shared<MCTSNode>(rootState, nullptr, QString(), searchSpaceFor(rootState));
+    std::mt19937 randomEngine(seed);
+    if (explorationParam <= 0.0) explorationParam = m_config.mctsExplorationParam();
+
+    for (int i = 0; i < iterations; ++i) {
+        runSingleMctsIteration(rootNode, weights, evalWeights, explorationParam, randomEngine);
+    }
+    return getMctsResults(rootNode);
+}
+
+QVector<QVector<MCTSResult>> MCTSManager::runTimed(const DraftState& rootState, const HeuristicWeights& weights,
+                                                   const EvalWeights& evalWeights,
+                                                   const QVector<double>& checkpointSeconds, int threads,
+                                                   quint32 seed, QVector<long long>* iterations,
+                                                   const CheckpointCallback& onCheckpoint) const {
+    QVector<QVector<MCTSResult>> results;
+    if (iterations) iterations->clear();
+    if (rootState.isComplete() || rootState.getLegalMoves().isEmpty() || checkpointSeconds.isEmpty()) {
+        return results;
+    }
+
+    auto rootNode = std::make_shared<MCTSNode>(rootState, nullptr, QString(), searchSpaceFor(rootState));
+    const double explorationParam = m_config.mctsExplorationParam();
+    std::atomic<bool> stopRequested{false};
+    std::atomic<long long> iterationsDone{0};
+
+    // Own threads rather than the task executor's, so the thread count is exact (scaling benchmarks)
+    QThreadPool pool;
+    pool.setMaxThreadCount(std::max(1, threads));
+    for (int i = 0; i < pool.maxThreadCount(); ++i) {
+        pool.start([&, i]() {
+            std::mt19937 threadRandomEngine(seed + static_cast<quint32>(i) * 7919u);
+            try {
+                while (!stopRequested.load(std::memory_order_relaxed)) {
+                    runSingleMctsIteration(rootNode, weights, evalWeights, explorationParam, threadRandomEngine);
+                    iterationsDone.fetch_add(1, std::memory_order_relaxed);
+                }
+            } catch (const std::exception& e) {
+                qCritical() << "Exception in timed MCTS worker thread" << i << ":" << e.what();
+            }
+        });
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for (double seconds : checkpointSeconds) {
+        qint64 dueMs = static_cast<qint64>(seconds * 1000.0);
+        qint64 remainingMs = dueMs - timer.elapsed();
+        if (remainingMs > 0) QThread::msleep(static_cast<unsigned long>(remainingMs));
+        results.append(getMctsResults(rootNode)); // Safe while workers run
+        long long done = iterationsDone.load(std::memory_order_relaxed);
+        if (iterations) iterations->append(done);
+        if (onCheckpoint && !onCheckpoint(results.last(), done)) break;
+    }
+    stopRequested = true;
+    pool.waitForDone();
+    return results;
+}
+
+std::shared_ptr<const QSet<QString>> MCTSManager::activeRosterFor(const DraftState& rootState) const {
+    return activeRosterFor(rootState, stats());
+}
+
+std::shared_ptr<const QSet<QString>> MCTSManager::activeRosterFor(const DraftState& rootState,
+                                                                  const StatsCalculator& statsCalculator) const {
+    if (!m_activeRosterPruning) return nullptr;
+    return statsCalculator.activeRoster(rootState.mapName(), rootState.modeName());
+}
+
+std::shared_ptr<const MCTSSearchSpace> MCTSManager::searchSpaceFor(const DraftState& rootState) const {
+    return searchSpaceFor(rootState, stats());
+}
+
+std::shared_ptr<const MCTSSearchSpace> MCTSManager::searchSpaceFor(const DraftState& rootState,
+                                                                   const StatsCalculator& statsCalculator) const {
+    auto space = std::make_shared<MCTSSearchSpace>();
+    space->activeRoster = activeRosterFor(rootState, statsCalculator);
+    if (m_moveClusters) space->clusters = m_moveClusters->table(rootState.mapName(), rootState.modeName());
+    space->byteCap = MemoryLedger::capBytes(MemorySubsystem::SearchTrees, m_config);
+    return space;
+}
+
+void MCTSManager::setMoveClusters(std::shared_ptr<const MoveClusters> clusters) {
+    if (isRunning()) {
+        qWarning() << "Ignoring move cluster change while MCTS is running.";
+        return;
+    }
+    m_moveClusters = std::move(clusters);
+    qInfo() << "MCTS selection:" << (m_moveClusters ? "two-level (cluster, then member)" : "one-level");
+}
+
+void MCTSManager::setStatsSnapshot(std::shared_ptr<const StatsCalculator> stats) {
+    m_nextStats = std::move(stats);
+}
+
+void MCTSManager::setRolloutPolicy(const PolicyTable* policyTable) {
+    if (isRunning()) {
+        qWarning() << "Ignoring rollout policy change while MCTS is running.";
+        return;
+    }
+    m_rolloutPolicy = policyTable;
+    qInfo() << "MCTS rollout policy:" << (policyTable ? "distilled policy table" : "heuristic");
+}
+
+void MCTSManager::setSnapshotDirectory(const QString& directory) {
+    if (isRunning()) {
+        qWarning() << "Ignoring snapshot directory change while MCTS is running.";
+        return;
+    }
+    m_snapshotDirectory = directory;
+    if (directory.isEmpty()) return;
+
+    // Snapshots of older packs can never be resumed again
+    QDir dir(directory);
+    QString currentSuffix = QString("-%1.snap").arg(m_statsCalculator.packVersion());
+    for (const QString& name : dir.entryList({"*.snap"}, QDir::Files)) {
+        if (!name.endsWith(currentSuffix)) dir.remove(name);
+    }
+    qInfo() << "MCTS snapshots in" << directory;
+}
+
+QString MCTSManager::snapshotPath(const DraftState& rootState) const {
+    return QDir(m_snapshotDirectory).filePath(TreeSnapshot::fileNameFor(rootState, stats().packVersion()));
+}
+
+std::optional<TreeSnapshot> MCTSManager::loadSnapshot(const DraftState& rootState, const QString& weightsKey) const {
+    if (m_snapshotDirectory.isEmpty() || !m_config.mctsResumeSnapshots()) return std::nullopt;
+    return TreeSnapshot::load(snapshotPath(rootState), rootState, stats().packVersion(), weightsKey);
+}
+
+void MCTSManager::saveSnapshot(const TreeSnapshot& snapshot, const DraftState& rootState) const {
+    if (m_snapshotDirectory.isEmpty() || snapshot.nodes.isEmpty()) return;
+    if (snapshot.save(snapshotPath(rootState))) {
+        qInfo() << "Saved MCTS snapshot:" << snapshot.nodes.size() << "nodes," << snapshot.rootVisits() << "visits.";
+    }
+}
+
+void MCTSManager::setWorkerProcesses(int processes, const QString& packPath) {
+    if (isRunning()) {
+        qWarning() << "Ignoring worker process change while MCTS is running.";
+        return;
+    }
+    if (processes > 0 && !SharedTreeSearch::isSupported()) {
+        qWarning() << "Multi-process MCTS is not supported on this platform; using threads.";
+        processes = 0;
+    }
+    m_workerProcesses = std::clamp(processes, 0, SharedTreeSearch::MAX_WORKERS);
+    m_workerPackPath = packPath;
+    qInfo() << "MCTS mode:" << (m_workerProcesses > 0 ? QString("%1 worker processes").arg(m_workerProcesses)
+                                                       : QString("in-process threads"));
+}
+
+// --- Sessions ---
+
+std::shared_ptr<MCTSSession> MCTSManager::createSession(const DraftState& rootState,
+                                                        const HeuristicWeights& weights) const {
+    if (rootState.isComplete() || rootState.getLegalMoves().isEmpty()) return nullptr;
+
+    auto session = std::make_shared<MCTSSession>();
+    session->weights = weights;
+    session->evalWeights = m_config.evalWeights();
+    session->explorationParam = m_config.mctsExplorationParam();
+    session->weightsKey = TreeSnapshot::weightsKeyFor(weights, session->evalWeights);
+    session->stats = m_nextStats;
+    const StatsCalculator& statsCalculator = session->stats ? *session->stats : m_statsCalculator;
+
+    std::shared_ptr<const MCTSSearchSpace> space = searchSpaceFor(rootState, statsCalculator);
+    if (std::optional<TreeSnapshot> snapshot = loadSnapshot(rootState, session->weightsKey)) {
+        session->root = snapshot->restore(rootState, space);
+        qInfo() << "MCTS session resumed from snapshot with" << snapshot->rootVisits() << "visits.";
+    } else {
+        session->root = std::make_shared<MCTSNode>(rootState, nullptr, QString(), space);
+    }
+    return session;
+}
+
+void MCTSManager::runSessionIteration(const MCTSSession& session, std::mt19937& randomEngine) const {
+    runSingleMctsIteration(session.root, session.weights, session.evalWeights, session.explorationParam, randomEngine,
+                           session.stats ? *session.stats : m_statsCalculator);
+}
+
+void MCTSManager::saveSessionSnapshot(const MCTSSession& session) const {
+    const StatsCalculator& statsCalculator = session.stats ? *session.stats : m_statsCalculator;
+    saveSnapshot(TreeSnapshot::capture(session.root, session.weightsKey, statsCalculator.packVersion()),
+                 session.root->state);
+}
+
+long long MCTSManager::iterationsDone() const {
+    return m_totalIterationsDone.load(std::memory_order_relaxed);
+}
+
 void MCTSManager::stopMcts() {
     if (!m_stopRequested.load()) { // Only signal stop once
         qInfo() << "Signaling MCTS threads to stop...";
         m_stopRequested = true;
-        // Workers and controller will check this flag and exit their loops.
+        m_searchToken.cancel();
+        // Worker slices and the controller check these and exit their loops.
         // Optionally wait for controller future here if needed immediately,
         // but destructor handles waiting.
     }
 }
 
+void MCTSManager::runWorkerSlice(std::shared_ptr<MCTSNode> rootNode, HeuristicWeights weights, EvalWeights evalWeights,
+                                 double explorationParam, std::shared_ptr<const StatsCalculator> stats,
+                                 CancellationToken token) {
+    // One engine per executor thread, seeded uniquely, whichever search its slices belong to
+    thread_local std::mt19937 threadRandomEngine(std::random_device{}());
+    QElapsedTimer slice;
+    slice.start();
+    try {
+        const StatsCalculator& statsCalculator = stats ? *stats : m_statsCalculator;
+        while (!token.isCancelled() && slice.elapsed() < WORKER_SLICE_MS) {
+            runSingleMctsIteration(rootNode, weights, evalWeights, explorationParam, threadRandomEngine, statsCalculator);
+            m_totalIterationsDone.fetch_add(1, std::memory_order_relaxed);
+        }
+    } catch (const std::exception& e) {
+        qCritical() << "Exception in MCTS worker slice:" << e.what();
+        return; // This chain ends; the controller still stops the search on time
+    }
+    // Queued again rather than looping, so other interactive tasks interleave with the search
+    m_workerTasks.submit([this, rootNode, weights, evalWeights, explorationParam, stats, token]() {
+        runWorkerSlice(rootNode, weights, evalWeights, explorationParam, stats, token);
+    }, TaskPriority::Interactive, token);
+}
+
+void MCTSManager::runSingleMctsIteration(std::shared_ptr<MCTSNode> rootNode, const HeuristicWeights& weights, const EvalWeights& evalWeights, double explorationParam, std::mt19937& randomEngine) const
+{
+    runSingleMctsIteration(std::move(rootNode), weights, evalWeights, explorationParam, randomEngine, stats());
+}
+
 // New function: Performs one MCTS iteration (Select, Expand, Simulate, Backprop)
 // This is the core logic executed by each worker thread.
-void MCTSManager::runSingleMctsIteration(std::shared_ptr<MCTSNode> rootNode, const HeuristicWeights& weights, double explorationParam, std::mt19937& randomEngine)
+void MCTSManager::runSingleMctsIteration(std::shared_ptr<MCTSNode> rootNode, const HeuristicWeights& weights, const EvalWeights& evalWeights, double explorationParam, std::mt19937& randomEngine, const StatsCalculator& statsCalculator) const
 {
     // 1. Selection
     std::shared_ptr<MCTSNode> node = rootNode;
@@ -254,7 +635,9 @@ void MCTSManager::runSingleMctsIteration(std::shared_ptr<MCTSNode> rootNode, con
 
     // 3. Simulation
     // simulateRollout needs the worker's random engine
-    double result = simulateRollout(node->state, weights, randomEngine); // Result is win prob for T1
+    double result = simulateRollout(node->state, weights, evalWeights, randomEngine,
+                                    node->space ? node->space->activeRoster.get() : nullptr,
+                                    statsCalculator); // Result is win prob for T1
 
     // 4. Backpropagation
     std::shared_ptr<MCTSNode> tempNode = node;
@@ -299,6 +682,8 @@ void MCTSManager::runMctsControllerTask(std::shared_ptr<MCTSNode> rootNode, Heur
         int reportIntervalMs = 200; // How often to check status/emit reports
         int intermediateResultIntervalMs = m_config.mctsUpdateIntervalIters() > 0 ? 1000 : 0; // Approx interval for intermediate results (e.g., 1 sec)
         qint64 nextIntermediateResultTime = intermediateResultIntervalMs > 0 ? timer.elapsed() + intermediateResultIntervalMs : -1;
+        qint64 snapshotIntervalMs = static_cast<qint64>(m_config.mctsSnapshotInterval()) * 1000;
+        qint64 nextSnapshotTime = snapshotIntervalMs;
 
         qInfo() << "MCTS Controller Task Started.";
 
@@ -333,6 +718,13 @@ void MCTSManager::runMctsControllerTask(std::shared_ptr<MCTSNode> rootNode, Heur
                 nextIntermediateResultTime = elapsed + intermediateResultIntervalMs; // Schedule next report
             }
 
+            // Periodic snapshot, so a long search survives the app closing
+            if (snapshotIntervalMs > 0 && elapsed >= nextSnapshotTime) {
+                saveSnapshot(TreeSnapshot::capture(rootNode, m_activeWeightsKey, stats().packVersion()),
+                             rootNode->state);
+                nextSnapshotTime = elapsed + snapshotIntervalMs;
+            }
+
 
             // Sleep briefly to avoid busy-waiting
             QThread::msleep(reportIntervalMs); // Check every ~200ms
@@ -346,6 +738,9 @@ void MCTSManager::runMctsControllerTask(std::shared_ptr<MCTSNode> rootNode, Heur
         }
 
         qInfo() << "MCTS Controller task finishing. Total iterations:" << m_totalIterationsDone.load();
+        const MCTSSearchSpace& space = *rootNode->space;
+        qInfo() << "MCTS tree:" << space.treeBytes.load() / 1024 << "KB"
+                << (space.atByteCap() ? "(at MemoryCapSearchTreesMB)" : "") << "| Memory:" << MemoryLedger::summary();
 
         // Wait briefly for worker threads to potentially finish their current iteration after stop signal
         // This is optional and might not be strictly necessary.
@@ -354,6 +749,8 @@ void MCTSManager::runMctsControllerTask(std::shared_ptr<MCTSNode> rootNode, Heur
         // Get and emit final results
         QVector<MCTSResult> finalResults = getMctsResults(rootNode);
         emit mctsFinalResult(finalResults);
+        saveSnapshot(TreeSnapshot::capture(rootNode, m_activeWeightsKey, stats().packVersion()),
+                     rootNode->state);
 
 
     } catch (const std::exception& e) {
@@ -372,26 +769,132 @@ void MCTSManager::runMctsControllerTask(std::shared_ptr<MCTSNode> rootNode, Heur
 }
 
 
+void MCTSManager::runSharedTreeControllerTask(DraftState rootState, HeuristicWeights weights, EvalWeights evalWeights,
+                                              double explorationParam) {
+    SharedSearchSpec spec = SharedSearchSpec::fromState(rootState);
+    spec.weights = weights;
+    spec.evalWeights = evalWeights;
+    spec.explorationParam = explorationParam;
+    spec.packVersion = m_statsCalculator.packVersion();
+    if (std::shared_ptr<const QSet<QString>> activeRoster = activeRosterFor(rootState)) {
+        spec.activeRoster = QStringList(activeRoster->begin(), activeRoster->end());
+        spec.activeRoster.sort();
+    }
+
+    quint32 nodeCapacity = m_config.mctsSharedTreeNodes();
+    const qint64 treeCap = MemoryLedger::capBytes(MemorySubsystem::SearchTrees, m_config);
+    if (treeCap > 0 && SharedTreeSearch::capacityForBytes(treeCap) < nodeCapacity) {
+        nodeCapacity = std::max<quint32>(1024, SharedTreeSearch::capacityForBytes(treeCap));
+        qInfo() << "Shared tree limited to" << nodeCapacity << "nodes by MemoryCapSearchTreesMB.";
+    }
+
+    // Lives on this thread: QProcess objects must be used from the thread that created them
+    SharedTreeSearch search(QCoreApplication::applicationFilePath(), m_workerPackPath);
+    std::optional<TreeSnapshot> snapshot = loadSnapshot(rootState, m_activeWeightsKey);
+    try {
+        search.start(spec, m_workerProcesses, nodeCapacity, snapshot ? &*snapshot : nullptr);
+    } catch (const std::exception& e) {
+        qCritical() << "Shared-tree MCTS failed to start:" << e.what();
+        emit mctsError(QString("MCTS worker processes failed to start: %1").arg(e.what()));
+        emit mctsFinished();
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    double timeLimitMs = m_config.mctsTimeLimit() * 1000.0;
+    int reportIntervalMs = 200;
+    int intermediateResultIntervalMs = m_config.mctsUpdateIntervalIters() > 0 ? 1000 : 0;
+    qint64 nextIntermediateResultTime = intermediateResultIntervalMs;
+    qint64 snapshotIntervalMs = static_cast<qint64>(m_config.mctsSnapshotInterval()) * 1000;
+    qint64 nextSnapshotTime = snapshotIntervalMs;
+
+    while (!m_stopRequested.load(std::memory_order_relaxed)) {
+        qint64 elapsed = timer.elapsed();
+        if (elapsed >= timeLimitMs) {
+            qInfo() << "MCTS time limit (" << m_config.mctsTimeLimit() << "s) reached by shared-tree controller.";
+            emit mctsStatusUpdate("MCTS Time Limit Reached");
+            stopMcts();
+            break;
+        }
+
+        search.superviseWorkers();
+        SharedTreeTelemetry telemetry = search.telemetry();
+        m_totalIterationsDone.store(static_cast<long long>(telemetry.iterations), std::memory_order_relaxed);
+        int alive = std::count_if(telemetry.workers.begin(), telemetry.workers.end(),
+                                  [](const SharedWorkerTelemetry& w) { return w.alive; });
+        emit mctsStatusUpdate(QString("Running MCTS: %1 iter, %2/%3 processes (%4s / %5s)%6")
+                              .arg(telemetry.iterations).arg(alive).arg(telemetry.workers.size())
+                              .arg(elapsed / 1000.0, 0, 'f', 1)
+                              .arg(m_config.mctsTimeLimit(), 0, 'f', 1)
+                              .arg(telemetry.treeFull ? ", tree full" : ""));
+
+        if (intermediateResultIntervalMs > 0 && elapsed >= nextIntermediateResultTime) {
+            emit mctsIntermediateResult(search.results());
+            nextIntermediateResultTime = elapsed + intermediateResultIntervalMs;
+        }
+        if (snapshotIntervalMs > 0 && elapsed >= nextSnapshotTime) {
+            saveSnapshot(search.exportSnapshot(m_activeWeightsKey), rootState);
+            nextSnapshotTime = elapsed + snapshotIntervalMs;
+        }
+        QThread::msleep(reportIntervalMs);
+    }
+
+    if (m_stopRequested.load() && timer.elapsed() < timeLimitMs) {
+        emit mctsStatusUpdate("MCTS Stopped Early");
+    }
+    search.stop();
+
+    // --- Aggregate Telemetry ---
+    SharedTreeTelemetry telemetry = search.telemetry();
+    m_totalIterationsDone.store(static_cast<long long>(telemetry.iterations), std::memory_order_relaxed);
+    qInfo() << "Shared-tree MCTS finished:" << telemetry.iterations << "iterations,"
+            << telemetry.nodesUsed << "/" << telemetry.nodeCapacity << "nodes in" << timer.elapsed() << "ms.";
+    qInfo() << "Memory:" << MemoryLedger::summary();
+    for (const SharedWorkerTelemetry& worker : telemetry.workers) {
+        qInfo() << "  worker" << worker.slot << "pid" << worker.pid << ":" << worker.iterations
+                << "iterations," << worker.restarts << "restarts";
+    }
+
+    emit mctsFinalResult(search.results());
+    saveSnapshot(search.exportSnapshot(m_activeWeightsKey), rootState);
+    emit mctsFinished();
+}
+
+
 // Simulate a game rollout using heuristics (Needs engine reference)
-double MCTSManager::simulateRollout(DraftState currentState, const HeuristicWeights& weights, std::mt19937& randomEngine) const {
+double MCTSManager::simulateRollout(DraftState currentState, const HeuristicWeights& weights, const EvalWeights& evalWeights,
+                                    std::mt19937& randomEngine, const QSet<QString>* activeRoster) const {
+    return simulateRollout(std::move(currentState), weights, evalWeights, randomEngine, activeRoster, stats());
+}
+
+double MCTSManager::simulateRollout(DraftState currentState, const HeuristicWeights& weights, const EvalWeights& evalWeights,
+                                    std::mt19937& randomEngine, const QSet<QString>* activeRoster,
+                                    const StatsCalculator& statsCalculator) const {
     DraftState rolloutState = currentState; // Copy for simulation
 
     while (!rolloutState.isComplete()) {
-        QVector<QString> possibleMoves = rolloutState.getLegalMoves();
+        QVector<QString> possibleMoves = rolloutState.getLegalMoves(activeRoster);
         if (possibleMoves.isEmpty()) {
             qWarning() << "Rollout reached non-terminal state with no legal moves:" << rolloutState.toString();
             break;
         }
 
-        auto [heuristicMove, scores] = suggestPickHeuristic(rolloutState, m_statsCalculator, weights);
         QString move;
+        if (m_rolloutPolicy) {
+            // Distilled policy (empty if it has no model for this map)
+            move = m_rolloutPolicy->sampleMove(rolloutState, statsCalculator, randomEngine);
+        }
 
-        if (!heuristicMove.isEmpty() && possibleMoves.contains(heuristicMove)) {
-            move = heuristicMove;
-        } else {
-            // Use the PASSED worker's engine for fallback
-            std::uniform_int_distribution<qsizetype> dist(0, possibleMoves.size() - 1);
-            move = possibleMoves[dist(randomEngine)];
+        if (move.isEmpty()) {
+            auto [heuristicMove, scores] = suggestPickHeuristic(rolloutState, statsCalculator, weights);
+            if (!heuristicMove.isEmpty() && possibleMoves.contains(heuristicMove)) {
+                move = heuristicMove;
+            } else {
+                // Use the PASSED worker's engine for fallback
+                std::uniform_int_distribution<qsizetype> dist(0, possibleMoves.size() - 1);
+                move = possibleMoves[dist(randomEngine)];
+            }
         }
 
         try {
@@ -409,7 +912,7 @@ double MCTSManager::simulateRollout(DraftState currentState, const HeuristicWeig
             winProbTeam1 = predictWinProbabilityModel(
                 rolloutState.team1Picks(), rolloutState.team2Picks(),
                 rolloutState.mapName(), rolloutState.modeName(),
-                m_statsCalculator, weights);
+                statsCalculator, evalWeights);
         } catch (const std::exception& e) {
             qCritical() << "Error during MCTS final evaluation:" << e.what();
             winProbTeam1 = 0.5;
@@ -425,17 +928,19 @@ double MCTSManager::simulateRollout(DraftState currentState, const HeuristicWeig
 // Extracts the results (top moves) from the root node's children
 QVector<MCTSResult> MCTSManager::getMctsResults(std::shared_ptr<MCTSNode> rootNode) const {
     QVector<MCTSResult> results;
-    if (!rootNode || rootNode->children.isEmpty()) {
+    if (!rootNode) {
         return results;
     }
 
-    // Reading children vector and atomic stats should be safe concurrently
-    // However, if children could be ADDED during this time (they shouldn't if expansion locks), a lock might be needed.
-    // Let's assume expansion lock prevents concurrent modification of the children vector *structure*.
-
-    results.reserve(rootNode->children.size());
+    // Copied under the node's lock: the root keeps widening (cluster mode) while results are read
+    QVector<std::shared_ptr<MCTSNode>> children;
+    {
+        QMutexLocker locker(&rootNode->mutex);
+        children = rootNode->children;
+    }
+    results.reserve(children.size());
 
-    for (const auto& child : rootNode->children) {
+    for (const auto& child : children) {
         int childVisits = child->visits.load(std::memory_order_relaxed);
         if (childVisits > 0) {
             double childWins = child->wins.load(std::memory_order_relaxed);
@@ -6,8 +6,8 @@
 #include <QString>
 #include <QFuture>
 #include <QMutex>
-#include <QThreadPool> // <-- ADD
 #include <atomic>
+#include <functional>
 #include <memory>
 #include <random>
 
@@ -16,8 +16,32 @@
 #include "StatsCalculator.h"
 #include "AppConfig.h"
 #include "Heuristics.h"
+#include "TreeSnapshot.h"
+#include "MemoryLedger.h"
+#include "TaskExecutor.h"
 
 class MCTSNode;
+class PolicyTable;
+class MoveClusters;
+struct MoveClusterTable;
+
+// What one tree branches over below its root; shared by all of its nodes
+struct MCTSSearchSpace {
+    // Map's active roster (nullptr = no pruning). Non-root nodes only branch over it; the root keeps
+    // every legal move so a pruned brawler can still be found as the answer to the actual question.
+    std::shared_ptr<const QSet<QString>> activeRoster;
+    // Set: two-level selection, UCT over clusters (statistics pooled over their expanded members),
+    // then over members; each node expands one member per cluster first, then widens
+    std::shared_ptr<const MoveClusterTable> clusters;
+    // Estimated bytes of the tree's nodes, charged to the ledger (SearchTrees) until the tree is
+    // gone. Once all live trees together reach byteCap (0: none) no node is added; selection runs
+    // down the existing tree and iterations roll out from its leaves.
+    mutable std::atomic<qint64> treeBytes{0};
+    qint64 byteCap = 0;
+
+    bool atByteCap() const { return byteCap > 0 && MemoryLedger::bytes(MemorySubsystem::SearchTrees) >= byteCap; }
+    ~MCTSSearchSpace() { MemoryLedger::charge(MemorySubsystem::SearchTrees, -treeBytes.load()); }
+};
 
 class MCTSNode : public std::enable_shared_from_this<MCTSNode> {
 public:
@@ -30,8 +54,10 @@ public:
     QVector<QString> untriedMoves;
     std::atomic<bool> isTerminal{false};
     QMutex mutex; // Protects untriedMoves and children during expansion
+    std::shared_ptr<const MCTSSearchSpace> space; // nullptr = every legal move, one-level UCT, no byte cap
 
-    MCTSNode(DraftState s, std::shared_ptr<MCTSNode> p = nullptr, QString m = "");
+    MCTSNode(DraftState s, std::shared_ptr<MCTSNode> p = nullptr, QString m = "",
+             std::shared_ptr<const MCTSSearchSpace> searchSpace = nullptr);
 
     bool isFullyExpanded();
     // uctSelectChild needs the engine for random tie-breaking/fallback
@@ -39,9 +65,32 @@ public:
     // expand needs the engine if random move selection is used (currently takes last)
     std::shared_ptr<MCTSNode> expand(/*std::mt19937& randomEngine*/); // Engine not needed if just taking last
     void update(double result);
+    // Appends an expanded child; caller holds 'mutex' (or owns the node exclusively)
+    void addChild(std::shared_ptr<MCTSNode> child);
+
+private:
+    const MoveClusterTable* clusterTable() const { return space ? space->clusters.get() : nullptr; }
+    int clusterSlot(const QString& brawler) const; // Unclustered moves share the last slot
+    int takeClusteredMove(); // Index into untriedMoves of the next move to expand in cluster mode
+    std::shared_ptr<MCTSNode> uctSelectClustered(double explorationParam, std::mt19937& randomEngine);
+
+    QVector<int> m_clusterChildren; // Expanded children per cluster slot (cluster mode)
+    int m_clustersWithMoves = 0;    // Slots that had legal moves when the node was created
+    int m_clustersExpanded = 0;     // Slots with at least one expanded child
 };
 
 
+// An interactive search tree with everything its iterations read, for searches driven from
+// outside the manager (see SearchScheduler). Any number of threads may iterate on it at once.
+struct MCTSSession {
+    std::shared_ptr<MCTSNode> root;
+    HeuristicWeights weights;
+    EvalWeights evalWeights;
+    double explorationParam = 0.0;
+    QString weightsKey; // Snapshot identity
+    std::shared_ptr<const StatsCalculator> stats; // Live stats it started on (nullptr: the manager's)
+};
+
 class MCTSManager : public QObject {
     Q_OBJECT
 
@@ -51,6 +100,71 @@ public:
 
     bool isRunning() const; // Checks if the controller task is running
 
+    // Synchronous fixed-budget search on the calling thread. Emits no signals and does not
+    // touch the interactive search, so batch jobs can run several of these in parallel.
+    // explorationParam <= 0 uses the configured value.
+    QVector<MCTSResult> runFixedBudget(const DraftState& rootState, const HeuristicWeights& weights,
+                                       const EvalWeights& evalWeights, int iterations, quint32 seed,
+                                       double explorationParam = 0.0) const;
+    // Synchronous timed search: 'threads' threads share one tree as in the interactive search (no
+    // signals, no snapshots). Results are read at each of 'checkpointSeconds' (ascending) while the
+    // workers keep going, so one run gives the whole anytime curve; it stops at the last one.
+    // 'iterations' receives the iteration count at each checkpoint. 'onCheckpoint' (optional) sees
+    // each checkpoint's results as they are taken, on the calling thread; returning false stops there.
+    using CheckpointCallback = std::function<bool(const QVector<MCTSResult>& results, long long iterations)>;
+    QVector<QVector<MCTSResult>> runTimed(const DraftState& rootState, const HeuristicWeights& weights,
+                                          const EvalWeights& evalWeights, const QVector<double>& checkpointSeconds,
+                                          int threads, quint32 seed, QVector<long long>* iterations = nullptr,
+                                          const CheckpointCallback& onCheckpoint = nullptr) const;
+
+    // Rollouts sample this distilled policy on maps it covers (nullptr = heuristic rollouts).
+    // Set only while no search is running; the table must outlive the manager.
+    void setRolloutPolicy(const PolicyTable* policyTable);
+
+    // processes > 0 runs interactive searches in that many worker processes sharing one tree in
+    // POSIX shared memory (see SharedTree.h); workers load 'packPath'. 0 = in-process threads.
+    // Set only while no search is running.
+    void setWorkerProcesses(int processes, const QString& packPath);
+
+    // Interactive searches save their tree here (on stop and every MctsSnapshotInterval seconds)
+    // and resume from a saved tree of the same position and stats pack. Empty disables.
+    // Snapshots of other pack versions in the directory are deleted.
+    void setSnapshotDirectory(const QString& directory);
+
+    // Iterations of the current (or last) interactive search
+    long long iterationsDone() const;
+    int workerProcesses() const { return m_workerProcesses; }
+
+    // --- Sessions ---
+    // Tree for an interactive search of 'rootState' on the current stats (see setStatsSnapshot),
+    // resumed from its snapshot when there is one; nullptr if the position has no legal move
+    std::shared_ptr<MCTSSession> createSession(const DraftState& rootState, const HeuristicWeights& weights) const;
+    void runSessionIteration(const MCTSSession& session, std::mt19937& randomEngine) const;
+    QVector<MCTSResult> sessionResults(const MCTSSession& session) const { return getMctsResults(session.root); }
+    void saveSessionSnapshot(const MCTSSession& session) const;
+
+    // One rollout to the end of the draft; returns Team 1's win probability. Public for worker processes.
+    // Random fallback moves stay inside 'activeRoster' when given.
+    double simulateRollout(DraftState currentState, const HeuristicWeights& weights, const EvalWeights& evalWeights,
+                           std::mt19937& randomEngine, const QSet<QString>* activeRoster = nullptr) const;
+
+    // Active roster searched below the root of 'rootState' (nullptr = every legal move)
+    std::shared_ptr<const QSet<QString>> activeRosterFor(const DraftState& rootState) const;
+    std::shared_ptr<const QSet<QString>> activeRosterFor(const DraftState& rootState,
+                                                         const StatsCalculator& statsCalculator) const;
+    // false: branch over every legal move even where the stats have an active roster
+    void setActiveRosterPruning(bool enabled) { m_activeRosterPruning = enabled; }
+    // Non-null: in-process searches use two-level (cluster, then member) selection on maps it covers.
+    // Set only while no search is running. Worker-process searches keep one-level selection.
+    void setMoveClusters(std::shared_ptr<const MoveClusters> clusters);
+    // Never null: it also carries the tree's byte count and MemoryCapSearchTreesMB
+    std::shared_ptr<const MCTSSearchSpace> searchSpaceFor(const DraftState& rootState) const;
+    std::shared_ptr<const MCTSSearchSpace> searchSpaceFor(const DraftState& rootState,
+                                                          const StatsCalculator& statsCalculator) const;
+    // Stats the next in-process search reads instead of the constructor's (nullptr: back to those).
+    // A running search keeps the stats it started with. Call from the manager's thread.
+    void setStatsSnapshot(std::shared_ptr<const StatsCalculator> stats);
+
 public slots:
     void startMcts(DraftState rootState, HeuristicWeights weights);
     void stopMcts();
@@ -65,17 +179,41 @@ signals:
 private:
     // Renamed: This is now the controller task managing time/reporting
     void runMctsControllerTask(std::shared_ptr<MCTSNode> rootNode, HeuristicWeights weights);
+    // Controller for the multi-process mode: owns the shared segment and supervises workers
+    void runSharedTreeControllerTask(DraftState rootState, HeuristicWeights weights, EvalWeights evalWeights,
+                                     double explorationParam);
+    // Iterations for WORKER_SLICE_MS, then queues the next slice unless 'token' is cancelled. Slices hold
+    // their search's stats ('stats', nullptr: m_statsCalculator), so a new search cannot swap them mid-slice.
+    void runWorkerSlice(std::shared_ptr<MCTSNode> rootNode, HeuristicWeights weights, EvalWeights evalWeights,
+                        double explorationParam, std::shared_ptr<const StatsCalculator> stats, CancellationToken token);
     // New: Represents the work done by ONE iteration in a worker thread
-    void runSingleMctsIteration(std::shared_ptr<MCTSNode> rootNode, const HeuristicWeights& weights, double explorationParam, std::mt19937& randomEngine);
+    void runSingleMctsIteration(std::shared_ptr<MCTSNode> rootNode, const HeuristicWeights& weights, const EvalWeights& evalWeights, double explorationParam, std::mt19937& randomEngine) const;
+    void runSingleMctsIteration(std::shared_ptr<MCTSNode> rootNode, const HeuristicWeights& weights, const EvalWeights& evalWeights, double explorationParam, std::mt19937& randomEngine, const StatsCalculator& statsCalculator) const;
+    double simulateRollout(DraftState currentState, const HeuristicWeights& weights, const EvalWeights& evalWeights,
+                           std::mt19937& randomEngine, const QSet<QString>* activeRoster,
+                           const StatsCalculator& statsCalculator) const;
 
     QVector<MCTSResult> getMctsResults(std::shared_ptr<MCTSNode> rootNode) const;
-    // simulateRollout now needs the engine reference again
-    double simulateRollout(DraftState currentState, const HeuristicWeights& weights, std::mt19937& randomEngine) const;
+
+    const StatsCalculator& stats() const { return m_searchStats ? *m_searchStats : m_statsCalculator; }
+    QString snapshotPath(const DraftState& rootState) const;
+    std::optional<TreeSnapshot> loadSnapshot(const DraftState& rootState, const QString& weightsKey) const;
+    void saveSnapshot(const TreeSnapshot& snapshot, const DraftState& rootState) const;
 
     const StatsCalculator& m_statsCalculator;
+    std::shared_ptr<const StatsCalculator> m_nextStats;   // setStatsSnapshot; adopted when a search starts
+    std::shared_ptr<const StatsCalculator> m_searchStats; // Read by the current search (nullptr: m_statsCalculator)
     const AppConfig& m_config;
-
-    QThreadPool m_threadPool; // Manages worker threads
+    const PolicyTable* m_rolloutPolicy = nullptr;
+    int m_workerProcesses = 0;
+    QString m_workerPackPath;
+    QString m_snapshotDirectory;
+    QString m_activeWeightsKey; // Weights of the running search, part of the snapshot identity
+    bool m_activeRosterPruning = true;
+    std::shared_ptr<const MoveClusters> m_moveClusters;
+
+    TaskGroup m_workerTasks; // Worker slices of in-process searches
+    CancellationToken m_searchToken; // The running search's; cancelled by stopMcts
     QFuture<void> m_controllerFuture; // Tracks the controller task
     std::atomic<bool> m_stopRequested{false};
     std::atomic<long long> m_totalIterationsDone{0}; // Counter across threads
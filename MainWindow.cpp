@@ -19,6 +19,13 @@
 #include <algorithm>
 #include <limits>
 #include <QCoreApplication> // Include for processEvents
+#include <QInputDialog>
+#include <QTimer>
+#include <QTabBar>
+#include <QSignalBlocker>
+#include "CompFinder.h"
+#include "MemoryLedger.h"
+#include "Bootstrap.h"
 
 
 // Constructor (no changes needed here unless dependencies changed)
@@ -33,9 +40,12 @@ MainWindow::MainWindow(const StatsCalculator& statsCalculator,
       m_allBrawlersMasterList(allBrawlers),
       m_mapModeData(mapModeData),
       m_config(config),
-      m_mctsManager(mctsManager)
+      m_mctsManager(mctsManager),
+      m_scheduler(new SearchScheduler(*mctsManager, config, this))
 {
-    setWindowTitle("Glizzy Draft");
+    setWindowTitle(statsCalculator.isApproximate()
+                   ? QString("Glizzy Draft (approximate stats, %1% sample)").arg(statsCalculator.sampleFraction() * 100.0, 0, 'f', 1)
+                   : QString("Glizzy Draft"));
     setWindowIcon(QIcon(":/icon.ico"));
 
     setupUi();
@@ -47,16 +57,43 @@ MainWindow::MainWindow(const StatsCalculator& statsCalculator,
 
 MainWindow::~MainWindow() {}
 
+void MainWindow::setPolicyTable(const PolicyTable* policyTable) {
+    m_policyTable = policyTable;
+    updateUiFromState();
+}
+
+void MainWindow::setStatsSnapshot(std::shared_ptr<const StatsCalculator> stats, qint64 newGames) {
+    m_liveStats = std::move(stats);
+    m_mctsManager->setStatsSnapshot(m_liveStats); // A running search finishes on the old stats
+    updateMapDataLabel();
+    setStatus(QString("Stats updated with %1 new games.").arg(newGames));
+}
+
 // Create and layout UI elements
 void MainWindow::setupUi() {
     QWidget *centralWidget = new QWidget(this);
     QVBoxLayout *mainLayout = new QVBoxLayout(centralWidget);
 
+    // --- 0. Draft Tabs ---
+    m_draftTabBar = new QTabBar();
+    m_draftTabBar->setTabsClosable(true);
+    m_draftTabBar->setExpanding(false);
+    m_newTabButton = new QPushButton("+ New Draft");
+    m_newTabButton->setToolTip("Follow another match; each tab keeps its own draft and deep search");
+    m_tabs.append(DraftTab());
+    m_draftTabBar->addTab("New draft");
+    m_activeTab = 0;
+    QHBoxLayout *tabLayout = new QHBoxLayout();
+    tabLayout->addWidget(m_draftTabBar, 1);
+    tabLayout->addWidget(m_newTabButton);
+    mainLayout->addLayout(tabLayout);
+
     // --- 1. Control Frame ---
     QGroupBox *controlGroup = new QGroupBox("Draft Setup");
     QHBoxLayout *controlLayout = new QHBoxLayout();
     m_modeComboBox = new QComboBox();
     m_mapComboBox = new QComboBox();
+    m_mapDataLabel = new QLabel();
     m_mctsTimeLineEdit = new QLineEdit(QString::number(m_config.mctsTimeLimit()));
     m_mctsTimeLineEdit->setValidator(new QDoubleValidator(0.1, 600.0, 1, this));
     m_mctsTimeLineEdit->setFixedWidth(50);
@@ -66,6 +103,7 @@ void MainWindow::setupUi() {
     controlLayout->addWidget(m_modeComboBox);
     controlLayout->addWidget(new QLabel("Map:"));
     controlLayout->addWidget(m_mapComboBox);
+    controlLayout->addWidget(m_mapDataLabel);
     controlLayout->addStretch(1);
     controlLayout->addWidget(new QLabel("MCTS Time (s):"));
     controlLayout->addWidget(m_mctsTimeLineEdit);
@@ -146,26 +184,32 @@ void MainWindow::setupUi() {
 
     m_suggestHeuristicButton = new QPushButton("Suggest Pick (Fast)");
     m_suggestMctsButton = new QPushButton("Suggest Pick (Deep)");
+    m_suggestPolicyButton = new QPushButton("Suggest Pick (Instant)");
+    m_suggestPolicyButton->setToolTip("Distilled policy table (run 'GlizzyDraft distill' to create policy.table)");
     m_suggestBanButton = new QPushButton("Suggest Ban");
+    m_bestResponseButton = new QPushButton("Best Response");
+    m_bestResponseButton->setToolTip("Top teams for the side to move against a given enemy team");
     m_stopMctsButton = new QPushButton("Stop MCTS"); m_stopMctsButton->setEnabled(false);
 
     suggestionLayout->addWidget(m_suggestHeuristicButton, 0, 0);
     suggestionLayout->addWidget(m_suggestMctsButton, 0, 1);
-    suggestionLayout->addWidget(m_suggestBanButton, 0, 2);
-    suggestionLayout->addWidget(m_stopMctsButton, 0, 3);
+    suggestionLayout->addWidget(m_suggestPolicyButton, 0, 2);
+    suggestionLayout->addWidget(m_suggestBanButton, 0, 3);
+    suggestionLayout->addWidget(m_bestResponseButton, 0, 4);
+    suggestionLayout->addWidget(m_stopMctsButton, 0, 5);
 
     m_suggestionLabel = new QLabel("Suggestion: -");
     m_suggestionLabel->setStyleSheet("font-weight: bold; font-size: 12pt;");
     m_suggestionLabel->setWordWrap(true);
-    suggestionLayout->addWidget(m_suggestionLabel, 1, 0, 1, 4);
+    suggestionLayout->addWidget(m_suggestionLabel, 1, 0, 1, 6);
 
     m_scoresTitleLabel = new QLabel("Details:");
-    suggestionLayout->addWidget(m_scoresTitleLabel, 2, 0, 1, 4);
+    suggestionLayout->addWidget(m_scoresTitleLabel, 2, 0, 1, 6);
 
     m_scoresTextEdit = new QTextEdit();
     m_scoresTextEdit->setReadOnly(true);
     m_scoresTextEdit->setLineWrapMode(QTextEdit::NoWrap);
-    suggestionLayout->addWidget(m_scoresTextEdit, 3, 0, 1, 4);
+    suggestionLayout->addWidget(m_scoresTextEdit, 3, 0, 1, 6);
 
     suggestionGroup->setLayout(suggestionLayout);
     mainLayout->addWidget(suggestionGroup);
@@ -174,6 +218,8 @@ void MainWindow::setupUi() {
     // --- 5. Status Bar --- (No changes here)
     m_statusLabel = new QLabel("Status: Initializing...");
     statusBar()->addWidget(m_statusLabel, 1);
+    m_memoryLabel = new QLabel();
+    statusBar()->addPermanentWidget(m_memoryLabel);
     statusBar()->addPermanentWidget(new QLabel("Made by Texesh"));
 
 
@@ -184,6 +230,11 @@ void MainWindow::setupUi() {
 
 // Connect signals to slots (No changes needed related to weights)
 void MainWindow::setupConnections() {
+    // Draft Tabs
+    connect(m_draftTabBar, &QTabBar::currentChanged, this, &MainWindow::onDraftTabChanged);
+    connect(m_draftTabBar, &QTabBar::tabCloseRequested, this, &MainWindow::onDraftTabCloseRequested);
+    connect(m_newTabButton, &QPushButton::clicked, this, &MainWindow::onNewDraftTabClicked);
+
     // Control Frame
     connect(m_modeComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(onModeChanged(int)));
     connect(m_mapComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(onMapChanged(int)));
@@ -204,15 +255,23 @@ void MainWindow::setupConnections() {
     // Suggestion Frame
     connect(m_suggestHeuristicButton, &QPushButton::clicked, this, &MainWindow::onSuggestHeuristicClicked);
     connect(m_suggestMctsButton, &QPushButton::clicked, this, &MainWindow::onSuggestMctsClicked);
+    connect(m_suggestPolicyButton, &QPushButton::clicked, this, &MainWindow::onSuggestPolicyClicked);
     connect(m_suggestBanButton, &QPushButton::clicked, this, &MainWindow::onSuggestBanClicked);
+    connect(m_bestResponseButton, &QPushButton::clicked, this, &MainWindow::onBestResponseClicked);
     connect(m_stopMctsButton, &QPushButton::clicked, this, &MainWindow::onStopMctsClicked);
 
-    // MCTS Manager Signals -> MainWindow Slots
-    connect(m_mctsManager, &MCTSManager::mctsStatusUpdate, this, &MainWindow::handleMctsStatus);
-    connect(m_mctsManager, &MCTSManager::mctsIntermediateResult, this, &MainWindow::handleMctsIntermediateResult);
-    connect(m_mctsManager, &MCTSManager::mctsFinalResult, this, &MainWindow::handleMctsFinalResult);
-    connect(m_mctsManager, &MCTSManager::mctsError, this, &MainWindow::handleMctsError);
-    connect(m_mctsManager, &MCTSManager::mctsFinished, this, &MainWindow::handleMctsFinished);
+    // Search Scheduler Signals -> MainWindow Slots
+    connect(m_scheduler, &SearchScheduler::sessionStatus, this, &MainWindow::handleMctsStatus);
+    connect(m_scheduler, &SearchScheduler::sessionIntermediateResult, this, &MainWindow::handleMctsIntermediateResult);
+    connect(m_scheduler, &SearchScheduler::sessionFinalResult, this, &MainWindow::handleMctsFinalResult);
+    connect(m_scheduler, &SearchScheduler::sessionError, this, &MainWindow::handleMctsError);
+    connect(m_scheduler, &SearchScheduler::sessionFinished, this, &MainWindow::handleMctsFinished);
+
+    // Memory display: refreshed periodically (trees grow during a search) and after each search
+    auto* memoryTimer = new QTimer(this);
+    connect(memoryTimer, &QTimer::timeout, this, &MainWindow::updateMemoryDisplay);
+    memoryTimer->start(5000);
+    updateMemoryDisplay();
 }
 
 // Populate initial dropdown data (No changes needed)
@@ -233,18 +292,134 @@ void MainWindow::loadInitialData() {
 
 // --- Slot Implementations ---
 
+// --- Draft Tabs ---
+void MainWindow::onDraftTabChanged(int index) {
+    if (index < 0 || index >= m_tabs.size() || index == m_activeTab) return;
+    storeActiveTab();
+    m_activeTab = index;
+    m_scheduler->setFocusedSession(m_tabs[index].session);
+    restoreActiveTab();
+}
+
+void MainWindow::onDraftTabCloseRequested(int index) {
+    if (index < 0 || index >= m_tabs.size()) return;
+    if (m_tabs.size() == 1) {
+        setStatus("The last draft tab cannot be closed; use Reset Draft.");
+        return;
+    }
+    // Its search winds down in the background (the final snapshot is still saved)
+    m_scheduler->stopSession(m_tabs[index].session);
+    m_tabs.removeAt(index);
+    if (index == m_activeTab) {
+        m_activeTab = -1; // Nothing to store
+    } else if (index < m_activeTab) {
+        --m_activeTab;
+    }
+    {
+        QSignalBlocker blocker(m_draftTabBar);
+        m_draftTabBar->removeTab(index);
+    }
+    if (m_activeTab < 0) onDraftTabChanged(m_draftTabBar->currentIndex());
+}
+
+void MainWindow::onNewDraftTabClicked() {
+    m_tabs.append(DraftTab());
+    int index = m_draftTabBar->addTab("New draft");
+    m_draftTabBar->setCurrentIndex(index);
+}
+
+void MainWindow::storeActiveTab() {
+    if (m_activeTab < 0) return;
+    DraftTab& tab = m_tabs[m_activeTab];
+    tab.state = m_currentDraftState;
+    tab.mode = m_modeComboBox->currentText();
+    tab.map = m_mapComboBox->currentText();
+    tab.searchText = m_searchLineEdit->text();
+    tab.suggestion = m_suggestionLabel->text();
+    tab.detailsTitle = m_scoresTitleLabel->text();
+    tab.details = m_scoresTextEdit->toPlainText();
+    tab.status = m_statusLabel->text();
+    tab.statusIsError = !m_statusLabel->styleSheet().isEmpty();
+}
+
+void MainWindow::restoreActiveTab() {
+    const DraftTab& tab = m_tabs[m_activeTab];
+    {
+        QSignalBlocker searchBlocker(m_searchLineEdit);
+        m_searchLineEdit->setText(tab.searchText);
+    }
+    if (tab.mode.isEmpty()) {
+        // New tab: first mode and map, fresh draft
+        m_currentDraftState.reset();
+        setControlsEnabled(true);
+        {
+            QSignalBlocker modeBlocker(m_modeComboBox);
+            m_modeComboBox->setCurrentIndex(0);
+        }
+        onModeChanged(m_modeComboBox->currentIndex());
+        return;
+    }
+
+    {
+        QSignalBlocker modeBlocker(m_modeComboBox);
+        QSignalBlocker mapBlocker(m_mapComboBox);
+        m_modeComboBox->setCurrentText(tab.mode);
+        populateMapList(tab.mode);
+        m_mapComboBox->setCurrentText(tab.map);
+    }
+    m_currentDraftState = tab.state;
+    m_suggestionLabel->setText(tab.suggestion);
+    m_scoresTitleLabel->setText(tab.detailsTitle);
+    m_scoresTextEdit->setFontFamily("monospace");
+    m_scoresTextEdit->setText(tab.details);
+    m_statusLabel->setText(tab.status);
+    m_statusLabel->setStyleSheet(tab.statusIsError ? "color: red;" : "");
+
+    bool searching = m_scheduler->isRunning(tab.session);
+    setControlsEnabled(!searching); // Re-enabling refreshes the lists itself
+    if (searching) updateUiFromState();
+}
+
+void MainWindow::populateMapList(const QString& mode) {
+    m_mapComboBox->clear();
+    QStringList mapsList = m_mapModeData.value(mode).values();
+    std::sort(mapsList.begin(), mapsList.end());
+    m_mapComboBox->addItems(mapsList);
+}
+
+void MainWindow::updateTabTitle(int index) {
+    if (index < 0 || index >= m_tabs.size()) return;
+    const std::optional<DraftState>& state = (index == m_activeTab) ? m_currentDraftState : m_tabs[index].state;
+    bool searching = m_scheduler->isRunning(m_tabs[index].session);
+    QString title = "New draft";
+    if (state) {
+        title = QString("%1 (%2)").arg(state->mapName(), state->isComplete() ? QString("done")
+                                                                               : QString("pick %1").arg(state->currentPickNumber()));
+        m_draftTabBar->setTabToolTip(index, QString("%1 - %2").arg(state->modeName(), state->mapName()));
+    }
+    m_draftTabBar->setTabText(index, searching ? title + " *" : title);
+}
+
+int MainWindow::tabForSession(int session) const {
+    if (session == 0) return -1;
+    for (int i = 0; i < m_tabs.size(); ++i) {
+        if (m_tabs[i].session == session) return i;
+    }
+    return -1;
+}
+
+bool MainWindow::activeTabSearching() const {
+    return m_activeTab >= 0 && m_scheduler->isRunning(m_tabs[m_activeTab].session);
+}
+
 // onModeChanged, onMapChanged, onResetDraftClicked, validateMctsTimeInput (No changes needed)
 void MainWindow::onModeChanged(int index) {
     if (index < 0) return;
     QString selectedMode = m_modeComboBox->itemText(index);
 
-    m_mapComboBox->clear();
+    populateMapList(selectedMode); // Empty for an unknown mode
     if (m_mapModeData.contains(selectedMode)) {
-        QSet<QString> mapsSet = m_mapModeData.value(selectedMode);
-        QStringList mapsList = mapsSet.values();
-        std::sort(mapsList.begin(), mapsList.end());
-        m_mapComboBox->addItems(mapsList);
-        if (!mapsList.isEmpty()) {
+        if (m_mapComboBox->count() > 0) {
             m_mapComboBox->setCurrentIndex(0);
             onMapChanged(0);
         } else {
@@ -286,8 +461,8 @@ void MainWindow::validateMctsTimeInput() {
 
 
 void MainWindow::initializeDraft() {
-    if (m_mctsManager->isRunning()) {
-        QMessageBox::warning(this, "MCTS Running", "Stop MCTS before starting a new draft.");
+    if (activeTabSearching()) {
+        QMessageBox::warning(this, "MCTS Running", "Stop this tab's MCTS before starting a new draft (or open a new tab).");
         return;
     }
 
@@ -323,7 +498,7 @@ void MainWindow::initializeDraft() {
 // --- Draft Action Slots ---
 // onPickTeam1Clicked, onPickTeam2Clicked, onBanClicked, onUnbanClicked (No changes needed)
 void MainWindow::onPickTeam1Clicked() {
-    if (!m_currentDraftState || m_mctsManager->isRunning()) return;
+    if (!m_currentDraftState || activeTabSearching()) return;
     QString brawler = getSelectedListWidgetItemText(m_availableListWidget);
     if (brawler.isEmpty()) { setStatus("Select a brawler from 'Available'.", true); return; }
 
@@ -346,7 +521,7 @@ void MainWindow::onPickTeam1Clicked() {
     }
 }
 void MainWindow::onPickTeam2Clicked() {
-     if (!m_currentDraftState || m_mctsManager->isRunning()) return;
+     if (!m_currentDraftState || activeTabSearching()) return;
     QString brawler = getSelectedListWidgetItemText(m_availableListWidget);
     if (brawler.isEmpty()) { setStatus("Select a brawler from 'Available'.", true); return; }
 
@@ -369,12 +544,12 @@ void MainWindow::onPickTeam2Clicked() {
     }
 }
 void MainWindow::onBanClicked() {
-     if (!m_currentDraftState || m_mctsManager->isRunning()) return;
+     if (!m_currentDraftState || activeTabSearching()) return;
     QString brawler = getSelectedListWidgetItemText(m_availableListWidget);
     if (brawler.isEmpty()) { setStatus("Select a brawler from 'Available'.", true); return; }
 
     try {
-         if (m_currentDraftState->bans().size() >= 6) throw std::logic_error("Max bans (6) reached.");
+         if (m_currentDraftState->bans().size() >= m_currentDraftState->format().maxBans) throw std::logic_error("Max bans reached.");
         m_currentDraftState = m_currentDraftState->applyBan(brawler);
         setStatus(QString("Banned %1.").arg(brawler), false, true);
          qInfo() << "Action: Banned" << brawler << ". New state:" << m_currentDraftState->toString();
@@ -392,7 +567,7 @@ void MainWindow::onBanClicked() {
     }
 }
 void MainWindow::onUnbanClicked() {
-    if (!m_currentDraftState || m_mctsManager->isRunning()) return;
+    if (!m_currentDraftState || activeTabSearching()) return;
     QString brawler = getSelectedListWidgetItemText(m_bansListWidget);
     if (brawler.isEmpty()) { setStatus("Select a brawler from 'Bans'.", true); return; }
 
@@ -424,7 +599,7 @@ void MainWindow::onUnbanClicked() {
 // --- MODIFIED: onUndoPickClicked ---
 void MainWindow::onUndoPickClicked() {
     // **CRITICAL CHECK:** Ensure MCTS is not running before attempting undo
-    if (m_mctsManager->isRunning()) {
+    if (activeTabSearching()) {
         setStatus("Cannot undo while MCTS is running.", true);
         QMessageBox::warning(this, "Undo Failed", "Please wait for MCTS to finish or stop it before undoing.");
         return;
@@ -436,7 +611,7 @@ void MainWindow::onUndoPickClicked() {
        return;
     }
 
-    // Allow undo even if the draft is technically complete (pick number > 6)
+    // Allow undo even if the draft is technically complete (pick number > total picks)
     // if (m_currentDraftState->isComplete()){ setStatus("Cannot undo, draft complete."); return; } // REMOVED
 
     int currentPickNum = m_currentDraftState->currentPickNumber();
@@ -463,56 +638,18 @@ void MainWindow::onUndoPickClicked() {
 
     // Determine previous turn and remove last pick based on *current* pick number
     // (The pick number *before* the one being undone)
-    switch (currentPickNum) {
-        // Who made pick 'prevPickNum' (which is currentPickNum - 1)?
-        case 2: // T1 made pick 1
-            prevTurn = "team1";
-            if (!prevTeam1Picks.isEmpty()) {
-               lastPickedBrawler = prevTeam1Picks.last(); // Get brawler first
-               prevTeam1Picks.removeLast();               // Then remove
-            }
-            break;
-        case 3: // T2 made pick 2
-            prevTurn = "team2";
-            if (!prevTeam2Picks.isEmpty()) {
-               lastPickedBrawler = prevTeam2Picks.last();
-               prevTeam2Picks.removeLast();
-            }
-            break;
-        case 4: // T2 made pick 3
-            prevTurn = "team2";
-            if (!prevTeam2Picks.isEmpty()) {
-                lastPickedBrawler = prevTeam2Picks.last();
-                prevTeam2Picks.removeLast();
-             }
-            break;
-        case 5: // T1 made pick 4
-            prevTurn = "team1";
-            if (!prevTeam1Picks.isEmpty()) {
-                lastPickedBrawler = prevTeam1Picks.last();
-                prevTeam1Picks.removeLast();
-            }
-            break;
-        case 6: // T1 made pick 5
-            prevTurn = "team1";
-            if (!prevTeam1Picks.isEmpty()) {
-                 lastPickedBrawler = prevTeam1Picks.last();
-                 prevTeam1Picks.removeLast();
-             }
-            break;
-        case 7: // T2 made pick 6 (State is AFTER pick 6, so undoing pick 6)
-            prevTurn = "team2"; // The player whose turn it becomes is T2 (to make pick 6 again)
-            if (!prevTeam2Picks.isEmpty()) {
-                lastPickedBrawler = prevTeam2Picks.last();
-                prevTeam2Picks.removeLast();
-            }
-            // Corrected Logic: When pick # is 7 (after pick 6), undoing means going
-            // back to pick #6, and it was T2's turn to make that pick.
-            break;
-        default:
-            qWarning() << "Undo error: Unexpected current pick number" << currentPickNum;
-            setStatus("Undo failed (invalid state).", true);
-            return;
+    const DraftFormatInfo& format = m_currentDraftState->format();
+    if (prevPickNum > format.totalPicks) {
+        qWarning() << "Undo error: Unexpected current pick number" << currentPickNum;
+        setStatus("Undo failed (invalid state).", true);
+        return;
+    }
+    // Who made pick 'prevPickNum'? That side gets the turn back (snake order, see DraftFormat)
+    QVector<QString>& undoneTeam = (format.sideForPick(prevPickNum) == 1) ? prevTeam1Picks : prevTeam2Picks;
+    prevTurn = (format.sideForPick(prevPickNum) == 1) ? "team1" : "team2";
+    if (!undoneTeam.isEmpty()) {
+        lastPickedBrawler = undoneTeam.last(); // Get brawler first
+        undoneTeam.removeLast();               // Then remove
     }
 
     // Check if a brawler was actually removed (handles empty team lists unexpectedly)
@@ -553,13 +690,13 @@ void MainWindow::onUndoPickClicked() {
 
 // onAvailableListDoubleClicked, onBansListDoubleClicked, onSearchTextChanged (No changes needed)
 void MainWindow::onAvailableListDoubleClicked(QListWidgetItem *item) {
-    if (!item || !m_currentDraftState || m_mctsManager->isRunning()) return;
+    if (!item || !m_currentDraftState || activeTabSearching()) return;
     const DraftState& ds = *m_currentDraftState;
-    if (ds.currentTurn() == "team1" && ds.team1Picks().size() < 3) {
+    if (ds.currentTurn() == "team1" && ds.team1Picks().size() < ds.format().teamSize) {
         onPickTeam1Clicked();
-    } else if (ds.currentTurn() == "team2" && ds.team2Picks().size() < 3) {
+    } else if (ds.currentTurn() == "team2" && ds.team2Picks().size() < ds.format().teamSize) {
         onPickTeam2Clicked();
-    } else if (ds.bans().size() < 6 && !ds.isComplete()) {
+    } else if (ds.bans().size() < ds.format().maxBans && !ds.isComplete()) {
         onBanClicked();
     } else {
          setStatus(QString("Cannot auto-pick/ban %1 currently.").arg(item->text()));
@@ -567,7 +704,7 @@ void MainWindow::onAvailableListDoubleClicked(QListWidgetItem *item) {
 }
 
 void MainWindow::onBansListDoubleClicked(QListWidgetItem *item) {
-    if (!item || !m_currentDraftState || m_mctsManager->isRunning()) return;
+    if (!item || !m_currentDraftState || activeTabSearching()) return;
     onUnbanClicked();
 }
 
@@ -587,7 +724,7 @@ void MainWindow::onSuggestHeuristicClicked() {
      if (!m_currentDraftState || m_currentDraftState->isComplete()) {
         setStatus("Cannot suggest: Draft not active or complete."); return;
      }
-     if (m_mctsManager->isRunning()) { setStatus("Stop MCTS first."); return; }
+     if (activeTabSearching()) { setStatus("Stop MCTS first."); return; }
 
     // Use weights directly from config
     HeuristicWeights weights = m_config.heuristicWeights();
@@ -598,11 +735,21 @@ void MainWindow::onSuggestHeuristicClicked() {
     QCoreApplication::processEvents(); // Allow UI update
 
     try {
-        auto [bestPick, scoresDict] = suggestPickHeuristic(*m_currentDraftState, m_statsCalculator, weights);
+        auto [bestPick, scoresDict] = suggestPickHeuristic(*m_currentDraftState, stats(), weights);
 
         if (!bestPick.isEmpty()) {
-            m_suggestionLabel->setText(QString("Heuristic Suggestion: %1").arg(bestPick));
-            displayHeuristicScores(scoresDict);
+            // How often the pick stays on top when the stats are redrawn within their errors
+            const int replicas = m_config.bootstrapReplicas();
+            QHash<QString, double> firstShares = Bootstrap::firstPlaceShares(*m_currentDraftState, stats(), weights,
+                                                                             scoresDict, replicas);
+            if (firstShares.isEmpty()) {
+                m_suggestionLabel->setText(QString("Heuristic Suggestion: %1").arg(bestPick));
+            } else {
+                m_suggestionLabel->setText(QString("Heuristic Suggestion: %1 (best in %2% of %3 replicas)")
+                                               .arg(bestPick).arg(firstShares.value(bestPick) * 100.0, 0, 'f', 0)
+                                               .arg(replicas));
+            }
+            displayHeuristicScores(scoresDict, firstShares);
             setStatus("Heuristic suggestion complete.");
         } else {
             m_suggestionLabel->setText("Suggestion: No legal moves found.");
@@ -615,12 +762,31 @@ void MainWindow::onSuggestHeuristicClicked() {
     }
 }
 
+void MainWindow::onSuggestPolicyClicked() {
+    if (!m_currentDraftState || m_currentDraftState->isComplete()) {
+        setStatus("Cannot suggest: Draft not active or complete."); return;
+    }
+    if (!m_policyTable || !m_policyTable->hasModel(m_currentDraftState->mapName(), m_currentDraftState->modeName())) {
+        setStatus("No distilled policy for this map. Run 'GlizzyDraft distill'.", true); return;
+    }
+
+    QVector<QPair<QString, double>> ranked = m_policyTable->rankMoves(*m_currentDraftState, stats());
+    if (!ranked.isEmpty()) {
+        m_suggestionLabel->setText(QString("Policy Suggestion: %1").arg(ranked.first().first));
+        displayPolicyScores(ranked);
+        setStatus("Policy suggestion complete.");
+    } else {
+        m_suggestionLabel->setText("Suggestion: No legal moves found.");
+        setStatus("No policy suggestions possible.");
+    }
+}
+
 void MainWindow::onSuggestMctsClicked() {
      if (!m_currentDraftState || m_currentDraftState->isComplete()) {
          setStatus("Cannot start MCTS: Draft not active or complete."); return;
      }
-     if (m_mctsManager->isRunning()) {
-         QMessageBox::warning(this, "MCTS Running", "MCTS is already running."); return;
+     if (activeTabSearching()) {
+         QMessageBox::warning(this, "MCTS Running", "MCTS is already running in this tab."); return;
      }
 
      validateMctsTimeInput();
@@ -630,15 +796,20 @@ void MainWindow::onSuggestMctsClicked() {
      HeuristicWeights weights = m_config.heuristicWeights();
 
     setStatus("Starting MCTS...");
-    m_suggestionLabel->setText("Suggestion: Starting MCTS...");
     clearSuggestionDisplay();
+    m_suggestionLabel->setText("Suggestion: Starting MCTS...");
+
+    // Runs beside the other tabs' searches; this tab has focus, so it gets most of the threads
+    int session = m_scheduler->startSession(*m_currentDraftState, weights, m_config.mctsTimeLimit());
+    if (session == 0) {
+        setStatus("Cannot start MCTS: no legal moves.");
+        return;
+    }
+    m_tabs[m_activeTab].session = session;
+    m_scheduler->setFocusedSession(session);
     setControlsEnabled(false);
     m_stopMctsButton->setEnabled(true);
-
-    // Pass the weights from config to the MCTS manager
-    QMetaObject::invokeMethod(m_mctsManager, "startMcts", Qt::QueuedConnection,
-                              Q_ARG(DraftState, *m_currentDraftState),
-                              Q_ARG(HeuristicWeights, weights));
+    updateTabTitle(m_activeTab);
 }
 
 // onSuggestBanClicked, onStopMctsClicked (No changes needed)
@@ -646,8 +817,8 @@ void MainWindow::onSuggestBanClicked() {
     if (!m_currentDraftState || m_currentDraftState->isComplete()) {
         setStatus("Cannot suggest ban: Draft not active or complete."); return;
      }
-     if (m_mctsManager->isRunning()) { setStatus("Stop MCTS first."); return; }
-     if (m_currentDraftState->bans().size() >= 6) { setStatus("Max bans reached."); return; }
+     if (activeTabSearching()) { setStatus("Stop MCTS first."); return; }
+     if (m_currentDraftState->bans().size() >= m_currentDraftState->format().maxBans) { setStatus("Max bans reached."); return; }
 
 
     setStatus("Calculating ban suggestions...");
@@ -658,7 +829,7 @@ void MainWindow::onSuggestBanClicked() {
 
     try {
          int numSuggestions = 5;
-        QVector<QString> suggestedBans = suggestBanHeuristic(*m_currentDraftState, m_statsCalculator, numSuggestions);
+        QVector<QString> suggestedBans = suggestBanHeuristic(*m_currentDraftState, stats(), numSuggestions);
 
         if (!suggestedBans.isEmpty()) {
             m_suggestionLabel->setText(QString("Ban Suggestions: %1").arg(QStringList::fromVector(suggestedBans).join(", ")));
@@ -675,12 +846,67 @@ void MainWindow::onSuggestBanClicked() {
     }
 }
 
+void MainWindow::onBestResponseClicked() {
+    if (!m_currentDraftState) { setStatus("Cannot search: Draft not active."); return; }
+    if (activeTabSearching()) { setStatus("Stop MCTS first."); return; }
+
+    const DraftState& ds = *m_currentDraftState;
+    // Our side is the team to move; once the draft is complete, evaluate team1
+    QString ourTeam = ds.isComplete() ? "team1" : ds.currentTurn();
+    const QVector<QString>& ourPicks = (ourTeam == "team1") ? ds.team1Picks() : ds.team2Picks();
+    const QVector<QString>& theirPicks = (ourTeam == "team1") ? ds.team2Picks() : ds.team1Picks();
+
+    bool ok = false;
+    QString enemyText = QInputDialog::getText(this, "Best Response",
+                                              QString("Enemy team for %1 (3 brawlers, comma-separated):").arg(ourTeam),
+                                              QLineEdit::Normal, QStringList::fromVector(theirPicks).join(", "), &ok);
+    if (!ok) return;
+
+    QVector<QString> enemyTeam;
+    for (const QString& part : enemyText.split(',', Qt::SkipEmptyParts)) {
+        QString name = part.trimmed();
+        if (!name.isEmpty()) enemyTeam.append(name);
+    }
+    if (enemyTeam.size() != 3) { setStatus("Best response needs exactly 3 enemy brawlers.", true); return; }
+    for (const QString& name : enemyTeam) {
+        if (!m_allBrawlersMasterList.contains(name)) { setStatus(QString("Unknown brawler: %1").arg(name), true); return; }
+    }
+    QString conflict = bestResponseConflict(enemyTeam, ourPicks, ds.bans());
+    if (!conflict.isEmpty()) { setStatus(conflict, true); return; }
+
+    setStatus("Searching best-response teams...");
+    m_suggestionLabel->setText("Suggestion: Searching teams...");
+    clearSuggestionDisplay();
+    QCoreApplication::processEvents();
+
+    try {
+        CompSearchResult result = findBestResponse(enemyTeam, ourPicks, ds.bans(), m_allBrawlersMasterList,
+                                                   ds.mapName(), ds.modeName(), stats(),
+                                                   m_config.evalWeights(), m_config.compFinderTopK());
+        if (!result.topComps.isEmpty()) {
+            const CompResult& best = result.topComps.first();
+            m_suggestionLabel->setText(QString("Best Team: %1 (%2%)")
+                                       .arg(QStringList::fromVector(best.team).join(", "))
+                                       .arg(best.winProbability * 100.0, 0, 'f', 1));
+            displayCompResults(result);
+            setStatus(QString("Best response complete (%1 teams evaluated, %2 ms).")
+                      .arg(result.teamsEvaluated).arg(result.elapsedUs / 1000.0, 0, 'f', 1));
+        } else {
+            m_suggestionLabel->setText("Suggestion: No valid teams found.");
+            setStatus("No best-response teams found.");
+        }
+    } catch (const std::exception& e) {
+        setStatus(QString("Best response error: %1").arg(e.what()), true, true);
+        QMessageBox::critical(this, "Best Response Error", QString("Error:\n%1").arg(e.what()));
+    }
+}
+
 void MainWindow::onStopMctsClicked() {
-    if (m_mctsManager->isRunning()) {
+    if (activeTabSearching()) {
         qInfo() << "Stop MCTS button clicked.";
         setStatus("Attempting to stop MCTS...");
         m_stopMctsButton->setEnabled(false);
-        QMetaObject::invokeMethod(m_mctsManager, "stopMcts", Qt::QueuedConnection);
+        m_scheduler->stopSession(m_tabs[m_activeTab].session);
     } else {
         qWarning() << "Stop MCTS clicked, but MCTS not running.";
         m_stopMctsButton->setEnabled(false);
@@ -689,53 +915,87 @@ void MainWindow::onStopMctsClicked() {
 
 
 // --- MCTS Update Slots --- (No changes needed)
-void MainWindow::handleMctsStatus(const QString& status) {
+void MainWindow::handleMctsStatus(int session, const QString& status) {
+     int tab = tabForSession(session);
+     if (tab < 0) return;
+     bool isError = status.contains("Error", Qt::CaseInsensitive);
+     if (tab != m_activeTab) {
+         m_tabs[tab].status = QString("Status: %1").arg(status);
+         m_tabs[tab].statusIsError = isError;
+         return;
+     }
+
      bool controlsCurrentlyDisabled = !m_suggestMctsButton->isEnabled();
      bool isFinalStatus = status.contains("Finished", Qt::CaseInsensitive) ||
-                          status.contains("Error", Qt::CaseInsensitive) ||
+                          isError ||
                           status.contains("Stopped", Qt::CaseInsensitive) ||
                           status.contains("Reached", Qt::CaseInsensitive);
 
      if (controlsCurrentlyDisabled || isFinalStatus) {
-        setStatus(QString("Status: %1").arg(status), status.contains("Error", Qt::CaseInsensitive));
+        setStatus(QString("Status: %1").arg(status), isError);
      }
 }
 
-void MainWindow::handleMctsIntermediateResult(const QVector<MCTSResult>& results) {
-     if (m_mctsManager->isRunning()) {
-        displayMctsScores(results, true);
-        if (!results.isEmpty()) {
-             m_suggestionLabel->setText(QString("MCTS Suggestion (Live): %1").arg(results[0].move));
-        } else {
-             m_suggestionLabel->setText("Suggestion: MCTS Running...");
-        }
+void MainWindow::handleMctsIntermediateResult(int session, const QVector<MCTSResult>& results) {
+     int tab = tabForSession(session);
+     if (tab < 0 || !m_scheduler->isRunning(session)) return;
+     QString suggestion = results.isEmpty() ? QString("Suggestion: MCTS Running...")
+                                            : QString("MCTS Suggestion (Live): %1").arg(results[0].move);
+     if (tab != m_activeTab) {
+         DraftTab& background = m_tabs[tab];
+         background.suggestion = suggestion;
+         background.detailsTitle = "MCTS Top Picks (Live):";
+         background.details = mctsScoresText(results);
+         return;
      }
+     displayMctsScores(results, true);
+     m_suggestionLabel->setText(suggestion);
 }
 
-void MainWindow::handleMctsFinalResult(const QVector<MCTSResult>& results) {
-     qInfo() << "Processing final MCTS result.";
+void MainWindow::handleMctsFinalResult(int session, const QVector<MCTSResult>& results) {
+     int tab = tabForSession(session);
+     if (tab < 0) return;
+     qInfo() << "Processing final MCTS result of session" << session;
+     QString suggestion = results.isEmpty() ? QString("Suggestion: MCTS found no moves.")
+                                            : QString("MCTS Suggestion: %1").arg(results[0].move);
+     if (tab != m_activeTab) {
+         DraftTab& background = m_tabs[tab];
+         background.suggestion = suggestion;
+         background.detailsTitle = "MCTS Top Picks:";
+         background.details = mctsScoresText(results);
+         return;
+     }
+
      displayMctsScores(results, false);
-     if (!results.isEmpty()) {
-         m_suggestionLabel->setText(QString("MCTS Suggestion: %1").arg(results[0].move));
-         if (!m_statusLabel->text().contains("Finished") && !m_statusLabel->text().contains("Stopped")) {
-            setStatus("MCTS finished.");
-         }
-     } else {
-         m_suggestionLabel->setText("Suggestion: MCTS found no moves.");
-         if (!m_statusLabel->text().contains("Finished") && !m_statusLabel->text().contains("Stopped")) {
-             setStatus("MCTS finished, no suggestion.");
-         }
+     m_suggestionLabel->setText(suggestion);
+     if (!m_statusLabel->text().contains("Finished") && !m_statusLabel->text().contains("Stopped")) {
+         setStatus(results.isEmpty() ? "MCTS finished, no suggestion." : "MCTS finished.");
      }
 }
 
-void MainWindow::handleMctsError(const QString& errorMsg) {
+void MainWindow::handleMctsError(int session, const QString& errorMsg) {
+    int tab = tabForSession(session);
+    if (tab < 0) return;
+    qCritical() << "MCTS Error reported for session" << session << ":" << errorMsg;
+    if (tab != m_activeTab) {
+        m_tabs[tab].status = QString("Status: %1").arg(errorMsg); // Shown when the tab is opened
+        m_tabs[tab].statusIsError = true;
+        return;
+    }
     setStatus(QString("Status: %1").arg(errorMsg), true, true);
-    qCritical() << "MCTS Error reported: " << errorMsg;
     QMessageBox::critical(this, "MCTS Error", errorMsg);
 }
 
-void MainWindow::handleMctsFinished() {
+void MainWindow::handleMctsFinished(int session) {
+     updateMemoryDisplay();
+     int tab = tabForSession(session);
+     if (tab < 0) return;
+     m_tabs[tab].session = 0;
+     updateTabTitle(tab);
+     if (tab != m_activeTab) return;
+
      qInfo() << "MCTS finished signal received. Re-enabling controls.";
+     m_scheduler->setFocusedSession(0);
      setControlsEnabled(true);
      m_stopMctsButton->setEnabled(false);
      if (!m_statusLabel->text().contains("Finished") && !m_statusLabel->text().contains("Error") && !m_statusLabel->text().contains("Stopped")) {
@@ -745,7 +1005,23 @@ void MainWindow::handleMctsFinished() {
 
 // --- UI Update Helpers ---
 
+// New or rotated maps borrow most of their scores from the mode-wide and global tables
+void MainWindow::updateMapDataLabel() {
+    QString mode = m_modeComboBox->currentText();
+    QString map = m_mapComboBox->currentText();
+    if (mode.isEmpty() || map.isEmpty()) {
+        m_mapDataLabel->setText(QString());
+        return;
+    }
+    double share = stats().realDataShare(map, mode);
+    m_mapDataLabel->setText(QString("Map data: %1% real").arg(share * 100.0, 0, 'f', 0));
+    m_mapDataLabel->setToolTip("Share of this map's scores that comes from games on the map itself.\n"
+                               "The rest comes from the mode-wide and global stats (FallbackShrinkage).");
+    m_mapDataLabel->setStyleSheet(share < 0.5 ? "color: darkorange;" : "");
+}
+
 void MainWindow::updateUiFromState() {
+    updateMapDataLabel();
     // Clear lists
     m_availableListWidget->clear();
     m_team1ListWidget->clear();
@@ -753,7 +1029,7 @@ void MainWindow::updateUiFromState() {
     m_bansListWidget->clear();
 
     bool draftActive = m_currentDraftState.has_value();
-    bool mctsRunning = m_mctsManager->isRunning();
+    bool mctsRunning = activeTabSearching();
 
     if (draftActive && !mctsRunning) {
         const DraftState& ds = *m_currentDraftState;
@@ -768,13 +1044,13 @@ void MainWindow::updateUiFromState() {
         bool isComplete = ds.isComplete();
         QString turnText = isComplete ? "Complete" : ds.currentTurn();
         m_turnLabel->setText(QString("Turn: %1").arg(turnText));
-        QString pickText = (ds.currentPickNumber() <= 6) ? QString::number(ds.currentPickNumber()) : "Done";
+        QString pickText = !ds.isComplete() ? QString::number(ds.currentPickNumber()) : "Done";
         m_pickNumLabel->setText(QString("Pick #: %1").arg(pickText));
 
         // --- Button State Logic ---
-        bool canPickT1 = !isComplete && ds.currentTurn() == "team1" && ds.team1Picks().size() < 3;
-        bool canPickT2 = !isComplete && ds.currentTurn() == "team2" && ds.team2Picks().size() < 3;
-        bool canBan = !isComplete && ds.bans().size() < 6;
+        bool canPickT1 = !isComplete && ds.currentTurn() == "team1" && ds.team1Picks().size() < ds.format().teamSize;
+        bool canPickT2 = !isComplete && ds.currentTurn() == "team2" && ds.team2Picks().size() < ds.format().teamSize;
+        bool canBan = !isComplete && ds.bans().size() < ds.format().maxBans;
         bool canUnban = !ds.bans().isEmpty();
         // Allow undo unless it's the very beginning
         bool canUndoPick = ds.currentPickNumber() > 1;
@@ -787,7 +1063,9 @@ void MainWindow::updateUiFromState() {
 
         m_suggestHeuristicButton->setEnabled(!isComplete);
         m_suggestMctsButton->setEnabled(!isComplete);
+        m_suggestPolicyButton->setEnabled(!isComplete && m_policyTable && m_policyTable->hasModel(ds.mapName(), ds.modeName()));
         m_suggestBanButton->setEnabled(canBan); // Suggest ban only if banning is possible
+        m_bestResponseButton->setEnabled(true);
 
         m_resetButton->setEnabled(true);
 
@@ -801,7 +1079,7 @@ void MainWindow::updateUiFromState() {
             m_bansListWidget->addItems(bansSorted);
             QString turnText = m_currentDraftState->isComplete() ? "Complete" : m_currentDraftState->currentTurn();
             m_turnLabel->setText(QString("Turn: %1").arg(turnText));
-            QString pickText = (m_currentDraftState->currentPickNumber() <= 6) ? QString::number(m_currentDraftState->currentPickNumber()) : "Done";
+            QString pickText = !m_currentDraftState->isComplete() ? QString::number(m_currentDraftState->currentPickNumber()) : "Done";
             m_pickNumLabel->setText(QString("Pick #: %1").arg(pickText));
          }
          // Controls are disabled by setControlsEnabled(false)
@@ -817,11 +1095,14 @@ void MainWindow::updateUiFromState() {
         m_undoPickButton->setEnabled(false);
         m_suggestHeuristicButton->setEnabled(false);
         m_suggestMctsButton->setEnabled(false);
+        m_suggestPolicyButton->setEnabled(false);
         m_suggestBanButton->setEnabled(false);
+        m_bestResponseButton->setEnabled(false);
         m_resetButton->setEnabled(!m_modeComboBox->currentText().isEmpty() && !m_mapComboBox->currentText().isEmpty());
     }
-}
 
+    updateTabTitle(m_activeTab);
+}
 
 void MainWindow::updateAvailableListDisplay() {
     m_availableListWidget->clear();
@@ -862,7 +1143,9 @@ void MainWindow::setControlsEnabled(bool enabled) {
 
     m_suggestHeuristicButton->setEnabled(enabled && draftCanProgress);
     m_suggestMctsButton->setEnabled(enabled && draftCanProgress);
+    m_suggestPolicyButton->setEnabled(enabled && draftCanProgress && m_policyTable); // Further refine in updateUiFromState
     m_suggestBanButton->setEnabled(enabled && draftCanProgress); // Further refine in updateUiFromState
+    m_bestResponseButton->setEnabled(enabled && draftIsActive);
 
     m_stopMctsButton->setEnabled(!enabled); // Stop button is enabled ONLY when other controls are disabled
 
@@ -890,7 +1173,8 @@ void MainWindow::clearSuggestionDisplay() {
     m_scoresTextEdit->clear();
 }
 
-void MainWindow::displayHeuristicScores(const QHash<QString, HeuristicScoreComponents>& scoresDict) {
+void MainWindow::displayHeuristicScores(const QHash<QString, HeuristicScoreComponents>& scoresDict,
+                                        const QHash<QString, double>& firstShares) {
     m_scoresTitleLabel->setText("Heuristic Scores (Top 30):");
     m_scoresTextEdit->clear();
 
@@ -912,22 +1196,26 @@ void MainWindow::displayHeuristicScores(const QHash<QString, HeuristicScoreCompo
 
     QString text;
     QTextStream stream(&text);
-    stream << QString("%1 | %2 | %3 | %4 | %5 | %6\n")
+    const bool showShares = !firstShares.isEmpty();
+    stream << QString("%1 | %2 | %3 | %4 | %5 | %6")
               .arg("Brawler", -18).arg("Score", 8).arg("Adj WR", 8)
               .arg("Avg Syn", 8).arg("Avg Ctr", 8).arg("PickRate", 8);
-    stream << QString("-").repeated(78) << "\n";
+    if (showShares) stream << QString(" | %1").arg("P(best)", 8);
+    stream << "\n" << QString("-").repeated(showShares ? 89 : 78) << "\n";
 
     int count = 0;
     const int DISPLAY_LIMIT = 30;
     for (const auto& pair : sortedScores) {
         const HeuristicScoreComponents& scores = pair.second;
-        stream << QString("%1 | %2 | %3 | %4 | %5 | %6\n")
+        stream << QString("%1 | %2 | %3 | %4 | %5 | %6")
                   .arg(pair.first, -18)
                   .arg(scores.totalScore, 8, 'f', 3)
                   .arg(scores.winRate, 8, 'f', 3)
                   .arg(scores.avgSynergy, 8, 'f', 3)
                   .arg(scores.avgCounter, 8, 'f', 3)
                   .arg(scores.pickRate, 8, 'f', 3);
+        if (showShares) stream << QString(" | %1%").arg(firstShares.value(pair.first) * 100.0, 7, 'f', 0);
+        stream << "\n";
         count++;
         if (count >= DISPLAY_LIMIT) {
             stream << "\n... (Top " << count << " shown)";
@@ -951,7 +1239,7 @@ void MainWindow::displayBanScores(const QVector<QString>& suggestedBans) {
      QVector<QPair<QString, double>> banDetails;
      if(m_currentDraftState){
          for(const QString& brawler : suggestedBans) {
-              double wr = m_statsCalculator.getWinRate(brawler, m_currentDraftState->mapName(), m_currentDraftState->modeName())
+              double wr = stats().getWinRate(brawler, m_currentDraftState->mapName(), m_currentDraftState->modeName())
                             .value_or(m_config.lowConfidenceWinRateTarget());
               banDetails.append({brawler, wr});
          }
@@ -983,11 +1271,14 @@ void MainWindow::displayBanScores(const QVector<QString>& suggestedBans) {
 
 void MainWindow::displayMctsScores(const QVector<MCTSResult>& results, bool isIntermediate) {
     m_scoresTitleLabel->setText(QString("MCTS Top Picks%1:").arg(isIntermediate ? " (Live)" : ""));
-    m_scoresTextEdit->clear();
+    m_scoresTextEdit->setFontFamily("monospace");
+    m_scoresTextEdit->setText(mctsScoresText(results));
+}
 
+// Also kept for background tabs until they are shown
+QString MainWindow::mctsScoresText(const QVector<MCTSResult>& results) const {
     if (results.isEmpty()) {
-        m_scoresTextEdit->setText("No MCTS results available.");
-        return;
+        return "No MCTS results available.";
     }
 
     QString text;
@@ -996,21 +1287,54 @@ void MainWindow::displayMctsScores(const QVector<MCTSResult>& results, bool isIn
               .arg("Brawler", -18).arg("Visits", 8).arg("Est Win %", 10);
     stream << QString("-").repeated(42) << "\n";
 
-    // int displayCount = m_config.mctsResultCount(); // <-- REMOVE or comment out this line
-    // int count = 0; // <-- REMOVE or comment out this line
-
     for (const auto& result : results) {
-        // if (count >= displayCount) break; // <-- REMOVE or comment out this line
         double winPercent = (result.winRate * 100.0) - 3;
         stream << QString("%1 | %2 | %3%\n")
                   .arg(result.move, -18)
                   .arg(result.visits, 8)
                   .arg(winPercent, 9, 'f', 1);
-        // count++; // <-- REMOVE or comment out this line
     }
-    // if (results.size() > displayCount) { // <-- REMOVE or comment out this block
-    //      stream << "\n... (Top " << displayCount << " shown)";
-    // }
+    return text;
+}
+
+void MainWindow::displayCompResults(const CompSearchResult& result) {
+    m_scoresTitleLabel->setText(QString("Best-Response Teams (Top %1):").arg(result.topComps.size()));
+    m_scoresTextEdit->clear();
+
+    QString text;
+    QTextStream stream(&text);
+    stream << QString("%1 | %2 | %3\n").arg("#", 3).arg("Team", -44).arg("Win %", 7);
+    stream << QString("-").repeated(60) << "\n";
+
+    int rank = 1;
+    for (const CompResult& comp : result.topComps) {
+        stream << QString("%1 | %2 | %3%\n")
+                  .arg(rank++, 3)
+                  .arg(QStringList::fromVector(comp.team).join(", "), -44)
+                  .arg(comp.winProbability * 100.0, 6, 'f', 1);
+    }
+    stream << QString("\n%1 teams evaluated, %2 branches pruned, %3 ms")
+              .arg(result.teamsEvaluated).arg(result.branchesPruned).arg(result.elapsedUs / 1000.0, 0, 'f', 1);
+
+    m_scoresTextEdit->setFontFamily("monospace");
+    m_scoresTextEdit->setText(text);
+}
+
+void MainWindow::displayPolicyScores(const QVector<QPair<QString, double>>& rankedMoves) {
+    m_scoresTitleLabel->setText("Policy Probabilities (Top 30):");
+    m_scoresTextEdit->clear();
+
+    QString text;
+    QTextStream stream(&text);
+    stream << QString("%1 | %2\n").arg("Brawler", -18).arg("Prob %", 8);
+    stream << QString("-").repeated(29) << "\n";
+
+    const int DISPLAY_LIMIT = 30;
+    for (int i = 0; i < rankedMoves.size() && i < DISPLAY_LIMIT; ++i) {
+        stream << QString("%1 | %2\n")
+                  .arg(rankedMoves[i].first, -18)
+                  .arg(rankedMoves[i].second * 100.0, 8, 'f', 2);
+    }
 
     m_scoresTextEdit->setFontFamily("monospace");
     m_scoresTextEdit->setText(text);
@@ -1039,14 +1363,13 @@ void MainWindow::saveConfig() {
 
 void MainWindow::closeEvent(QCloseEvent *event) {
     qInfo() << "Close event triggered.";
-    if (m_mctsManager->isRunning()) {
+    if (m_scheduler->hasRunningSessions()) {
         QMessageBox::StandardButton reply;
         reply = QMessageBox::question(this, "MCTS Running",
-                                      "MCTS is currently running. Stop it and exit?",
+                                      "MCTS is currently running in a draft tab. Stop it and exit?",
                                       QMessageBox::Yes | QMessageBox::No);
         if (reply == QMessageBox::Yes) {
-            qInfo() << "Stopping MCTS before exiting...";
-            onStopMctsClicked();
+            qInfo() << "Stopping MCTS before exiting..."; // The scheduler snapshots running searches as it goes
             saveConfig(); // Save config even if stopping MCTS
             event->accept();
         } else {
@@ -1057,4 +1380,11 @@ void MainWindow::closeEvent(QCloseEvent *event) {
         saveConfig();
         event->accept();
     }
-}
\ No newline at end of file
+}
+
+void MainWindow::updateMemoryDisplay() {
+    qint64 total = 0;
+    for (const MemoryUsage& entry : MemoryLedger::usage(m_config)) total += entry.bytes;
+    m_memoryLabel->setText(QString("Memory: %1 MB").arg(total / (1024.0 * 1024.0), 0, 'f', 0));
+    m_memoryLabel->setToolTip("<pre>" + MemoryLedger::report(m_config).toHtmlEscaped() + "</pre>");
+}
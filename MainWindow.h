@@ -14,6 +14,8 @@
 #include "StatsCalculator.h"
 #include "AppConfig.h"
 #include "MCTS.h"
+#include "PolicyTable.h"
+#include "SearchScheduler.h"
 
 // Forward declarations for UI elements
 QT_BEGIN_NAMESPACE
@@ -24,6 +26,7 @@ class QLineEdit;
 class QPushButton;
 class QLabel;
 class QTextEdit;
+class QTabBar;
 // class QDoubleSpinBox; // Removed - weights hidden
 QT_END_NAMESPACE
 
@@ -39,10 +42,20 @@ public:
                QWidget *parent = nullptr);
     ~MainWindow();
 
+    // Enables instant suggestions from a distilled policy (must outlive the window)
+    void setPolicyTable(const PolicyTable* policyTable);
+    // Live stats (see LiveIngest) for every later suggestion and MCTS search
+    void setStatsSnapshot(std::shared_ptr<const StatsCalculator> stats, qint64 newGames);
+
 protected:
     void closeEvent(QCloseEvent *event) override; // To save config on close
 
 private slots:
+    // Draft Tabs
+    void onDraftTabChanged(int index);
+    void onDraftTabCloseRequested(int index);
+    void onNewDraftTabClicked();
+
     // Control Slots
     void onModeChanged(int index);
     void onMapChanged(int index);
@@ -62,15 +75,17 @@ private slots:
     // Suggestion Slots
     void onSuggestHeuristicClicked();
     void onSuggestMctsClicked();
+    void onSuggestPolicyClicked();
     void onSuggestBanClicked();
+    void onBestResponseClicked();
     void onStopMctsClicked();
 
-    // MCTS Update Slots
-    void handleMctsStatus(const QString& status);
-    void handleMctsIntermediateResult(const QVector<MCTSResult>& results);
-    void handleMctsFinalResult(const QVector<MCTSResult>& results);
-    void handleMctsError(const QString& errorMsg);
-    void handleMctsFinished(); // Slot connected to MCTSManager::mctsFinished
+    // MCTS Update Slots (SearchScheduler sessions; each belongs to one tab)
+    void handleMctsStatus(int session, const QString& status);
+    void handleMctsIntermediateResult(int session, const QVector<MCTSResult>& results);
+    void handleMctsFinalResult(int session, const QVector<MCTSResult>& results);
+    void handleMctsError(int session, const QString& errorMsg);
+    void handleMctsFinished(int session); // Slot connected to SearchScheduler::sessionFinished
 
 private:
     void setupUi(); // Create and layout widgets manually or load .ui file
@@ -79,34 +94,72 @@ private:
 
     void initializeDraft(); // Resets internal state and UI for new draft
     void updateUiFromState(); // Updates all lists, labels, button states
+    void updateMapDataLabel(); // Share of the selected map's scores from its own games
     void updateAvailableListDisplay(); // Updates the available list based on search and state
     void setControlsEnabled(bool enabled); // Enables/disables UI elements during MCTS etc.
     void setStatus(const QString& text, bool isError = false, bool clearSuggestion = false);
     void clearSuggestionDisplay();
-    void displayHeuristicScores(const QHash<QString, HeuristicScoreComponents>& scores);
+    // 'firstShares': Bootstrap::firstPlaceShares, shown as a P(best) column when not empty
+    void displayHeuristicScores(const QHash<QString, HeuristicScoreComponents>& scores,
+                                const QHash<QString, double>& firstShares = {});
     void displayBanScores(const QVector<QString>& suggestedBans); // Pass bans, lookup WR internally
     void displayMctsScores(const QVector<MCTSResult>& results, bool isIntermediate = false);
+    QString mctsScoresText(const QVector<MCTSResult>& results) const;
+    void displayCompResults(const CompSearchResult& result);
+    void displayPolicyScores(const QVector<QPair<QString, double>>& rankedMoves);
     void saveConfig(); // Saves current weights/settings
+    void updateMemoryDisplay(); // Status bar total; tooltip per subsystem (see MemoryLedger)
+
+    // Draft tabs share one set of widgets: switching stores what they show into the tab left
+    // and loads the tab entered. Searches keep running in their session meanwhile.
+    void storeActiveTab();
+    void restoreActiveTab();
+    void populateMapList(const QString& mode);
+    void updateTabTitle(int index);
+    int tabForSession(int session) const; // -1: no tab (closed while its search finished)
+    bool activeTabSearching() const;
 
     // Helper to get selected item text
     QString getSelectedListWidgetItemText(QListWidget* listWidget) const;
+    const StatsCalculator& stats() const { return m_liveStats ? *m_liveStats : m_statsCalculator; }
     // Helper to get current weights from UI - REMOVED
     // HeuristicWeights getWeightsFromUi() const;
 
 
     // Dependencies (passed in constructor)
     const StatsCalculator& m_statsCalculator;
+    std::shared_ptr<const StatsCalculator> m_liveStats; // Overrides m_statsCalculator once published
     const QSet<QString>& m_allBrawlersMasterList;
     const QHash<QString, QSet<QString>>& m_mapModeData;
     AppConfig& m_config; // Mutable reference
     MCTSManager* m_mctsManager; // Pointer to manager
+    SearchScheduler* m_scheduler; // Deep searches of every tab, on one thread pool
+    const PolicyTable* m_policyTable = nullptr; // Optional distilled policy
 
     // Internal state
-    std::optional<DraftState> m_currentDraftState; // Use optional to represent no active draft
+    std::optional<DraftState> m_currentDraftState; // Active tab's draft; use optional to represent no active draft
+
+    struct DraftTab {
+        std::optional<DraftState> state; // Stale for the active tab (see m_currentDraftState)
+        QString mode;                    // Empty: new tab, not shown yet
+        QString map;
+        int session = 0;                 // SearchScheduler session of its deep search (0 = none)
+        QString searchText;
+        QString suggestion = "Suggestion: -";
+        QString detailsTitle = "Details:";
+        QString details;
+        QString status;
+        bool statusIsError = false;
+    };
+    QVector<DraftTab> m_tabs; // Same order as m_draftTabBar
+    int m_activeTab = -1;
 
     // --- UI Elements (Declare pointers) ---
+    QTabBar *m_draftTabBar;
+    QPushButton *m_newTabButton;
     QComboBox *m_modeComboBox;
     QComboBox *m_mapComboBox;
+    QLabel *m_mapDataLabel;
     QLineEdit *m_mctsTimeLineEdit;
     QPushButton *m_resetButton;
 
@@ -133,7 +186,9 @@ private:
     // Suggestion Frame
     QPushButton *m_suggestHeuristicButton;
     QPushButton *m_suggestMctsButton;
+    QPushButton *m_suggestPolicyButton;
     QPushButton *m_suggestBanButton;
+    QPushButton *m_bestResponseButton;
     QPushButton *m_stopMctsButton;
     QLabel *m_suggestionLabel;
     QLabel *m_scoresTitleLabel; // Label above the text edit
@@ -141,6 +196,7 @@ private:
 
     // Status Bar
     QLabel *m_statusLabel;
+    QLabel *m_memoryLabel;
 };
 
 #endif // MAINWINDOW_H
\ No newline at end of file
@@ -0,0 +1,221 @@
+#include "MapSweep.h"
+#include "CacheUtils.h"
+#include "CompFinder.h"
+#include "DraftState.h"
+#include "Heuristics.h"
+#include "TaskExecutor.h"
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QDebug>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+struct MapJob {
+    QString mapName;
+    QString modeName;
+};
+
+QString sortedJoin(const QVector<QString>& names) {
+    QStringList sorted = QStringList::fromVector(names);
+    sorted.sort();
+    return sorted.join(",");
+}
+
+// Tier by rank percentile within the map's full roster
+QString tierForRank(int rank, int total) {
+    double percentile = total > 0 ? static_cast<double>(rank) / total : 1.0;
+    if (percentile < 0.10) return "S";
+    if (percentile < 0.25) return "A";
+    if (percentile < 0.50) return "B";
+    if (percentile < 0.75) return "C";
+    return "D";
+}
+
+} // namespace
+
+
+MapSweeper::MapSweeper(const StatsCalculator& statsCalculator,
+                       const QSet<QString>& allBrawlers,
+                       const QHash<QString, QSet<QString>>& mapModeData,
+                       const AppConfig& config,
+                       const MCTSManager* mctsManager)
+    : m_statsCalculator(statsCalculator),
+      m_allBrawlers(allBrawlers),
+      m_mapModeData(mapModeData),
+      m_config(config),
+      m_mctsManager(mctsManager)
+{
+}
+
+QString MapSweeper::paramsKey(const SweepRequest& request, const HeuristicWeights& weights, const EvalWeights& evalWeights) {
+    QStringList bans = request.bans.values();
+    bans.sort();
+    return QString("kind=%1;mode=%2;pool=%3;team=%4;bans=%5;top=%6;iters=%7;w=%8,%9,%10,%11")
+        .arg(static_cast<int>(request.kind))
+        .arg(request.modeFilter, sortedJoin(request.pool), sortedJoin(request.team), bans.join(","))
+        .arg(request.topK)
+        .arg(request.kind == SweepKind::Mcts ? request.mctsIterations : 0)
+        .arg(weights.winRate).arg(weights.synergy).arg(weights.counter).arg(weights.pickRate)
+        + QString(";e=%1,%2,%3,%4,%5")
+        .arg(evalWeights.winRate).arg(evalWeights.synergy).arg(evalWeights.counter)
+        .arg(evalWeights.peakCounter).arg(evalWeights.slope);
+}
+
+SweepReport MapSweeper::run(const SweepRequest& request, const QString& cacheFilePath) const {
+    // --- Validate Request ---
+    if (request.topK <= 0) throw std::invalid_argument("Sweep topK must be positive.");
+    if (request.kind == SweepKind::TeamStrength && request.team.size() != 3) {
+        throw std::invalid_argument("Team strength sweep needs exactly 3 brawlers.");
+    }
+    if (request.kind == SweepKind::Mcts && (!m_mctsManager || request.mctsIterations <= 0)) {
+        throw std::invalid_argument("MCTS sweep needs an MCTS manager and a positive iteration budget.");
+    }
+    if (!request.modeFilter.isEmpty() && !m_mapModeData.contains(request.modeFilter)) {
+        throw std::invalid_argument(QString("Unknown mode: %1").arg(request.modeFilter).toStdString());
+    }
+
+    HeuristicWeights weights = m_config.heuristicWeights();
+    EvalWeights evalWeights = m_config.evalWeights();
+    QString key = paramsKey(request, weights, evalWeights);
+    qint64 packVersion = m_statsCalculator.packVersion();
+
+    // --- Cache Lookup ---
+    QHash<QString, SweepReport> cachedReports;
+    if (!cacheFilePath.isEmpty()) {
+        cachedReports = CacheUtils::loadSweepCache(cacheFilePath, packVersion);
+        auto it = cachedReports.constFind(key);
+        if (it != cachedReports.constEnd()) {
+            qInfo() << "Map sweep served from cache:" << key;
+            SweepReport report = it.value();
+            report.fromCache = true;
+            return report;
+        }
+    }
+
+    // --- Collect Maps ---
+    QVector<MapJob> jobs;
+    for (auto modeIt = m_mapModeData.constBegin(); modeIt != m_mapModeData.constEnd(); ++modeIt) {
+        if (!request.modeFilter.isEmpty() && modeIt.key() != request.modeFilter) continue;
+        for (const QString& mapName : modeIt.value()) {
+            jobs.append({mapName, modeIt.key()});
+        }
+    }
+
+    // --- Run All Maps Concurrently ---
+    QElapsedTimer timer;
+    timer.start();
+    qInfo() << "Starting map sweep over" << jobs.size() << "maps:" << key;
+
+    QList<MapSweepResult> perMap = TaskExecutor::instance().mapped(jobs, [this, &request, &weights, &evalWeights](const MapJob& job) {
+        try {
+            switch (request.kind) {
+            case SweepKind::TierList:     return sweepTierList(request, job.mapName, job.modeName, weights);
+            case SweepKind::TeamStrength: return sweepTeamStrength(request, job.mapName, job.modeName, evalWeights);
+            case SweepKind::Mcts:         return sweepMcts(request, job.mapName, job.modeName, weights, evalWeights);
+            }
+        } catch (const std::exception& e) {
+            qWarning() << "Map sweep failed for" << job.mapName << "(" << job.modeName << "):" << e.what();
+        }
+        MapSweepResult failed;
+        failed.mapName = job.mapName;
+        failed.modeName = job.modeName;
+        return failed;
+    }, TaskPriority::Batch);
+
+    SweepReport report;
+    report.kind = request.kind;
+    report.paramsKey = key;
+    report.packVersion = packVersion;
+    report.maps = QVector<MapSweepResult>(perMap.begin(), perMap.end());
+    std::sort(report.maps.begin(), report.maps.end(), [](const MapSweepResult& a, const MapSweepResult& b) {
+        if (a.mapScore != b.mapScore) return a.mapScore > b.mapScore;
+        return a.mapName < b.mapName;
+    });
+    report.elapsedMs = timer.elapsed();
+    qInfo() << "Map sweep finished in" << report.elapsedMs << "ms.";
+
+    // --- Cache Store ---
+    if (!cacheFilePath.isEmpty()) {
+        cachedReports.insert(key, report);
+        CacheUtils::saveSweepCache(cacheFilePath, cachedReports);
+    }
+    return report;
+}
+
+// --- Per-Map Analyses ---
+
+MapSweepResult MapSweeper::sweepTierList(const SweepRequest& request, const QString& mapName, const QString& modeName,
+                                         const HeuristicWeights& weights) const {
+    MapSweepResult result;
+    result.mapName = mapName;
+    result.modeName = modeName;
+
+    DraftState emptyDraft(mapName, modeName, m_allBrawlers, request.bans);
+    auto [bestPick, scores] = suggestPickHeuristic(emptyDraft, m_statsCalculator, weights);
+    Q_UNUSED(bestPick);
+
+    QVector<SweepEntry> ranked;
+    ranked.reserve(scores.size());
+    for (auto it = scores.constBegin(); it != scores.constEnd(); ++it) {
+        ranked.append({it.key(), it.value().totalScore, QString()});
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const SweepEntry& a, const SweepEntry& b) {
+        if (a.score != b.score) return a.score > b.score;
+        return a.label < b.label;
+    });
+    for (int i = 0; i < ranked.size(); ++i) {
+        ranked[i].tier = tierForRank(i, ranked.size());
+    }
+
+    // Restrict to the pool after tiering, so tiers stay relative to the whole roster
+    if (!request.pool.isEmpty()) {
+        QSet<QString> pool(request.pool.begin(), request.pool.end());
+        ranked.erase(std::remove_if(ranked.begin(), ranked.end(),
+                                    [&pool](const SweepEntry& e) { return !pool.contains(e.label); }),
+                     ranked.end());
+    }
+
+    // Map score: mean of the best three (a full team's worth) of the ranked brawlers
+    int scored = std::min<int>(3, ranked.size());
+    double sum = 0.0;
+    for (int i = 0; i < scored; ++i) sum += ranked[i].score;
+    result.mapScore = scored > 0 ? sum / scored : 0.0;
+
+    result.entries = ranked.mid(0, request.topK);
+    return result;
+}
+
+MapSweepResult MapSweeper::sweepTeamStrength(const SweepRequest& request, const QString& mapName, const QString& modeName,
+                                             const EvalWeights& evalWeights) const {
+    MapSweepResult result;
+    result.mapName = mapName;
+    result.modeName = modeName;
+
+    // Our team plays the "enemy" role of the comp finder: its top results are our worst matchups
+    CompSearchResult responses = findBestResponse(request.team, {}, request.bans, m_allBrawlers,
+                                                  mapName, modeName, m_statsCalculator, evalWeights, request.topK);
+    for (const CompResult& comp : responses.topComps) {
+        result.entries.append({QStringList::fromVector(comp.team).join(", "), comp.winProbability, QString()});
+    }
+    result.mapScore = responses.topComps.isEmpty() ? 0.5 : 1.0 - responses.topComps.first().winProbability;
+    return result;
+}
+
+MapSweepResult MapSweeper::sweepMcts(const SweepRequest& request, const QString& mapName, const QString& modeName,
+                                     const HeuristicWeights& weights, const EvalWeights& evalWeights) const {
+    MapSweepResult result;
+    result.mapName = mapName;
+    result.modeName = modeName;
+
+    DraftState emptyDraft(mapName, modeName, m_allBrawlers, request.bans);
+    quint32 seed = static_cast<quint32>(qHash(mapName + "|" + modeName));
+    QVector<MCTSResult> moves = m_mctsManager->runFixedBudget(emptyDraft, weights, evalWeights, request.mctsIterations, seed);
+
+    for (const MCTSResult& move : moves.mid(0, request.topK)) {
+        result.entries.append({move.move, move.winRate, QString()});
+    }
+    result.mapScore = moves.isEmpty() ? 0.5 : moves.first().winRate;
+    return result;
+}
@@ -0,0 +1,58 @@
+#ifndef MAPSWEEP_H
+#define MAPSWEEP_H
+
+#include <QString>
+#include <QVector>
+#include <QSet>
+#include <QHash>
+#include "DataStructures.h"
+#include "StatsCalculator.h"
+#include "AppConfig.h"
+#include "MCTS.h"
+
+// Parameters of one sweep across every map (or every map of one mode)
+struct SweepRequest {
+    SweepKind kind = SweepKind::TierList;
+    QString modeFilter;        // Only maps of this mode (empty = every discovered mode)
+    QVector<QString> pool;     // TierList: maps are ranked by this brawler pool (empty = whole roster)
+    QVector<QString> team;     // TeamStrength: our three brawlers
+    QSet<QString> bans;        // Removed from every map's draft
+    int topK = 10;             // Entries kept per map
+    int mctsIterations = 2000; // Mcts: fixed iteration budget per map
+};
+
+// Runs the same analysis on every map concurrently on the global thread pool:
+//  - TierList:     heuristic first-pick scores, bucketed into S/A/B/C/D tiers per map
+//  - TeamStrength: best enemy responses to our team (comp finder); maps ranked by our worst case
+//  - Mcts:         fixed-budget MCTS from an empty draft (deterministic seed per map)
+// Reports are cached next to stats.pack against its pack version, so repeat sweeps are instant.
+class MapSweeper {
+public:
+    MapSweeper(const StatsCalculator& statsCalculator,
+               const QSet<QString>& allBrawlers,
+               const QHash<QString, QSet<QString>>& mapModeData,
+               const AppConfig& config,
+               const MCTSManager* mctsManager = nullptr); // Required for SweepKind::Mcts only
+
+    // Empty cacheFilePath disables caching. Throws std::invalid_argument on a bad request.
+    SweepReport run(const SweepRequest& request, const QString& cacheFilePath = QString()) const;
+
+    // Canonical cache key for a request (order of pool/team/bans does not matter)
+    static QString paramsKey(const SweepRequest& request, const HeuristicWeights& weights, const EvalWeights& evalWeights);
+
+private:
+    MapSweepResult sweepTierList(const SweepRequest& request, const QString& mapName, const QString& modeName,
+                                 const HeuristicWeights& weights) const;
+    MapSweepResult sweepTeamStrength(const SweepRequest& request, const QString& mapName, const QString& modeName,
+                                     const EvalWeights& evalWeights) const;
+    MapSweepResult sweepMcts(const SweepRequest& request, const QString& mapName, const QString& modeName,
+                             const HeuristicWeights& weights, const EvalWeights& evalWeights) const;
+
+    const StatsCalculator& m_statsCalculator;
+    const QSet<QString>& m_allBrawlers;
+    const QHash<QString, QSet<QString>>& m_mapModeData;
+    const AppConfig& m_config;
+    const MCTSManager* m_mctsManager;
+};
+
+#endif // MAPSWEEP_H
@@ -0,0 +1,148 @@
+#include "MemoryLedger.h"
+#include "AppConfig.h"
+#include <QFile>
+#include <QStringList>
+#include <array>
+#include <atomic>
+
+namespace {
+
+std::array<std::atomic<qint64>, MEMORY_SUBSYSTEM_COUNT> g_bytes{};
+
+const double BYTES_PER_MB = 1024.0 * 1024.0;
+
+QString megabytes(qint64 bytes) {
+    return QString("%1 MB").arg(bytes / BYTES_PER_MB, 0, 'f', 1);
+}
+
+// "VmRSS:   123456 kB" style field of /proc/self/status, in MB
+double procStatusMb(const QByteArray& field) {
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly)) return -1.0;
+    for (const QByteArray& line : status.readAll().split('\n')) {
+        if (!line.startsWith(field)) continue;
+        QByteArray value = line.mid(field.size()).trimmed();
+        value.chop(3); // " kB"
+        return value.toDouble() / 1024.0;
+    }
+    return -1.0;
+}
+
+} // namespace
+
+
+// --- MemoryCharge ---
+
+MemoryCharge::MemoryCharge(MemorySubsystem subsystem)
+    : m_subsystem(subsystem)
+{}
+
+MemoryCharge::MemoryCharge(const MemoryCharge& other)
+    : m_subsystem(other.m_subsystem)
+{
+    set(other.m_bytes);
+}
+
+MemoryCharge& MemoryCharge::operator=(const MemoryCharge& other) {
+    if (this != &other) {
+        set(0);
+        m_subsystem = other.m_subsystem;
+        set(other.m_bytes);
+    }
+    return *this;
+}
+
+MemoryCharge::~MemoryCharge() {
+    set(0);
+}
+
+void MemoryCharge::set(qint64 bytes) {
+    if (bytes == m_bytes) return;
+    MemoryLedger::charge(m_subsystem, bytes - m_bytes);
+    m_bytes = bytes;
+}
+
+
+// --- MemoryLedger ---
+
+namespace MemoryLedger {
+
+QString name(MemorySubsystem subsystem) {
+    switch (subsystem) {
+    case MemorySubsystem::StatsTables: return "stats";
+    case MemorySubsystem::NamePools: return "names";
+    case MemorySubsystem::LoaderBuffers: return "loader";
+    case MemorySubsystem::EvalCaches: return "eval";
+    case MemorySubsystem::SearchTrees: return "trees";
+    case MemorySubsystem::HistoryCaches: return "history";
+    }
+    return "?";
+}
+
+void charge(MemorySubsystem subsystem, qint64 deltaBytes) {
+    g_bytes[static_cast<int>(subsystem)].fetch_add(deltaBytes, std::memory_order_relaxed);
+}
+
+qint64 bytes(MemorySubsystem subsystem) {
+    return g_bytes[static_cast<int>(subsystem)].load(std::memory_order_relaxed);
+}
+
+qint64 capBytes(MemorySubsystem subsystem, const AppConfig& config) {
+    switch (subsystem) {
+    case MemorySubsystem::SearchTrees: return qint64(config.memoryCapSearchTreesMb()) * 1024 * 1024;
+    case MemorySubsystem::LoaderBuffers: return qint64(config.memoryCapLoaderBuffersMb()) * 1024 * 1024;
+    case MemorySubsystem::HistoryCaches: return qint64(config.memoryCapHistoryMb()) * 1024 * 1024;
+    default: return 0;
+    }
+}
+
+QVector<MemoryUsage> usage(const AppConfig& config) {
+    QVector<MemoryUsage> result;
+    for (int i = 0; i < MEMORY_SUBSYSTEM_COUNT; ++i) {
+        auto subsystem = static_cast<MemorySubsystem>(i);
+        result.append({subsystem, bytes(subsystem), capBytes(subsystem, config)});
+    }
+    return result;
+}
+
+QString summary() {
+    QStringList parts;
+    for (int i = 0; i < MEMORY_SUBSYSTEM_COUNT; ++i) {
+        auto subsystem = static_cast<MemorySubsystem>(i);
+        parts << QString("%1 %2").arg(name(subsystem), megabytes(bytes(subsystem)));
+    }
+    double rss = residentMb();
+    return parts.join(", ") + (rss >= 0.0 ? QString(" (RSS %1 MB)").arg(rss, 0, 'f', 1) : QString());
+}
+
+QString report(const AppConfig& config) {
+    QStringList lines;
+    qint64 total = 0;
+    for (const MemoryUsage& entry : usage(config)) {
+        total += entry.bytes;
+        lines << QString("%1 %2 %3").arg(name(entry.subsystem), -8).arg(megabytes(entry.bytes), 12)
+                     .arg(entry.capBytes > 0 ? QString("(cap %1)").arg(megabytes(entry.capBytes)) : QString());
+    }
+    lines << QString("%1 %2").arg("total", -8).arg(megabytes(total), 12);
+    double rss = residentMb();
+    if (rss >= 0.0) {
+        lines << QString("Process: %1 MB resident, %2 MB peak").arg(rss, 0, 'f', 1).arg(peakResidentMb(), 0, 'f', 1);
+    }
+    return lines.join('\n');
+}
+
+double residentMb() {
+    return procStatusMb("VmRSS:");
+}
+
+double peakResidentMb() {
+    return procStatusMb("VmHWM:");
+}
+
+// Writing 5 to clear_refs resets VmHWM to the current RSS (no-op elsewhere)
+void resetPeakResident() {
+    QFile clearRefs("/proc/self/clear_refs");
+    if (clearRefs.open(QIODevice::WriteOnly)) clearRefs.write("5");
+}
+
+} // namespace MemoryLedger
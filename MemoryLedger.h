@@ -0,0 +1,82 @@
+#ifndef MEMORYLEDGER_H
+#define MEMORYLEDGER_H
+
+#include <QString>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+
+class AppConfig;
+
+// --- Memory Accounting ---
+// Long-lived structures report their approximate heap size here per subsystem, so the status bar,
+// the 'stats' command and the search log can show where memory goes. Sizes are estimates from
+// container capacities and owned strings, not allocator counts.
+
+enum class MemorySubsystem {
+    StatsTables,   // Stats hash tables and compact score arrays
+    NamePools,     // Name indexes and the player index's tag table
+    LoaderBuffers, // DataLoader's raw JSON and processed games
+    EvalCaches,    // Active rosters, distilled policy models and move clusters
+    SearchTrees,   // In-process MCTS trees and the shared-memory tree segment
+    HistoryCaches, // Follow mode's window of recent battle keys
+};
+constexpr int MEMORY_SUBSYSTEM_COUNT = 6;
+
+struct MemoryUsage {
+    MemorySubsystem subsystem = MemorySubsystem::StatsTables;
+    qint64 bytes = 0;
+    qint64 capBytes = 0; // 0: no cap
+};
+
+// One object's share of a subsystem, released when the object goes. A copy charges again: a
+// copied container holds its own memory once either side detaches.
+class MemoryCharge {
+public:
+    explicit MemoryCharge(MemorySubsystem subsystem);
+    MemoryCharge(const MemoryCharge& other);
+    MemoryCharge& operator=(const MemoryCharge& other);
+    ~MemoryCharge();
+
+    void set(qint64 bytes);
+    qint64 bytes() const { return m_bytes; }
+
+private:
+    MemorySubsystem m_subsystem;
+    qint64 m_bytes = 0;
+};
+
+namespace MemoryLedger {
+
+    QString name(MemorySubsystem subsystem);
+    // Thread-safe; charges may come from any thread (search workers, follow-mode polls)
+    void charge(MemorySubsystem subsystem, qint64 deltaBytes);
+    qint64 bytes(MemorySubsystem subsystem);
+    // Configured cap (MemoryCap* settings) the subsystem holds itself to; 0 = none. Stats, names
+    // and eval caches are sized by the pack and only reported.
+    qint64 capBytes(MemorySubsystem subsystem, const AppConfig& config);
+    QVector<MemoryUsage> usage(const AppConfig& config);
+
+    // "stats 120.4 MB, names 0.2 MB, ... (RSS 410.0 MB)", for log lines
+    QString summary();
+    // One line per subsystem with its cap, the total and the process's resident set
+    QString report(const AppConfig& config);
+
+    // Resident set and its peak in MB from /proc/self/status; -1 where there is no procfs
+    double residentMb();
+    double peakResidentMb();
+    void resetPeakResident(); // Linux: the peak restarts from the current resident set
+
+    // --- Size estimates ---
+    inline qint64 stringBytes(const QString& s) { return s.isEmpty() ? 0 : 24 + s.size() * qint64(sizeof(QChar)); }
+    template<typename T>
+    qint64 vectorBytes(const QVector<T>& v) { return v.capacity() * qint64(sizeof(T)); }
+    // Qt 6 hashes keep entries in spans with one index byte per bucket
+    template<typename K, typename V>
+    qint64 hashBytes(const QHash<K, V>& h) { return h.capacity() * qint64(sizeof(K) + sizeof(V) + 1); }
+    template<typename T>
+    qint64 setBytes(const QSet<T>& s) { return s.capacity() * qint64(sizeof(T) + 1); }
+
+} // namespace MemoryLedger
+
+#endif // MEMORYLEDGER_H
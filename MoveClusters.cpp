@@ -0,0 +1,201 @@
+#include "MoveClusters.h"
+#include "StatsCalculator.h"
+#include "TaskExecutor.h"
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+const int MAX_ITERATIONS = 50;
+
+struct MapJob {
+    QString mapName;
+    QString modeName;
+};
+
+// One row per brawler: win rate, then its counter and synergy rows against the whole roster.
+// Rows are scaled by 1/sqrt(n) so each of the three parts weighs like a single score.
+QVector<QVector<double>> featureRows(const QStringList& roster, const StatsCalculator& stats, const MapJob& job) {
+    const int n = roster.size();
+    const double rowScale = 1.0 / std::sqrt(static_cast<double>(n));
+    QVector<QVector<double>> rows(n);
+    for (int i = 0; i < n; ++i) {
+        QVector<double>& row = rows[i];
+        row.reserve(2 * n + 1);
+        row.append(stats.getWinRate(roster[i], job.mapName, job.modeName).value_or(0.5));
+        for (int j = 0; j < n; ++j) {
+            row.append(stats.getCounterScore(roster[i], roster[j], job.mapName, job.modeName) * rowScale);
+        }
+        for (int j = 0; j < n; ++j) {
+            row.append(stats.getSynergyScore(roster[i], roster[j], job.mapName, job.modeName) * rowScale);
+        }
+    }
+    return rows;
+}
+
+double squaredDistance(const QVector<double>& a, const QVector<double>& b) {
+    double sum = 0.0;
+    for (int i = 0; i < a.size(); ++i) {
+        double d = a[i] - b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+// k-medoids++ seeding, then alternate assignment and medoid update until the medoids settle
+QVector<int> kMedoids(const QVector<double>& dist, int n, int k, std::mt19937& randomEngine) {
+    QVector<int> medoids;
+    std::uniform_int_distribution<int> first(0, n - 1);
+    medoids.append(first(randomEngine));
+    QVector<double> nearest(n, std::numeric_limits<double>::infinity());
+    while (medoids.size() < k) {
+        double total = 0.0;
+        for (int i = 0; i < n; ++i) {
+            nearest[i] = std::min(nearest[i], dist[i * n + medoids.last()]);
+            total += nearest[i];
+        }
+        int next = -1;
+        if (total > 0.0) {
+            std::uniform_real_distribution<double> pick(0.0, total);
+            double target = pick(randomEngine);
+            for (int i = 0; i < n && next < 0; ++i) {
+                target -= nearest[i];
+                if (target <= 0.0 && nearest[i] > 0.0) next = i;
+            }
+        }
+        if (next < 0) { // Everything left coincides with a medoid: take any non-medoid
+            for (int i = 0; i < n && next < 0; ++i) {
+                if (!medoids.contains(i)) next = i;
+            }
+        }
+        medoids.append(next);
+    }
+
+    QVector<int> assignment(n, 0);
+    for (int iteration = 0; iteration < MAX_ITERATIONS; ++iteration) {
+        for (int i = 0; i < n; ++i) {
+            int best = 0;
+            for (int c = 1; c < k; ++c) {
+                if (dist[i * n + medoids[c]] < dist[i * n + medoids[best]]) best = c;
+            }
+            assignment[i] = best;
+        }
+        for (int c = 0; c < k; ++c) assignment[medoids[c]] = c; // Ties with another medoid
+
+        bool changed = false;
+        for (int c = 0; c < k; ++c) {
+            int bestMedoid = medoids[c];
+            double bestCost = std::numeric_limits<double>::infinity();
+            for (int i = 0; i < n; ++i) {
+                if (assignment[i] != c) continue;
+                double cost = 0.0;
+                for (int j = 0; j < n; ++j) {
+                    if (assignment[j] == c) cost += dist[i * n + j];
+                }
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestMedoid = i;
+                }
+            }
+            if (bestMedoid != medoids[c]) {
+                medoids[c] = bestMedoid;
+                changed = true;
+            }
+        }
+        if (!changed) break;
+    }
+    return assignment;
+}
+
+std::shared_ptr<const MoveClusterTable> clusterMapMode(const QStringList& roster, const StatsCalculator& stats,
+                                                       const MapJob& job, int k, quint32 seed) {
+    if (!stats.getPickRate(roster.first(), job.mapName, job.modeName).has_value()) return nullptr;
+    const int n = roster.size();
+    k = std::min(k, n);
+
+    QVector<QVector<double>> rows = featureRows(roster, stats, job);
+    QVector<double> dist(n * n, 0.0);
+    for (int i = 0; i < n; ++i) {
+        for (int j = i + 1; j < n; ++j) {
+            dist[i * n + j] = dist[j * n + i] = std::sqrt(squaredDistance(rows[i], rows[j]));
+        }
+    }
+
+    // Seeded per map/mode, so the result does not depend on which thread ran it
+    std::mt19937 randomEngine(seed ^ static_cast<quint32>(qHash(job.mapName + "|" + job.modeName)));
+    QVector<int> assignment = kMedoids(dist, n, k, randomEngine);
+
+    QVector<QVector<int>> members(k);
+    for (int i = 0; i < n; ++i) members[assignment[i]].append(i);
+    auto table = std::make_shared<MoveClusterTable>();
+    for (QVector<int>& cluster : members) {
+        // Medoid = the member closest to all others; it leads, the rest follow by distance to it
+        auto costOf = [&](int i) {
+            double cost = 0.0;
+            for (int j : cluster) cost += dist[i * n + j];
+            return cost;
+        };
+        int medoid = *std::min_element(cluster.begin(), cluster.end(),
+                                       [&](int a, int b) { return costOf(a) < costOf(b); });
+        std::sort(cluster.begin(), cluster.end(), [&](int a, int b) {
+            double da = dist[medoid * n + a], db = dist[medoid * n + b];
+            return da != db ? da < db : roster[a] < roster[b];
+        });
+        QStringList names;
+        for (int i : cluster) names.append(roster[i]);
+        table->clusters.append(names);
+    }
+    std::sort(table->clusters.begin(), table->clusters.end(), [](const QStringList& a, const QStringList& b) {
+        return a.size() != b.size() ? a.size() > b.size() : a.first() < b.first();
+    });
+    for (int c = 0; c < table->clusters.size(); ++c) {
+        for (const QString& brawler : table->clusters[c]) table->clusterOf.insert(brawler, c);
+    }
+    return table;
+}
+
+} // namespace
+
+
+std::shared_ptr<const MoveClusters> MoveClusters::build(const StatsCalculator& stats, const QSet<QString>& allBrawlers,
+                                                        const QHash<QString, QSet<QString>>& mapModeData,
+                                                        int k, quint32 seed) {
+    if (k < 2) throw std::invalid_argument("Move clustering needs at least 2 clusters.");
+    auto clusters = std::make_shared<MoveClusters>();
+    if (allBrawlers.isEmpty()) return clusters;
+
+    QStringList roster(allBrawlers.begin(), allBrawlers.end());
+    roster.sort();
+    QVector<MapJob> jobs;
+    for (auto modeIt = mapModeData.constBegin(); modeIt != mapModeData.constEnd(); ++modeIt) {
+        for (const QString& mapName : modeIt.value()) jobs.append({mapName, modeIt.key()});
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QList<std::shared_ptr<const MoveClusterTable>> tables = TaskExecutor::instance().mapped(jobs,
+        [&](const MapJob& job) { return clusterMapMode(roster, stats, job, k, seed); }, TaskPriority::Background);
+    qint64 bytes = 0; // Member names share the roster's string data
+    for (int i = 0; i < jobs.size(); ++i) {
+        if (!tables[i]) continue;
+        clusters->m_tables[jobs[i].mapName][jobs[i].modeName] = tables[i];
+        clusters->m_mapModes++;
+        bytes += MemoryLedger::vectorBytes(tables[i]->clusters) + MemoryLedger::hashBytes(tables[i]->clusterOf);
+        for (const QStringList& members : tables[i]->clusters) bytes += MemoryLedger::vectorBytes(members);
+    }
+    clusters->m_charge.set(bytes);
+    qInfo() << "Clustered" << roster.size() << "brawlers into" << std::min(k, int(roster.size())) << "groups for"
+            << clusters->m_mapModes << "map/modes in" << timer.elapsed() << "ms.";
+    return clusters;
+}
+
+std::shared_ptr<const MoveClusterTable> MoveClusters::table(const QString& mapName, const QString& mode) const {
+    auto mapIt = m_tables.constFind(mapName);
+    if (mapIt == m_tables.constEnd()) return nullptr;
+    return mapIt.value().value(mode);
+}
@@ -0,0 +1,43 @@
+#ifndef MOVECLUSTERS_H
+#define MOVECLUSTERS_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <memory>
+#include "MemoryLedger.h"
+
+class StatsCalculator;
+
+// Brawlers of one map/mode grouped by how alike they play there
+struct MoveClusterTable {
+    QVector<QStringList> clusters; // clusters[c][0] is the medoid, the rest by distance to it
+    QHash<QString, int> clusterOf;
+
+    int cluster(const QString& brawler) const { return clusterOf.value(brawler, -1); }
+};
+
+// Per map/mode k-medoids clusters over each brawler's finalized win rate, counter row and
+// synergy row (every row compared against the full roster). Built once when stats load; the
+// MCTS two-level selection mode picks a cluster first and a member within it.
+class MoveClusters {
+public:
+    // Map/modes are clustered in parallel; 'k' is capped at the roster size.
+    // Throws std::invalid_argument if k < 2.
+    static std::shared_ptr<const MoveClusters> build(const StatsCalculator& stats, const QSet<QString>& allBrawlers,
+                                                     const QHash<QString, QSet<QString>>& mapModeData,
+                                                     int k, quint32 seed = 1);
+
+    // nullptr if the map/mode has no stats
+    std::shared_ptr<const MoveClusterTable> table(const QString& mapName, const QString& mode) const;
+    int mapModeCount() const { return m_mapModes; }
+
+private:
+    QHash<QString, QHash<QString, std::shared_ptr<const MoveClusterTable>>> m_tables; // Map -> Mode
+    int m_mapModes = 0;
+    MemoryCharge m_charge{MemorySubsystem::EvalCaches};
+};
+
+#endif // MOVECLUSTERS_H
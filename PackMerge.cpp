@@ -0,0 +1,154 @@
+#include "PackMerge.h"
+#include "TaskExecutor.h"
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+using MapModeKey = QPair<QString, QString>;
+
+// Summed variance numerators (plays * se)^2 per cell; a cell some contributing pack has no
+// error for is marked incomplete and gets none
+struct ErrorSums {
+    QHash<QString, double> variance;
+    QSet<QString> incomplete;
+};
+
+void addCells(QHash<QString, BrawlerStatsData>& target, const QHash<QString, BrawlerStatsData>& source,
+              const QHash<QString, float>* errors, ErrorSums& sums) {
+    for (auto it = source.constBegin(); it != source.constEnd(); ++it) {
+        BrawlerStatsData& cell = target[it.key()];
+        cell.wins += it.value().wins;
+        cell.plays += it.value().plays;
+        if (!errors) continue;
+        auto errorIt = errors->constFind(it.key());
+        if (errorIt == errors->constEnd()) {
+            sums.incomplete.insert(it.key());
+        } else {
+            sums.variance[it.key()] += std::pow(it.value().plays * errorIt.value(), 2);
+        }
+    }
+}
+
+void finishErrors(const QHash<QString, BrawlerStatsData>& cells, const ErrorSums& sums, QHash<QString, float>& errors) {
+    for (auto it = sums.variance.constBegin(); it != sums.variance.constEnd(); ++it) {
+        if (sums.incomplete.contains(it.key())) continue;
+        const double plays = cells.value(it.key()).plays;
+        if (plays > 0.0) errors.insert(it.key(), float(std::sqrt(it.value()) / plays));
+    }
+}
+
+struct MergedSection {
+    MapModeStatsData stats;
+    MapModeErrorData errors;
+};
+
+MergedSection mergeSection(const QVector<CacheData>& packs, const MapModeKey& key) {
+    // Packs that have no errors at all for this section leave it without errors
+    bool withErrors = true;
+    qsizetype largest = 0;
+    for (const CacheData& pack : packs) {
+        auto mapIt = pack.stats.constFind(key.first);
+        if (mapIt == pack.stats.constEnd() || !mapIt->contains(key.second)) continue;
+        if (!pack.errors.value(key.first).contains(key.second)) withErrors = false;
+        largest = std::max(largest, mapIt->value(key.second).counterStats.size());
+    }
+
+    MergedSection merged;
+    merged.stats.counterStats.reserve(largest);
+    ErrorSums brawlerSums, synergySums, counterSums;
+    for (const CacheData& pack : packs) {
+        auto mapIt = pack.stats.constFind(key.first);
+        if (mapIt == pack.stats.constEnd()) continue;
+        auto modeIt = mapIt->constFind(key.second);
+        if (modeIt == mapIt->constEnd()) continue;
+        const MapModeErrorData* errors = nullptr;
+        if (withErrors) errors = &*pack.errors.constFind(key.first)->constFind(key.second);
+
+        merged.stats.totalWeightedPlays += modeIt->totalWeightedPlays;
+        addCells(merged.stats.brawlerStats, modeIt->brawlerStats, errors ? &errors->brawlerStats : nullptr, brawlerSums);
+        addCells(merged.stats.synergyStats, modeIt->synergyStats, errors ? &errors->synergyStats : nullptr, synergySums);
+        addCells(merged.stats.counterStats, modeIt->counterStats, errors ? &errors->counterStats : nullptr, counterSums);
+    }
+    if (withErrors) {
+        finishErrors(merged.stats.brawlerStats, brawlerSums, merged.errors.brawlerStats);
+        finishErrors(merged.stats.synergyStats, synergySums, merged.errors.synergyStats);
+        finishErrors(merged.stats.counterStats, counterSums, merged.errors.counterStats);
+    }
+    return merged;
+}
+
+} // namespace
+
+
+CacheData PackMerge::merge(const QVector<CacheData>& packs, const QStringList& names) {
+    if (packs.size() < 2) throw std::invalid_argument("Merging needs at least 2 packs.");
+    QElapsedTimer timer;
+    timer.start();
+
+    // --- Sources: each raw-built pack may be counted once ---
+    CacheData merged;
+    CacheMetadata& metadata = merged.metadata;
+    QHash<qint64, QString> seen;
+    qint64 newest = 0;
+    for (int i = 0; i < packs.size(); ++i) {
+        const CacheMetadata& meta = packs[i].metadata;
+        const QString name = names.value(i, QString("pack %1").arg(i + 1));
+        QVector<PackSource> sources = meta.mergedFrom;
+        if (sources.isEmpty()) sources.append({name, meta.cacheCreationTime, meta.sampleFraction, meta.sampledGames});
+        for (const PackSource& source : sources) {
+            auto it = seen.constFind(source.cacheCreationTime);
+            if (source.cacheCreationTime != 0 && it != seen.constEnd()) {
+                throw std::invalid_argument(QString("%1 and %2 both contain the pack created at %3; its games would count twice.")
+                                                .arg(it.value(), name)
+                                                .arg(QDateTime::fromMSecsSinceEpoch(source.cacheCreationTime).toString(Qt::ISODate))
+                                                .toStdString());
+            }
+            seen.insert(source.cacheCreationTime, name);
+            metadata.mergedFrom.append(source);
+        }
+        newest = std::max(newest, meta.cacheCreationTime);
+        if (meta.isApproximate()) {
+            metadata.sampleFraction = std::min(metadata.sampleFraction, meta.sampleFraction);
+            metadata.sampledGames += meta.sampledGames;
+        }
+        merged.allBrawlers.unite(packs[i].allBrawlers);
+        for (auto it = packs[i].discoveredMapModes.constBegin(); it != packs[i].discoveredMapModes.constEnd(); ++it) {
+            merged.discoveredMapModes[it.key()].unite(it.value());
+        }
+    }
+    // Strictly newer than every input, so results cached against an input do not match the merge
+    metadata.cacheCreationTime = std::max(newest + 1, QDateTime::currentMSecsSinceEpoch());
+
+    // --- Sections: one task per map/mode ---
+    QVector<MapModeKey> sections;
+    QSet<MapModeKey> sectionSet;
+    for (const CacheData& pack : packs) {
+        for (auto mapIt = pack.stats.constBegin(); mapIt != pack.stats.constEnd(); ++mapIt) {
+            for (auto modeIt = mapIt->constBegin(); modeIt != mapIt->constEnd(); ++modeIt) {
+                const MapModeKey key(mapIt.key(), modeIt.key());
+                if (sectionSet.contains(key)) continue;
+                sectionSet.insert(key);
+                sections.append(key);
+            }
+        }
+    }
+    QList<MergedSection> results = TaskExecutor::instance().mapped(sections, [&packs](const MapModeKey& key) {
+        return mergeSection(packs, key);
+    }, TaskPriority::Batch);
+
+    for (int i = 0; i < sections.size(); ++i) {
+        const MapModeKey& key = sections[i];
+        merged.stats[key.first][key.second] = std::move(results[i].stats);
+        MapModeErrorData& errors = results[i].errors;
+        if (!errors.brawlerStats.isEmpty() || !errors.synergyStats.isEmpty() || !errors.counterStats.isEmpty()) {
+            merged.errors[key.first][key.second] = std::move(errors);
+        }
+    }
+    qInfo() << "Merged" << packs.size() << "packs," << sections.size() << "map/modes in" << timer.elapsed() << "ms.";
+    return merged;
+}
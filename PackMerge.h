@@ -0,0 +1,26 @@
+#ifndef PACKMERGE_H
+#define PACKMERGE_H
+
+#include <QStringList>
+#include <QVector>
+#include "DataStructures.h"
+
+// --- Pack Merge ---
+// Sums stats packs built from disjoint games (per day, per region, ...) into one, as if the games
+// had been processed together: every cell is a wins/plays sum, so no raw games are needed. Each
+// map/mode section is merged on its own task, reading the section from every pack that has it.
+// Rosters and map/modes are unioned. Standard errors are combined through the cells' plays
+// (se = sqrt(sum (plays_i * se_i)^2) / plays) where every pack with the cell has one, and dropped
+// otherwise.
+namespace PackMerge {
+
+    // 'names' label the packs in the merged metadata (PackSource::name). A merged input contributes
+    // its own sources, so merges can be merged again. The result is approximate if any input is,
+    // with the smallest sample fraction among them.
+    // Throws std::invalid_argument for fewer than 2 packs, or if the same source pack (by creation
+    // time) would be counted twice.
+    CacheData merge(const QVector<CacheData>& packs, const QStringList& names);
+
+} // namespace PackMerge
+
+#endif // PACKMERGE_H
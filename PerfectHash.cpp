@@ -0,0 +1,147 @@
+#include "PerfectHash.h"
+#include "MemoryLedger.h"
+#include <QDebug>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+const int MAX_SALTS = 64;
+const quint32 MAX_DISPLACEMENT = 1u << 16;
+
+QStringList sortedKeys(const QSet<QString>& set) {
+    QStringList keys(set.begin(), set.end());
+    keys.sort();
+    return keys;
+}
+
+} // namespace
+
+
+PerfectHash PerfectHash::build(const QStringList& keys) {
+    PerfectHash hash;
+    const int n = keys.size();
+    if (n == 0) return hash;
+    if (QSet<QString>(keys.begin(), keys.end()).size() != n) {
+        throw std::invalid_argument("Perfect hash keys must be unique.");
+    }
+
+    // ~2 keys per bucket keeps every displacement search short
+    const int bucketCount = n / 2 + 1;
+    for (int salt = 0; salt < MAX_SALTS; ++salt) {
+        QVector<QVector<int>> buckets(bucketCount);
+        QVector<quint64> hashes(n);
+        for (int i = 0; i < n; ++i) {
+            hashes[i] = hashKey(keys[i], quint64(salt));
+            buckets[hashes[i] % quint64(bucketCount)].append(i);
+        }
+        QVector<int> order(bucketCount);
+        for (int b = 0; b < bucketCount; ++b) order[b] = b;
+        // Largest buckets first, while most slots are still free
+        std::stable_sort(order.begin(), order.end(),
+                         [&buckets](int a, int b) { return buckets[a].size() > buckets[b].size(); });
+
+        QVector<quint32> displacements(bucketCount, 0);
+        QVector<int> slotOwner(n, -1);
+        bool placedAll = true;
+        for (int b : order) {
+            const QVector<int>& members = buckets[b];
+            if (members.isEmpty()) continue;
+            bool placed = false;
+            QVector<int> memberSlots(members.size());
+            for (quint32 d = 0; d < MAX_DISPLACEMENT && !placed; ++d) {
+                placed = true;
+                for (int m = 0; m < members.size() && placed; ++m) {
+                    memberSlots[m] = slotFor(hashes[members[m]], d, n);
+                    if (slotOwner[memberSlots[m]] >= 0) placed = false;
+                    for (int prev = 0; prev < m && placed; ++prev) {
+                        if (memberSlots[prev] == memberSlots[m]) placed = false;
+                    }
+                }
+                if (placed) {
+                    displacements[b] = d;
+                    for (int m = 0; m < members.size(); ++m) slotOwner[memberSlots[m]] = members[m];
+                }
+            }
+            if (!placed) {
+                placedAll = false;
+                break;
+            }
+        }
+        if (!placedAll) continue;
+
+        hash.m_salt = quint64(salt);
+        hash.m_displacements = displacements;
+        hash.m_keys.reserve(n);
+        for (int slot = 0; slot < n; ++slot) hash.m_keys.append(keys[slotOwner[slot]]);
+        return hash;
+    }
+    throw std::runtime_error("Failed to build a perfect hash for " + std::to_string(n) + " keys.");
+}
+
+bool PerfectHash::isConsistent() const {
+    if (m_keys.isEmpty()) return m_displacements.isEmpty();
+    if (m_displacements.isEmpty()) return false;
+    for (int slot = 0; slot < m_keys.size(); ++slot) {
+        if (indexOf(m_keys[slot]) != slot) return false;
+    }
+    return true;
+}
+
+qint64 PerfectHash::memoryBytes() const {
+    qint64 bytes = MemoryLedger::vectorBytes(m_displacements) + MemoryLedger::vectorBytes(m_keys);
+    for (const QString& key : m_keys) bytes += MemoryLedger::stringBytes(key);
+    return bytes;
+}
+
+QDataStream &operator<<(QDataStream &out, const PerfectHash &hash) {
+    out << hash.m_salt << hash.m_displacements << hash.m_keys;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, PerfectHash &hash) {
+    in >> hash.m_salt >> hash.m_displacements >> hash.m_keys;
+    return in;
+}
+
+// --- NameIndex ---
+
+NameIndex NameIndex::build(const QSet<QString>& allBrawlers, const QHash<QString, QSet<QString>>& discoveredMapModes) {
+    QSet<QString> maps;
+    for (const QSet<QString>& modeMaps : discoveredMapModes) maps.unite(modeMaps);
+    QStringList modes = discoveredMapModes.keys();
+    modes.sort();
+
+    NameIndex index;
+    index.brawlers = PerfectHash::build(sortedKeys(allBrawlers));
+    index.maps = PerfectHash::build(sortedKeys(maps));
+    index.modes = PerfectHash::build(modes);
+    return index;
+}
+
+bool NameIndex::matches(const QSet<QString>& allBrawlers, const QHash<QString, QSet<QString>>& discoveredMapModes) const {
+    if (brawlers.size() != allBrawlers.size() || modes.size() != discoveredMapModes.size()) return false;
+    for (const QString& name : allBrawlers) {
+        if (!brawlers.contains(name)) return false;
+    }
+    QSet<QString> seenMaps;
+    for (auto it = discoveredMapModes.constBegin(); it != discoveredMapModes.constEnd(); ++it) {
+        if (!modes.contains(it.key())) return false;
+        for (const QString& map : it.value()) {
+            if (!maps.contains(map)) return false;
+            seenMaps.insert(map);
+        }
+    }
+    return seenMaps.size() == maps.size();
+}
+
+QDataStream &operator<<(QDataStream &out, const NameIndex &index) {
+    out << index.brawlers << index.maps << index.modes;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, NameIndex &index) {
+    in >> index.brawlers >> index.maps >> index.modes;
+    return in;
+}
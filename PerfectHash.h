@@ -0,0 +1,83 @@
+#ifndef PERFECTHASH_H
+#define PERFECTHASH_H
+
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QDataStream>
+
+// Minimal perfect hash over a fixed set of names (hash and displace), built with the stats pack.
+// A lookup is one string hash, one bucket displacement mix and one compare; ids are dense in
+// [0, size()) and stable for the pack's lifetime (they are slot numbers, not sorted order).
+class PerfectHash {
+public:
+    PerfectHash() = default;
+
+    // Throws std::invalid_argument on duplicate keys
+    static PerfectHash build(const QStringList& keys);
+
+    // -1 if 'key' is not in the set
+    int indexOf(QStringView key) const {
+        if (m_keys.isEmpty()) return -1;
+        quint64 h = hashKey(key, m_salt);
+        int slot = slotFor(h, m_displacements[h % quint64(m_displacements.size())], m_keys.size());
+        return QStringView(m_keys[slot]) == key ? slot : -1;
+    }
+    bool contains(QStringView key) const { return indexOf(key) >= 0; }
+
+    int size() const { return m_keys.size(); }
+    bool isEmpty() const { return m_keys.isEmpty(); }
+    const QString& keyAt(int id) const { return m_keys[id]; }
+    const QStringList& keys() const { return m_keys; } // In id order
+
+    // True if every key resolves to its own slot (checks a deserialized table)
+    bool isConsistent() const;
+    qint64 memoryBytes() const; // Keys and displacement table (estimate, see MemoryLedger)
+
+    friend QDataStream &operator<<(QDataStream &out, const PerfectHash &hash);
+    friend QDataStream &operator>>(QDataStream &in, PerfectHash &hash);
+
+private:
+    // FNV-1a over UTF-16 code units, finished with a 64-bit mix
+    static quint64 hashKey(QStringView key, quint64 salt) {
+        quint64 h = 0xcbf29ce484222325ULL ^ salt;
+        for (QChar c : key) {
+            h ^= c.unicode();
+            h *= 0x100000001b3ULL;
+        }
+        return mix(h);
+    }
+    static quint64 mix(quint64 x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        return x;
+    }
+    static int slotFor(quint64 h, quint32 displacement, int n) {
+        return static_cast<int>(mix(h ^ (quint64(displacement) * 0x9e3779b97f4a7c15ULL)) % quint64(n));
+    }
+
+    quint64 m_salt = 0;
+    QVector<quint32> m_displacements; // One per bucket
+    QStringList m_keys;               // m_keys[slot]
+};
+
+// Name -> id tables for everything a draft request names, stored in stats.pack
+struct NameIndex {
+    PerfectHash brawlers;
+    PerfectHash maps;
+    PerfectHash modes;
+
+    static NameIndex build(const QSet<QString>& allBrawlers, const QHash<QString, QSet<QString>>& discoveredMapModes);
+    bool isEmpty() const { return brawlers.isEmpty(); }
+    // True if the tables cover exactly these names
+    bool matches(const QSet<QString>& allBrawlers, const QHash<QString, QSet<QString>>& discoveredMapModes) const;
+    qint64 memoryBytes() const { return brawlers.memoryBytes() + maps.memoryBytes() + modes.memoryBytes(); }
+};
+QDataStream &operator<<(QDataStream &out, const NameIndex &index);
+QDataStream &operator>>(QDataStream &in, NameIndex &index);
+
+#endif // PERFECTHASH_H
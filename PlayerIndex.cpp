@@ -0,0 +1,231 @@
+#include "PlayerIndex.h"
+#include <QtAlgorithms>
+#include <QSaveFile>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDataStream>
+#include <QDebug>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+const quint32 PLAYER_INDEX_MAGIC = 0x504C4958; // "PLIX"
+const qint16 PLAYER_INDEX_VERSION = 1;
+
+} // namespace
+
+
+// --- RosterMask ---
+
+RosterMask& RosterMask::operator|=(const RosterMask& other) {
+    if (other.m_words.size() > m_words.size()) m_words.resize(other.m_words.size());
+    for (int i = 0; i < other.m_words.size(); ++i) m_words[i] |= other.m_words[i];
+    return *this;
+}
+
+int RosterMask::count() const {
+    int bits = 0;
+    for (quint64 word : m_words) bits += qPopulationCount(word);
+    return bits;
+}
+
+// --- PlayerIndex ---
+
+QVector<PlayerBrawlerStats> PlayerIndex::brawlersOf(const QString& tag) const {
+    auto it = m_playerIds.constFind(tag);
+    if (it == m_playerIds.constEnd()) return {};
+    QVector<PlayerBrawlerStats> result;
+    for (quint32 e = m_offsets[it.value()]; e < m_offsets[it.value() + 1]; ++e) {
+        const Entry& entry = m_entries[e];
+        result.append({m_brawlers.keyAt(entry.brawler), entry.games, entry.wins});
+    }
+    std::sort(result.begin(), result.end(), [](const PlayerBrawlerStats& a, const PlayerBrawlerStats& b) {
+        return a.games != b.games ? a.games > b.games : a.brawler < b.brawler;
+    });
+    return result;
+}
+
+std::optional<PlayerBrawlerStats> PlayerIndex::stats(const QString& tag, const QString& brawler) const {
+    auto it = m_playerIds.constFind(tag);
+    int id = m_brawlers.indexOf(brawler);
+    if (it == m_playerIds.constEnd() || id < 0) return std::nullopt;
+    const quint64* mask = m_masks.constData() + qsizetype(it.value()) * wordsPerMask();
+    if (!((mask[id >> 6] >> (id & 63)) & 1)) return std::nullopt;
+
+    auto first = m_entries.cbegin() + m_offsets[it.value()];
+    auto last = m_entries.cbegin() + m_offsets[it.value() + 1];
+    auto entry = std::lower_bound(first, last, id, [](const Entry& e, int value) { return e.brawler < value; });
+    return PlayerBrawlerStats{brawler, entry->games, entry->wins};
+}
+
+RosterMask PlayerIndex::poolMask(const QStringList& tags, int minGames) const {
+    RosterMask pool(m_brawlers.size());
+    const int words = wordsPerMask();
+    for (const QString& tag : tags) {
+        auto it = m_playerIds.constFind(tag);
+        if (it == m_playerIds.constEnd()) continue;
+        if (minGames <= 1) {
+            const quint64* mask = m_masks.constData() + qsizetype(it.value()) * words;
+            for (int w = 0; w < words; ++w) pool.m_words[w] |= mask[w];
+            continue;
+        }
+        for (quint32 e = m_offsets[it.value()]; e < m_offsets[it.value() + 1]; ++e) {
+            if (m_entries[e].games >= quint32(minGames)) pool.set(m_entries[e].brawler);
+        }
+    }
+    return pool;
+}
+
+QSet<QString> PlayerIndex::brawlersIn(const RosterMask& mask) const {
+    QSet<QString> brawlers;
+    for (int id = 0; id < m_brawlers.size(); ++id) {
+        if (mask.test(id)) brawlers.insert(m_brawlers.keyAt(id));
+    }
+    return brawlers;
+}
+
+std::shared_ptr<const TeamPools> PlayerIndex::teamPools(const QStringList& team1Tags, const QStringList& team2Tags,
+                                                        int minGames) const {
+    auto pools = std::make_shared<TeamPools>();
+    pools->team1 = brawlersIn(poolMask(team1Tags, minGames));
+    pools->team2 = brawlersIn(poolMask(team2Tags, minGames));
+    return pools;
+}
+
+qint64 PlayerIndex::byteSize() const {
+    return qint64(m_entries.size()) * sizeof(Entry) + qint64(m_offsets.size()) * sizeof(quint32) +
+           qint64(m_masks.size()) * sizeof(quint64);
+}
+
+// --- Persistence ---
+
+QDataStream &operator<<(QDataStream &out, const PlayerIndex::Entry &entry) {
+    out << entry.brawler << entry.games << entry.wins;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, PlayerIndex::Entry &entry) {
+    in >> entry.brawler >> entry.games >> entry.wins;
+    return in;
+}
+
+// Tags are the bulk: one string per player in the hash
+void PlayerIndex::chargeMemory() {
+    qint64 bytes = byteSize() + m_brawlers.memoryBytes() + MemoryLedger::hashBytes(m_playerIds);
+    for (auto it = m_playerIds.constBegin(); it != m_playerIds.constEnd(); ++it) bytes += MemoryLedger::stringBytes(it.key());
+    m_charge.set(bytes);
+}
+
+bool PlayerIndex::save(const QString& filePath) const {
+    QDir dir = QFileInfo(filePath).dir();
+    if (!dir.exists() && !dir.mkpath(".")) {
+        qCritical() << "Failed to create player index directory:" << dir.path();
+        return false;
+    }
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCritical() << "Error opening player index for writing:" << filePath << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << PLAYER_INDEX_MAGIC << PLAYER_INDEX_VERSION << m_brawlers << m_playerIds << m_offsets << m_entries << m_masks;
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        qCritical() << "Error writing player index:" << filePath;
+        return false;
+    }
+    qInfo() << "Saved player index (" << playerCount() << "players ) to" << filePath;
+    return true;
+}
+
+std::optional<PlayerIndex> PlayerIndex::load(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.exists()) {
+        qInfo() << "Player index not found:" << filePath;
+        return std::nullopt;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Error opening player index:" << filePath << file.errorString();
+        return std::nullopt;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magicNumber = 0;
+    qint16 version = 0;
+    in >> magicNumber >> version;
+    if (in.status() != QDataStream::Ok || magicNumber != PLAYER_INDEX_MAGIC || version != PLAYER_INDEX_VERSION) {
+        qWarning() << "Player index has invalid header or version:" << filePath;
+        return std::nullopt;
+    }
+
+    PlayerIndex index;
+    in >> index.m_brawlers >> index.m_playerIds >> index.m_offsets >> index.m_entries >> index.m_masks;
+    bool shapeOk = index.m_offsets.size() == index.m_playerIds.size() + 1 &&
+                   index.m_masks.size() == qsizetype(index.m_playerIds.size()) * index.wordsPerMask() &&
+                   index.m_offsets.first() == 0 && index.m_offsets.last() == quint32(index.m_entries.size());
+    // Lookups index runs and masks straight from these, so a corrupt file must not get past here
+    for (int i = 1; shapeOk && i < index.m_offsets.size(); ++i) {
+        shapeOk = index.m_offsets[i - 1] <= index.m_offsets[i];
+    }
+    for (int i = 0; shapeOk && i < index.m_entries.size(); ++i) {
+        shapeOk = index.m_entries[i].brawler < index.m_brawlers.size();
+    }
+    for (auto it = index.m_playerIds.cbegin(); shapeOk && it != index.m_playerIds.cend(); ++it) {
+        shapeOk = it.value() >= 0 && it.value() < index.m_playerIds.size();
+    }
+    if (in.status() != QDataStream::Ok || !shapeOk || !index.m_brawlers.isConsistent()) {
+        qWarning() << "Error reading player index (likely corrupted):" << filePath;
+        return std::nullopt;
+    }
+    qInfo() << "Player index loaded with" << index.playerCount() << "players.";
+    index.chargeMemory();
+    return index;
+}
+
+// --- PlayerIndexBuilder ---
+
+void PlayerIndexBuilder::add(const QString& tag, const QString& brawler, bool win) {
+    Counts& counts = m_players[tag][brawler];
+    counts.games++;
+    if (win) counts.wins++;
+}
+
+PlayerIndex PlayerIndexBuilder::build(const QSet<QString>& allBrawlers) const {
+    if (allBrawlers.size() > std::numeric_limits<quint16>::max()) {
+        throw std::invalid_argument("Too many brawlers for the player index encoding.");
+    }
+    QStringList roster(allBrawlers.begin(), allBrawlers.end());
+    roster.sort();
+
+    PlayerIndex index;
+    index.m_brawlers = PerfectHash::build(roster);
+    const int words = index.wordsPerMask();
+    QStringList tags = m_players.keys();
+    tags.sort(); // Stable player ids for the same input
+    index.m_offsets.reserve(tags.size() + 1);
+    index.m_masks.fill(0, qsizetype(tags.size()) * words);
+    for (const QString& tag : tags) {
+        qint32 player = index.m_playerIds.size();
+        index.m_playerIds.insert(tag, player);
+        index.m_offsets.append(static_cast<quint32>(index.m_entries.size()));
+        const QHash<QString, Counts>& played = m_players[tag];
+        for (auto it = played.constBegin(); it != played.constEnd(); ++it) {
+            int id = index.m_brawlers.indexOf(it.key());
+            if (id < 0) continue;
+            index.m_entries.append({static_cast<quint16>(id), it.value().games, it.value().wins});
+            index.m_masks[qsizetype(player) * words + (id >> 6)] |= quint64(1) << (id & 63);
+        }
+        std::sort(index.m_entries.begin() + index.m_offsets.last(), index.m_entries.end(),
+                  [](const PlayerIndex::Entry& a, const PlayerIndex::Entry& b) { return a.brawler < b.brawler; });
+    }
+    index.m_offsets.append(static_cast<quint32>(index.m_entries.size()));
+    qInfo() << "Player index:" << index.playerCount() << "players," << index.m_entries.size() << "player/brawler records,"
+            << index.byteSize() / 1024 << "KB.";
+    index.chargeMemory();
+    return index;
+}
@@ -0,0 +1,107 @@
+#ifndef PLAYERINDEX_H
+#define PLAYERINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <optional>
+#include "PerfectHash.h"
+#include "MemoryLedger.h"
+#include "DraftState.h"
+
+// Bit set over the index's roster ids (one bit per brawler, ~2 words for a 90-brawler roster)
+class RosterMask {
+public:
+    RosterMask() = default;
+    explicit RosterMask(int rosterSize) : m_words((rosterSize + 63) / 64, 0) {}
+
+    void set(int id) { m_words[id >> 6] |= quint64(1) << (id & 63); }
+    bool test(int id) const {
+        return id >= 0 && (id >> 6) < m_words.size() && ((m_words[id >> 6] >> (id & 63)) & 1);
+    }
+    RosterMask& operator|=(const RosterMask& other);
+    int count() const;
+    bool isEmpty() const { return count() == 0; }
+
+private:
+    friend class PlayerIndex;
+    QVector<quint64> m_words;
+};
+
+// One player's record on one brawler (every map and mode)
+struct PlayerBrawlerStats {
+    QString brawler;
+    quint32 games = 0;
+    quint32 wins = 0;
+
+    double winRate() const { return games > 0 ? static_cast<double>(wins) / games : 0.0; }
+};
+
+// Player tag -> brawlers played, with games and wins, built from the tagged players of every
+// ingested game. Stored CSR-style: one hash lookup finds the player, a roster mask answers
+// "has played X" in O(1), and the per-brawler counts are a short sorted run of 12-byte entries.
+class PlayerIndex {
+public:
+    PlayerIndex() = default;
+
+    bool isEmpty() const { return m_playerIds.isEmpty(); }
+    int playerCount() const { return m_playerIds.size(); }
+    bool contains(const QString& tag) const { return m_playerIds.contains(tag); }
+    const PerfectHash& roster() const { return m_brawlers; }
+
+    // Brawlers 'tag' played, most games first (empty if unknown)
+    QVector<PlayerBrawlerStats> brawlersOf(const QString& tag) const;
+    std::optional<PlayerBrawlerStats> stats(const QString& tag, const QString& brawler) const;
+
+    // Union of the players' pools; brawlers with fewer than 'minGames' games are left out.
+    // Unknown tags contribute nothing.
+    RosterMask poolMask(const QStringList& tags, int minGames = 1) const;
+    QSet<QString> brawlersIn(const RosterMask& mask) const;
+    // Pools for DraftState::withTeamPools; a side with no tags (or no known tag) stays unrestricted
+    std::shared_ptr<const TeamPools> teamPools(const QStringList& team1Tags, const QStringList& team2Tags,
+                                               int minGames = 1) const;
+
+    qint64 byteSize() const; // Entries, offsets and masks (excludes the tag hash)
+
+    bool save(const QString& filePath) const;
+    static std::optional<PlayerIndex> load(const QString& filePath); // std::nullopt if missing or corrupt
+
+private:
+    friend class PlayerIndexBuilder;
+    struct Entry {
+        quint16 brawler; // Roster id
+        quint32 games;
+        quint32 wins;
+    };
+    friend QDataStream &operator<<(QDataStream &out, const Entry &entry);
+    friend QDataStream &operator>>(QDataStream &in, Entry &entry);
+
+    int wordsPerMask() const { return (m_brawlers.size() + 63) / 64; }
+    void chargeMemory(); // Once built or loaded
+
+    PerfectHash m_brawlers;
+    QHash<QString, qint32> m_playerIds;
+    QVector<quint32> m_offsets; // Player p's entries are [m_offsets[p], m_offsets[p + 1]), by roster id
+    QVector<Entry> m_entries;
+    QVector<quint64> m_masks;   // wordsPerMask() words per player
+    MemoryCharge m_charge{MemorySubsystem::NamePools};
+};
+
+// Collects (tag, brawler, win) observations during ingestion, then compacts them
+class PlayerIndexBuilder {
+public:
+    void add(const QString& tag, const QString& brawler, bool win);
+    // Brawlers outside 'allBrawlers' are dropped; throws std::invalid_argument past 65535 brawlers
+    PlayerIndex build(const QSet<QString>& allBrawlers) const;
+
+private:
+    struct Counts {
+        quint32 games = 0;
+        quint32 wins = 0;
+    };
+    QHash<QString, QHash<QString, Counts>> m_players;
+};
+
+#endif // PLAYERINDEX_H
@@ -0,0 +1,345 @@
+#include "PolicyTable.h"
+#include "Heuristics.h"
+#include "MCTS.h"
+#include "TaskExecutor.h"
+#include <QFile>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+
+const quint32 POLICY_MAGIC = 0xACED9011;
+const qint16 POLICY_VERSION = 1;
+const int FEATURE_COUNT = 3;
+
+using MoveFeatures = std::array<double, FEATURE_COUNT>; // synergy, counter, countered
+
+QString modelKey(const QString& mapName, const QString& modeName) {
+    return mapName + "|" + modeName;
+}
+
+MoveFeatures moveFeatures(const QString& brawler, const QVector<QString>& ownPicks, const QVector<QString>& oppPicks,
+                          const QString& mapName, const QString& modeName, const StatsCalculator& stats) {
+    MoveFeatures f{{0.0, 0.0, 0.0}};
+    for (const QString& teammate : ownPicks) {
+        f[0] += stats.getSynergyScore(brawler, teammate, mapName, modeName) - 0.5;
+    }
+    if (!ownPicks.isEmpty()) f[0] /= ownPicks.size();
+    for (const QString& opponent : oppPicks) {
+        f[1] += stats.getCounterScore(brawler, opponent, mapName, modeName) - 0.5;
+        f[2] += stats.getCounterScore(opponent, brawler, mapName, modeName) - 0.5;
+    }
+    if (!oppPicks.isEmpty()) { f[1] /= oppPicks.size(); f[2] /= oppPicks.size(); }
+    return f;
+}
+
+// Softmax in place; returns nothing, 'values' become probabilities
+void softmax(QVector<double>& values) {
+    if (values.isEmpty()) return;
+    double maxValue = *std::max_element(values.begin(), values.end());
+    double sum = 0.0;
+    for (double& v : values) { v = std::exp(v - maxValue); sum += v; }
+    for (double& v : values) v /= sum;
+}
+
+// One MCTS-labelled position
+struct TrainingSample {
+    QVector<int> moveIndex;          // Index into the map's brawler list
+    QVector<MoveFeatures> features;
+    QVector<double> target;          // Root visit share per move
+};
+
+QPair<QString, PolicyMapModel> distillMap(const QString& mapName, const QString& modeName,
+                                          const StatsCalculator& stats, const QSet<QString>& allBrawlers,
+                                          const MCTSManager& mctsManager, const HeuristicWeights& weights,
+                                          const EvalWeights& evalWeights, const DistillSettings& settings) {
+    std::mt19937 rng(settings.seed ^ static_cast<quint32>(qHash(modelKey(mapName, modeName))));
+    QVector<QString> roster(allBrawlers.begin(), allBrawlers.end());
+    std::sort(roster.begin(), roster.end());
+    QHash<QString, int> rosterIndex;
+    for (int i = 0; i < roster.size(); ++i) rosterIndex.insert(roster[i], i);
+
+    // --- 1. Sample positions and label them with fixed-budget MCTS ---
+    QVector<TrainingSample> samples;
+    samples.reserve(settings.positionsPerMap);
+    for (int p = 0; p < settings.positionsPerMap; ++p) {
+        QVector<QString> shuffled = roster;
+        std::shuffle(shuffled.begin(), shuffled.end(), rng);
+        int banCount = std::uniform_int_distribution<int>(0, 6)(rng);
+        QSet<QString> bans(shuffled.begin(), shuffled.begin() + std::min<int>(banCount, shuffled.size()));
+        DraftState state(mapName, modeName, allBrawlers, bans);
+
+        // Realistic prefix: random choices among the heuristic's best moves
+        int prefix = std::uniform_int_distribution<int>(0, 5)(rng);
+        for (int m = 0; m < prefix && !state.isComplete(); ++m) {
+            auto scores = suggestPickHeuristic(state, stats, weights).second;
+            QVector<QPair<double, QString>> ranked;
+            for (auto it = scores.constBegin(); it != scores.constEnd(); ++it) ranked.append({it.value().totalScore, it.key()});
+            std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+            int top = std::min<int>(8, ranked.size());
+            if (top == 0) break;
+            state = state.applyMove(ranked[std::uniform_int_distribution<int>(0, top - 1)(rng)].second);
+        }
+        if (state.isComplete()) continue;
+
+        QVector<MCTSResult> results = mctsManager.runFixedBudget(state, weights, evalWeights, settings.mctsIterations, rng());
+        double totalVisits = 0.0;
+        for (const MCTSResult& r : results) totalVisits += r.visits;
+        if (totalVisits <= 0.0) continue;
+
+        QHash<QString, double> visitShare;
+        for (const MCTSResult& r : results) visitShare.insert(r.move, r.visits / totalVisits);
+
+        const QVector<QString>& own = state.currentTurn() == "team1" ? state.team1Picks() : state.team2Picks();
+        const QVector<QString>& opp = state.currentTurn() == "team1" ? state.team2Picks() : state.team1Picks();
+        TrainingSample sample;
+        for (const QString& move : state.getLegalMoves()) {
+            sample.moveIndex.append(rosterIndex.value(move));
+            sample.features.append(moveFeatures(move, own, opp, mapName, modeName, stats));
+            sample.target.append(visitShare.value(move, 0.0));
+        }
+        samples.append(sample);
+    }
+
+    // --- 2. Fit the linear policy (full-batch gradient descent on cross-entropy) ---
+    // Features are scaled to unit variance for the fit; a per-position offset cancels in the softmax
+    MoveFeatures featureScale{{0.0, 0.0, 0.0}};
+    long long featureCount = 0;
+    for (const TrainingSample& s : samples) {
+        for (const MoveFeatures& f : s.features) {
+            for (int k = 0; k < FEATURE_COUNT; ++k) featureScale[k] += f[k] * f[k];
+            featureCount++;
+        }
+    }
+    for (int k = 0; k < FEATURE_COUNT; ++k) {
+        featureScale[k] = featureCount > 0 ? std::sqrt(featureScale[k] / featureCount) : 1.0;
+        if (featureScale[k] < 1e-9) featureScale[k] = 1.0;
+    }
+
+    const double learningRate = 0.5;
+    const double biasL2 = 1e-3; // Keeps rarely chosen brawlers near 0 instead of -inf
+    QVector<double> bias(roster.size(), 0.0);
+    MoveFeatures w{{0.0, 0.0, 0.0}};
+    double loss = 0.0;
+
+    auto logitsFor = [&](const TrainingSample& s) {
+        QVector<double> logits(s.moveIndex.size());
+        for (int i = 0; i < s.moveIndex.size(); ++i) {
+            double v = bias[s.moveIndex[i]];
+            for (int k = 0; k < FEATURE_COUNT; ++k) v += w[k] * s.features[i][k] / featureScale[k];
+            logits[i] = v;
+        }
+        return logits;
+    };
+
+    for (int epoch = 0; epoch < settings.epochs && !samples.isEmpty(); ++epoch) {
+        QVector<double> gradBias(roster.size(), 0.0);
+        MoveFeatures gradW{{0.0, 0.0, 0.0}};
+        loss = 0.0;
+        for (const TrainingSample& s : samples) {
+            QVector<double> probs = logitsFor(s);
+            softmax(probs);
+            for (int i = 0; i < probs.size(); ++i) {
+                double g = probs[i] - s.target[i];
+                gradBias[s.moveIndex[i]] += g;
+                for (int k = 0; k < FEATURE_COUNT; ++k) gradW[k] += g * s.features[i][k] / featureScale[k];
+                if (s.target[i] > 0.0) loss -= s.target[i] * std::log(std::max(probs[i], 1e-12));
+            }
+        }
+        double n = samples.size();
+        for (int b = 0; b < bias.size(); ++b) bias[b] -= learningRate * (gradBias[b] / n + biasL2 * bias[b]);
+        for (int k = 0; k < FEATURE_COUNT; ++k) w[k] -= learningRate * gradW[k] / n;
+        loss /= n;
+    }
+
+    // --- 3. Package the model (features back in raw units) ---
+    PolicyMapModel model;
+    for (int b = 0; b < roster.size(); ++b) {
+        if (bias[b] != 0.0) model.brawlerBias.insert(roster[b], bias[b]);
+    }
+    model.synergyWeight = w[0] / featureScale[0];
+    model.counterWeight = w[1] / featureScale[1];
+    model.counteredWeight = w[2] / featureScale[2];
+    model.positions = samples.size();
+    model.crossEntropy = loss;
+
+    int agree = 0;
+    for (const TrainingSample& s : samples) {
+        QVector<double> logits = logitsFor(s);
+        int policyBest = std::max_element(logits.begin(), logits.end()) - logits.begin();
+        int mctsBest = std::max_element(s.target.begin(), s.target.end()) - s.target.begin();
+        if (policyBest == mctsBest) agree++;
+    }
+    model.top1Agreement = samples.isEmpty() ? 0.0 : static_cast<double>(agree) / samples.size();
+
+    return {modelKey(mapName, modeName), model};
+}
+
+} // namespace
+
+
+// --- Persistence ---
+
+std::optional<PolicyTable> PolicyTable::load(const QString& filepath, qint64 packVersion) {
+    QFile file(filepath);
+    if (!file.exists()) {
+        qInfo() << "Policy table not found:" << filepath;
+        return std::nullopt;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Error opening policy table:" << filepath << file.errorString();
+        return std::nullopt;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magicNumber = 0;
+    qint16 version = 0;
+    in >> magicNumber >> version;
+    if (in.status() != QDataStream::Ok || magicNumber != POLICY_MAGIC || version != POLICY_VERSION) {
+        qWarning() << "Policy table has invalid header or version:" << filepath;
+        return std::nullopt;
+    }
+
+    PolicyTable table;
+    in >> table.m_packVersion >> table.m_models;
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "Error reading policy table (likely corrupted):" << filepath;
+        return std::nullopt;
+    }
+    if (table.m_packVersion != packVersion) {
+        qWarning() << "Policy table was distilled from a different stats pack; ignoring it. Re-run distill.";
+        return std::nullopt;
+    }
+
+    qInfo() << "Policy table loaded with" << table.m_models.size() << "map models.";
+    table.chargeMemory();
+    return table;
+}
+
+// Bias names share the pack's string data; the model keys are their own
+void PolicyTable::chargeMemory() {
+    qint64 bytes = MemoryLedger::hashBytes(m_models);
+    for (auto it = m_models.constBegin(); it != m_models.constEnd(); ++it) {
+        bytes += MemoryLedger::stringBytes(it.key()) + MemoryLedger::hashBytes(it.value().brawlerBias);
+    }
+    m_charge.set(bytes);
+}
+
+bool PolicyTable::save(const QString& filepath) const {
+    QFile file(filepath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCritical() << "Error opening policy table for writing:" << filepath << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << POLICY_MAGIC << POLICY_VERSION << m_packVersion << m_models;
+    file.close();
+
+    if (out.status() != QDataStream::Ok) {
+        qCritical() << "Error writing policy table:" << filepath;
+        file.remove();
+        return false;
+    }
+    qInfo() << "Saved policy table to" << filepath;
+    return true;
+}
+
+// --- Distillation ---
+
+PolicyTable PolicyTable::distill(const StatsCalculator& statsCalculator,
+                                 const QSet<QString>& allBrawlers,
+                                 const QHash<QString, QSet<QString>>& mapModeData,
+                                 const MCTSManager& mctsManager,
+                                 const HeuristicWeights& weights,
+                                 const EvalWeights& evalWeights,
+                                 const DistillSettings& settings) {
+    QVector<QPair<QString, QString>> maps;
+    for (auto modeIt = mapModeData.constBegin(); modeIt != mapModeData.constEnd(); ++modeIt) {
+        if (!settings.modeFilter.isEmpty() && modeIt.key() != settings.modeFilter) continue;
+        for (const QString& mapName : modeIt.value()) maps.append({mapName, modeIt.key()});
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    qInfo() << "Distilling policy for" << maps.size() << "maps," << settings.positionsPerMap
+            << "positions x" << settings.mctsIterations << "iterations each.";
+
+    QList<QPair<QString, PolicyMapModel>> models = TaskExecutor::instance().mapped(maps,
+        [&](const QPair<QString, QString>& map) {
+            return distillMap(map.first, map.second, statsCalculator, allBrawlers, mctsManager, weights, evalWeights, settings);
+        }, TaskPriority::Batch);
+
+    PolicyTable table;
+    table.m_packVersion = statsCalculator.packVersion();
+    for (const auto& entry : models) {
+        if (entry.second.positions > 0) table.m_models.insert(entry.first, entry.second);
+    }
+    qInfo() << "Policy distillation finished in" << timer.elapsed() << "ms.";
+    table.chargeMemory();
+    return table;
+}
+
+// --- Runtime Queries ---
+
+bool PolicyTable::hasModel(const QString& mapName, const QString& modeName) const {
+    return m_models.contains(modelKey(mapName, modeName));
+}
+
+const PolicyMapModel* PolicyTable::model(const QString& mapName, const QString& modeName) const {
+    auto it = m_models.constFind(modelKey(mapName, modeName));
+    return it != m_models.constEnd() ? &it.value() : nullptr;
+}
+
+QList<QString> PolicyTable::modelKeys() const {
+    return m_models.keys();
+}
+
+qint64 PolicyTable::packVersion() const {
+    return m_packVersion;
+}
+
+QVector<QPair<QString, double>> PolicyTable::rankMoves(const DraftState& state, const StatsCalculator& statsCalculator) const {
+    const PolicyMapModel* m = model(state.mapName(), state.modeName());
+    if (!m || state.isComplete()) return {};
+
+    const QVector<QString>& own = state.currentTurn() == "team1" ? state.team1Picks() : state.team2Picks();
+    const QVector<QString>& opp = state.currentTurn() == "team1" ? state.team2Picks() : state.team1Picks();
+    QVector<QString> moves = state.getLegalMoves();
+    QVector<double> probs(moves.size());
+    for (int i = 0; i < moves.size(); ++i) {
+        MoveFeatures f = moveFeatures(moves[i], own, opp, state.mapName(), state.modeName(), statsCalculator);
+        probs[i] = m->brawlerBias.value(moves[i], 0.0) + m->synergyWeight * f[0]
+                 + m->counterWeight * f[1] + m->counteredWeight * f[2];
+    }
+    softmax(probs);
+
+    QVector<QPair<QString, double>> ranked;
+    ranked.reserve(moves.size());
+    for (int i = 0; i < moves.size(); ++i) ranked.append({moves[i], probs[i]});
+    std::sort(ranked.begin(), ranked.end(), [](const QPair<QString, double>& a, const QPair<QString, double>& b) {
+        return a.second > b.second;
+    });
+    return ranked;
+}
+
+QString PolicyTable::suggest(const DraftState& state, const StatsCalculator& statsCalculator) const {
+    QVector<QPair<QString, double>> ranked = rankMoves(state, statsCalculator);
+    return ranked.isEmpty() ? QString() : ranked.first().first;
+}
+
+QString PolicyTable::sampleMove(const DraftState& state, const StatsCalculator& statsCalculator, std::mt19937& randomEngine) const {
+    QVector<QPair<QString, double>> ranked = rankMoves(state, statsCalculator);
+    if (ranked.isEmpty()) return QString();
+    std::vector<double> probs;
+    probs.reserve(ranked.size());
+    for (const auto& entry : ranked) probs.push_back(entry.second);
+    std::discrete_distribution<int> dist(probs.begin(), probs.end());
+    return ranked[dist(randomEngine)].first;
+}
@@ -0,0 +1,67 @@
+#ifndef POLICYTABLE_H
+#define POLICYTABLE_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QPair>
+#include <optional>
+#include <random>
+#include "DataStructures.h"
+#include "DraftState.h"
+#include "StatsCalculator.h"
+#include "MemoryLedger.h"
+
+class MCTSManager;
+
+// Settings for the offline distillation job
+struct DistillSettings {
+    int positionsPerMap = 200; // Sampled draft positions per map
+    int mctsIterations = 1500; // Fixed MCTS budget per position (targets are root visit shares)
+    int epochs = 300;          // Full-batch gradient steps per map
+    quint32 seed = 1;
+    QString modeFilter;        // Only distill maps of this mode (empty = all)
+};
+
+// Instant pick policy distilled from offline fixed-budget MCTS (see PolicyMapModel).
+// Scoring a position costs a few stats lookups per legal move, i.e. heuristic cost.
+// Stored next to stats.pack and only valid for the pack version it was distilled from.
+class PolicyTable {
+public:
+    PolicyTable() = default;
+
+    // Returns std::nullopt if missing, corrupted, or distilled from another pack version
+    static std::optional<PolicyTable> load(const QString& filepath, qint64 packVersion);
+    bool save(const QString& filepath) const;
+
+    // Runs MCTS on sampled positions of every map (maps in parallel) and fits one model per map
+    static PolicyTable distill(const StatsCalculator& statsCalculator,
+                               const QSet<QString>& allBrawlers,
+                               const QHash<QString, QSet<QString>>& mapModeData,
+                               const MCTSManager& mctsManager,
+                               const HeuristicWeights& weights,
+                               const EvalWeights& evalWeights,
+                               const DistillSettings& settings);
+
+    bool hasModel(const QString& mapName, const QString& modeName) const;
+    const PolicyMapModel* model(const QString& mapName, const QString& modeName) const;
+    QList<QString> modelKeys() const; // "map|mode"
+    qint64 packVersion() const;
+
+    // Legal moves with softmax probabilities, best first. Empty if the map has no model.
+    QVector<QPair<QString, double>> rankMoves(const DraftState& state, const StatsCalculator& statsCalculator) const;
+    // Best move, or empty string if the map has no model
+    QString suggest(const DraftState& state, const StatsCalculator& statsCalculator) const;
+    // Move sampled from the policy (for MCTS rollouts), or empty string if the map has no model
+    QString sampleMove(const DraftState& state, const StatsCalculator& statsCalculator, std::mt19937& randomEngine) const;
+
+private:
+    void chargeMemory(); // Once loaded or distilled
+
+    qint64 m_packVersion = 0;
+    QHash<QString, PolicyMapModel> m_models; // Key: map|mode
+    MemoryCharge m_charge{MemorySubsystem::EvalCaches};
+};
+
+#endif // POLICYTABLE_H
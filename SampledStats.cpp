@@ -0,0 +1,113 @@
+#include "SampledStats.h"
+#include "StatsCalculator.h"
+#include "AppConfig.h"
+#include "TaskExecutor.h"
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+using CellTable = QHash<QString, BrawlerStatsData>;
+
+const MapModeStatsData* findMapMode(const StatsContainer& stats, const QString& mapName, const QString& mode) {
+    auto mapIt = stats.constFind(mapName);
+    if (mapIt == stats.constEnd()) return nullptr;
+    auto modeIt = mapIt.value().constFind(mode);
+    return modeIt == mapIt.value().constEnd() ? nullptr : &modeIt.value();
+}
+
+// SE of each cell's pooled raw win rate from its rates in the groups that played it
+QHash<QString, float> groupErrors(const CellTable& cells, CellTable MapModeStatsData::*table,
+                                  const QVector<const MapModeStatsData*>& groups, double fpc) {
+    QHash<QString, float> errors;
+    QVector<double> rates;
+    for (auto cellIt = cells.constBegin(); cellIt != cells.constEnd(); ++cellIt) {
+        rates.clear();
+        for (const MapModeStatsData* group : groups) {
+            if (!group) continue;
+            auto it = (group->*table).constFind(cellIt.key());
+            if (it == (group->*table).constEnd() || it.value().plays <= 0.0) continue;
+            rates.append(it.value().wins / it.value().plays);
+        }
+        const int n = rates.size();
+        if (n < 2) continue; // Seen in one group only: no spread to measure
+        double mean = std::accumulate(rates.begin(), rates.end(), 0.0) / n;
+        double sumSq = 0.0;
+        for (double rate : rates) sumSq += (rate - mean) * (rate - mean);
+        errors.insert(cellIt.key(), static_cast<float>(std::sqrt(sumSq / (n - 1) / n) * fpc));
+    }
+    return errors;
+}
+
+void scaleCells(CellTable& cells, double scale) {
+    for (BrawlerStatsData& cell : cells) {
+        cell.wins *= scale;
+        cell.plays *= scale;
+    }
+}
+
+} // namespace
+
+
+CacheData SampledStats::buildPack(const QVector<ProcessedGame>& games, const StratumCounts& strata,
+                                  const AppConfig& config, quint32 seed, int groups) {
+    if (groups < 2) throw std::invalid_argument("Sampling error estimates need at least 2 groups.");
+    QElapsedTimer timer;
+    timer.start();
+
+    qint64 totalLines = 0;
+    qint64 sampledLines = 0;
+    for (const auto& modes : strata) {
+        for (const StratumSample& stratum : modes) {
+            totalLines += stratum.lines;
+            sampledLines += stratum.sampled;
+        }
+    }
+    const double overallFraction = totalLines > 0 ? double(sampledLines) / totalLines : 1.0;
+
+    // Random equal-size groups; each is tallied on its own, in parallel
+    QVector<int> order(games.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937 randomEngine(seed);
+    std::shuffle(order.begin(), order.end(), randomEngine);
+    QVector<QVector<ProcessedGame>> parts(groups);
+    for (int i = 0; i < order.size(); ++i) parts[i % groups].append(games[order[i]]);
+    QList<StatsContainer> groupStats = TaskExecutor::instance().mapped(parts, [&config](const QVector<ProcessedGame>& part) {
+        return StatsCalculator(part, config).getStatsForCache().stats;
+    }, TaskPriority::Background);
+
+    CacheData data = StatsCalculator(games, config).getStatsForCache();
+    for (auto mapIt = data.stats.begin(); mapIt != data.stats.end(); ++mapIt) {
+        for (auto modeIt = mapIt.value().begin(); modeIt != mapIt.value().end(); ++modeIt) {
+            double fraction = overallFraction; // Strata keys are scanned names; fall back if one differs
+            StratumSample stratum = strata.value(mapIt.key()).value(modeIt.key());
+            if (stratum.sampled > 0) fraction = double(stratum.sampled) / stratum.lines;
+            const double fpc = std::sqrt(std::max(0.0, 1.0 - fraction));
+
+            QVector<const MapModeStatsData*> groupCells;
+            for (const StatsContainer& group : groupStats) groupCells.append(findMapMode(group, mapIt.key(), modeIt.key()));
+            MapModeStatsData& cells = modeIt.value();
+            MapModeErrorData& errors = data.errors[mapIt.key()][modeIt.key()];
+            errors.brawlerStats = groupErrors(cells.brawlerStats, &MapModeStatsData::brawlerStats, groupCells, fpc);
+            errors.synergyStats = groupErrors(cells.synergyStats, &MapModeStatsData::synergyStats, groupCells, fpc);
+            errors.counterStats = groupErrors(cells.counterStats, &MapModeStatsData::counterStats, groupCells, fpc);
+
+            // Scale up to the whole stratum (errors are of ratios, so they are unaffected)
+            const double scale = fraction > 0.0 ? 1.0 / fraction : 1.0;
+            scaleCells(cells.brawlerStats, scale);
+            scaleCells(cells.synergyStats, scale);
+            scaleCells(cells.counterStats, scale);
+            cells.totalWeightedPlays *= scale;
+        }
+    }
+    data.metadata.sampleFraction = overallFraction;
+    data.metadata.sampledGames = games.size();
+    qInfo() << "Sampled stats from" << games.size() << "games (" << QString::number(overallFraction * 100.0, 'f', 1)
+            << "% of lines ) with errors from" << groups << "groups in" << timer.elapsed() << "ms.";
+    return data;
+}
@@ -0,0 +1,24 @@
+#ifndef SAMPLEDSTATS_H
+#define SAMPLEDSTATS_H
+
+#include <QVector>
+#include "DataStructures.h"
+#include "DataLoader.h"
+
+class AppConfig;
+
+// Approximate stats pack from a stratified sample (DataLoader::setSampleFraction). Each map/mode's
+// counts are scaled by its lines / sampled lines, so weighted plays estimate the full pack's and
+// smoothing, pick-rate and plays floors behave as they would on all games. Per-cell standard
+// errors come from random groups: the sample is split into 'groups' equal parts, and the spread
+// of each cell's raw win rate across the parts (with the finite population correction of its
+// map/mode) estimates the error of the pooled rate.
+namespace SampledStats {
+
+    // Throws std::invalid_argument if groups < 2
+    CacheData buildPack(const QVector<ProcessedGame>& games, const StratumCounts& strata, const AppConfig& config,
+                        quint32 seed = 1, int groups = 10);
+
+} // namespace SampledStats
+
+#endif // SAMPLEDSTATS_H
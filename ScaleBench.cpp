@@ -0,0 +1,174 @@
+#include "ScaleBench.h"
+#include "AppConfig.h"
+#include "CacheUtils.h"
+#include "DataLoader.h"
+#include "DraftState.h"
+#include "Heuristics.h"
+#include "MCTS.h"
+#include "MemoryLedger.h"
+#include "StatsCalculator.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+ScaleStage measureStage(const QString& name, const std::function<QString()>& stage) {
+    MemoryLedger::resetPeakResident();
+    QElapsedTimer timer;
+    timer.start();
+    ScaleStage result;
+    result.name = name;
+    result.detail = stage();
+    result.elapsedMs = timer.elapsed();
+    result.rssMb = MemoryLedger::residentMb();
+    result.peakMb = MemoryLedger::peakResidentMb();
+    qInfo() << "Scale stage" << name << "took" << result.elapsedMs << "ms," << result.detail;
+    return result;
+}
+
+QString perSecond(double count, qint64 elapsedMs, const QString& unit) {
+    return QString("%1 %2/s").arg(count * 1000.0 / std::max<qint64>(1, elapsedMs), 0, 'f', 0).arg(unit);
+}
+
+} // namespace
+
+
+ScaleBench::ScaleBench(const AppConfig& config)
+    : m_config(config)
+{}
+
+QVector<ScalePoint> ScaleBench::run(const ScaleSettings& settings) const {
+    if (settings.brawlers.isEmpty() || settings.maps.isEmpty() || settings.games.isEmpty() || settings.skews.isEmpty()) {
+        throw std::invalid_argument("Scale sweep needs at least one value per parameter.");
+    }
+    if (settings.workDirectory.isEmpty() || !QDir().mkpath(settings.workDirectory)) {
+        throw std::invalid_argument("Scale sweep needs a writable work directory.");
+    }
+    QVector<ScalePoint> points;
+    for (int brawlers : settings.brawlers) {
+        for (int maps : settings.maps) {
+            for (qint64 games : settings.games) {
+                for (double skew : settings.skews) {
+                    SyntheticSettings point = settings.base;
+                    point.brawlers = brawlers;
+                    point.maps = maps;
+                    point.games = games;
+                    point.skew = skew;
+                    points.append(runPoint(point, settings));
+                }
+            }
+        }
+    }
+    return points;
+}
+
+ScalePoint ScaleBench::runPoint(const SyntheticSettings& point, const ScaleSettings& settings) const {
+    SyntheticGenerator generator(point);
+    ScalePoint result;
+    result.settings = point;
+    QDir workDir(settings.workDirectory);
+    const QString gamesPath = workDir.filePath("synthetic_games.jsonl");
+    const QString packPath = workDir.filePath("synthetic.pack");
+    qInfo() << "Scale point:" << point.brawlers << "brawlers," << point.maps << "maps," << point.games
+            << "games, skew" << point.skew;
+
+    // --- Offline pipeline ---
+    CacheData data;
+    if (point.games <= settings.jsonlLimit) {
+        result.stages.append(measureStage("generate", [&]() {
+            qint64 bytes = generator.writeJsonl(gamesPath);
+            if (bytes < 0) throw std::runtime_error("Failed to write the synthetic games file.");
+            return QString("%1 MB of JSONL").arg(bytes / (1024.0 * 1024.0), 0, 'f', 1);
+        }));
+        std::optional<DataLoader> loader;
+        result.stages.append(measureStage("parse", [&]() {
+            loader.emplace(gamesPath, m_config);
+            if (!loader->loadAndProcess()) throw std::runtime_error("Failed to parse the synthetic games file.");
+            return QString("%1 games").arg(loader->getProcessedGames().size());
+        }));
+        result.stages.append(measureStage("aggregate", [&]() {
+            data = StatsCalculator(loader->getProcessedGames(), m_config).getStatsForCache();
+            data.allBrawlers = loader->getAllBrawlers();
+            data.discoveredMapModes = loader->getDiscoveredMapModes();
+            loader.reset(); // Parsed games are not needed past here, as in build-pack
+            return QString("%1 map/modes").arg(generator.settings().maps);
+        }));
+        QFile::remove(gamesPath);
+    } else {
+        result.stages.append(measureStage("generate+aggregate", [&]() {
+            data = generator.buildPack(m_config);
+            return QString("%1 games, no JSONL (over %2)").arg(point.games).arg(settings.jsonlLimit);
+        }));
+    }
+
+    result.stages.append(measureStage("save pack", [&]() {
+        if (!CacheUtils::saveCache(packPath, data)) throw std::runtime_error("Failed to save the synthetic pack.");
+        data = CacheData(); // The next stages start from the file, like the app
+        return QString("%1 MB").arg(QFileInfo(packPath).size() / (1024.0 * 1024.0), 0, 'f', 1);
+    }));
+
+    StatsCalculator stats(m_config);
+    result.stages.append(measureStage("load pack", [&]() {
+        std::optional<CacheData> loaded = CacheUtils::loadCache(packPath);
+        if (!loaded.has_value()) throw std::runtime_error("Failed to load the synthetic pack.");
+        data = std::move(loaded.value());
+        stats.setStatsFromCacheData(data);
+        return QString("%1 brawlers").arg(data.allBrawlers.size());
+    }));
+    QFile::remove(packPath);
+
+    // --- Search pipeline ---
+    QVector<QPair<QString, QString>> maps;
+    for (auto modeIt = data.discoveredMapModes.constBegin(); modeIt != data.discoveredMapModes.constEnd(); ++modeIt) {
+        for (const QString& mapName : modeIt.value()) maps.append({mapName, modeIt.key()});
+    }
+    std::sort(maps.begin(), maps.end());
+    if (maps.isEmpty()) return result;
+    std::mt19937 rng(point.seed);
+
+    result.stages.append(measureStage("draft", [&]() {
+        QElapsedTimer timer;
+        timer.start();
+        int moves = 0;
+        while (moves < settings.draftOps) {
+            const auto& map = maps[rng() % maps.size()];
+            DraftState state(map.first, map.second, data.allBrawlers);
+            while (!state.isComplete() && moves < settings.draftOps) {
+                QVector<QString> legal = state.getLegalMoves();
+                if (legal.isEmpty()) break;
+                state = state.applyMove(legal[rng() % legal.size()]);
+                moves++;
+            }
+        }
+        return perSecond(moves, timer.elapsed(), "moves");
+    }));
+
+    const HeuristicWeights weights = m_config.heuristicWeights();
+    result.stages.append(measureStage("heuristic", [&]() {
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < settings.heuristicCalls; ++i) {
+            const auto& map = maps[i % maps.size()];
+            suggestPickHeuristic(DraftState(map.first, map.second, data.allBrawlers), stats, weights);
+        }
+        return perSecond(settings.heuristicCalls, timer.elapsed(), "picks");
+    }));
+
+    result.stages.append(measureStage("mcts", [&]() {
+        MCTSManager mctsManager(stats, m_config);
+        DraftState root(maps.first().first, maps.first().second, data.allBrawlers);
+        QElapsedTimer timer;
+        timer.start();
+        mctsManager.runFixedBudget(root, weights, m_config.evalWeights(), settings.mctsIterations, point.seed);
+        return perSecond(settings.mctsIterations, timer.elapsed(), "iterations");
+    }));
+    return result;
+}
@@ -0,0 +1,56 @@
+#ifndef SCALEBENCH_H
+#define SCALEBENCH_H
+
+#include <QString>
+#include <QVector>
+#include "SyntheticData.h"
+
+class AppConfig;
+
+// Grid of synthetic datasets to run the pipeline on (every combination of the lists)
+struct ScaleSettings {
+    SyntheticSettings base;          // Modes, spread, ranks, players and seed of every point
+    QVector<int> brawlers = {90, 300};
+    QVector<int> maps = {40, 1000};
+    QVector<qint64> games = {100000, 1000000};
+    QVector<double> skews = {1.0};
+    qint64 jsonlLimit = 2000000;     // Larger points skip the JSON stages and aggregate while generating
+    int draftOps = 20000;            // Moves applied by the draft stage
+    int heuristicCalls = 200;        // suggestPickHeuristic calls (first picks over the maps)
+    int mctsIterations = 2000;       // Fixed-budget MCTS from an empty draft
+    QString workDirectory;           // Games file and pack of the current point; removed after it
+};
+
+// One pipeline stage of one point
+struct ScaleStage {
+    QString name;
+    qint64 elapsedMs = 0;
+    double rssMb = -1.0;  // Resident set after the stage (-1: not available on this platform)
+    double peakMb = -1.0; // Peak resident set during the stage
+    QString detail;       // Stage throughput or size
+};
+
+struct ScalePoint {
+    SyntheticSettings settings;
+    QVector<ScaleStage> stages;
+};
+
+// Runs every stage of the offline and search pipeline on generated data and records time and
+// memory per stage: JSONL generation, parsing (DataLoader), aggregation (StatsCalculator), pack
+// save and load, DraftState moves, heuristic picks and MCTS. Points are run one at a time so
+// the memory figures are their own; the peak is reset before each stage where the OS allows it.
+class ScaleBench {
+public:
+    explicit ScaleBench(const AppConfig& config);
+
+    // Throws std::invalid_argument on bad settings (see SyntheticGenerator), std::runtime_error if a
+    // stage cannot write or read its file
+    QVector<ScalePoint> run(const ScaleSettings& settings) const;
+
+private:
+    ScalePoint runPoint(const SyntheticSettings& point, const ScaleSettings& settings) const;
+
+    const AppConfig& m_config;
+};
+
+#endif // SCALEBENCH_H
@@ -0,0 +1,301 @@
+#include "SearchBench.h"
+#include "Heuristics.h"
+#include "TreeSnapshot.h"
+#include "TaskExecutor.h"
+#include <QSaveFile>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QDebug>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+const quint32 BENCH_CORPUS_MAGIC = 0x424E4348; // "BNCH"
+const qint16 BENCH_CORPUS_VERSION = 1;
+const double EXACT_TIE = 1e-9;
+
+// Most visited child, as the arena and the GUI play it
+QString chosenMove(const QVector<MCTSResult>& results) {
+    auto best = std::max_element(results.begin(), results.end(), [](const MCTSResult& a, const MCTSResult& b) {
+        return a.visits < b.visits;
+    });
+    return best != results.end() ? best->move : QString();
+}
+
+// Regret of playing 'move' in 'position'; moves the reference never valued count as its worst
+double regretOf(const BenchPosition& position, const QString& move) {
+    if (position.moveValues.isEmpty()) return 0.0;
+    double worst = *std::min_element(position.moveValues.constBegin(), position.moveValues.constEnd());
+    double best = position.moveValues.value(position.bestMove, worst);
+    return std::max(0.0, best - position.moveValues.value(move, worst));
+}
+
+} // namespace
+
+
+DraftState BenchPosition::state(const QSet<QString>& allBrawlers) const {
+    DraftState draft(mapName, modeName, allBrawlers, QSet<QString>(bans.begin(), bans.end()));
+    for (const QString& move : moves) draft = draft.applyMove(move);
+    return draft;
+}
+
+QDataStream &operator<<(QDataStream &out, const BenchPosition &position) {
+    out << position.mapName << position.modeName << position.bans << position.moves << position.exact
+        << position.bestMove << position.moveValues;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, BenchPosition &position) {
+    in >> position.mapName >> position.modeName >> position.bans >> position.moves >> position.exact
+       >> position.bestMove >> position.moveValues;
+    return in;
+}
+
+
+SearchBench::SearchBench(const StatsCalculator& statsCalculator,
+                         const QSet<QString>& allBrawlers,
+                         const QHash<QString, QSet<QString>>& mapModeData,
+                         const AppConfig& config,
+                         const MCTSManager& mctsManager)
+    : m_statsCalculator(statsCalculator),
+      m_allBrawlers(allBrawlers),
+      m_mapModeData(mapModeData),
+      m_config(config),
+      m_mctsManager(mctsManager)
+{}
+
+// --- Corpus ---
+
+QString SearchBench::corpusKey(const BenchSettings& settings, qint64 packVersion) const {
+    return QString("%1|%2|%3|%4|%5|%6")
+        .arg(packVersion).arg(settings.positions).arg(settings.seed)
+        .arg(settings.referenceSeconds, 0, 'g', 6).arg(settings.exactPicks)
+        .arg(TreeSnapshot::weightsKeyFor(m_config.heuristicWeights(), m_config.evalWeights()));
+}
+
+QVector<BenchPosition> SearchBench::corpus(const BenchSettings& settings, const QString& corpusPath,
+                                           qint64 packVersion) const {
+    if (settings.positions <= 0 || settings.referenceSeconds <= 0.0 || settings.exactPicks < 0) {
+        throw std::invalid_argument("Bench needs positive positions and reference seconds.");
+    }
+    const QString key = corpusKey(settings, packVersion);
+
+    if (!corpusPath.isEmpty() && QFile::exists(corpusPath)) {
+        QFile file(corpusPath);
+        if (file.open(QIODevice::ReadOnly)) {
+            QDataStream in(&file);
+            in.setVersion(QDataStream::Qt_6_0);
+            quint32 magic = 0;
+            qint16 version = 0;
+            QString storedKey;
+            QVector<BenchPosition> positions;
+            in >> magic >> version;
+            if (magic == BENCH_CORPUS_MAGIC && version == BENCH_CORPUS_VERSION) in >> storedKey >> positions;
+            if (in.status() == QDataStream::Ok && storedKey == key) {
+                qInfo() << "Loaded bench corpus of" << positions.size() << "positions from" << corpusPath;
+                return positions;
+            }
+        }
+        qInfo() << "Bench corpus" << corpusPath << "is for another pack or settings; rebuilding it.";
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QVector<BenchPosition> positions = samplePositions(settings);
+
+    // Exact positions are cheap and independent: solve them in parallel. Long searches already
+    // use every core, so they run one at a time.
+    QVector<int> exactIndexes;
+    QVector<int> searchIndexes;
+    for (int i = 0; i < positions.size(); ++i) {
+        DraftState state = positions[i].state(m_allBrawlers);
+        int picksLeft = state.format().totalPicks - (state.currentPickNumber() - 1);
+        (picksLeft <= settings.exactPicks ? exactIndexes : searchIndexes).append(i);
+    }
+    TaskExecutor::instance().map(exactIndexes, [this, &positions](int index) { solveExact(positions[index]); },
+                                 TaskPriority::Batch);
+    std::mt19937 seedEngine(settings.seed);
+    for (int index : searchIndexes) solveBySearch(positions[index], settings, seedEngine());
+    qInfo() << "Bench references:" << exactIndexes.size() << "exact," << searchIndexes.size() << "searched in"
+            << timer.elapsed() << "ms.";
+
+    if (!corpusPath.isEmpty()) {
+        QDir dir = QFileInfo(corpusPath).dir();
+        QSaveFile file(corpusPath);
+        if ((dir.exists() || dir.mkpath(".")) && file.open(QIODevice::WriteOnly)) {
+            QDataStream out(&file);
+            out.setVersion(QDataStream::Qt_6_0);
+            out << BENCH_CORPUS_MAGIC << BENCH_CORPUS_VERSION << key << positions;
+            if (out.status() != QDataStream::Ok || !file.commit()) {
+                qWarning() << "Error writing bench corpus:" << corpusPath;
+            }
+        } else {
+            qWarning() << "Error opening bench corpus for writing:" << corpusPath << file.errorString();
+        }
+    }
+    return positions;
+}
+
+// Round-robin over maps (shuffled) and pick numbers, so each map sees early, middle and late
+// positions. Bans are random; the picks so far are random choices among the heuristic's best.
+QVector<BenchPosition> SearchBench::samplePositions(const BenchSettings& settings) const {
+    QVector<QPair<QString, QString>> maps;
+    for (auto modeIt = m_mapModeData.constBegin(); modeIt != m_mapModeData.constEnd(); ++modeIt) {
+        for (const QString& mapName : modeIt.value()) maps.append({mapName, modeIt.key()});
+    }
+    if (maps.isEmpty()) throw std::invalid_argument("Bench has no maps to sample positions on.");
+    std::sort(maps.begin(), maps.end()); // Deterministic corpus for a given seed
+    std::mt19937 rng(settings.seed);
+    std::shuffle(maps.begin(), maps.end(), rng);
+    QVector<QString> roster(m_allBrawlers.begin(), m_allBrawlers.end());
+    std::sort(roster.begin(), roster.end());
+
+    QVector<BenchPosition> positions;
+    positions.reserve(settings.positions);
+    for (int i = 0; i < settings.positions; ++i) {
+        BenchPosition position;
+        position.mapName = maps[i % maps.size()].first;
+        position.modeName = maps[i % maps.size()].second;
+        std::shuffle(roster.begin(), roster.end(), rng);
+        DraftState probe(position.mapName, position.modeName, m_allBrawlers);
+        int banCount = std::uniform_int_distribution<int>(0, probe.format().maxBans)(rng);
+        position.bans = roster.mid(0, std::min<int>(banCount, roster.size()));
+        DraftState state = position.state(m_allBrawlers);
+
+        int picksMade = (i / maps.size() + i) % state.format().totalPicks;
+        for (int m = 0; m < picksMade && !state.isComplete(); ++m) {
+            auto scores = suggestPickHeuristic(state, m_statsCalculator, m_config.heuristicWeights()).second;
+            QVector<QPair<double, QString>> ranked;
+            for (auto it = scores.constBegin(); it != scores.constEnd(); ++it) ranked.append({it.value().totalScore, it.key()});
+            std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+                return a.first != b.first ? a.first > b.first : a.second < b.second;
+            });
+            int top = std::min<int>(8, ranked.size());
+            if (top == 0) break;
+            QString move = ranked[std::uniform_int_distribution<int>(0, top - 1)(rng)].second;
+            position.moves.append(move);
+            state = state.applyMove(move);
+        }
+        if (state.isComplete() || state.getLegalMoves().isEmpty()) continue;
+        positions.append(position);
+    }
+    return positions;
+}
+
+// --- References ---
+
+void SearchBench::solveExact(BenchPosition& position) const {
+    DraftState state = position.state(m_allBrawlers);
+    const bool team1ToMove = state.currentTurn() == "team1";
+    double bestValue = -1.0;
+    for (const QString& move : state.getLegalMoves()) {
+        double team1Value = minimax(state.applyMove(move), -std::numeric_limits<double>::infinity(),
+                                    std::numeric_limits<double>::infinity());
+        double value = team1ToMove ? team1Value : 1.0 - team1Value;
+        position.moveValues.insert(move, value);
+        if (value > bestValue) { // Ties keep the first move in roster order
+            bestValue = value;
+            position.bestMove = move;
+        }
+    }
+    position.exact = true;
+}
+
+double SearchBench::minimax(const DraftState& state, double alpha, double beta) const {
+    if (state.isComplete()) {
+        return predictWinProbabilityModel(state.team1Picks(), state.team2Picks(), state.mapName(), state.modeName(),
+                                          m_statsCalculator, m_config.evalWeights());
+    }
+    bool maximizing = state.currentTurn() == "team1";
+    double best = maximizing ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+    for (const QString& move : state.getLegalMoves()) {
+        double value = minimax(state.applyMove(move), alpha, beta);
+        if (maximizing) {
+            best = std::max(best, value);
+            alpha = std::max(alpha, value);
+        } else {
+            best = std::min(best, value);
+            beta = std::min(beta, value);
+        }
+        if (beta <= alpha) break; // Cutoff; only the root needs every move's exact value
+    }
+    return best;
+}
+
+void SearchBench::solveBySearch(BenchPosition& position, const BenchSettings& settings, quint32 seed) const {
+    DraftState state = position.state(m_allBrawlers);
+    QVector<QVector<MCTSResult>> results = m_mctsManager.runTimed(state, m_config.heuristicWeights(), m_config.evalWeights(),
+                                                                  {settings.referenceSeconds},
+                                                                  QThread::idealThreadCount(), seed);
+    if (results.isEmpty()) return;
+    for (const MCTSResult& result : results.last()) position.moveValues.insert(result.move, result.winRate);
+    position.bestMove = chosenMove(results.last());
+    position.exact = false;
+}
+
+// --- Measurement ---
+
+BenchReport SearchBench::run(const QVector<BenchPosition>& positions, const BenchSettings& settings) const {
+    if (settings.budgets.isEmpty() || settings.threads.isEmpty()) {
+        throw std::invalid_argument("Bench needs at least one budget and one thread count.");
+    }
+    QVector<double> budgets = settings.budgets;
+    std::sort(budgets.begin(), budgets.end());
+    if (budgets.first() <= 0.0) throw std::invalid_argument("Bench budgets must be positive.");
+
+    QElapsedTimer timer;
+    timer.start();
+    BenchReport report;
+    for (const BenchPosition& position : positions) {
+        if (position.bestMove.isEmpty()) continue;
+        (position.exact ? report.exactPositions : report.searchedPositions)++;
+    }
+
+    for (int threads : settings.threads) {
+        QVector<BenchCell> cells(budgets.size());
+        QVector<double> iterationsSum(budgets.size(), 0.0);
+        for (int b = 0; b < budgets.size(); ++b) {
+            cells[b].threads = threads;
+            cells[b].seconds = budgets[b];
+        }
+
+        for (int p = 0; p < positions.size(); ++p) {
+            const BenchPosition& position = positions[p];
+            if (position.bestMove.isEmpty()) continue; // Reference search found nothing
+            QVector<long long> iterations;
+            QVector<QVector<MCTSResult>> results = m_mctsManager.runTimed(
+                position.state(m_allBrawlers), m_config.heuristicWeights(), m_config.evalWeights(), budgets, threads,
+                settings.seed ^ static_cast<quint32>(p * 2654435761u), &iterations);
+            for (int b = 0; b < results.size(); ++b) {
+                QString move = chosenMove(results[b]);
+                double regret = regretOf(position, move);
+                bool agrees = position.exact ? regret <= EXACT_TIE : move == position.bestMove;
+                BenchCell& cell = cells[b];
+                cell.positions++;
+                cell.agreement += agrees ? 1.0 : 0.0;
+                cell.meanRegret += regret;
+                cell.maxRegret = std::max(cell.maxRegret, regret);
+                iterationsSum[b] += iterations.value(b);
+            }
+        }
+
+        for (int b = 0; b < cells.size(); ++b) {
+            BenchCell& cell = cells[b];
+            if (cell.positions > 0) {
+                cell.agreement /= cell.positions;
+                cell.meanRegret /= cell.positions;
+                cell.iterationsPerSecond = iterationsSum[b] / (cell.positions * cell.seconds);
+            }
+            report.cells.append(cell);
+        }
+        qInfo() << "Bench:" << threads << "threads done after" << timer.elapsed() << "ms.";
+    }
+    report.elapsedMs = timer.elapsed();
+    return report;
+}
@@ -0,0 +1,91 @@
+#ifndef SEARCHBENCH_H
+#define SEARCHBENCH_H
+
+#include <QString>
+#include <QVector>
+#include <QSet>
+#include <QHash>
+#include <QDataStream>
+#include "DataStructures.h"
+#include "DraftState.h"
+#include "StatsCalculator.h"
+#include "AppConfig.h"
+#include "MCTS.h"
+
+// One corpus position and its reference answer
+struct BenchPosition {
+    QString mapName;
+    QString modeName;
+    QVector<QString> bans;
+    QVector<QString> moves;  // Picks made so far, in draft order
+    bool exact = false;      // Reference from full enumeration (else a long search)
+    QString bestMove;
+    QHash<QString, double> moveValues; // Side to move's win probability after each move (searched: visited moves only)
+
+    DraftState state(const QSet<QString>& allBrawlers) const;
+};
+
+QDataStream &operator<<(QDataStream &out, const BenchPosition &position);
+QDataStream &operator>>(QDataStream &in, BenchPosition &position);
+
+struct BenchSettings {
+    int positions = 40;          // Spread round-robin over maps and pick numbers
+    quint32 seed = 1;
+    QVector<double> budgets = {0.1, 0.25, 0.5, 1.0}; // Seconds; read off one run per position (anytime)
+    QVector<int> threads = {1, 2, 4};
+    double referenceSeconds = 10.0; // Long search per non-exact position, on every core
+    int exactPicks = 2;          // Positions with at most this many picks left are enumerated exactly
+};
+
+// One (threads, budget) cell of the report
+struct BenchCell {
+    int threads = 1;
+    double seconds = 0.0;
+    int positions = 0;
+    double agreement = 0.0;     // Share choosing the reference move (exact: any move of best value)
+    double meanRegret = 0.0;    // Reference value of the best move minus that of the chosen move
+    double maxRegret = 0.0;
+    double iterationsPerSecond = 0.0;
+};
+
+struct BenchReport {
+    QVector<BenchCell> cells;   // By thread count, then budget
+    int exactPositions = 0;
+    int searchedPositions = 0;
+    qint64 elapsedMs = 0;
+};
+
+// Decision quality of MCTS against time and threads on a fixed corpus of positions. References
+// come from exact minimax over the remaining picks where few are left, otherwise from one long
+// search; both use the configured win model, so regret is in its win probability. The corpus and
+// its references are saved next to the pack and reused while pack, settings and weights match.
+class SearchBench {
+public:
+    SearchBench(const StatsCalculator& statsCalculator,
+                const QSet<QString>& allBrawlers,
+                const QHash<QString, QSet<QString>>& mapModeData,
+                const AppConfig& config,
+                const MCTSManager& mctsManager);
+
+    // Loads 'corpusPath' if it matches, else samples and solves the corpus and saves it there
+    // (empty path: never cached). Throws std::invalid_argument on bad settings or no maps.
+    QVector<BenchPosition> corpus(const BenchSettings& settings, const QString& corpusPath, qint64 packVersion) const;
+
+    // Runs every position at every thread count; positions one after another so runs never share cores
+    BenchReport run(const QVector<BenchPosition>& positions, const BenchSettings& settings) const;
+
+private:
+    QVector<BenchPosition> samplePositions(const BenchSettings& settings) const;
+    void solveExact(BenchPosition& position) const;
+    double minimax(const DraftState& state, double alpha, double beta) const; // Team 1's win probability
+    void solveBySearch(BenchPosition& position, const BenchSettings& settings, quint32 seed) const;
+    QString corpusKey(const BenchSettings& settings, qint64 packVersion) const;
+
+    const StatsCalculator& m_statsCalculator;
+    const QSet<QString>& m_allBrawlers;
+    const QHash<QString, QSet<QString>>& m_mapModeData;
+    const AppConfig& m_config;
+    const MCTSManager& m_mctsManager;
+};
+
+#endif // SEARCHBENCH_H
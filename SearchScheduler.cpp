@@ -0,0 +1,306 @@
+#include "SearchScheduler.h"
+#include "AppConfig.h"
+#include "MemoryLedger.h"
+#include "TaskExecutor.h"
+#include <QtConcurrent/QtConcurrent>
+#include <QDebug>
+#include <algorithm>
+#include <random>
+
+namespace {
+
+const qint64 SLICE_NS = 10 * 1000 * 1000;  // Iterations one task runs on one session before choosing again
+const int CONTROLLER_TICK_MS = 200;         // Status, time limits and snapshots
+const qint64 INTERMEDIATE_RESULT_MS = 1000;
+const double MIN_SHARE = 0.01;              // Background sessions never stop entirely
+
+} // namespace
+
+
+SearchScheduler::SearchScheduler(MCTSManager& manager, const AppConfig& config, QObject* parent)
+    : QObject(parent),
+      m_manager(manager),
+      m_config(config)
+{
+    m_controllerTimer.setInterval(CONTROLLER_TICK_MS);
+    connect(&m_controllerTimer, &QTimer::timeout, this, &SearchScheduler::onControllerTick);
+
+    // Worker-process searches run in the manager; its signals belong to m_processSession
+    connect(&m_manager, &MCTSManager::mctsStatusUpdate, this, [this](const QString& status) {
+        if (m_processSession) emit sessionStatus(m_processSession, status);
+    });
+    connect(&m_manager, &MCTSManager::mctsIntermediateResult, this, [this](const QVector<MCTSResult>& results) {
+        if (m_processSession) emit sessionIntermediateResult(m_processSession, results);
+    });
+    connect(&m_manager, &MCTSManager::mctsFinalResult, this, [this](const QVector<MCTSResult>& results) {
+        if (m_processSession) emit sessionFinalResult(m_processSession, results);
+    });
+    connect(&m_manager, &MCTSManager::mctsError, this, [this](const QString& errorMsg) {
+        if (m_processSession) emit sessionError(m_processSession, errorMsg);
+    });
+    connect(&m_manager, &MCTSManager::mctsFinished, this, [this]() {
+        if (!m_processSession) return;
+        int finished = m_processSession;
+        m_processSession = 0;
+        emit sessionFinished(finished);
+        startNextProcessSession();
+    });
+}
+
+SearchScheduler::~SearchScheduler() {
+    QVector<std::shared_ptr<Session>> running;
+    {
+        QMutexLocker lock(&m_mutex);
+        m_shutdown = true;
+        running = m_sessions.values();
+        for (const auto& session : running) session->stopRequested = true;
+    }
+    m_slices.wait();
+    m_snapshotSaves.waitForFinished();
+    // Searches cut short by closing the app continue from here next time
+    for (const auto& session : running) m_manager.saveSessionSnapshot(*session->search);
+    if (m_processSession) m_manager.stopMcts();
+}
+
+int SearchScheduler::startSession(const DraftState& rootState, const HeuristicWeights& weights, double seconds) {
+    if (rootState.isComplete() || rootState.getLegalMoves().isEmpty()) return 0;
+    int id = m_nextId++;
+
+    // --- Worker processes: one search at a time ---
+    if (m_manager.workerProcesses() > 0) {
+        m_processQueue.append({id, rootState, weights});
+        if (m_processSession == 0) {
+            startNextProcessSession();
+        } else {
+            emit sessionStatus(id, QString("Waiting for the worker processes (%1 ahead)").arg(m_processQueue.size()));
+        }
+        return id;
+    }
+
+    auto session = std::make_shared<Session>();
+    session->id = id;
+    session->search = m_manager.createSession(rootState, weights);
+    if (!session->search) return 0;
+    session->timeLimitMs = seconds * 1000.0;
+    session->nextIntermediateMs = m_config.mctsUpdateIntervalIters() > 0 ? INTERMEDIATE_RESULT_MS : -1;
+    session->nextSnapshotMs = static_cast<qint64>(m_config.mctsSnapshotInterval()) * 1000;
+    session->clock.start();
+
+    int running = 0;
+    {
+        QMutexLocker lock(&m_mutex);
+        m_sessions.insert(id, session);
+        rebalanceLocked();
+        startSlicesLocked();
+        running = m_sessions.size();
+    }
+    if (!m_controllerTimer.isActive()) m_controllerTimer.start();
+
+    qInfo() << "MCTS session" << id << "started (" << running << "running) for state:" << rootState.toString();
+    emit sessionStatus(id, "MCTS Started...");
+    return id;
+}
+
+void SearchScheduler::stopSession(int session) {
+    {
+        QMutexLocker lock(&m_mutex);
+        if (std::shared_ptr<Session> running = m_sessions.value(session)) {
+            running->stopRequested = true; // Finished by the next tick
+            return;
+        }
+    }
+    if (session != 0 && session == m_processSession) {
+        m_manager.stopMcts();
+        return;
+    }
+    for (int i = 0; i < m_processQueue.size(); ++i) {
+        if (m_processQueue[i].id != session) continue;
+        m_processQueue.removeAt(i);
+        emit sessionStatus(session, "MCTS Stopped Early");
+        emit sessionFinalResult(session, {});
+        emit sessionFinished(session);
+        return;
+    }
+}
+
+bool SearchScheduler::isRunning(int session) const {
+    if (session == 0) return false;
+    if (session == m_processSession) return true;
+    for (const QueuedSearch& queued : m_processQueue) {
+        if (queued.id == session) return true;
+    }
+    QMutexLocker lock(&m_mutex);
+    return m_sessions.contains(session);
+}
+
+bool SearchScheduler::hasRunningSessions() const {
+    if (m_processSession || !m_processQueue.isEmpty()) return true;
+    QMutexLocker lock(&m_mutex);
+    return !m_sessions.isEmpty();
+}
+
+void SearchScheduler::setFocusedSession(int session) {
+    QMutexLocker lock(&m_mutex);
+    if (session == m_focusedSession) return;
+    m_focusedSession = session;
+    rebalanceLocked();
+}
+
+
+// --- Thread sessions ---
+
+// One slice chain per executor worker while any session can run; each chain ends when nothing does
+void SearchScheduler::startSlicesLocked() {
+    const int workers = TaskExecutor::instance().workerCount();
+    for (; m_sliceChains < workers; ++m_sliceChains) {
+        m_slices.submit([this]() { runSlice(); }, TaskPriority::Interactive);
+    }
+}
+
+void SearchScheduler::runSlice() {
+    thread_local std::mt19937 randomEngine(std::random_device{}());
+    QMutexLocker lock(&m_mutex);
+    std::shared_ptr<Session> session = m_shutdown ? nullptr : takeSliceLocked();
+    if (!session) {
+        --m_sliceChains;
+        return;
+    }
+    lock.unlock();
+
+    QElapsedTimer slice;
+    slice.start();
+    long long done = 0;
+    try {
+        while (slice.nsecsElapsed() < SLICE_NS && !session->stopRequested.load(std::memory_order_relaxed)) {
+            m_manager.runSessionIteration(*session->search, randomEngine);
+            ++done;
+        }
+    } catch (const std::exception& e) {
+        qCritical() << "Exception in MCTS session" << session->id << ":" << e.what();
+        session->failed = true;
+        session->stopRequested = true;
+    }
+    session->iterations.fetch_add(done, std::memory_order_relaxed);
+    const qint64 used = slice.nsecsElapsed();
+
+    lock.relock();
+    session->pass += (used - SLICE_NS) / shareLocked(*session); // takeSliceLocked charged a full slice
+    // Back through the queue rather than looping here, so other interactive work gets a turn
+    m_slices.submit([this]() { runSlice(); }, TaskPriority::Interactive);
+}
+
+std::shared_ptr<SearchScheduler::Session> SearchScheduler::takeSliceLocked() {
+    std::shared_ptr<Session> next;
+    for (const auto& session : std::as_const(m_sessions)) {
+        if (session->stopRequested.load(std::memory_order_relaxed)) continue;
+        if (!next || session->pass < next->pass) next = session;
+    }
+    // Charged up front so the other workers spread over the sessions instead of all taking this one
+    if (next) next->pass += SLICE_NS / shareLocked(*next);
+    return next;
+}
+
+double SearchScheduler::shareLocked(const Session& session) const {
+    int runnable = 0;
+    bool focusedRunnable = false;
+    for (const auto& other : m_sessions) {
+        if (other->stopRequested.load(std::memory_order_relaxed)) continue;
+        ++runnable;
+        if (other->id == m_focusedSession) focusedRunnable = true;
+    }
+    if (runnable <= 1) return 1.0;
+    if (!focusedRunnable) return 1.0 / runnable;
+    const double focusShare = m_config.searchFocusShare();
+    double share = session.id == m_focusedSession ? focusShare : (1.0 - focusShare) / (runnable - 1);
+    return std::max(MIN_SHARE, share);
+}
+
+void SearchScheduler::rebalanceLocked() {
+    // Shares only apply from here on: history under the old shares must not starve anyone
+    for (const auto& session : std::as_const(m_sessions)) session->pass = 0.0;
+}
+
+void SearchScheduler::onControllerTick() {
+    QVector<std::shared_ptr<Session>> sessions;
+    {
+        QMutexLocker lock(&m_mutex);
+        sessions = m_sessions.values();
+    }
+    for (const auto& session : sessions) {
+        qint64 elapsed = session->clock.elapsed();
+        if (session->stopRequested.load() || elapsed >= session->timeLimitMs) {
+            finishSession(session);
+            continue;
+        }
+
+        double share = 1.0;
+        {
+            QMutexLocker lock(&m_mutex);
+            share = shareLocked(*session);
+        }
+        emit sessionStatus(session->id, QString("Running MCTS: %1 iter (%2s / %3s, %4% of threads)")
+                                           .arg(session->iterations.load(std::memory_order_relaxed))
+                                           .arg(elapsed / 1000.0, 0, 'f', 1)
+                                           .arg(session->timeLimitMs / 1000.0, 0, 'f', 1)
+                                           .arg(share * 100.0, 0, 'f', 0));
+
+        if (session->nextIntermediateMs >= 0 && elapsed >= session->nextIntermediateMs) {
+            emit sessionIntermediateResult(session->id, m_manager.sessionResults(*session->search));
+            session->nextIntermediateMs = elapsed + INTERMEDIATE_RESULT_MS;
+        }
+        // Periodic snapshot, so a long search survives the app closing
+        if (session->nextSnapshotMs > 0 && elapsed >= session->nextSnapshotMs) {
+            std::shared_ptr<MCTSSession> search = session->search;
+            m_snapshotSaves.addFuture(QtConcurrent::run([this, search]() { m_manager.saveSessionSnapshot(*search); }));
+            session->nextSnapshotMs = elapsed + static_cast<qint64>(m_config.mctsSnapshotInterval()) * 1000;
+        }
+    }
+
+    QMutexLocker lock(&m_mutex);
+    if (m_sessions.isEmpty()) m_controllerTimer.stop();
+}
+
+void SearchScheduler::finishSession(const std::shared_ptr<Session>& session) {
+    session->stopRequested = true;
+    {
+        QMutexLocker lock(&m_mutex);
+        m_sessions.remove(session->id);
+        rebalanceLocked();
+    }
+
+    const int id = session->id;
+    if (session->failed.load()) {
+        emit sessionError(id, "MCTS worker error (see the log); results are from the iterations before it.");
+    } else if (session->clock.elapsed() >= session->timeLimitMs) {
+        emit sessionStatus(id, "MCTS Time Limit Reached");
+    } else {
+        emit sessionStatus(id, "MCTS Stopped Early");
+    }
+    const MCTSSearchSpace& space = *session->search->root->space;
+    qInfo() << "MCTS session" << id << "finished after" << session->iterations.load() << "iterations. Tree:"
+            << space.treeBytes.load() / 1024 << "KB" << (space.atByteCap() ? "(at MemoryCapSearchTreesMB)" : "")
+            << "| Memory:" << MemoryLedger::summary();
+
+    emit sessionFinalResult(id, m_manager.sessionResults(*session->search));
+    std::shared_ptr<MCTSSession> search = session->search;
+    m_snapshotSaves.addFuture(QtConcurrent::run([this, search]() { m_manager.saveSessionSnapshot(*search); }));
+    emit sessionFinished(id);
+}
+
+
+// --- Worker-process sessions ---
+
+void SearchScheduler::startNextProcessSession() {
+    if (m_processSession || m_processQueue.isEmpty()) return;
+    if (m_manager.isRunning()) {
+        // The last search's controller is still winding down after mctsFinished
+        QTimer::singleShot(50, this, &SearchScheduler::startNextProcessSession);
+        return;
+    }
+    QueuedSearch next = m_processQueue.takeFirst();
+    m_processSession = next.id;
+    m_manager.startMcts(next.rootState, next.weights);
+    for (int i = 0; i < m_processQueue.size(); ++i) {
+        emit sessionStatus(m_processQueue[i].id, QString("Waiting for the worker processes (%1 ahead)").arg(i + 1));
+    }
+}
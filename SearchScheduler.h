@@ -0,0 +1,105 @@
+#ifndef SEARCHSCHEDULER_H
+#define SEARCHSCHEDULER_H
+
+#include <QObject>
+#include <QVector>
+#include <QHash>
+#include <QString>
+#include <QMutex>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QFutureSynchronizer>
+#include <atomic>
+#include <memory>
+
+#include "DataStructures.h"
+#include "DraftState.h"
+#include "MCTS.h"
+#include "TaskExecutor.h"
+
+class AppConfig;
+
+// Runs any number of timed MCTS searches (sessions, one per draft tab) as interactive tasks on
+// the task executor. Each task runs a short slice of iterations on one session and queues the
+// next slice. Sessions take slices in stride order: each session's consumed thread time is
+// divided by its share, and the session furthest behind runs next. The focused session's share is SearchFocusShare while others search; the rest split
+// what is left evenly. Changing focus only changes the shares, never a session's tree, so a
+// search keeps going while its tab is in the background.
+//
+// With MctsWorkerProcesses > 0 searches need the manager's shared-memory tree, which holds one
+// search at a time: sessions then run one after another in the order they were started.
+class SearchScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    SearchScheduler(MCTSManager& manager, const AppConfig& config, QObject* parent = nullptr);
+    ~SearchScheduler() override; // Stops every session and waits for the running slices
+
+    // Starts a search of 'rootState' for 'seconds' of wall-clock time (worker processes: the
+    // MctsTimeLimit in effect when it leaves the queue). Returns its session id (> 0), or 0 if
+    // the position has no legal move.
+    int startSession(const DraftState& rootState, const HeuristicWeights& weights, double seconds);
+    // The session finishes at the next controller tick (results and snapshot as at its time limit)
+    void stopSession(int session);
+    bool isRunning(int session) const;
+    bool hasRunningSessions() const;
+    // Session with priority (0 = none: every running session gets an equal share)
+    void setFocusedSession(int session);
+
+signals:
+    // All emitted on the scheduler's thread, tagged with the session they belong to
+    void sessionStatus(int session, const QString& status);
+    void sessionIntermediateResult(int session, const QVector<MCTSResult>& results);
+    void sessionFinalResult(int session, const QVector<MCTSResult>& results);
+    void sessionError(int session, const QString& errorMsg);
+    void sessionFinished(int session);
+
+private:
+    struct Session {
+        int id = 0;
+        std::shared_ptr<MCTSSession> search;
+        double timeLimitMs = 0.0;
+        QElapsedTimer clock;
+        qint64 nextIntermediateMs = 0;
+        qint64 nextSnapshotMs = 0;
+        std::atomic<bool> stopRequested{false};
+        std::atomic<bool> failed{false}; // A slice threw; reported when the session finishes
+        std::atomic<long long> iterations{0};
+        double pass = 0.0; // Thread time consumed divided by share (guarded by m_mutex)
+    };
+
+    // --- Thread sessions ---
+    void startSlicesLocked();
+    void runSlice(); // One slice of the session furthest behind, then the next slice is queued
+    std::shared_ptr<Session> takeSliceLocked(); // Session furthest behind in stride order, charged one slice
+    double shareLocked(const Session& session) const;
+    void rebalanceLocked(); // Passes restart level after a session joins or the focus moves
+    void onControllerTick();
+    void finishSession(const std::shared_ptr<Session>& session);
+
+    // --- Worker-process sessions ---
+    struct QueuedSearch {
+        int id;
+        DraftState rootState;
+        HeuristicWeights weights;
+    };
+    void startNextProcessSession();
+
+    MCTSManager& m_manager;
+    const AppConfig& m_config;
+    int m_nextId = 1;
+
+    mutable QMutex m_mutex;
+    QHash<int, std::shared_ptr<Session>> m_sessions; // Running thread sessions
+    int m_focusedSession = 0;
+    bool m_shutdown = false;
+    int m_sliceChains = 0; // Queued or running slice tasks (guarded by m_mutex)
+    TaskGroup m_slices;
+    QTimer m_controllerTimer;
+    QFutureSynchronizer<void> m_snapshotSaves; // Final snapshots, written off the GUI thread
+
+    QVector<QueuedSearch> m_processQueue;
+    int m_processSession = 0; // Session running in the worker processes (0 = none)
+};
+
+#endif // SEARCHSCHEDULER_H
@@ -0,0 +1,358 @@
+#include "ShardPartials.h"
+#include "AppConfig.h"
+#include "DataLoader.h"
+#include "StatsCalculator.h"
+#include "TaskExecutor.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDebug>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+
+namespace {
+
+const quint32 PARTIAL_MAGIC = 0xACED5A27;
+const qint16 PARTIAL_VERSION = 1;
+const quint32 MANIFEST_MAGIC = 0xACED3A1F;
+const qint16 MANIFEST_VERSION = 1;
+const QString MANIFEST_FILE_NAME = "manifest.dat";
+const QString PARTIAL_SUFFIX = ".partial";
+// Bump when DataLoader's filters or StatsCalculator's counting change: every partial is then stale
+const int AGGREGATION_VERSION = 1;
+// Cells left with fewer weighted plays by a subtraction are rounding residue (a real play weighs at least 0.1)
+const double RESIDUE_PLAYS = 1e-6;
+
+struct ShardEntry {
+    QString name;           // File name; the manifest matches shards across builds by it
+    qint64 size = 0;
+    qint64 modifiedMs = 0;
+    QByteArray contentHash; // Hex SHA-1 of the file, reused while size and modification time match
+};
+
+QDataStream& operator<<(QDataStream& out, const ShardEntry& entry) {
+    out << entry.name << entry.size << entry.modifiedMs << entry.contentHash;
+    return out;
+}
+
+QDataStream& operator>>(QDataStream& in, ShardEntry& entry) {
+    in >> entry.name >> entry.size >> entry.modifiedMs >> entry.contentHash;
+    return in;
+}
+
+// One shard's counts, or the sum of several
+struct Partial {
+    StatsContainer stats;
+    qint64 games = 0;
+};
+
+struct Manifest {
+    QString settingsKey;
+    qint32 incrementalBuilds = 0; // Since the last full merge
+    QVector<ShardEntry> shards;
+    Partial totals;               // Sum of the shards' partials
+};
+
+// Everything besides a shard's content that changes its counts
+QString settingsKey(const AppConfig& config) {
+    QString settings = QString("%1|%2|%3|%4").arg(AGGREGATION_VERSION).arg(config.minRank())
+                           .arg(config.maxRankConsidered()).arg(config.rankWeightScaleDivisor(), 0, 'g', 17);
+    return QString::fromLatin1(QCryptographicHash::hash(settings.toUtf8(), QCryptographicHash::Sha1).toHex().left(16));
+}
+
+QByteArray contentHash(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        throw std::runtime_error(QString("Cannot read shard %1: %2").arg(path, file.errorString()).toStdString());
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!hash.addData(&file)) throw std::runtime_error(QString("Cannot read shard %1").arg(path).toStdString());
+    return hash.result().toHex();
+}
+
+// --- Persistence ---
+
+bool savePartial(const QString& path, const Partial& partial) {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCritical() << "Error opening shard partial for writing:" << path << file.errorString();
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << PARTIAL_MAGIC << PARTIAL_VERSION << partial.games << partial.stats;
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        qCritical() << "Error writing shard partial:" << path;
+        return false;
+    }
+    return true;
+}
+
+Partial loadPartial(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        throw std::runtime_error(QString("Cannot read shard partial %1: %2").arg(path, file.errorString()).toStdString());
+    }
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magicNumber = 0;
+    qint16 version = 0;
+    Partial partial;
+    in >> magicNumber >> version;
+    if (in.status() == QDataStream::Ok && magicNumber == PARTIAL_MAGIC && version == PARTIAL_VERSION) {
+        in >> partial.games >> partial.stats;
+    }
+    if (in.status() != QDataStream::Ok || magicNumber != PARTIAL_MAGIC || version != PARTIAL_VERSION) {
+        // Deleted so the next build parses the shard again
+        file.remove();
+        throw std::runtime_error(QString("Shard partial %1 is corrupted; it was removed, build again.").arg(path).toStdString());
+    }
+    return partial;
+}
+
+bool saveManifest(const QString& path, const Manifest& manifest) {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCritical() << "Error opening shard manifest for writing:" << path << file.errorString();
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << MANIFEST_MAGIC << MANIFEST_VERSION << manifest.settingsKey << manifest.incrementalBuilds
+        << manifest.shards << manifest.totals.games << manifest.totals.stats;
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        qCritical() << "Error writing shard manifest:" << path;
+        return false;
+    }
+    return true;
+}
+
+// std::nullopt if missing or unreadable: the build then sums every partial
+std::optional<Manifest> loadManifest(const QString& path) {
+    QFile file(path);
+    if (!file.exists() || !file.open(QIODevice::ReadOnly)) return std::nullopt;
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magicNumber = 0;
+    qint16 version = 0;
+    in >> magicNumber >> version;
+    if (in.status() != QDataStream::Ok || magicNumber != MANIFEST_MAGIC || version != MANIFEST_VERSION) {
+        qWarning() << "Ignoring shard manifest with invalid header:" << path;
+        return std::nullopt;
+    }
+    Manifest manifest;
+    in >> manifest.settingsKey >> manifest.incrementalBuilds >> manifest.shards >> manifest.totals.games
+       >> manifest.totals.stats;
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "Ignoring corrupted shard manifest:" << path;
+        return std::nullopt;
+    }
+    return manifest;
+}
+
+// --- Aggregation ---
+
+Partial aggregateShard(const QString& path, const AppConfig& config) {
+    DataLoader loader(path, config);
+    Partial partial;
+    if (!loader.loadAndProcess() || loader.getProcessedGames().isEmpty()) {
+        qWarning() << "Shard has no usable games:" << path;
+        return partial;
+    }
+    partial.games = loader.getProcessedGames().size();
+    partial.stats = StatsCalculator(loader.getProcessedGames(), config).getStatsForCache().stats;
+    return partial;
+}
+
+void addCells(QHash<QString, BrawlerStatsData>& target, const QHash<QString, BrawlerStatsData>& source, double sign) {
+    for (auto it = source.constBegin(); it != source.constEnd(); ++it) {
+        BrawlerStatsData& cell = target[it.key()];
+        cell.wins += sign * it.value().wins;
+        cell.plays += sign * it.value().plays;
+    }
+}
+
+// total += sign * part, one executor task per map/mode section
+void addPartial(Partial& total, const Partial& part, double sign) {
+    total.games += sign > 0.0 ? part.games : -part.games;
+    // Sections are created first: pointers into the tables stay valid once nothing is inserted
+    for (auto mapIt = part.stats.constBegin(); mapIt != part.stats.constEnd(); ++mapIt) {
+        for (auto modeIt = mapIt.value().constBegin(); modeIt != mapIt.value().constEnd(); ++modeIt) {
+            total.stats[mapIt.key()][modeIt.key()];
+        }
+    }
+    QVector<MapModeStatsData*> targets;
+    QVector<const MapModeStatsData*> sources;
+    for (auto mapIt = part.stats.constBegin(); mapIt != part.stats.constEnd(); ++mapIt) {
+        for (auto modeIt = mapIt.value().constBegin(); modeIt != mapIt.value().constEnd(); ++modeIt) {
+            targets.append(&total.stats[mapIt.key()][modeIt.key()]);
+            sources.append(&modeIt.value());
+        }
+    }
+    TaskExecutor::instance().parallelFor(targets.size(), [&](qsizetype i) {
+        MapModeStatsData& target = *targets[i];
+        const MapModeStatsData& source = *sources[i];
+        target.totalWeightedPlays += sign * source.totalWeightedPlays;
+        addCells(target.brawlerStats, source.brawlerStats, sign);
+        addCells(target.synergyStats, source.synergyStats, sign);
+        addCells(target.counterStats, source.counterStats, sign);
+    }, TaskPriority::Background);
+}
+
+// After subtractions: cells, sections and maps whose games were all taken away
+void removeResidue(Partial& total) {
+    auto prune = [](QHash<QString, BrawlerStatsData>& cells) {
+        for (auto it = cells.begin(); it != cells.end(); ) {
+            if (it.value().plays < RESIDUE_PLAYS) it = cells.erase(it);
+            else ++it;
+        }
+    };
+    for (auto mapIt = total.stats.begin(); mapIt != total.stats.end(); ) {
+        for (auto modeIt = mapIt.value().begin(); modeIt != mapIt.value().end(); ) {
+            MapModeStatsData& section = modeIt.value();
+            prune(section.brawlerStats);
+            prune(section.synergyStats);
+            prune(section.counterStats);
+            if (section.brawlerStats.isEmpty()) modeIt = mapIt.value().erase(modeIt);
+            else ++modeIt;
+        }
+        if (mapIt.value().isEmpty()) mapIt = total.stats.erase(mapIt);
+        else ++mapIt;
+    }
+}
+
+} // namespace
+
+
+CacheData ShardPartials::buildPack(const QStringList& shards, const QString& cacheDir, const AppConfig& config,
+                                   ShardBuildReport* reportOut) {
+    if (shards.isEmpty()) throw std::invalid_argument("No shards to build from.");
+    QElapsedTimer timer;
+    timer.start();
+    ShardBuildReport report;
+    report.shards = shards.size();
+    QDir dir(cacheDir);
+    if (!dir.exists() && !dir.mkpath(".")) {
+        throw std::runtime_error(QString("Cannot create the shard cache directory %1").arg(cacheDir).toStdString());
+    }
+    const QString settings = settingsKey(config);
+    const QString manifestPath = dir.filePath(MANIFEST_FILE_NAME);
+    std::optional<Manifest> previous = loadManifest(manifestPath);
+    QHash<QString, ShardEntry> previousByName;
+    if (previous) {
+        for (const ShardEntry& entry : std::as_const(previous->shards)) previousByName.insert(entry.name, entry);
+    }
+
+    // --- Content hashes, in parallel ---
+    QVector<ShardEntry> current;
+    QSet<QString> names;
+    for (const QString& path : shards) {
+        QFileInfo info(path);
+        if (names.contains(info.fileName())) {
+            throw std::invalid_argument(QString("Two shards are named %1; shard names must be unique.")
+                                            .arg(info.fileName()).toStdString());
+        }
+        names.insert(info.fileName());
+        current.append({info.fileName(), info.size(), info.lastModified().toMSecsSinceEpoch(), {}});
+    }
+    QVector<int> indices(shards.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    QList<QByteArray> hashes = TaskExecutor::instance().mapped(indices, [&](int i) {
+        auto it = previousByName.constFind(current[i].name);
+        if (it != previousByName.constEnd() && it->size == current[i].size && it->modifiedMs == current[i].modifiedMs) {
+            return it->contentHash;
+        }
+        return contentHash(shards[i]);
+    }, TaskPriority::Background);
+
+    // --- Partials: only shards whose content has none under these settings are parsed ---
+    auto partialPath = [&](const QByteArray& hash) {
+        return dir.filePath(QString::fromLatin1(hash) + "-" + settings + PARTIAL_SUFFIX);
+    };
+    QHash<QString, QByteArray> currentByName;
+    for (int i = 0; i < current.size(); ++i) {
+        current[i].contentHash = hashes[i];
+        currentByName.insert(current[i].name, hashes[i]);
+        const QString path = partialPath(hashes[i]);
+        if (QFile::exists(path)) {
+            report.reused++;
+            continue;
+        }
+        qInfo() << "Aggregating shard" << shards[i];
+        if (!savePartial(path, aggregateShard(shards[i], config))) {
+            throw std::runtime_error(QString("Cannot write shard partial %1").arg(path).toStdString());
+        }
+        report.parsed++;
+    }
+
+    // --- Totals: the last build's, minus changed or removed shards, plus changed or new ones ---
+    QStringList toSubtract;
+    QStringList toAdd;
+    bool incremental = previous && previous->settingsKey == settings && previous->incrementalBuilds < FULL_REMERGE_EVERY;
+    if (incremental) {
+        for (const ShardEntry& old : std::as_const(previous->shards)) {
+            if (currentByName.value(old.name) == old.contentHash) continue;
+            toSubtract.append(partialPath(old.contentHash));
+            if (!QFile::exists(toSubtract.last())) incremental = false;
+        }
+        for (const ShardEntry& entry : std::as_const(current)) {
+            if (previousByName.value(entry.name).contentHash != entry.contentHash) toAdd.append(partialPath(entry.contentHash));
+        }
+    }
+
+    Manifest manifest;
+    manifest.settingsKey = settings;
+    manifest.shards = current;
+    if (incremental) {
+        manifest.totals = std::move(previous->totals);
+        for (const QString& path : std::as_const(toSubtract)) addPartial(manifest.totals, loadPartial(path), -1.0);
+        for (const QString& path : std::as_const(toAdd)) addPartial(manifest.totals, loadPartial(path), 1.0);
+        if (!toSubtract.isEmpty()) removeResidue(manifest.totals);
+        const bool changed = !toSubtract.isEmpty() || !toAdd.isEmpty();
+        manifest.incrementalBuilds = previous->incrementalBuilds + (changed ? 1 : 0);
+        report.subtracted = toSubtract.size();
+        report.added = toAdd.size();
+    } else {
+        for (const ShardEntry& entry : std::as_const(current)) {
+            addPartial(manifest.totals, loadPartial(partialPath(entry.contentHash)), 1.0);
+        }
+        report.added = current.size();
+    }
+    report.incremental = incremental;
+    report.games = manifest.totals.games;
+    if (!saveManifest(manifestPath, manifest)) {
+        throw std::runtime_error(QString("Cannot write shard manifest %1").arg(manifestPath).toStdString());
+    }
+
+    // Partials no current shard refers to (older contents, other settings)
+    QSet<QString> referenced;
+    for (const ShardEntry& entry : std::as_const(current)) referenced.insert(QFileInfo(partialPath(entry.contentHash)).fileName());
+    for (const QString& file : dir.entryList({"*" + PARTIAL_SUFFIX}, QDir::Files)) {
+        if (!referenced.contains(file)) dir.remove(file);
+    }
+
+    // --- Pack: rosters and map/modes are whatever has plays left ---
+    CacheData data;
+    data.stats = std::move(manifest.totals.stats);
+    for (auto mapIt = data.stats.constBegin(); mapIt != data.stats.constEnd(); ++mapIt) {
+        for (auto modeIt = mapIt.value().constBegin(); modeIt != mapIt.value().constEnd(); ++modeIt) {
+            data.discoveredMapModes[modeIt.key()].insert(mapIt.key());
+            for (auto it = modeIt.value().brawlerStats.constBegin(); it != modeIt.value().brawlerStats.constEnd(); ++it) {
+                data.allBrawlers.insert(it.key());
+            }
+        }
+    }
+    if (data.allBrawlers.isEmpty()) throw std::runtime_error("The shards hold no usable games.");
+    data.metadata.cacheCreationTime = QDateTime::currentMSecsSinceEpoch();
+
+    qInfo() << "Shard build:" << report.shards << "shards," << report.parsed << "parsed," << report.reused << "reused,"
+            << (incremental ? "incremental" : "full merge") << "in" << timer.elapsed() << "ms.";
+    if (reportOut) *reportOut = report;
+    return data;
+}
@@ -0,0 +1,45 @@
+#ifndef SHARDPARTIALS_H
+#define SHARDPARTIALS_H
+
+#include <QString>
+#include <QStringList>
+#include "DataStructures.h"
+
+class AppConfig;
+
+struct ShardBuildReport {
+    int shards = 0;
+    int parsed = 0;       // Shards whose partial was missing, so they were read and aggregated
+    int reused = 0;       // Shards whose partial was found by content hash
+    int added = 0;        // Partials added to the last build's totals (incremental builds)
+    int subtracted = 0;   // Partials of changed or removed shards taken off the totals
+    bool incremental = false; // false: every partial was summed afresh
+    qint64 games = 0;
+};
+
+// --- Shard Partials ---
+// Incremental pack builds over a directory of JSONL shards (one per day, say). Each shard's counts
+// are cached as a partial aggregate under the content hash of the shard and of the settings that
+// shape the counts (rank weights and the loader's filters), so a shard is only ever parsed once
+// per content. A manifest keeps the last build's shard list and summed totals: the next build
+// subtracts the partials of shards that changed or disappeared and adds those of new or changed
+// shards, so a daily rebuild reads one shard. Changed settings, a missing partial or every
+// FULL_REMERGE_EVERY incremental builds (to shed rounding drift) sum all partials instead,
+// still without parsing unchanged shards. Partials no build refers to any more are deleted.
+//
+// Counts are additive, so the result matches one load of all shards, except that a battle present
+// in two shards counts twice (the full loader does not dedupe either). Shard packs carry no
+// standard errors: the bootstrap needs the raw games.
+namespace ShardPartials {
+
+    constexpr int FULL_REMERGE_EVERY = 64;
+
+    // 'shards' are the shard files (names must be unique; they key the manifest), 'cacheDir' holds
+    // the partials and the manifest. Throws std::runtime_error if a shard cannot be read or the
+    // cache cannot be written, std::invalid_argument for an empty or ambiguous shard list.
+    CacheData buildPack(const QStringList& shards, const QString& cacheDir, const AppConfig& config,
+                        ShardBuildReport* report = nullptr);
+
+} // namespace ShardPartials
+
+#endif // SHARDPARTIALS_H
@@ -0,0 +1,674 @@
+#include "SharedTree.h"
+#include "MCTS.h"
+#include "StatsCalculator.h"
+#include <QProcess>
+#include <QDataStream>
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QVarLengthArray>
+#include <QQueue>
+#include <QDebug>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <new>
+#include <random>
+#include <stdexcept>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr quint32 SEGMENT_MAGIC = 0xACED7433;
+constexpr quint32 SEGMENT_VERSION = 3;
+constexpr int SPEC_BYTES = 64 * 1024;
+constexpr double WIN_SCALE = 1e6;  // Wins are accumulated as fixed-point integers
+constexpr int MAX_RESTARTS = 5;    // Per worker slot, so a crash loop does not spin forever
+constexpr int PARENT_CHECK_INTERVAL = 256;
+
+enum ExpandState : quint32 { Unexpanded = 0, Expanding = 1, Expanded = 2, Leaf = 3 };
+
+static_assert(std::atomic<quint64>::is_always_lock_free, "Shared tree needs lock-free 64-bit atomics");
+static_assert(std::atomic<qint64>::is_always_lock_free, "Shared tree needs lock-free 64-bit atomics");
+static_assert(std::atomic<quint32>::is_always_lock_free, "Shared tree needs lock-free 32-bit atomics");
+
+struct WorkerSlot {
+    std::atomic<qint64> pid;
+    std::atomic<quint64> iterations;
+    std::atomic<qint64> heartbeatMs;
+    std::atomic<qint32> expandingNode; // Node this worker holds in Expanding (-1 none); reset if it dies
+};
+
+struct SegmentHeader {
+    quint32 magic;
+    quint32 version;
+    qint64 managerPid;
+    quint32 nodeCapacity;
+    quint32 specSize;
+    std::atomic<quint32> nodeCount;
+    std::atomic<quint32> stop;
+    std::atomic<quint32> treeFull;
+    std::atomic<quint64> iterations;
+    WorkerSlot workers[SharedTreeSearch::MAX_WORKERS];
+    char spec[SPEC_BYTES];
+};
+
+// Children of a node are allocated as one contiguous block when it is expanded.
+// A node's results are from the perspective of the side that made its move.
+// Widest field first so the node packs into 32 bytes with no padding holes
+struct SharedNode {
+    std::atomic<quint64> winsScaled;   // Added on the way back up
+    std::atomic<quint32> visits;       // Incremented on the way down (virtual loss for concurrent workers)
+    std::atomic<quint32> expandState;
+    qint32 firstChild;                 // Valid once expandState is Expanded
+    quint32 childCount;
+    qint32 parent;
+    quint16 move;                      // Index into SharedSearchSpec::brawlers
+    quint8 team1Moved;
+};
+static_assert(sizeof(SharedNode) == 32, "SharedNode layout changed; update the node size in the README");
+
+constexpr size_t nodesOffset() {
+    return (sizeof(SegmentHeader) + 63) & ~size_t(63);
+}
+
+SegmentHeader* headerOf(void* segment) {
+    return static_cast<SegmentHeader*>(segment);
+}
+
+SharedNode* nodesOf(void* segment) {
+    return reinterpret_cast<SharedNode*>(static_cast<char*>(segment) + nodesOffset());
+}
+
+QDataStream& operator<<(QDataStream& out, const SharedSearchSpec& spec) {
+    out << spec.mapName << spec.modeName << spec.brawlers << spec.bans << spec.team1Picks << spec.team2Picks
+        << spec.turn << qint32(spec.pickNumber)
+        << spec.weights.winRate << spec.weights.synergy << spec.weights.counter << spec.weights.pickRate
+        << spec.evalWeights.winRate << spec.evalWeights.synergy << spec.evalWeights.counter
+        << spec.evalWeights.peakCounter << spec.evalWeights.slope
+        << spec.explorationParam << spec.packVersion << spec.activeRoster << spec.team1Pool << spec.team2Pool;
+    return out;
+}
+
+QDataStream& operator>>(QDataStream& in, SharedSearchSpec& spec) {
+    qint32 pickNumber = 1;
+    in >> spec.mapName >> spec.modeName >> spec.brawlers >> spec.bans >> spec.team1Picks >> spec.team2Picks
+       >> spec.turn >> pickNumber
+       >> spec.weights.winRate >> spec.weights.synergy >> spec.weights.counter >> spec.weights.pickRate
+       >> spec.evalWeights.winRate >> spec.evalWeights.synergy >> spec.evalWeights.counter
+       >> spec.evalWeights.peakCounter >> spec.evalWeights.slope
+       >> spec.explorationParam >> spec.packVersion >> spec.activeRoster >> spec.team1Pool >> spec.team2Pool;
+    spec.pickNumber = pickNumber;
+    return in;
+}
+
+// Snapshot node waiting to be copied into the arena
+struct PendingImport {
+    int snapshotIndex;
+    qint32 sharedIndex;
+    DraftState state;
+};
+
+// --- Worker-side search ---
+
+qint32 selectChild(SharedNode* nodes, const SharedNode& node, double explorationParam, std::mt19937& randomEngine) {
+    quint32 count = node.childCount;
+    if (count == 0) return -1;
+    double logParentVisits = std::log(std::max<double>(1.0, node.visits.load(std::memory_order_relaxed)));
+
+    // Random scan start breaks ties between unvisited children
+    std::uniform_int_distribution<quint32> dist(0, count - 1);
+    quint32 start = dist(randomEngine);
+    qint32 best = -1;
+    double bestScore = -std::numeric_limits<double>::infinity();
+    for (quint32 k = 0; k < count; ++k) {
+        qint32 index = node.firstChild + static_cast<qint32>((start + k) % count);
+        quint32 visits = nodes[index].visits.load(std::memory_order_relaxed);
+        double score = std::numeric_limits<double>::infinity();
+        if (visits > 0) {
+            double winRate = nodes[index].winsScaled.load(std::memory_order_relaxed) / WIN_SCALE / visits;
+            score = winRate + explorationParam * std::sqrt(logParentVisits / visits);
+        }
+        if (score > bestScore) {
+            bestScore = score;
+            best = index;
+        }
+    }
+    return best;
+}
+
+// Called with the node claimed (Expanding). Returns false if it has to stay a leaf.
+// The root (index 0) branches over every legal move, deeper nodes over the active roster
+bool expandNode(SegmentHeader* header, SharedNode* nodes, qint32 index, const DraftState& state,
+                const QHash<QString, quint16>& moveIds, const QSet<QString>* activeRoster) {
+    SharedNode& node = nodes[index];
+    QVector<QString> moves = state.getLegalMoves(index == 0 ? nullptr : activeRoster);
+    quint32 count = static_cast<quint32>(moves.size());
+    quint32 first = count > 0 ? header->nodeCount.fetch_add(count, std::memory_order_relaxed) : 0;
+    if (count == 0 || quint64(first) + count > header->nodeCapacity) {
+        if (count > 0) header->treeFull.store(1, std::memory_order_relaxed);
+        node.expandState.store(Leaf, std::memory_order_release);
+        return false;
+    }
+
+    quint8 team1Moves = state.currentTurn() == "team1" ? 1 : 0;
+    for (quint32 i = 0; i < count; ++i) {
+        SharedNode& child = nodes[first + i];
+        child.parent = index;
+        child.move = moveIds.value(moves[i]);
+        child.team1Moved = team1Moves;
+    }
+    node.firstChild = static_cast<qint32>(first);
+    node.childCount = count;
+    node.expandState.store(Expanded, std::memory_order_release); // Publishes the children
+    return true;
+}
+
+void runSharedIteration(SegmentHeader* header, SharedNode* nodes, WorkerSlot& slot,
+                        const SharedSearchSpec& spec, const DraftState& rootState,
+                        const QHash<QString, quint16>& moveIds, const QSet<QString>* activeRoster,
+                        const MCTSManager& mctsManager, std::mt19937& randomEngine) {
+    // 1. Selection (+ expansion of at most one node)
+    QVarLengthArray<qint32, 8> path;
+    DraftState state = rootState;
+    qint32 index = 0;
+    nodes[0].visits.fetch_add(1, std::memory_order_relaxed);
+    path.append(0);
+    while (!state.isComplete()) {
+        SharedNode& node = nodes[index];
+        quint32 expandState = node.expandState.load(std::memory_order_acquire);
+        bool expandedHere = false;
+        if (expandState == Unexpanded) {
+            quint32 expected = Unexpanded;
+            if (!node.expandState.compare_exchange_strong(expected, Expanding, std::memory_order_acq_rel)) break;
+            slot.expandingNode.store(index, std::memory_order_relaxed);
+            expandedHere = expandNode(header, nodes, index, state, moveIds, activeRoster);
+            slot.expandingNode.store(-1, std::memory_order_relaxed);
+            if (!expandedHere) break;
+            expandState = Expanded;
+        }
+        if (expandState != Expanded) break; // Being expanded by another worker, or a leaf: roll out from here
+
+        qint32 child = selectChild(nodes, node, spec.explorationParam, randomEngine);
+        if (child < 0) break;
+        state = state.applyMove(spec.brawlers[nodes[child].move]);
+        nodes[child].visits.fetch_add(1, std::memory_order_relaxed);
+        path.append(child);
+        index = child;
+        if (expandedHere) break;
+    }
+
+    // 2. Simulation
+    double result = mctsManager.simulateRollout(state, spec.weights, spec.evalWeights, randomEngine, activeRoster);
+
+    // 3. Backpropagation (visits were already counted on the way down)
+    for (qint32 nodeIndex : path) {
+        double value = nodes[nodeIndex].team1Moved ? result : 1.0 - result;
+        nodes[nodeIndex].winsScaled.fetch_add(static_cast<quint64>(std::llround(value * WIN_SCALE)),
+                                              std::memory_order_relaxed);
+    }
+}
+
+} // namespace
+
+
+// --- SharedSearchSpec ---
+
+SharedSearchSpec SharedSearchSpec::fromState(const DraftState& rootState) {
+    SharedSearchSpec spec;
+    spec.mapName = rootState.mapName();
+    spec.modeName = rootState.modeName();
+    spec.brawlers = QStringList(rootState.masterBrawlerList().begin(), rootState.masterBrawlerList().end());
+    spec.brawlers.sort();
+    spec.bans = QStringList(rootState.bans().begin(), rootState.bans().end());
+    spec.bans.sort();
+    spec.team1Picks = QStringList::fromVector(rootState.team1Picks());
+    spec.team2Picks = QStringList::fromVector(rootState.team2Picks());
+    spec.turn = rootState.currentTurn();
+    spec.pickNumber = rootState.currentPickNumber();
+    if (const TeamPools* pools = rootState.teamPools()) {
+        spec.team1Pool = QStringList(pools->team1.begin(), pools->team1.end());
+        spec.team1Pool.sort();
+        spec.team2Pool = QStringList(pools->team2.begin(), pools->team2.end());
+        spec.team2Pool.sort();
+    }
+    return spec;
+}
+
+DraftState SharedSearchSpec::rootState() const {
+    DraftState state(mapName, modeName, QSet<QString>(brawlers.begin(), brawlers.end()),
+                     QSet<QString>(bans.begin(), bans.end()),
+                     team1Picks.toVector(), team2Picks.toVector(), turn, pickNumber);
+    if (team1Pool.isEmpty() && team2Pool.isEmpty()) return state;
+    auto pools = std::make_shared<TeamPools>();
+    pools->team1 = QSet<QString>(team1Pool.begin(), team1Pool.end());
+    pools->team2 = QSet<QString>(team2Pool.begin(), team2Pool.end());
+    return state.withTeamPools(pools);
+}
+
+
+// --- SharedTreeSearch (owning process) ---
+
+SharedTreeSearch::SharedTreeSearch(const QString& executablePath, const QString& packPath)
+    : m_executablePath(executablePath),
+      m_packPath(packPath)
+{
+}
+
+SharedTreeSearch::~SharedTreeSearch() {
+    stop();
+    releaseSegment();
+}
+
+bool SharedTreeSearch::isSupported() {
+#ifdef Q_OS_UNIX
+    return true;
+#else
+    return false;
+#endif
+}
+
+quint32 SharedTreeSearch::capacityForBytes(qint64 bytes) {
+    if (bytes <= qint64(nodesOffset())) return 0;
+    qint64 nodes = (bytes - qint64(nodesOffset())) / qint64(sizeof(SharedNode));
+    return static_cast<quint32>(std::min<qint64>(nodes, std::numeric_limits<quint32>::max()));
+}
+
+void SharedTreeSearch::start(const SharedSearchSpec& spec, int processes, quint32 nodeCapacity,
+                             const TreeSnapshot* resumeFrom) {
+    if (m_segment) throw std::logic_error("Shared tree search already started.");
+    if (processes <= 0 || processes > MAX_WORKERS) {
+        throw std::invalid_argument(QString("Worker processes must be 1..%1.").arg(MAX_WORKERS).toStdString());
+    }
+    if (nodeCapacity < 1024) throw std::invalid_argument("Shared tree needs room for at least 1024 nodes.");
+    if (spec.brawlers.size() > std::numeric_limits<quint16>::max()) {
+        throw std::invalid_argument("Too many brawlers for the shared tree move encoding.");
+    }
+
+    QByteArray specBytes;
+    QDataStream stream(&specBytes, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << spec;
+    if (specBytes.size() > SPEC_BYTES) throw std::invalid_argument("Search spec does not fit the shared segment.");
+
+#ifdef Q_OS_UNIX
+    static std::atomic<int> segmentCounter{0};
+    m_segmentName = QString("/glizzydraft-%1-%2").arg(::getpid()).arg(segmentCounter.fetch_add(1));
+    m_segmentBytes = nodesOffset() + size_t(nodeCapacity) * sizeof(SharedNode);
+
+    QByteArray name = m_segmentName.toLocal8Bit();
+    int fd = ::shm_open(name.constData(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) throw std::runtime_error("shm_open failed for " + m_segmentName.toStdString());
+    if (::ftruncate(fd, static_cast<off_t>(m_segmentBytes)) != 0) {
+        ::close(fd);
+        ::shm_unlink(name.constData());
+        throw std::runtime_error("Could not size shared segment " + m_segmentName.toStdString());
+    }
+    void* mapped = ::mmap(nullptr, m_segmentBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        ::shm_unlink(name.constData());
+        throw std::runtime_error("Could not map shared segment " + m_segmentName.toStdString());
+    }
+    m_segment = mapped;
+    m_segmentCharge.set(static_cast<qint64>(m_segmentBytes));
+
+    // ftruncate zero-fills, which is the initial state of every node and counter
+    SegmentHeader* header = new (m_segment) SegmentHeader();
+    header->magic = SEGMENT_MAGIC;
+    header->version = SEGMENT_VERSION;
+    header->managerPid = ::getpid();
+    header->nodeCapacity = nodeCapacity;
+    header->specSize = static_cast<quint32>(specBytes.size());
+    std::copy(specBytes.constBegin(), specBytes.constEnd(), header->spec);
+    for (WorkerSlot& slot : header->workers) slot.expandingNode.store(-1);
+
+    SharedNode& root = nodesOf(m_segment)[0];
+    root.parent = -1;
+    root.team1Moved = spec.turn == "team1" ? 1 : 0; // Same root perspective as the in-process search
+    header->nodeCount.store(1);
+    m_spec = spec;
+    if (resumeFrom) importSnapshot(*resumeFrom);
+#else
+    Q_UNUSED(nodeCapacity);
+    throw std::runtime_error("Shared-memory MCTS needs a POSIX system.");
+#endif
+
+    m_stopping = false;
+    m_workers = QVector<QProcess*>(processes, nullptr);
+    m_restarts = QVector<int>(processes, 0);
+    for (int slot = 0; slot < processes; ++slot) spawnWorker(slot);
+
+    bool anyRunning = std::any_of(m_workers.begin(), m_workers.end(), [](QProcess* p) {
+        return p && p->state() != QProcess::NotRunning;
+    });
+    if (!anyRunning) {
+        stop();
+        releaseSegment();
+        throw std::runtime_error("No MCTS worker process could be started.");
+    }
+    qInfo() << "Shared-tree MCTS started:" << processes << "worker processes," << nodeCapacity
+            << "node capacity, segment" << m_segmentName;
+}
+
+void SharedTreeSearch::spawnWorker(int slot) {
+    auto* process = new QProcess();
+    process->setProgram(m_executablePath);
+    process->setArguments({"mcts-worker", "--segment", m_segmentName, "--slot", QString::number(slot),
+                           "--pack", m_packPath});
+    process->setProcessChannelMode(QProcess::ForwardedChannels);
+    process->start();
+    if (!process->waitForStarted(5000)) {
+        qWarning() << "MCTS worker" << slot << "failed to start:" << process->errorString();
+    }
+    m_workers[slot] = process;
+}
+
+void SharedTreeSearch::superviseWorkers() {
+    if (!m_segment || m_stopping) return;
+    SegmentHeader* header = headerOf(m_segment);
+    SharedNode* nodes = nodesOf(m_segment);
+
+    for (int slot = 0; slot < m_workers.size(); ++slot) {
+        QProcess* process = m_workers[slot];
+        if (!process) continue;
+        process->waitForFinished(0); // No event loop on the controller thread: poll
+        if (process->state() != QProcess::NotRunning) continue;
+
+        qWarning() << "MCTS worker" << slot << "exited unexpectedly, code" << process->exitCode()
+                   << (process->exitStatus() == QProcess::CrashExit ? "(crashed)" : "");
+
+        // A node the worker was expanding would otherwise stay claimed forever.
+        // Its in-flight virtual-loss visits are left in place; that bias is a handful of visits.
+        qint32 claimed = header->workers[slot].expandingNode.exchange(-1);
+        if (claimed >= 0) {
+            quint32 expected = Expanding;
+            nodes[claimed].expandState.compare_exchange_strong(expected, Unexpanded);
+        }
+
+        delete process;
+        m_workers[slot] = nullptr;
+        if (m_restarts[slot] >= MAX_RESTARTS) {
+            qWarning() << "MCTS worker" << slot << "exceeded" << MAX_RESTARTS << "restarts; slot disabled.";
+            continue;
+        }
+        m_restarts[slot]++;
+        spawnWorker(slot);
+    }
+}
+
+void SharedTreeSearch::stop() {
+    if (!m_segment) return;
+    m_stopping = true;
+    headerOf(m_segment)->stop.store(1);
+    for (QProcess*& process : m_workers) {
+        if (!process) continue;
+        if (!process->waitForFinished(2000)) {
+            qWarning() << "MCTS worker did not stop in time; killing it.";
+            process->kill();
+            process->waitForFinished(1000);
+        }
+    }
+}
+
+void SharedTreeSearch::releaseSegment() {
+    for (QProcess* process : m_workers) delete process;
+    m_workers.clear();
+#ifdef Q_OS_UNIX
+    if (m_segment) {
+        ::munmap(m_segment, m_segmentBytes);
+        ::shm_unlink(m_segmentName.toLocal8Bit().constData());
+    }
+#endif
+    m_segment = nullptr;
+    m_segmentCharge.set(0);
+}
+
+QVector<MCTSResult> SharedTreeSearch::results() const {
+    QVector<MCTSResult> results;
+    if (!m_segment) return results;
+    SharedNode* nodes = nodesOf(m_segment);
+    const SharedNode& root = nodes[0];
+    if (root.expandState.load(std::memory_order_acquire) != Expanded) return results;
+
+    for (quint32 i = 0; i < root.childCount; ++i) {
+        const SharedNode& child = nodes[root.firstChild + i];
+        quint32 visits = child.visits.load(std::memory_order_relaxed);
+        if (visits == 0) continue;
+        double winRate = child.winsScaled.load(std::memory_order_relaxed) / WIN_SCALE / visits;
+        results.append(MCTSResult(m_spec.brawlers.value(child.move), static_cast<int>(visits), winRate));
+    }
+    std::sort(results.begin(), results.end(), [](const MCTSResult& a, const MCTSResult& b) {
+        if (a.winRate != b.winRate) return a.winRate > b.winRate;
+        return a.visits > b.visits;
+    });
+    return results;
+}
+
+SharedTreeTelemetry SharedTreeSearch::telemetry() const {
+    SharedTreeTelemetry telemetry;
+    if (!m_segment) return telemetry;
+    const SegmentHeader* header = headerOf(m_segment);
+    telemetry.iterations = header->iterations.load(std::memory_order_relaxed);
+    telemetry.nodeCapacity = header->nodeCapacity;
+    telemetry.nodesUsed = std::min(header->nodeCount.load(std::memory_order_relaxed), header->nodeCapacity);
+    telemetry.treeFull = header->treeFull.load(std::memory_order_relaxed) != 0;
+
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (int slot = 0; slot < m_workers.size(); ++slot) {
+        const WorkerSlot& shared = header->workers[slot];
+        SharedWorkerTelemetry worker;
+        worker.slot = slot;
+        worker.pid = shared.pid.load(std::memory_order_relaxed);
+        worker.iterations = shared.iterations.load(std::memory_order_relaxed);
+        worker.restarts = m_restarts.value(slot);
+        worker.alive = m_workers[slot] && m_workers[slot]->state() != QProcess::NotRunning;
+        qint64 heartbeat = shared.heartbeatMs.load(std::memory_order_relaxed);
+        worker.msSinceHeartbeat = heartbeat > 0 ? now - heartbeat : -1;
+        telemetry.workers.append(worker);
+    }
+    return telemetry;
+}
+
+
+// --- Snapshots ---
+
+TreeSnapshot SharedTreeSearch::exportSnapshot(const QString& weightsKey) const {
+    TreeSnapshot snapshot;
+    if (!m_segment) return snapshot;
+    SharedNode* nodes = nodesOf(m_segment);
+    DraftState rootState = m_spec.rootState();
+    snapshot.positionKey = TreeSnapshot::keyFor(rootState);
+    snapshot.packVersion = m_spec.packVersion;
+    snapshot.weightsKey = weightsKey;
+    snapshot.roster = m_spec.brawlers;
+
+    TreeSnapshotNode rootRecord;
+    rootRecord.visits = nodes[0].visits.load(std::memory_order_relaxed);
+    rootRecord.wins = nodes[0].winsScaled.load(std::memory_order_relaxed) / WIN_SCALE;
+    snapshot.nodes.append(rootRecord);
+
+    // Breadth-first over expanded nodes; the snapshot keeps visited children only
+    QVector<qint32> sharedIndexOf{0};
+    for (int index = 0; index < sharedIndexOf.size(); ++index) {
+        const SharedNode& node = nodes[sharedIndexOf[index]];
+        snapshot.nodes[index].firstChild = static_cast<quint32>(snapshot.nodes.size());
+        if (node.expandState.load(std::memory_order_acquire) != Expanded) continue;
+        for (quint32 i = 0; i < node.childCount; ++i) {
+            qint32 childIndex = node.firstChild + static_cast<qint32>(i);
+            const SharedNode& child = nodes[childIndex];
+            quint32 visits = child.visits.load(std::memory_order_relaxed);
+            if (visits == 0) continue;
+            TreeSnapshotNode record;
+            record.move = child.move;
+            record.visits = visits;
+            record.wins = child.winsScaled.load(std::memory_order_relaxed) / WIN_SCALE;
+            snapshot.nodes.append(record);
+            snapshot.nodes[index].childCount++;
+            sharedIndexOf.append(childIndex);
+        }
+    }
+    return snapshot;
+}
+
+// Called from start() before any worker exists. Expanded snapshot nodes get a full block of
+// children (as workers would allocate it), with the saved statistics on the visited ones.
+void SharedTreeSearch::importSnapshot(const TreeSnapshot& snapshot) {
+    if (snapshot.nodes.isEmpty() || snapshot.roster != m_spec.brawlers) return;
+    SegmentHeader* header = headerOf(m_segment);
+    SharedNode* nodes = nodesOf(m_segment);
+
+    QHash<QString, quint16> moveIds;
+    for (int i = 0; i < m_spec.brawlers.size(); ++i) moveIds.insert(m_spec.brawlers[i], static_cast<quint16>(i));
+    QSet<QString> activeRoster(m_spec.activeRoster.begin(), m_spec.activeRoster.end());
+
+    nodes[0].visits.store(snapshot.nodes[0].visits);
+    nodes[0].winsScaled.store(static_cast<quint64>(std::llround(snapshot.nodes[0].wins * WIN_SCALE)));
+
+    QQueue<PendingImport> queue;
+    queue.enqueue({0, 0, m_spec.rootState()});
+    quint32 imported = 1;
+    while (!queue.isEmpty()) {
+        PendingImport pending = queue.dequeue();
+        const TreeSnapshotNode& record = snapshot.nodes[pending.snapshotIndex];
+        if (record.childCount == 0 || pending.state.isComplete()) continue;
+
+        // Same move lists as expandNode, so imported blocks match what workers would allocate
+        QVector<QString> moves = pending.state.getLegalMoves(
+            pending.sharedIndex == 0 || activeRoster.isEmpty() ? nullptr : &activeRoster);
+        quint32 first = header->nodeCount.load();
+        if (quint64(first) + moves.size() > header->nodeCapacity) {
+            header->treeFull.store(1);
+            continue; // Stays unexpanded; workers will find the arena full too
+        }
+        header->nodeCount.store(first + static_cast<quint32>(moves.size()));
+
+        QHash<quint16, qint32> childByMove;
+        quint8 team1Moves = pending.state.currentTurn() == "team1" ? 1 : 0;
+        for (int i = 0; i < moves.size(); ++i) {
+            SharedNode& child = nodes[first + i];
+            child.parent = pending.sharedIndex;
+            child.move = moveIds.value(moves[i]);
+            child.team1Moved = team1Moves;
+            childByMove.insert(child.move, static_cast<qint32>(first + i));
+        }
+        SharedNode& node = nodes[pending.sharedIndex];
+        node.firstChild = static_cast<qint32>(first);
+        node.childCount = static_cast<quint32>(moves.size());
+        node.expandState.store(Expanded);
+
+        for (quint32 c = record.firstChild; c < record.firstChild + record.childCount; ++c) {
+            const TreeSnapshotNode& childRecord = snapshot.nodes[c];
+            auto it = childByMove.constFind(childRecord.move);
+            if (it == childByMove.constEnd()) continue;
+            SharedNode& child = nodes[it.value()];
+            child.visits.store(childRecord.visits);
+            child.winsScaled.store(static_cast<quint64>(std::llround(childRecord.wins * WIN_SCALE)));
+            queue.enqueue({static_cast<int>(c), it.value(), pending.state.applyMove(m_spec.brawlers[childRecord.move])});
+            imported++;
+        }
+    }
+    qInfo() << "Shared tree resumed from snapshot:" << imported << "nodes," << snapshot.rootVisits() << "visits.";
+}
+
+
+// --- Worker process ---
+
+int SharedTreeSearch::runWorker(const QString& segmentName, int slot,
+                                const MCTSManager& mctsManager, const StatsCalculator& statsCalculator) {
+#ifdef Q_OS_UNIX
+    if (slot < 0 || slot >= MAX_WORKERS) {
+        qCritical() << "MCTS worker: invalid slot" << slot;
+        return 1;
+    }
+    QByteArray name = segmentName.toLocal8Bit();
+    int fd = ::shm_open(name.constData(), O_RDWR, 0);
+    if (fd < 0) {
+        qCritical() << "MCTS worker: cannot open segment" << segmentName;
+        return 1;
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < nodesOffset()) {
+        ::close(fd);
+        qCritical() << "MCTS worker: segment too small" << segmentName;
+        return 1;
+    }
+    size_t bytes = static_cast<size_t>(info.st_size);
+    void* segment = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (segment == MAP_FAILED) {
+        qCritical() << "MCTS worker: cannot map segment" << segmentName;
+        return 1;
+    }
+
+    SegmentHeader* header = headerOf(segment);
+    SharedNode* nodes = nodesOf(segment);
+    int exitCode = 0;
+    if (header->magic != SEGMENT_MAGIC || header->version != SEGMENT_VERSION ||
+        bytes < nodesOffset() + size_t(header->nodeCapacity) * sizeof(SharedNode)) {
+        qCritical() << "MCTS worker: segment layout mismatch" << segmentName;
+        exitCode = 1;
+    }
+
+    SharedSearchSpec spec;
+    if (exitCode == 0) {
+        QByteArray specBytes(header->spec, static_cast<int>(header->specSize));
+        QDataStream stream(specBytes);
+        stream.setVersion(QDataStream::Qt_6_0);
+        stream >> spec;
+        if (stream.status() != QDataStream::Ok) {
+            qCritical() << "MCTS worker: corrupt search spec";
+            exitCode = 1;
+        } else if (spec.packVersion != statsCalculator.packVersion()) {
+            qCritical() << "MCTS worker: stats pack version" << statsCalculator.packVersion()
+                        << "does not match the search" << spec.packVersion;
+            exitCode = 1;
+        }
+    }
+
+    if (exitCode == 0) {
+        WorkerSlot& workerSlot = header->workers[slot];
+        workerSlot.pid.store(::getpid());
+        workerSlot.expandingNode.store(-1);
+
+        QHash<QString, quint16> moveIds;
+        for (int i = 0; i < spec.brawlers.size(); ++i) moveIds.insert(spec.brawlers[i], static_cast<quint16>(i));
+        DraftState rootState = spec.rootState();
+        QSet<QString> activeRoster(spec.activeRoster.begin(), spec.activeRoster.end());
+        const QSet<QString>* activeRosterPtr = activeRoster.isEmpty() ? nullptr : &activeRoster;
+        std::mt19937 randomEngine(std::random_device{}() ^ (static_cast<quint32>(slot) * 0x9E3779B9u));
+
+        quint64 done = 0;
+        while (!header->stop.load(std::memory_order_relaxed)) {
+            runSharedIteration(header, nodes, workerSlot, spec, rootState, moveIds, activeRosterPtr, mctsManager,
+                               randomEngine);
+            header->iterations.fetch_add(1, std::memory_order_relaxed);
+            workerSlot.iterations.fetch_add(1, std::memory_order_relaxed);
+            workerSlot.heartbeatMs.store(QDateTime::currentMSecsSinceEpoch(), std::memory_order_relaxed);
+            // Do not outlive the owning process
+            if (++done % PARENT_CHECK_INTERVAL == 0 && ::getppid() != header->managerPid) {
+                qWarning() << "MCTS worker" << slot << "lost its owner; exiting.";
+                exitCode = 2;
+                break;
+            }
+        }
+    }
+
+    ::munmap(segment, bytes);
+    return exitCode;
+#else
+    Q_UNUSED(segmentName);
+    Q_UNUSED(slot);
+    Q_UNUSED(mctsManager);
+    Q_UNUSED(statsCalculator);
+    qCritical() << "Shared-memory MCTS needs a POSIX system.";
+    return 1;
+#endif
+}
@@ -0,0 +1,110 @@
+#ifndef SHAREDTREE_H
+#define SHAREDTREE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "DataStructures.h"
+#include "DraftState.h"
+#include "MemoryLedger.h"
+#include "TreeSnapshot.h"
+
+class QProcess;
+class MCTSManager;
+class StatsCalculator;
+
+// Everything a worker process needs to rebuild the search root. Moves in the shared tree are
+// indices into 'brawlers' (sorted), since QSet/QHash iteration order differs between processes.
+struct SharedSearchSpec {
+    QString mapName;
+    QString modeName;
+    QStringList brawlers;
+    QStringList bans;
+    QStringList team1Picks;
+    QStringList team2Picks;
+    QString turn;
+    int pickNumber = 1;
+    QStringList team1Pool; // TeamPools (sorted); empty = unrestricted
+    QStringList team2Pool;
+    HeuristicWeights weights;
+    EvalWeights evalWeights;
+    double explorationParam = 1.414;
+    qint64 packVersion = 0; // Workers refuse to search with a different stats pack
+    QStringList activeRoster; // Moves below the root are limited to these (sorted); empty = no pruning
+
+    static SharedSearchSpec fromState(const DraftState& rootState);
+    DraftState rootState() const;
+};
+
+struct SharedWorkerTelemetry {
+    int slot = 0;
+    qint64 pid = 0;
+    quint64 iterations = 0;
+    int restarts = 0;
+    bool alive = false;
+    qint64 msSinceHeartbeat = -1;
+};
+
+struct SharedTreeTelemetry {
+    quint64 iterations = 0;
+    quint32 nodesUsed = 0;
+    quint32 nodeCapacity = 0;
+    bool treeFull = false; // Capacity reached; further leaves are only rolled out, not expanded
+    QVector<SharedWorkerTelemetry> workers;
+};
+
+// Multi-process MCTS: the owning process maps a POSIX shared-memory segment holding a fixed-size
+// node arena, and spawns worker processes (the hidden 'mcts-worker' command) that run iterations
+// against that one tree. All node statistics are lock-free atomics inside the segment; expansion
+// is claimed per node with a compare-and-swap. Crashed workers are respawned by superviseWorkers().
+// POSIX only; isSupported() is false elsewhere.
+class SharedTreeSearch {
+public:
+    static constexpr int MAX_WORKERS = 64;
+
+    SharedTreeSearch(const QString& executablePath, const QString& packPath);
+    ~SharedTreeSearch(); // Stops workers and unlinks the segment
+
+    static bool isSupported();
+    // Nodes a segment of 'bytes' holds (MemoryCapSearchTreesMB applies to the segment too)
+    static quint32 capacityForBytes(qint64 bytes);
+
+    // Throws std::invalid_argument on bad arguments, std::runtime_error if the segment
+    // cannot be created or no worker starts. 'resumeFrom' (same position) pre-loads the arena.
+    void start(const SharedSearchSpec& spec, int processes, quint32 nodeCapacity,
+               const TreeSnapshot* resumeFrom = nullptr);
+
+    // Respawns workers that exited while the search is running. Call periodically.
+    void superviseWorkers();
+
+    // Signals workers to finish their current iteration, waits briefly, then kills stragglers
+    void stop();
+
+    QVector<MCTSResult> results() const;
+    SharedTreeTelemetry telemetry() const;
+    // Safe while workers run; statistics are read atomically node by node
+    TreeSnapshot exportSnapshot(const QString& weightsKey) const;
+
+    // Worker side: attaches to the segment and runs iterations until told to stop.
+    // Returns the process exit code.
+    static int runWorker(const QString& segmentName, int slot,
+                         const MCTSManager& mctsManager, const StatsCalculator& statsCalculator);
+
+private:
+    void spawnWorker(int slot);
+    void releaseSegment();
+    void importSnapshot(const TreeSnapshot& snapshot);
+
+    QString m_executablePath;
+    QString m_packPath;
+    QString m_segmentName;
+    void* m_segment = nullptr;
+    size_t m_segmentBytes = 0;
+    SharedSearchSpec m_spec;
+    QVector<QProcess*> m_workers;
+    QVector<int> m_restarts;
+    bool m_stopping = false;
+    MemoryCharge m_segmentCharge{MemorySubsystem::SearchTrees};
+};
+
+#endif // SHAREDTREE_H
@@ -1,10 +1,17 @@
 #include "StatsCalculator.h"
 #include "DataStructures.h"
+#include "DraftFormat.h"
+#include "CompactStats.h"
+#include "MemoryLedger.h"
+#include "TaskExecutor.h"
 #include <QDebug>
 #include <cmath>     // For std::max, std::min
 #include <numeric>   // For std::accumulate if needed
 #include <algorithm> // For std::sort
 #include <atomic> // Make sure this is included
+#include <QDateTime>
+#include <stdexcept>
+#include <type_traits>
 
 // Helper function for atomic double addition
 void atomic_add_double(std::atomic<double>& atomic_var, double value) {
@@ -42,66 +49,109 @@ void StatsCalculator::calculateStats(const QVector<ProcessedGame>& processedGame
     // QElapsedTimer timer; timer.start(); // For timing
 
     m_stats.clear(); // Clear previous stats
+    m_compact.reset();
+    m_sampleFraction = 1.0;
+    m_sampledGames = 0;
+    m_errors.clear();
+    m_packVersion = QDateTime::currentMSecsSinceEpoch(); // New pack; stamped into the cache metadata
+    accumulateGames(processedGames);
+    buildFallbackTables();
+    buildActiveRosters();
+    updateMemoryCharges();
 
-    // Iterate through games and accumulate weighted stats
-    for (const auto& game : processedGames) {
-        // Get or create the entry for this map and mode
-        // QHash automatically default-constructs MapModeStats if needed
-        MapModeStats& currentMapModeStats = m_stats[game.map][game.mode];
-
-        // Update Brawler Wins/Plays and Total Plays
-        double gameTotalWeightContribution = 0; // Track weight added by this game to total plays
-
-        // Winners
-        for (const auto& playerData : game.winningTeamData) {
-            double weight = m_config.getRankWeight(playerData.rank);
-            BrawlerStats& bStats = currentMapModeStats.brawlerStats[playerData.brawlerName]; // Creates if new
-            atomic_add_double(bStats.wins, weight);
-            atomic_add_double(bStats.plays, weight);
-            gameTotalWeightContribution += weight;
+    // qInfo() << "Statistics calculation took" << timer.elapsed() << "ms";
+}
+
+void StatsCalculator::addGames(const QVector<ProcessedGame>& processedGames) {
+    if (m_compact) throw std::logic_error("Cannot add games to compact stats.");
+    accumulateGames(processedGames);
+    // Strictly newer, so results cached against the old totals are dropped
+    m_packVersion = std::max(m_packVersion + 1, QDateTime::currentMSecsSinceEpoch());
+    buildFallbackTables();
+    buildActiveRosters();
+    updateMemoryCharges();
+}
+
+void StatsCalculator::addStats(const CacheData& cacheData) {
+    if (m_compact) throw std::logic_error("Cannot add stats to compact stats.");
+    for (auto mapIt = cacheData.stats.constBegin(); mapIt != cacheData.stats.constEnd(); ++mapIt) {
+        for (auto modeIt = mapIt.value().constBegin(); modeIt != mapIt.value().constEnd(); ++modeIt) {
+            const MapModeStatsData& sourceData = modeIt.value();
+            MapModeStats& targetStats = m_stats[mapIt.key()][modeIt.key()];
+            atomic_add_double(targetStats.totalWeightedPlays, sourceData.totalWeightedPlays);
+            for (auto bsIt = sourceData.brawlerStats.constBegin(); bsIt != sourceData.brawlerStats.constEnd(); ++bsIt) {
+                atomic_add_double(targetStats.brawlerStats[bsIt.key()].wins, bsIt.value().wins);
+                atomic_add_double(targetStats.brawlerStats[bsIt.key()].plays, bsIt.value().plays);
+            }
+            for (auto ssIt = sourceData.synergyStats.constBegin(); ssIt != sourceData.synergyStats.constEnd(); ++ssIt) {
+                atomic_add_double(targetStats.synergyStats[ssIt.key()].wins, ssIt.value().wins);
+                atomic_add_double(targetStats.synergyStats[ssIt.key()].plays, ssIt.value().plays);
+            }
+            for (auto csIt = sourceData.counterStats.constBegin(); csIt != sourceData.counterStats.constEnd(); ++csIt) {
+                atomic_add_double(targetStats.counterStats[csIt.key()].wins, csIt.value().wins);
+                atomic_add_double(targetStats.counterStats[csIt.key()].plays, csIt.value().plays);
+            }
         }
-        // Losers
-        for (const auto& playerData : game.losingTeamData) {
-            double weight = m_config.getRankWeight(playerData.rank);
-            BrawlerStats& bStats = currentMapModeStats.brawlerStats[playerData.brawlerName]; // Creates if new
-            // No wins update for losers
-            atomic_add_double(bStats.plays, weight);
-            gameTotalWeightContribution += weight;
+    }
+    m_packVersion = std::max(m_packVersion + 1, QDateTime::currentMSecsSinceEpoch());
+    buildFallbackTables();
+    buildActiveRosters();
+    updateMemoryCharges();
+}
+
+// Iterate through games and accumulate weighted stats. Each map/mode is one shard on the task
+// executor: a table is only touched by its own task, and its games add up in input order as
+// they would serially, so the totals do not depend on the thread count.
+void StatsCalculator::accumulateGames(const QVector<ProcessedGame>& processedGames) {
+    int skippedGames = 0;
+    QHash<QPair<QString, QString>, int> shardIndex; // (map, mode) -> shard
+    QVector<QPair<QString, QString>> shardKeys;
+    QVector<QVector<int>> shardGames;
+    for (int i = 0; i < processedGames.size(); ++i) {
+        const ProcessedGame& game = processedGames[i];
+        int teamSize = game.winningTeamData.size();
+        if (game.losingTeamData.size() != teamSize || !isSupportedTeamSize(teamSize)) {
+            skippedGames++;
+            continue;
         }
-        atomic_add_double(currentMapModeStats.totalWeightedPlays, gameTotalWeightContribution);
-
-
-        // Update Synergy Stats
-        updateTeamSynergy(currentMapModeStats, game.winningTeamData, true);
-        updateTeamSynergy(currentMapModeStats, game.losingTeamData, false);
-
-        // Update Counter Stats
-        for (const auto& winnerData : game.winningTeamData) {
-            double weightWin = m_config.getRankWeight(winnerData.rank);
-            for (const auto& loserData : game.losingTeamData) {
-                 double weightLose = m_config.getRankWeight(loserData.rank);
-
-                // Winner vs Loser perspective (Winner wins the matchup)
-                QString winLoseKey = counterPairKey(winnerData.brawlerName, loserData.brawlerName);
-                BrawlerStats& cStatsWin = currentMapModeStats.counterStats[winLoseKey];
-                atomic_add_double(cStatsWin.wins, weightWin); // NEW
-                atomic_add_double(cStatsWin.plays, weightWin); // NEW
-
-                // Loser vs Winner perspective (Loser plays the matchup)
-                QString loseWinKey = counterPairKey(loserData.brawlerName, winnerData.brawlerName);
-                BrawlerStats& cStatsLose = currentMapModeStats.counterStats[loseWinKey];
-                // Loser only contributes play count from their perspective
-                atomic_add_double(cStatsLose.plays, weightLose);
-            }
+        const QPair<QString, QString> key(game.map, game.mode);
+        auto it = shardIndex.constFind(key);
+        if (it == shardIndex.constEnd()) {
+            it = shardIndex.insert(key, shardKeys.size());
+            shardKeys.append(key);
+            shardGames.append(QVector<int>());
         }
+        shardGames[it.value()].append(i);
     } // End game loop
+    if (skippedGames > 0) {
+        qWarning() << "Skipped" << skippedGames << "games with uneven or unsupported team sizes.";
+    }
 
-    // qInfo() << "Statistics calculation took" << timer.elapsed() << "ms";
+    // Every table exists before any address is taken: inserting may move a hash's entries
+    // QHash automatically default-constructs MapModeStats if needed
+    for (const auto& key : shardKeys) m_stats[key.first][key.second];
+    QVector<MapModeStats*> tables;
+    for (const auto& key : shardKeys) tables.append(&m_stats[key.first][key.second]);
+
+    TaskExecutor::instance().parallelFor(shardKeys.size(), [&](qsizetype shard) {
+        MapModeStats& currentMapModeStats = *tables[shard];
+        for (int i : shardGames[shard]) {
+            const ProcessedGame& game = processedGames[i];
+            dispatchTeamSize(game.winningTeamData.size(), [&](auto format) {
+                accumulateGame<decltype(format)>(currentMapModeStats, game);
+            });
+        }
+    }, TaskPriority::Background);
 }
 
 void StatsCalculator::setStatsFromCacheData(const CacheData& cacheData) {
      qInfo() << "Loading stats from cache data...";
      m_stats.clear();
+     m_compact.reset();
+     m_packVersion = cacheData.metadata.cacheCreationTime;
+     m_sampleFraction = cacheData.metadata.sampleFraction;
+     m_sampledGames = cacheData.metadata.sampledGames;
+     m_errors = cacheData.errors;
 
      // Convert non-atomic CacheData structures to atomic MapModeStats
      for (auto mapIt = cacheData.stats.constBegin(); mapIt != cacheData.stats.constEnd(); ++mapIt) {
@@ -131,6 +181,9 @@ void StatsCalculator::setStatsFromCacheData(const CacheData& cacheData) {
          }
      }
      qInfo() << "Stats loaded into calculator.";
+     buildFallbackTables();
+     buildActiveRosters();
+     updateMemoryCharges();
 }
 
 
@@ -165,10 +218,368 @@ CacheData StatsCalculator::getStatsForCache() const {
             }
         }
     }
+    cacheData.metadata.cacheCreationTime = m_packVersion;
+    cacheData.metadata.sampleFraction = m_sampleFraction;
+    cacheData.metadata.sampledGames = m_sampledGames;
+    cacheData.errors = m_errors;
     qInfo() << "Stats data prepared for caching.";
     return cacheData; // RVO should handle this efficiently
 }
 
+void StatsCalculator::setCompactStats(std::shared_ptr<const CompactStats> compact) {
+    if (!compact) return;
+    // Rosters built from this pack's doubles also use the plays floor, which the tables cannot;
+    // its fallback tables still serve maps the compact pack has no table for
+    bool keepRosters = !m_stats.isEmpty() && m_packVersion == compact->packVersion();
+    m_compact = std::move(compact);
+    m_packVersion = m_compact->packVersion();
+    m_stats.clear();
+    qInfo() << "Stats now served from compact tables (" << m_compact->tableBytes() / 1024 << "KB ).";
+    if (!keepRosters) {
+        m_modeFallbacks.clear();
+        m_globalFallback.reset();
+        m_realShares.clear();
+        buildActiveRosters();
+    }
+    updateMemoryCharges();
+}
+
+qint64 StatsCalculator::packVersion() const {
+    return m_packVersion;
+}
+
+// --- Fallback Tables ---
+
+namespace {
+
+// Counts summed over several map/modes
+struct CellSums {
+    QHash<QString, BrawlerStatsData> brawlers;
+    QHash<QString, BrawlerStatsData> synergy;
+    QHash<QString, BrawlerStatsData> counter;
+    double totalPlays = 0.0;
+};
+
+template<typename Cell>
+void addCells(QHash<QString, BrawlerStatsData>& target, const QHash<QString, Cell>& source) {
+    for (auto it = source.constBegin(); it != source.constEnd(); ++it) {
+        BrawlerStatsData& cell = target[it.key()];
+        if constexpr (std::is_same_v<Cell, BrawlerStats>) {
+            cell.wins += it.value().wins.load();
+            cell.plays += it.value().plays.load();
+        } else {
+            cell.wins += it.value().wins;
+            cell.plays += it.value().plays;
+        }
+    }
+}
+
+// The win rate shrunk toward 'prior' by 'strength' pseudo-plays; the prior alone without plays
+double blend(double wins, double plays, double prior, double strength) {
+    if (plays + strength <= 0.0) return prior;
+    return std::clamp((wins + strength * prior) / (plays + strength), 0.0, 1.0);
+}
+
+// Rare picks are pulled toward LowConfidenceWinRateTarget
+double withPickRateConfidence(const AppConfig& config, double rate, double pickRate) {
+    double prThreshold = config.lowPickRateThreshold();
+    double confidenceFactor = prThreshold > 0.0 ? std::clamp(pickRate / prThreshold, 0.0, 1.0) : 1.0;
+    double adjusted = rate * confidenceFactor + config.lowConfidenceWinRateTarget() * (1.0 - confidenceFactor);
+    return std::clamp(adjusted, 0.0, 1.0);
+}
+
+// 'key' in 'table' or the nearest parent that has it; 0.5 without any
+double fallbackScore(const FallbackTable* table, QHash<QString, double> FallbackTable::*cells, const QString& key) {
+    for (; table; table = table->parent.get()) {
+        auto it = (table->*cells).constFind(key);
+        if (it != (table->*cells).constEnd()) return it.value();
+    }
+    return 0.5;
+}
+
+std::shared_ptr<const FallbackTable> makeFallbackTable(const CellSums& sums, std::shared_ptr<const FallbackTable> parent,
+                                                       double strength, const AppConfig& config) {
+    auto table = std::make_shared<FallbackTable>();
+    for (auto it = sums.brawlers.constBegin(); it != sums.brawlers.constEnd(); ++it) {
+        double rate = blend(it.value().wins, it.value().plays,
+                            fallbackScore(parent.get(), &FallbackTable::brawlerRate, it.key()), strength);
+        double pickRate = sums.totalPlays > 0.0 ? it.value().plays / sums.totalPlays : 0.0;
+        table->brawlerRate.insert(it.key(), rate);
+        table->winRate.insert(it.key(), withPickRateConfidence(config, rate, pickRate));
+    }
+    for (auto it = sums.synergy.constBegin(); it != sums.synergy.constEnd(); ++it) {
+        table->synergy.insert(it.key(), blend(it.value().wins, it.value().plays,
+                                              fallbackScore(parent.get(), &FallbackTable::synergy, it.key()), strength));
+    }
+    for (auto it = sums.counter.constBegin(); it != sums.counter.constEnd(); ++it) {
+        table->counter.insert(it.key(), blend(it.value().wins, it.value().plays,
+                                              fallbackScore(parent.get(), &FallbackTable::counter, it.key()), strength));
+    }
+    table->parent = std::move(parent);
+    return table;
+}
+
+} // namespace
+
+// Global sums are smoothed toward 0.5 by SmoothingK, each mode's toward the global table and each
+// map's toward its mode's, FallbackShrinkage pseudo-plays at a time. Without shrinkage, maps are
+// smoothed toward 0.5 on their own, as before. Either way every cell's final score is stored, so
+// the accessors do no arithmetic. Modes, then map/modes, are independent tasks on the executor.
+void StatsCalculator::buildFallbackTables() {
+    m_modeFallbacks.clear();
+    m_globalFallback.reset();
+    m_realShares.clear();
+    if (m_compact) return;
+    const double k = m_config.smoothingK();
+    const double shrinkage = m_config.fallbackShrinkage();
+
+    QVector<MapModeStats*> tables;
+    QVector<QString> tableMaps;
+    QVector<QString> tableModes;
+    QHash<QString, QVector<const MapModeStats*>> tablesByMode;
+    for (auto mapIt = m_stats.begin(); mapIt != m_stats.end(); ++mapIt) {
+        for (auto modeIt = mapIt.value().begin(); modeIt != mapIt.value().end(); ++modeIt) {
+            tables.append(&modeIt.value());
+            tableMaps.append(mapIt.key());
+            tableModes.append(modeIt.key());
+            tablesByMode[modeIt.key()].append(&modeIt.value());
+        }
+    }
+
+    if (shrinkage > 0.0 && !tables.isEmpty()) {
+        const QStringList modes = tablesByMode.keys();
+        QList<CellSums> modeSums = TaskExecutor::instance().mapped(modes, [&tablesByMode](const QString& mode) {
+            CellSums sums;
+            for (const MapModeStats* table : tablesByMode.value(mode)) {
+                addCells(sums.brawlers, table->brawlerStats);
+                addCells(sums.synergy, table->synergyStats);
+                addCells(sums.counter, table->counterStats);
+                sums.totalPlays += table->totalWeightedPlays.load();
+            }
+            return sums;
+        }, TaskPriority::Background);
+
+        CellSums globalSums;
+        for (const CellSums& sums : std::as_const(modeSums)) {
+            addCells(globalSums.brawlers, sums.brawlers);
+            addCells(globalSums.synergy, sums.synergy);
+            addCells(globalSums.counter, sums.counter);
+            globalSums.totalPlays += sums.totalPlays;
+        }
+        m_globalFallback = makeFallbackTable(globalSums, nullptr, k, m_config);
+
+        QList<std::shared_ptr<const FallbackTable>> modeTables = TaskExecutor::instance().mapped(modeSums,
+            [this, shrinkage](const CellSums& sums) {
+                return makeFallbackTable(sums, m_globalFallback, shrinkage, m_config);
+            }, TaskPriority::Background);
+        for (int i = 0; i < modes.size(); ++i) m_modeFallbacks.insert(modes[i], modeTables[i]);
+    }
+
+    // --- Final scores per map/mode ---
+    QVector<double> realShares(tables.size(), 1.0);
+    TaskExecutor::instance().parallelFor(tables.size(), [&](qsizetype i) {
+        MapModeStats& table = *tables[i];
+        table.fallback = m_modeFallbacks.value(tableModes[i]);
+        const FallbackTable* parent = table.fallback.get();
+        const double strength = parent ? shrinkage : k;
+        double realWeight = 0.0;
+        auto finish = [&](QHash<QString, BrawlerStats>& cells, QHash<QString, double> FallbackTable::*parentCells) {
+            for (auto it = cells.begin(); it != cells.end(); ++it) {
+                BrawlerStats& cell = it.value();
+                const double plays = cell.plays.load();
+                cell.score = blend(cell.wins.load(), plays, fallbackScore(parent, parentCells, it.key()), strength);
+                if (parent) realWeight += plays / (plays + shrinkage);
+            }
+        };
+
+        finish(table.brawlerStats, &FallbackTable::brawlerRate);
+        const double totalPlays = table.totalWeightedPlays.load();
+        for (auto it = table.brawlerStats.begin(); it != table.brawlerStats.end(); ++it) {
+            BrawlerStats& cell = it.value();
+            const double plays = cell.plays.load();
+            cell.score = plays + strength <= 0.0
+                ? m_config.lowConfidenceWinRateTarget()
+                : withPickRateConfidence(m_config, cell.score, totalPlays > 0.0 ? plays / totalPlays : 0.0);
+        }
+        finish(table.synergyStats, &FallbackTable::synergy);
+        finish(table.counterStats, &FallbackTable::counter);
+
+        // The mode's cells include every cell of its maps
+        if (parent) {
+            const qsizetype cells = parent->brawlerRate.size() + parent->synergy.size() + parent->counter.size();
+            realShares[i] = cells > 0 ? realWeight / cells : 1.0;
+        }
+    }, TaskPriority::Background);
+
+    if (m_globalFallback) {
+        for (int i = 0; i < tables.size(); ++i) m_realShares[tableMaps[i]][tableModes[i]] = realShares[i];
+        qInfo() << "Fallback tables for" << m_modeFallbacks.size() << "modes; map/modes are shrunk toward them by"
+                << shrinkage << "weighted plays.";
+    }
+}
+
+const FallbackTable* StatsCalculator::fallbackTable(const QString& mode) const {
+    auto it = m_modeFallbacks.constFind(mode);
+    return it != m_modeFallbacks.constEnd() ? it.value().get() : m_globalFallback.get();
+}
+
+double StatsCalculator::realDataShare(const QString& mapName, const QString& mode) const {
+    auto mapIt = m_realShares.constFind(mapName);
+    if (mapIt != m_realShares.constEnd()) {
+        auto modeIt = mapIt.value().constFind(mode);
+        if (modeIt != mapIt.value().constEnd()) return modeIt.value();
+    }
+    if (getMapModeStats(mapName, mode) || (m_compact && m_compact->table(mapName, mode))) return 1.0;
+    return 0.0;
+}
+
+
+// --- Active Rosters ---
+
+std::shared_ptr<const QSet<QString>> StatsCalculator::activeRoster(const QString& mapName, const QString& mode) const {
+    auto mapIt = m_activeRosters.constFind(mapName);
+    if (mapIt == m_activeRosters.constEnd()) return nullptr;
+    return mapIt.value().value(mode);
+}
+
+void StatsCalculator::buildActiveRosters() {
+    m_activeRosters.clear();
+    if (!m_config.activeRosterPruning()) return;
+    const double minPickRate = m_config.activeRosterMinPickRate();
+    const double minPlays = m_config.activeRosterMinPlays();
+
+    int mapModes = 0;
+    qint64 keptTotal = 0;
+    auto store = [&](const QString& mapName, const QString& mode, QSet<QString> roster) {
+        // Too small to fill a draft's picks and bans: pruning would change the game, so search it all
+        DraftFormatInfo format = draftFormatForMode(mode);
+        if (roster.size() < format.totalPicks + format.maxBans) return;
+        keptTotal += roster.size();
+        mapModes++;
+        m_activeRosters[mapName][mode] = std::make_shared<const QSet<QString>>(std::move(roster));
+    };
+
+    if (m_compact) {
+        // Only pick rates survive quantization
+        const NameIndex& names = m_compact->names();
+        for (const QString& mapName : names.maps.keys()) {
+            for (const QString& mode : names.modes.keys()) {
+                const CompactMapModeTable* table = m_compact->table(mapName, mode);
+                if (!table || !table->hasPlays) continue;
+                QSet<QString> roster;
+                for (int i = 0; i < table->pickRate.size(); ++i) {
+                    if (CompactFixed::decode(table->pickRate[i]) >= minPickRate) roster.insert(m_compact->roster()[i]);
+                }
+                store(mapName, mode, std::move(roster));
+            }
+        }
+    } else {
+        for (auto mapIt = m_stats.constBegin(); mapIt != m_stats.constEnd(); ++mapIt) {
+            for (auto modeIt = mapIt.value().constBegin(); modeIt != mapIt.value().constEnd(); ++modeIt) {
+                double totalPlays = modeIt.value().totalWeightedPlays.load();
+                if (totalPlays <= 0) continue;
+                QSet<QString> roster;
+                for (auto bsIt = modeIt.value().brawlerStats.constBegin(); bsIt != modeIt.value().brawlerStats.constEnd(); ++bsIt) {
+                    double plays = bsIt.value().plays.load();
+                    if (plays >= minPlays || plays / totalPlays >= minPickRate) roster.insert(bsIt.key());
+                }
+                store(mapIt.key(), modeIt.key(), std::move(roster));
+            }
+        }
+    }
+    if (mapModes > 0) {
+        qInfo() << "Active rosters for" << mapModes << "map/modes, mean"
+                << QString::number(double(keptTotal) / mapModes, 'f', 1) << "brawlers each.";
+    }
+}
+
+
+// --- Memory Accounting ---
+
+namespace {
+
+// Hash table plus its QString keys (values that own memory are added by the caller)
+template<typename V>
+qint64 keyedTableBytes(const QHash<QString, V>& table) {
+    qint64 bytes = MemoryLedger::hashBytes(table);
+    for (auto it = table.constBegin(); it != table.constEnd(); ++it) bytes += MemoryLedger::stringBytes(it.key());
+    return bytes;
+}
+
+} // namespace
+
+// Compact tables are charged by CompactStats itself, once however many calculators share them
+void StatsCalculator::updateMemoryCharges() {
+    qint64 tableBytes = keyedTableBytes(m_stats);
+    for (const auto& modes : m_stats) {
+        tableBytes += keyedTableBytes(modes);
+        for (const MapModeStats& mapModeStats : modes) {
+            tableBytes += keyedTableBytes(mapModeStats.brawlerStats) + keyedTableBytes(mapModeStats.synergyStats)
+                        + keyedTableBytes(mapModeStats.counterStats);
+        }
+    }
+    tableBytes += keyedTableBytes(m_errors);
+    for (const auto& modes : m_errors) {
+        tableBytes += keyedTableBytes(modes);
+        for (const MapModeErrorData& errors : modes) {
+            tableBytes += keyedTableBytes(errors.brawlerStats) + keyedTableBytes(errors.synergyStats)
+                        + keyedTableBytes(errors.counterStats);
+        }
+    }
+    // Fallback tables are shared by the map/modes that read them
+    auto fallbackBytes = [](const FallbackTable& table) {
+        return keyedTableBytes(table.brawlerRate) + keyedTableBytes(table.winRate) + keyedTableBytes(table.synergy)
+             + keyedTableBytes(table.counter);
+    };
+    if (m_globalFallback) tableBytes += fallbackBytes(*m_globalFallback);
+    for (const auto& table : m_modeFallbacks) tableBytes += fallbackBytes(*table);
+    tableBytes += keyedTableBytes(m_realShares);
+    m_tablesCharge.set(tableBytes);
+
+    // Roster names share the stats' (or compact roster's) string data
+    qint64 rosterBytes = MemoryLedger::hashBytes(m_activeRosters);
+    for (const auto& modes : m_activeRosters) {
+        rosterBytes += MemoryLedger::hashBytes(modes);
+        for (const auto& roster : modes) rosterBytes += MemoryLedger::setBytes(*roster) + 32; // + shared_ptr block
+    }
+    m_rostersCharge.set(rosterBytes);
+}
+
+
+// --- Sampling Error ---
+
+namespace {
+
+std::optional<double> cellError(const ErrorContainer& errors, const QString& mapName, const QString& mode,
+                                QHash<QString, float> MapModeErrorData::*cells, const QString& key) {
+    auto mapIt = errors.constFind(mapName);
+    if (mapIt == errors.constEnd()) return std::nullopt;
+    auto modeIt = mapIt.value().constFind(mode);
+    if (modeIt == mapIt.value().constEnd()) return std::nullopt;
+    auto cellIt = (modeIt.value().*cells).constFind(key);
+    if (cellIt == (modeIt.value().*cells).constEnd()) return std::nullopt;
+    return static_cast<double>(cellIt.value());
+}
+
+} // namespace
+
+void StatsCalculator::setErrors(const ErrorContainer& errors) {
+    m_errors = errors;
+    updateMemoryCharges();
+}
+
+std::optional<double> StatsCalculator::getWinRateError(const QString& brawler, const QString& mapName, const QString& mode) const {
+    return cellError(m_errors, mapName, mode, &MapModeErrorData::brawlerStats, brawler);
+}
+
+std::optional<double> StatsCalculator::getSynergyError(const QString& brawler1, const QString& brawler2, const QString& mapName, const QString& mode) const {
+    return cellError(m_errors, mapName, mode, &MapModeErrorData::synergyStats, sortedPairKey(brawler1, brawler2));
+}
+
+std::optional<double> StatsCalculator::getCounterError(const QString& brawlerUs, const QString& brawlerThem, const QString& mapName, const QString& mode) const {
+    return cellError(m_errors, mapName, mode, &MapModeErrorData::counterStats, counterPairKey(brawlerUs, brawlerThem));
+}
+
 
 // Helper to get stats pointer (const version)
 const MapModeStats* StatsCalculator::getMapModeStats(const QString& mapName, const QString& mode) const {
@@ -197,12 +608,65 @@ MapModeStats* StatsCalculator::getMapModeStats(const QString& mapName, const QSt
 }
 
 
+template<typename Format>
+void StatsCalculator::accumulateGame(MapModeStats& currentMapModeStats, const ProcessedGame& game) {
+    constexpr int N = Format::teamSize;
+    const PlayerData* winners = game.winningTeamData.constData();
+    const PlayerData* losers = game.losingTeamData.constData();
+
+    // Rank weights are looked up once per player instead of once per pair/matchup
+    double winnerWeights[N];
+    double loserWeights[N];
+    unrolledFor<N>([&](auto i) {
+        winnerWeights[i] = m_config.getRankWeight(winners[i].rank);
+        loserWeights[i] = m_config.getRankWeight(losers[i].rank);
+    });
+
+    // Update Brawler Wins/Plays and Total Plays
+    double gameTotalWeightContribution = 0; // Track weight added by this game to total plays
+    unrolledFor<N>([&](auto i) {
+        // Winner
+        BrawlerStats& winStats = currentMapModeStats.brawlerStats[winners[i].brawlerName]; // Creates if new
+        atomic_add_double(winStats.wins, winnerWeights[i]);
+        atomic_add_double(winStats.plays, winnerWeights[i]);
+        // Loser (no wins update)
+        BrawlerStats& loseStats = currentMapModeStats.brawlerStats[losers[i].brawlerName];
+        atomic_add_double(loseStats.plays, loserWeights[i]);
+        gameTotalWeightContribution += winnerWeights[i] + loserWeights[i];
+    });
+    atomic_add_double(currentMapModeStats.totalWeightedPlays, gameTotalWeightContribution);
+
+
+    // Update Synergy Stats
+    updateTeamSynergy<Format>(currentMapModeStats, winners, true);
+    updateTeamSynergy<Format>(currentMapModeStats, losers, false);
+
+    // Update Counter Stats
+    unrolledFor<N>([&](auto i) {
+        unrolledFor<N>([&](auto j) {
+            // Winner vs Loser perspective (Winner wins the matchup)
+            QString winLoseKey = counterPairKey(winners[i].brawlerName, losers[j].brawlerName);
+            BrawlerStats& cStatsWin = currentMapModeStats.counterStats[winLoseKey];
+            atomic_add_double(cStatsWin.wins, winnerWeights[i]);
+            atomic_add_double(cStatsWin.plays, winnerWeights[i]);
+
+            // Loser vs Winner perspective (Loser plays the matchup)
+            QString loseWinKey = counterPairKey(losers[j].brawlerName, winners[i].brawlerName);
+            BrawlerStats& cStatsLose = currentMapModeStats.counterStats[loseWinKey];
+            // Loser only contributes play count from their perspective
+            atomic_add_double(cStatsLose.plays, loserWeights[j]);
+        });
+    });
+}
+
 // Helper to update synergy stats for a team
-void StatsCalculator::updateTeamSynergy(MapModeStats& mapModeStats, const QVector<PlayerData>& teamData, bool win) {
-    for (int i = 0; i < teamData.size(); ++i) {
+template<typename Format>
+void StatsCalculator::updateTeamSynergy(MapModeStats& mapModeStats, const PlayerData* teamData, bool win) {
+    constexpr int N = Format::teamSize;
+    unrolledFor<N>([&](auto i) {
         const PlayerData& p1 = teamData[i];
-        for (int j = i + 1; j < teamData.size(); ++j) {
-            const PlayerData& p2 = teamData[j];
+        unrolledFor<N - 1 - decltype(i)::value>([&](auto offset) {
+            const PlayerData& p2 = teamData[i + 1 + offset];
             QString pairKey = sortedPairKey(p1.brawlerName, p2.brawlerName);
 
             // Use average rank for weighting synergy pairs
@@ -214,56 +678,34 @@ void StatsCalculator::updateTeamSynergy(MapModeStats& mapModeStats, const QVecto
                 atomic_add_double(pairStats.wins, weight);
             }
             atomic_add_double(pairStats.plays, weight);
-        }
-    }
+        });
+    });
 }
 
 
 // --- Stat Accessors ---
 
 std::optional<double> StatsCalculator::getWinRate(const QString& brawler, const QString& mapName, const QString& mode) const {
+    if (m_compact && (!m_globalFallback || m_compact->table(mapName, mode))) return m_compact->winRate(brawler, mapName, mode);
     const MapModeStats* statsPtr = getMapModeStats(mapName, mode);
-    if (!statsPtr) return std::nullopt; // No stats for this map/mode
+    if (!statsPtr) {
+        // No stats for this map/mode: the mode-wide (or global) table, if fallback is on
+        const FallbackTable* fallback = fallbackTable(mode);
+        if (!fallback) return std::nullopt;
+        return fallback->winRate.value(brawler, m_config.lowConfidenceWinRateTarget());
+    }
 
     auto brawlerIt = statsPtr->brawlerStats.constFind(brawler);
     if (brawlerIt == statsPtr->brawlerStats.constEnd()) {
         // Brawler not found in stats for this map/mode, apply low confidence target
         return m_config.lowConfidenceWinRateTarget();
     }
-
-    const BrawlerStats& bStats = *brawlerIt;
-    double plays = bStats.plays.load();
-    double wins = bStats.wins.load();
-    double k = m_config.smoothingK();
-
-    if (plays + k <= 0) {
-        // Avoid division by zero, apply low confidence target
-        return m_config.lowConfidenceWinRateTarget();
-    }
-
-    // Calculate smoothed win rate
-    double smoothedWinRate = (wins + k * 0.5) / (plays + k);
-
-    // Adjust for confidence based on pick rate
-    std::optional<double> pickRateOpt = getPickRate(brawler, mapName, mode);
-    double pickRate = pickRateOpt.value_or(0.0); // Use 0.0 if pick rate couldn't be calculated
-
-    double prThreshold = m_config.lowPickRateThreshold();
-    double confidenceFactor = 1.0; // Default to full confidence
-
-    if (prThreshold > 0.0) {
-         confidenceFactor = std::max(0.0, std::min(1.0, pickRate / prThreshold));
-    }
-
-    double adjustedWinRate = (smoothedWinRate * confidenceFactor) +
-                             (m_config.lowConfidenceWinRateTarget() * (1.0 - confidenceFactor));
-
-    // Clamp final rate between 0.0 and 1.0
-    return std::max(0.0, std::min(1.0, adjustedWinRate));
+    return brawlerIt->score; // Smoothed and pick-rate adjusted by buildFallbackTables
 }
 
 
 std::optional<double> StatsCalculator::getPickRate(const QString& brawler, const QString& mapName, const QString& mode) const {
+    if (m_compact) return m_compact->pickRate(brawler, mapName, mode);
     const MapModeStats* statsPtr = getMapModeStats(mapName, mode);
     if (!statsPtr || statsPtr->totalWeightedPlays <= 0) {
         return std::nullopt; // No data or no plays for this map/mode
@@ -283,48 +725,29 @@ std::optional<double> StatsCalculator::getPickRate(const QString& brawler, const
 
 
 double StatsCalculator::getSynergyScore(const QString& brawler1, const QString& brawler2, const QString& mapName, const QString& mode) const {
+    if (m_compact && (!m_globalFallback || m_compact->table(mapName, mode))) return m_compact->synergyScore(brawler1, brawler2, mapName, mode);
     const MapModeStats* statsPtr = getMapModeStats(mapName, mode);
-    if (!statsPtr) return 0.5; // Default if no map/mode stats
-
     QString pairKey = sortedPairKey(brawler1, brawler2);
+    // Default if no map/mode stats: the fallback tables, else 0.5
+    if (!statsPtr) return fallbackScore(fallbackTable(mode), &FallbackTable::synergy, pairKey);
+
     auto pairIt = statsPtr->synergyStats.constFind(pairKey);
     if (pairIt == statsPtr->synergyStats.constEnd()) {
-        return 0.5; // No data for this pair
-    }
-
-    const BrawlerStats& pairStats = *pairIt;
-    double plays = pairStats.plays.load();
-    double wins = pairStats.wins.load();
-    double k = m_config.smoothingK(); // Use same smoothing as win rate
-
-    if (plays + k <= 0) {
-        return 0.5; // Avoid division by zero or meaningless result
+        return fallbackScore(statsPtr->fallback.get(), &FallbackTable::synergy, pairKey); // No data for this pair
     }
-
-    // Calculate smoothed win rate for the pair
-    return std::max(0.0, std::min(1.0, (wins + k * 0.5) / (plays + k)));
+    return pairIt->score;
 }
 
 
 double StatsCalculator::getCounterScore(const QString& brawlerUs, const QString& brawlerThem, const QString& mapName, const QString& mode) const {
+    if (m_compact && (!m_globalFallback || m_compact->table(mapName, mode))) return m_compact->counterScore(brawlerUs, brawlerThem, mapName, mode);
     const MapModeStats* statsPtr = getMapModeStats(mapName, mode);
-    if (!statsPtr) return 0.5; // Default if no map/mode stats
-
     QString matchupKey = counterPairKey(brawlerUs, brawlerThem);
+    if (!statsPtr) return fallbackScore(fallbackTable(mode), &FallbackTable::counter, matchupKey);
+
     auto matchupIt = statsPtr->counterStats.constFind(matchupKey);
     if (matchupIt == statsPtr->counterStats.constEnd()) {
-        return 0.5; // No data for this specific matchup
+        return fallbackScore(statsPtr->fallback.get(), &FallbackTable::counter, matchupKey); // No data for this specific matchup
     }
-
-    const BrawlerStats& matchupStats = *matchupIt;
-    double plays = matchupStats.plays.load();
-    double wins = matchupStats.wins.load();
-    double k = m_config.smoothingK(); // Use same smoothing
-
-    if (plays + k <= 0) {
-        return 0.5; // Avoid division by zero or meaningless result
-    }
-
-    // Calculate smoothed win rate for us vs them
-    return std::max(0.0, std::min(1.0, (wins + k * 0.5) / (plays + k)));
+    return matchupIt->score;
 }
\ No newline at end of file
@@ -6,8 +6,12 @@
 #include <QVector>
 #include <QSet>
 #include <optional> // C++17 required
+#include <memory>
 #include "DataStructures.h"
 #include "AppConfig.h"
+#include "MemoryLedger.h"
+
+class CompactStats;
 
 class StatsCalculator {
 public:
@@ -18,28 +22,86 @@ public:
 
 
     void calculateStats(const QVector<ProcessedGame>& processedGames);
+    // Adds games (or another pack's counts) to the loaded totals under a new pack version.
+    // Not available once compact stats are set; not thread-safe against readers.
+    void addGames(const QVector<ProcessedGame>& processedGames);
+    void addStats(const CacheData& cacheData);
     void setStatsFromCacheData(const CacheData& cacheData); // Load from non-atomic cache struct
     CacheData getStatsForCache() const; // Get non-atomic data for saving
+    // Serves every accessor from quantized, pruned tables instead; the double stats are released
+    void setCompactStats(std::shared_ptr<const CompactStats> compact);
+    const CompactStats* compactStats() const { return m_compact.get(); }
+
+    // Identifies the loaded stats (pack creation time); derived results are cached against it
+    qint64 packVersion() const;
 
     // --- Stat Accessors ---
     // Use std::optional to indicate if stats exist for the map/mode
     std::optional<double> getWinRate(const QString& brawler, const QString& mapName, const QString& mode) const;
     std::optional<double> getPickRate(const QString& brawler, const QString& mapName, const QString& mode) const;
     // Synergy/Counter return 0.5 if no data, matching Python's behavior
+    // With FallbackShrinkage, every cell is shrunk toward the mode-wide table (which is shrunk toward
+    // the global one), and maps or cells without games read those tables instead of 0.5 / nullopt.
+    // Scores are finalized when the stats load, so an accessor is one or two hash lookups.
     double getSynergyScore(const QString& brawler1, const QString& brawler2, const QString& mapName, const QString& mode) const;
     double getCounterScore(const QString& brawlerUs, const QString& brawlerThem, const QString& mapName, const QString& mode) const;
 
+    // --- Sampling Error ---
+    // Standard error of the raw win rate behind each score: from random groups for approximate
+    // packs (built from a sample of the games), from bootstrap replicas for exact ones.
+    // std::nullopt for cells without an estimate and packs built with neither.
+    bool isApproximate() const { return m_sampleFraction < 1.0; }
+    double sampleFraction() const { return m_sampleFraction; }
+    std::optional<double> getWinRateError(const QString& brawler, const QString& mapName, const QString& mode) const;
+    std::optional<double> getSynergyError(const QString& brawler1, const QString& brawler2, const QString& mapName, const QString& mode) const;
+    std::optional<double> getCounterError(const QString& brawlerUs, const QString& brawlerThem, const QString& mapName, const QString& mode) const;
+    // Errors estimated outside the pack (Bootstrap::cellErrors on the games behind exact stats)
+    void setErrors(const ErrorContainer& errors);
+
+    // --- Fallback Tables ---
+    // Share of the map/mode's scores that comes from its own games: the mean over the mode's cells
+    // of plays / (plays + FallbackShrinkage), so 0 for a map without games. 1 for any map with
+    // games when shrinkage is off, and for compact packs loaded without the double stats.
+    double realDataShare(const QString& mapName, const QString& mode) const;
+
+    // --- Active Rosters ---
+    // Brawlers worth branching over on a map/mode: pick rate or weighted plays at the ActiveRoster*
+    // floors, rebuilt whenever stats load. nullptr: search everything (pruning off, no stats,
+    // or too few active brawlers to fill a draft).
+    std::shared_ptr<const QSet<QString>> activeRoster(const QString& mapName, const QString& mode) const;
+
 private:
     // Helper to safely get map/mode stats (returns pointer or nullptr)
     const MapModeStats* getMapModeStats(const QString& mapName, const QString& mode) const;
     MapModeStats* getMapModeStats(const QString& mapName, const QString& mode); // Non-const version
 
-    void updateTeamSynergy(MapModeStats& mapModeStats, const QVector<PlayerData>& teamData, bool win);
+    // One instantiation per DraftFormat (dispatched per game in calculateStats), with unrolled team loops.
+    // Both teams of 'game' hold exactly Format::teamSize players.
+    void accumulateGames(const QVector<ProcessedGame>& processedGames);
+    template<typename Format>
+    void accumulateGame(MapModeStats& mapModeStats, const ProcessedGame& game);
+    template<typename Format>
+    void updateTeamSynergy(MapModeStats& mapModeStats, const PlayerData* teamData, bool win);
+    void buildFallbackTables(); // Also finalizes every cell's score; after every change to the counts
+    const FallbackTable* fallbackTable(const QString& mode) const; // Mode table, else global; null when off
+    void buildActiveRosters();
+    void updateMemoryCharges(); // After every change to the tables or rosters
 
     const AppConfig& m_config;
     // Main storage: Map -> Mode -> Stats
     // Use QHash for efficiency, outer key is map name, inner key is mode name
     QHash<QString, QHash<QString, MapModeStats>> m_stats;
+    qint64 m_packVersion = 0;
+    std::shared_ptr<const CompactStats> m_compact; // Set: accessors read it, m_stats is empty
+    double m_sampleFraction = 1.0;
+    qint64 m_sampledGames = 0;
+    ErrorContainer m_errors; // Sampling or bootstrap errors; empty if the pack has neither
+    QHash<QString, std::shared_ptr<const FallbackTable>> m_modeFallbacks; // Mode -> aggregate over its maps
+    std::shared_ptr<const FallbackTable> m_globalFallback;                // Every map/mode; null when off
+    QHash<QString, QHash<QString, double>> m_realShares;                  // Map -> Mode; kept under compact stats
+    QHash<QString, QHash<QString, std::shared_ptr<const QSet<QString>>>> m_activeRosters; // Map -> Mode
+    MemoryCharge m_tablesCharge{MemorySubsystem::StatsTables};
+    MemoryCharge m_rostersCharge{MemorySubsystem::EvalCaches};
 };
 
 #endif // STATSCALCULATOR_H
\ No newline at end of file
@@ -0,0 +1,270 @@
+#include "SyntheticData.h"
+#include "AppConfig.h"
+#include "DraftFormat.h"
+#include "StatsCalculator.h"
+#include "TaskExecutor.h"
+#include <QFile>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+const qint64 GAMES_PER_BLOCK = 50000;
+const qint64 FIRST_BATTLE_SECS = 1767225600; // 2026-01-01T00:00:00Z; one battle per second after it
+
+// Deterministic 64-bit hash of a few ids (splitmix64 finalizer)
+quint64 mixIds(quint64 a, quint64 b, quint64 c) {
+    quint64 x = a * 0x9E3779B97F4A7C15ull ^ (b + 0x632BE59BD9B4E019ull) * 0xBF58476D1CE4E5B9ull ^ c * 0x94D049BB133111EBull;
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+// Deterministic uniform in [-1, 1)
+double hashedUnit(quint64 a, quint64 b, quint64 c) {
+    return static_cast<double>(mixIds(a, b, c) >> 11) / static_cast<double>(1ull << 52) - 1.0;
+}
+
+QByteArray playerTag(int player) {
+    return QByteArray("#SYN").append(QByteArray::number(player, 36).toUpper());
+}
+
+} // namespace
+
+
+const QStringList SyntheticGenerator::MODES = {
+    "gemGrab", "brawlBall", "heist", "bounty", "knockout", "hotZone", "wipeout",
+    "brawlBall5V5", "knockout5V5", "brawlBall2v2",
+};
+
+SyntheticGenerator::SyntheticGenerator(const SyntheticSettings& settings)
+    : m_settings(settings)
+{
+    if (settings.maps <= 0 || settings.modes <= 0 || settings.modes > MODES.size() || settings.games < 0 ||
+        settings.players <= 0 || settings.skew < 0.0 || settings.strengthSpread < 0.0 || settings.rankSpread < 0.0) {
+        throw std::invalid_argument("Invalid synthetic data settings.");
+    }
+    int largestTeam = 0;
+    for (int m = 0; m < settings.modes; ++m) largestTeam = std::max(largestTeam, teamSizeForMode(MODES[m]));
+    // Room for a whole draft: both teams plus a ban per pick
+    if (settings.brawlers < 4 * largestTeam) {
+        throw std::invalid_argument(QString("Synthetic data needs at least %1 brawlers for these modes.")
+                                        .arg(4 * largestTeam).toStdString());
+    }
+
+    std::mt19937 rng(settings.seed);
+    std::normal_distribution<double> strengthDist(0.0, settings.strengthSpread);
+    const int nameWidth = QString::number(settings.brawlers).size();
+    for (int b = 0; b < settings.brawlers; ++b) {
+        m_brawlerNames.append(QString("SYN %1").arg(b + 1, nameWidth, 10, QChar('0')));
+        m_baseStrength.append(strengthDist(rng));
+        m_popularity.append(1.0 / std::pow(b + 1.0, settings.skew));
+        m_roster.insert(m_brawlerNames.last());
+    }
+    // Running sum, for sampling a popularity rank with one binary search
+    for (int r = 1; r < m_popularity.size(); ++r) m_popularity[r] += m_popularity[r - 1];
+
+    const int mapWidth = QString::number(settings.maps).size();
+    for (int m = 0; m < settings.maps; ++m) {
+        m_mapNames.append(QString("Synthetic Map %1").arg(m + 1, mapWidth, 10, QChar('0')));
+        m_mapModeNames.append(MODES[m % settings.modes]);
+        m_mapModes[m_mapModeNames.last()].insert(m_mapNames.last());
+    }
+}
+
+double SyntheticGenerator::strength(int brawler, int map) const {
+    return m_baseStrength[brawler] + 0.5 * m_settings.strengthSpread * hashedUnit(m_settings.seed, brawler, map + 1);
+}
+
+double SyntheticGenerator::pairEffect(int a, int b) const {
+    if (a > b) std::swap(a, b);
+    return 0.25 * m_settings.strengthSpread * hashedUnit(m_settings.seed ^ 0xA5A5A5A5u, a, b);
+}
+
+qint64 SyntheticGenerator::blockCount() const {
+    return (m_settings.games + GAMES_PER_BLOCK - 1) / GAMES_PER_BLOCK;
+}
+
+// --- Generation ---
+
+QVector<SyntheticGenerator::Battle> SyntheticGenerator::generateBlock(qint64 block) const {
+    std::mt19937_64 rng(mixIds(m_settings.seed, 0x51u, static_cast<quint64>(block)));
+    const int brawlers = m_settings.brawlers;
+    std::uniform_int_distribution<int> mapDist(0, m_settings.maps - 1);
+    std::uniform_real_distribution<double> unitDist(0.0, 1.0);
+    std::normal_distribution<double> rankDist(m_settings.rankMean, m_settings.rankSpread);
+    std::uniform_int_distribution<int> playerDist(0, m_settings.players - 1);
+
+    qint64 first = block * GAMES_PER_BLOCK;
+    qint64 count = std::min(GAMES_PER_BLOCK, m_settings.games - first);
+    QVector<Battle> battles(count);
+    for (Battle& battle : battles) {
+        battle.map = mapDist(rng);
+        const int teamSize = teamSizeForMode(m_mapModeNames[battle.map]);
+        // Each map has its own popularity order: the Zipf ranking rotated by a per-map offset
+        const int rotation = static_cast<int>(mixIds(m_settings.seed, 0x70u, battle.map) % brawlers);
+        // Ranks are drawn without replacement: the draw lives on the popularity line with the picked
+        // ranks' intervals cut out, and is mapped back by stepping over each cut below it. Redrawing
+        // duplicates instead would almost never finish at high skew, where the top ranks hold nearly
+        // all of the weight.
+        QVector<int> picked;
+        QVector<int> pickedRanks; // Ascending
+        double remaining = m_popularity.last();
+        while (picked.size() < 2 * teamSize) {
+            double target = std::uniform_real_distribution<double>(0.0, remaining)(rng);
+            for (int taken : pickedRanks) {
+                double start = taken > 0 ? m_popularity[taken - 1] : 0.0;
+                if (start > target) break;
+                target += m_popularity[taken] - start;
+            }
+            int rank = std::min<int>(std::upper_bound(m_popularity.begin(), m_popularity.end(), target) - m_popularity.begin(),
+                                     brawlers - 1);
+            // Rounding can land on a cut edge: take the next free rank
+            while (std::binary_search(pickedRanks.begin(), pickedRanks.end(), rank)) rank = (rank + 1) % brawlers;
+            pickedRanks.insert(std::lower_bound(pickedRanks.begin(), pickedRanks.end(), rank) - pickedRanks.begin(), rank);
+            remaining = std::max(0.0, remaining - (m_popularity[rank] - (rank > 0 ? m_popularity[rank - 1] : 0.0)));
+            picked.append((rank + rotation) % brawlers);
+        }
+        battle.team1 = picked.mid(0, teamSize);
+        battle.team2 = picked.mid(teamSize);
+
+        double diff = 0.0;
+        for (int i = 0; i < teamSize; ++i) {
+            diff += strength(battle.team1[i], battle.map) - strength(battle.team2[i], battle.map);
+            for (int j = i + 1; j < teamSize; ++j) {
+                diff += pairEffect(battle.team1[i], battle.team1[j]) - pairEffect(battle.team2[i], battle.team2[j]);
+            }
+        }
+        battle.team1Won = unitDist(rng) < 1.0 / (1.0 + std::exp(-diff));
+        for (int p = 0; p < 2 * teamSize; ++p) {
+            battle.ranks.append(std::clamp(static_cast<int>(std::lround(rankDist(rng))), 1, MAX_RANK));
+            battle.players.append(playerDist(rng));
+        }
+    }
+    return battles;
+}
+
+QVector<ProcessedGame> SyntheticGenerator::games(qint64 first, qint64 count) const {
+    QVector<ProcessedGame> games;
+    first = std::max<qint64>(0, first);
+    count = std::min(count, m_settings.games - first);
+    if (count <= 0) return games;
+    games.reserve(count);
+    for (qint64 block = first / GAMES_PER_BLOCK; block * GAMES_PER_BLOCK < first + count; ++block) {
+        QVector<Battle> battles = generateBlock(block);
+        for (qint64 i = 0; i < battles.size(); ++i) {
+            qint64 index = block * GAMES_PER_BLOCK + i;
+            if (index < first || index >= first + count) continue;
+            const Battle& battle = battles[i];
+            const int teamSize = battle.team1.size();
+            ProcessedGame game;
+            game.mode = m_mapModeNames[battle.map];
+            game.map = m_mapNames[battle.map];
+            QVector<PlayerData> team1, team2;
+            for (int p = 0; p < teamSize; ++p) {
+                team1.append({m_brawlerNames[battle.team1[p]], battle.ranks[p]});
+                team2.append({m_brawlerNames[battle.team2[p]], battle.ranks[teamSize + p]});
+            }
+            game.winningTeamData = battle.team1Won ? team1 : team2;
+            game.losingTeamData = battle.team1Won ? team2 : team1;
+            games.append(game);
+        }
+    }
+    return games;
+}
+
+// Written by hand rather than through QJsonDocument: every name is plain ASCII, and this is the
+// hot loop when generating millions of lines
+QByteArray SyntheticGenerator::blockJsonl(qint64 block) const {
+    QVector<Battle> battles = generateBlock(block);
+    QByteArray lines;
+    lines.reserve(battles.size() * 700);
+    for (qint64 i = 0; i < battles.size(); ++i) {
+        const Battle& battle = battles[i];
+        const int teamSize = battle.team1.size();
+        const QByteArray mode = m_mapModeNames[battle.map].toUtf8();
+        const QByteArray battleTime = QDateTime::fromSecsSinceEpoch(FIRST_BATTLE_SECS + block * GAMES_PER_BLOCK + i).toUTC()
+                                          .toString("yyyyMMdd'T'HHmmss'.000Z'").toUtf8();
+        // The first player of team 1 is the one whose battle log this line came from
+        lines.append("{\"queried_player_tag\":\"").append(playerTag(battle.players[0]))
+             .append("\",\"battleTime\":\"").append(battleTime)
+             .append("\",\"event\":{\"mode\":\"").append(mode)
+             .append("\",\"map\":\"").append(m_mapNames[battle.map].toUtf8())
+             .append("\"},\"battle\":{\"mode\":\"").append(mode)
+             .append("\",\"type\":\"soloRanked\",\"result\":\"").append(battle.team1Won ? "victory" : "defeat")
+             .append("\",\"teams\":[");
+        for (int side = 0; side < 2; ++side) {
+            const QVector<int>& team = side == 0 ? battle.team1 : battle.team2;
+            lines.append(side == 0 ? "[" : ",[");
+            for (int p = 0; p < teamSize; ++p) {
+                int slot = side * teamSize + p;
+                if (p > 0) lines.append(',');
+                lines.append("{\"tag\":\"").append(playerTag(battle.players[slot]))
+                     .append("\",\"brawler\":{\"name\":\"").append(m_brawlerNames[team[p]].toUtf8())
+                     .append("\",\"rank\":").append(QByteArray::number(battle.ranks[slot]))
+                     .append("}}");
+            }
+            lines.append(']');
+        }
+        lines.append("]}}\n");
+    }
+    return lines;
+}
+
+qint64 SyntheticGenerator::writeJsonl(const QString& filePath) const {
+    QElapsedTimer timer;
+    timer.start();
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCritical() << "Error opening synthetic games file for writing:" << filePath << file.errorString();
+        return -1;
+    }
+    // A batch of blocks per round keeps memory at a few blocks per thread whatever the game count
+    const qint64 batch = TaskExecutor::instance().workerCount();
+    qint64 written = 0;
+    for (qint64 firstBlock = 0; firstBlock < blockCount(); firstBlock += batch) {
+        QVector<qint64> blocks;
+        for (qint64 b = firstBlock; b < std::min(firstBlock + batch, blockCount()); ++b) blocks.append(b);
+        QList<QByteArray> chunks = TaskExecutor::instance().mapped(blocks, [this](qint64 block) { return blockJsonl(block); },
+                                                                    TaskPriority::Batch);
+        for (const QByteArray& chunk : chunks) {
+            if (file.write(chunk) != chunk.size()) {
+                qCritical() << "Error writing synthetic games file:" << filePath << file.errorString();
+                return -1;
+            }
+            written += chunk.size();
+        }
+    }
+    file.close();
+    qInfo() << "Wrote" << m_settings.games << "synthetic games (" << written / (1024 * 1024) << "MB ) to" << filePath
+            << "in" << timer.elapsed() << "ms.";
+    return written;
+}
+
+CacheData SyntheticGenerator::buildPack(const AppConfig& config) const {
+    QElapsedTimer timer;
+    timer.start();
+    StatsCalculator totals(config);
+    const qint64 batch = TaskExecutor::instance().workerCount();
+    for (qint64 firstBlock = 0; firstBlock < blockCount(); firstBlock += batch) {
+        QVector<qint64> blocks;
+        for (qint64 b = firstBlock; b < std::min(firstBlock + batch, blockCount()); ++b) blocks.append(b);
+        QList<CacheData> parts = TaskExecutor::instance().mapped(blocks, [this, &config](qint64 block) {
+            return StatsCalculator(games(block * GAMES_PER_BLOCK, GAMES_PER_BLOCK), config).getStatsForCache();
+        }, TaskPriority::Batch);
+        for (const CacheData& part : parts) totals.addStats(part);
+    }
+    CacheData data = totals.getStatsForCache();
+    data.allBrawlers = m_roster;
+    data.discoveredMapModes = m_mapModes;
+    qInfo() << "Built a synthetic pack from" << m_settings.games << "games in" << timer.elapsed() << "ms.";
+    return data;
+}
@@ -0,0 +1,74 @@
+#ifndef SYNTHETICDATA_H
+#define SYNTHETICDATA_H
+
+#include <QString>
+#include <QVector>
+#include <QSet>
+#include <QHash>
+#include "DataStructures.h"
+
+class AppConfig;
+
+struct SyntheticSettings {
+    int brawlers = 90;
+    int maps = 40;               // Assigned to the modes round-robin
+    int modes = 6;               // First N of SyntheticGenerator::MODES (3v3, then 5v5 and duo)
+    qint64 games = 100000;
+    double skew = 1.0;           // Zipf exponent of pick popularity (0 = uniform); rotated per map
+    double strengthSpread = 0.3; // Std dev of brawler strength in logits; map and pair effects are smaller
+    double rankMean = 18.0;      // Brawler ranks ~ normal, clamped to 1..MAX_RANK
+    double rankSpread = 5.0;
+    int players = 100000;        // Distinct player tags
+    quint32 seed = 1;
+};
+
+// Realistic synthetic battles for scaling tests: Zipf pick popularity, hidden per-brawler,
+// per-map and per-pair strengths deciding the winner through a logistic model, normal rank
+// distribution and a finite player population. Games are generated in fixed blocks, each from
+// its own seed, so the output depends only on the settings and blocks run in parallel.
+class SyntheticGenerator {
+public:
+    static constexpr int MAX_RANK = 35;
+    static const QStringList MODES;
+
+    // Throws std::invalid_argument on impossible settings (e.g. fewer brawlers than a draft needs)
+    explicit SyntheticGenerator(const SyntheticSettings& settings);
+
+    const SyntheticSettings& settings() const { return m_settings; }
+    const QSet<QString>& roster() const { return m_roster; }
+    const QHash<QString, QSet<QString>>& mapModes() const { return m_mapModes; }
+
+    // Battles as the scraper writes them (one JSON object per line). Returns bytes written, -1 on error.
+    qint64 writeJsonl(const QString& filePath) const;
+    // Stats pack straight from the generated games, without JSON; holds at most one block per thread
+    CacheData buildPack(const AppConfig& config) const;
+    // Games [first, first + count) as DataLoader would return them
+    QVector<ProcessedGame> games(qint64 first, qint64 count) const;
+
+private:
+    struct Battle {
+        int map = 0;
+        QVector<int> team1;     // Brawler ids
+        QVector<int> team2;
+        QVector<int> ranks;     // Team 1 then team 2
+        QVector<int> players;   // Player ids, same order
+        bool team1Won = false;
+    };
+
+    QVector<Battle> generateBlock(qint64 block) const;
+    qint64 blockCount() const;
+    QByteArray blockJsonl(qint64 block) const;
+    double strength(int brawler, int map) const;
+    double pairEffect(int a, int b) const; // Synergy of two teammates, in logits
+
+    SyntheticSettings m_settings;
+    QVector<QString> m_brawlerNames;
+    QVector<QString> m_mapNames;
+    QVector<QString> m_mapModeNames; // Mode of each map
+    QVector<double> m_baseStrength;
+    QVector<double> m_popularity;    // Zipf weights by popularity rank
+    QSet<QString> m_roster;
+    QHash<QString, QSet<QString>> m_mapModes;
+};
+
+#endif // SYNTHETICDATA_H
@@ -0,0 +1,244 @@
+#include "TaskExecutor.h"
+#include <QThread>
+#include <QDebug>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+namespace {
+
+// Worker identity of the current thread, so submissions from a task stay on its own deque
+thread_local const TaskExecutor* t_executor = nullptr;
+thread_local int t_workerIndex = -1;
+
+void runLogged(const std::function<void()>& task) {
+    try {
+        task();
+    } catch (const std::exception& e) {
+        qCritical() << "Exception in executor task:" << e.what();
+    } catch (...) {
+        qCritical() << "Unknown exception in executor task.";
+    }
+}
+
+// One parallelFor call; shared with its helper tasks, which may start after the caller returned
+// (they then find no item left and never touch 'body')
+struct ParallelFor {
+    const std::function<void(qsizetype)>* body = nullptr;
+    qsizetype count = 0;
+    CancellationToken token;
+    std::atomic<qsizetype> next{0};
+    std::atomic<qsizetype> finished{0};
+    std::atomic<bool> failed{false};
+    QMutex mutex;
+    QWaitCondition done;
+    std::exception_ptr error; // First exception (guarded by mutex)
+};
+
+void runItems(ParallelFor& job) {
+    for (qsizetype i = job.next.fetch_add(1); i < job.count; i = job.next.fetch_add(1)) {
+        if (!job.failed.load(std::memory_order_relaxed) && !job.token.isCancelled()) {
+            try {
+                (*job.body)(i);
+            } catch (...) {
+                QMutexLocker lock(&job.mutex);
+                if (!job.error) job.error = std::current_exception();
+                job.failed = true;
+            }
+        }
+        if (job.finished.fetch_add(1) + 1 == job.count) {
+            QMutexLocker lock(&job.mutex);
+            job.done.wakeAll();
+        }
+    }
+}
+
+} // namespace
+
+
+// --- TaskExecutor ---
+
+TaskExecutor& TaskExecutor::instance() {
+    static TaskExecutor executor(QThread::idealThreadCount());
+    return executor;
+}
+
+TaskExecutor::TaskExecutor(int workers) {
+    workers = std::max(1, workers);
+    for (int i = 0; i < workers; ++i) m_workers.push_back(std::make_unique<Worker>());
+    for (int i = 0; i < workers; ++i) {
+        m_workers[i]->thread = std::thread([this, i]() { workerLoop(i); });
+    }
+    qInfo() << "Task executor started" << workers << "worker threads.";
+}
+
+TaskExecutor::~TaskExecutor() {
+    {
+        QMutexLocker lock(&m_sleepMutex);
+        m_shutdown = true;
+    }
+    m_wake.wakeAll();
+    for (const auto& worker : m_workers) worker->thread.join();
+    // Nothing runs any more; whatever is still queued is dropped, so group waits still return
+    for (std::deque<Task>& queue : m_injected) drop(queue);
+    for (const auto& worker : m_workers) {
+        for (std::deque<Task>& queue : worker->queues) drop(queue);
+    }
+}
+
+void TaskExecutor::drop(std::deque<Task>& queue) {
+    for (Task& task : queue) {
+        if (task.dropped) runLogged(task.dropped);
+    }
+    queue.clear();
+}
+
+void TaskExecutor::submit(std::function<void()> task, TaskPriority priority, const CancellationToken& token) {
+    push({[task = std::move(task), token]() {
+        if (!token.isCancelled()) runLogged(task);
+    }}, priority);
+}
+
+bool TaskExecutor::parallelFor(qsizetype count, const std::function<void(qsizetype)>& body, TaskPriority priority,
+                               const CancellationToken& token) {
+    if (count <= 0) return !token.isCancelled();
+    auto job = std::make_shared<ParallelFor>();
+    job->body = &body;
+    job->count = count;
+    job->token = token;
+
+    // The caller takes items too, so a nested call from a task completes even with every worker busy
+    const qsizetype helpers = std::min<qsizetype>(count - 1, workerCount());
+    for (qsizetype h = 0; h < helpers; ++h) push({[job]() { runItems(*job); }}, priority);
+    runItems(*job);
+    {
+        QMutexLocker lock(&job->mutex);
+        while (job->finished.load() < count) job->done.wait(&job->mutex);
+    }
+    if (job->error) std::rethrow_exception(job->error);
+    return !token.isCancelled();
+}
+
+void TaskExecutor::push(Task task, TaskPriority priority) {
+    {
+        QMutexLocker lock(&m_sleepMutex);
+        if (m_shutdown) { // Submitted by a task finishing during shutdown: never queued
+            lock.unlock();
+            if (task.dropped) runLogged(task.dropped);
+            return;
+        }
+    }
+    const int p = static_cast<int>(priority);
+    if (t_executor == this) {
+        Worker& own = *m_workers[t_workerIndex];
+        QMutexLocker lock(&own.mutex);
+        own.queues[p].push_back(std::move(task));
+    } else {
+        QMutexLocker lock(&m_injectedMutex);
+        m_injected[p].push_back(std::move(task));
+    }
+    m_queued.fetch_add(1);
+    QMutexLocker lock(&m_sleepMutex);
+    if (m_sleeping > 0) m_wake.wakeOne();
+}
+
+// Per priority, highest first: the shared queue (oldest first), the worker's own deque (newest
+// first), then the oldest task of another worker
+bool TaskExecutor::takeTask(int index, Task& task) {
+    if (m_queued.load() <= 0) return false;
+    const int n = workerCount();
+    for (int p = 0; p < TASK_PRIORITY_COUNT; ++p) {
+        {
+            QMutexLocker lock(&m_injectedMutex);
+            if (!m_injected[p].empty()) {
+                task = std::move(m_injected[p].front());
+                m_injected[p].pop_front();
+                m_queued.fetch_sub(1);
+                return true;
+            }
+        }
+        {
+            Worker& own = *m_workers[index];
+            QMutexLocker lock(&own.mutex);
+            if (!own.queues[p].empty()) {
+                task = std::move(own.queues[p].back());
+                own.queues[p].pop_back();
+                m_queued.fetch_sub(1);
+                return true;
+            }
+        }
+        for (int k = 1; k < n; ++k) {
+            Worker& victim = *m_workers[(index + k) % n];
+            QMutexLocker lock(&victim.mutex);
+            if (!victim.queues[p].empty()) {
+                task = std::move(victim.queues[p].front());
+                victim.queues[p].pop_front();
+                m_queued.fetch_sub(1);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void TaskExecutor::workerLoop(int index) {
+    t_executor = this;
+    t_workerIndex = index;
+    Task task;
+    while (true) {
+        {
+            QMutexLocker lock(&m_sleepMutex);
+            if (m_shutdown) return;
+        }
+        if (takeTask(index, task)) {
+            task.run();
+            task.run = nullptr; // Release captures before sleeping
+            continue;
+        }
+        QMutexLocker lock(&m_sleepMutex);
+        if (m_shutdown) return;
+        if (m_queued.load() > 0) continue; // Pushed after takeTask looked
+        ++m_sleeping;
+        m_wake.wait(&m_sleepMutex);
+        --m_sleeping;
+    }
+}
+
+
+// --- TaskGroup ---
+
+TaskGroup::TaskGroup(TaskExecutor& executor)
+    : m_executor(executor)
+{}
+
+TaskGroup::~TaskGroup() {
+    wait();
+}
+
+void TaskGroup::submit(std::function<void()> task, TaskPriority priority, const CancellationToken& token) {
+    {
+        QMutexLocker lock(&m_mutex);
+        ++m_pending;
+    }
+    // The group checks the token itself, so skipped tasks are counted off too, as are tasks the
+    // executor drops at shutdown
+    m_executor.push({[this, task = std::move(task), token]() {
+        if (!token.isCancelled()) runLogged(task);
+        finishOne();
+    }, [this]() { finishOne(); }}, priority);
+}
+
+void TaskGroup::finishOne() {
+    QMutexLocker lock(&m_mutex);
+    if (--m_pending == 0) m_idle.wakeAll();
+}
+
+void TaskGroup::wait() {
+    QMutexLocker lock(&m_mutex);
+    while (m_pending > 0) m_idle.wait(&m_mutex);
+}
+
+int TaskGroup::pending() const {
+    QMutexLocker lock(&m_mutex);
+    return m_pending;
+}
@@ -0,0 +1,139 @@
+#ifndef TASKEXECUTOR_H
+#define TASKEXECUTOR_H
+
+#include <QList>
+#include <QMutex>
+#include <QWaitCondition>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// --- Task Executor ---
+// One set of worker threads (one per core) for every CPU-bound job in the process: search
+// slices, best-response and sweep jobs, ingestion parsing and stats shards. Each worker keeps a
+// deque per priority; tasks submitted from a worker go on its own deque (taken newest first),
+// tasks from other threads go on a shared queue, and an idle worker steals the oldest task of a
+// busy one. Higher priorities always go first, so a background rebuild never slows a search.
+//
+// Tasks must not block on other tasks, except through parallelFor/mapped, whose caller runs
+// items itself and so always makes progress. Threads that mostly sleep or wait on I/O (search
+// controllers, follow-mode polls) stay off the executor.
+
+enum class TaskPriority {
+    Interactive, // Searches and queries someone is waiting on
+    Batch,       // Sweeps, arenas, tuning, distillation, benchmarks
+    Background,  // Ingestion and stats building
+};
+constexpr int TASK_PRIORITY_COUNT = 3;
+
+// Shared flag: copies cancel together. A cancelled task that has not started is skipped; a
+// running one sees isCancelled() and should return early.
+class CancellationToken {
+public:
+    CancellationToken() : m_cancelled(std::make_shared<std::atomic<bool>>(false)) {}
+    void cancel() const { m_cancelled->store(true); }
+    bool isCancelled() const { return m_cancelled->load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+};
+
+class TaskExecutor {
+public:
+    // Process-wide executor with QThread::idealThreadCount() workers, started on first use
+    static TaskExecutor& instance();
+
+    explicit TaskExecutor(int workers);
+    ~TaskExecutor(); // Joins the workers, then drops queued tasks (their groups count them off)
+    TaskExecutor(const TaskExecutor&) = delete;
+    TaskExecutor& operator=(const TaskExecutor&) = delete;
+
+    int workerCount() const { return static_cast<int>(m_workers.size()); }
+    // Fire and forget; skipped if 'token' is cancelled before it starts. Exceptions are logged.
+    void submit(std::function<void()> task, TaskPriority priority, const CancellationToken& token = CancellationToken());
+
+    // Runs body(0) .. body(count - 1) on the workers and the calling thread, returning once all
+    // have run. Items are claimed one at a time, so uneven items balance themselves. The first
+    // exception stops the remaining items and is rethrown here. Returns false if 'token' was
+    // cancelled (items not started by then are skipped).
+    bool parallelFor(qsizetype count, const std::function<void(qsizetype)>& body, TaskPriority priority,
+                     const CancellationToken& token = CancellationToken());
+
+    // function(item) for every item, results in input order (QtConcurrent::blockingMapped)
+    template<typename Sequence, typename Function>
+    auto mapped(const Sequence& items, Function&& function, TaskPriority priority,
+                const CancellationToken& token = CancellationToken())
+        -> QList<std::decay_t<std::invoke_result_t<Function&, const typename Sequence::value_type&>>>
+    {
+        using Result = std::decay_t<std::invoke_result_t<Function&, const typename Sequence::value_type&>>;
+        QList<Result> results(items.size());
+        Result* out = results.data(); // Detached once here, not from every worker
+        parallelFor(items.size(), [&](qsizetype i) { out[i] = function(items.at(i)); }, priority, token);
+        return results;
+    }
+
+    // function(item) for every item, in place of QtConcurrent::blockingMap
+    template<typename Sequence, typename Function>
+    void map(const Sequence& items, Function&& function, TaskPriority priority,
+             const CancellationToken& token = CancellationToken())
+    {
+        parallelFor(items.size(), [&](qsizetype i) { function(items.at(i)); }, priority, token);
+    }
+
+private:
+    friend class TaskGroup;
+    struct Task {
+        std::function<void()> run;
+        std::function<void()> dropped; // Called instead of 'run' if shutdown discards the task
+    };
+    struct Worker {
+        QMutex mutex;
+        std::array<std::deque<Task>, TASK_PRIORITY_COUNT> queues;
+        std::thread thread;
+    };
+
+    void workerLoop(int index);
+    bool takeTask(int index, Task& task);
+    void push(Task task, TaskPriority priority);
+    static void drop(std::deque<Task>& queue);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    QMutex m_injectedMutex;
+    std::array<std::deque<Task>, TASK_PRIORITY_COUNT> m_injected; // Submitted from outside the workers
+    std::atomic<qsizetype> m_queued{0};
+    QMutex m_sleepMutex;
+    QWaitCondition m_wake;
+    int m_sleeping = 0;
+    bool m_shutdown = false;
+};
+
+// Tasks submitted through a group can be waited for: owners of long-running task chains (search
+// slices that resubmit themselves) wait here before releasing what the tasks use. wait() must
+// not be called from an executor task.
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskExecutor& executor = TaskExecutor::instance());
+    ~TaskGroup(); // Waits
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    // Safe from inside a task of this group (continuations keep the group busy)
+    void submit(std::function<void()> task, TaskPriority priority, const CancellationToken& token = CancellationToken());
+    void wait();
+    int pending() const;
+
+private:
+    void finishOne();
+
+    TaskExecutor& m_executor;
+    mutable QMutex m_mutex;
+    QWaitCondition m_idle;
+    int m_pending = 0;
+};
+
+#endif // TASKEXECUTOR_H
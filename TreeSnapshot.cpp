@@ -0,0 +1,218 @@
+#include "TreeSnapshot.h"
+#include "MCTS.h"
+#include <QCryptographicHash>
+#include <QSaveFile>
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QHash>
+#include <QQueue>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+const quint32 SNAPSHOT_MAGIC = 0xACED7EE5;
+const qint16 SNAPSHOT_VERSION = 1;
+
+QStringList sortedRoster(const DraftState& state) {
+    QStringList roster(state.masterBrawlerList().begin(), state.masterBrawlerList().end());
+    roster.sort();
+    return roster;
+}
+
+QString sortedJoin(QStringList names) {
+    names.sort();
+    return names.join(",");
+}
+
+} // namespace
+
+
+QString TreeSnapshot::keyFor(const DraftState& state) {
+    QString key = QString("%1|%2|bans=%3|t1=%4|t2=%5|turn=%6|pick=%7")
+        .arg(state.mapName(), state.modeName(),
+             sortedJoin(QStringList(state.bans().begin(), state.bans().end())),
+             sortedJoin(QStringList::fromVector(state.team1Picks())),
+             sortedJoin(QStringList::fromVector(state.team2Picks())),
+             state.currentTurn())
+        .arg(state.currentPickNumber());
+    // Team pools change the search space; unrestricted positions keep their old keys
+    if (const TeamPools* pools = state.teamPools()) {
+        key += QString("|pool1=%1|pool2=%2")
+                   .arg(sortedJoin(QStringList(pools->team1.begin(), pools->team1.end())),
+                        sortedJoin(QStringList(pools->team2.begin(), pools->team2.end())));
+    }
+    return key;
+}
+
+QString TreeSnapshot::weightsKeyFor(const HeuristicWeights& weights, const EvalWeights& evalWeights) {
+    return QString("w=%1,%2,%3,%4;e=%5,%6,%7,%8,%9")
+        .arg(weights.winRate).arg(weights.synergy).arg(weights.counter).arg(weights.pickRate)
+        .arg(evalWeights.winRate).arg(evalWeights.synergy).arg(evalWeights.counter)
+        .arg(evalWeights.peakCounter).arg(evalWeights.slope);
+}
+
+QString TreeSnapshot::fileNameFor(const DraftState& state, qint64 packVersion) {
+    QByteArray digest = QCryptographicHash::hash(keyFor(state).toUtf8(), QCryptographicHash::Sha1);
+    return QString("%1-%2.snap").arg(QString::fromLatin1(digest.toHex().left(16))).arg(packVersion);
+}
+
+// --- Capture / Restore ---
+
+TreeSnapshot TreeSnapshot::capture(const std::shared_ptr<MCTSNode>& root, const QString& weightsKey, qint64 packVersion) {
+    TreeSnapshot snapshot;
+    if (!root) return snapshot;
+    snapshot.positionKey = keyFor(root->state);
+    snapshot.packVersion = packVersion;
+    snapshot.weightsKey = weightsKey;
+    snapshot.roster = sortedRoster(root->state);
+
+    QHash<QString, quint16> moveIds;
+    for (int i = 0; i < snapshot.roster.size(); ++i) moveIds.insert(snapshot.roster[i], static_cast<quint16>(i));
+
+    TreeSnapshotNode rootRecord;
+    rootRecord.visits = static_cast<quint32>(root->visits.load(std::memory_order_relaxed));
+    rootRecord.wins = root->wins.load(std::memory_order_relaxed);
+    snapshot.nodes.append(rootRecord);
+
+    // Breadth-first, so every node's visited children end up contiguous
+    QQueue<std::shared_ptr<MCTSNode>> queue;
+    queue.enqueue(root);
+    int index = 0;
+    while (!queue.isEmpty()) {
+        std::shared_ptr<MCTSNode> node = queue.dequeue();
+        QVector<std::shared_ptr<MCTSNode>> children;
+        {
+            QMutexLocker locker(&node->mutex);
+            children = node->children;
+        }
+        snapshot.nodes[index].firstChild = static_cast<quint32>(snapshot.nodes.size());
+        for (const auto& child : children) {
+            int visits = child->visits.load(std::memory_order_relaxed);
+            if (visits <= 0) continue;
+            TreeSnapshotNode record;
+            record.move = moveIds.value(child->move);
+            record.visits = static_cast<quint32>(visits);
+            record.wins = child->wins.load(std::memory_order_relaxed);
+            snapshot.nodes.append(record);
+            snapshot.nodes[index].childCount++;
+            queue.enqueue(child);
+        }
+        index++;
+    }
+    return snapshot;
+}
+
+std::shared_ptr<MCTSNode> TreeSnapshot::restore(const DraftState& rootState,
+                                                std::shared_ptr<const MCTSSearchSpace> space) const {
+    auto root = std::make_shared<MCTSNode>(rootState, nullptr, QString(), space);
+    if (nodes.isEmpty()) return root;
+    root->visits = static_cast<int>(nodes[0].visits);
+    root->wins = nodes[0].wins;
+
+    QQueue<QPair<int, std::shared_ptr<MCTSNode>>> queue;
+    queue.enqueue({0, root});
+    while (!queue.isEmpty()) {
+        auto [index, node] = queue.dequeue();
+        const TreeSnapshotNode& record = nodes[index];
+        for (quint32 c = record.firstChild; c < record.firstChild + record.childCount; ++c) {
+            const TreeSnapshotNode& childRecord = nodes[c];
+            QString move = roster.value(childRecord.move);
+            // Expanded children are exactly the legal moves no longer untried
+            if (!node->untriedMoves.removeOne(move)) continue;
+            auto child = std::make_shared<MCTSNode>(node->state.applyMove(move), node, move, space);
+            child->visits = static_cast<int>(childRecord.visits);
+            child->wins = childRecord.wins;
+            node->addChild(child);
+            queue.enqueue({static_cast<int>(c), child});
+        }
+    }
+    return root;
+}
+
+// --- Persistence ---
+
+bool TreeSnapshot::save(const QString& filePath) const {
+    QDir dir = QFileInfo(filePath).dir();
+    if (!dir.exists() && !dir.mkpath(".")) {
+        qWarning() << "Failed to create snapshot directory:" << dir.path();
+        return false;
+    }
+
+    // QSaveFile: a crash mid-write never leaves a truncated snapshot behind
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Error opening MCTS snapshot for writing:" << filePath << file.errorString();
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << SNAPSHOT_MAGIC << SNAPSHOT_VERSION << positionKey << packVersion << weightsKey << roster
+        << quint32(nodes.size());
+    for (const TreeSnapshotNode& node : nodes) {
+        out << node.move << node.visits << node.wins << node.firstChild << node.childCount;
+    }
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        qWarning() << "Error writing MCTS snapshot:" << filePath;
+        return false;
+    }
+    return true;
+}
+
+std::optional<TreeSnapshot> TreeSnapshot::load(const QString& filePath, const DraftState& rootState,
+                                               qint64 packVersion, const QString& weightsKey) {
+    QFile file(filePath);
+    if (!file.exists() || !file.open(QIODevice::ReadOnly)) {
+        return std::nullopt;
+    }
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magicNumber = 0;
+    qint16 version = 0;
+    in >> magicNumber >> version;
+    if (in.status() != QDataStream::Ok || magicNumber != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION) {
+        qWarning() << "Ignoring MCTS snapshot with invalid header:" << filePath;
+        return std::nullopt;
+    }
+
+    TreeSnapshot snapshot;
+    quint32 nodeCount = 0;
+    in >> snapshot.positionKey >> snapshot.packVersion >> snapshot.weightsKey >> snapshot.roster >> nodeCount;
+    if (in.status() != QDataStream::Ok) return std::nullopt;
+    if (snapshot.positionKey != keyFor(rootState) || snapshot.packVersion != packVersion ||
+        snapshot.roster != sortedRoster(rootState)) {
+        qInfo() << "MCTS snapshot is for another position or stats pack:" << filePath;
+        return std::nullopt;
+    }
+    if (snapshot.weightsKey != weightsKey) {
+        qInfo() << "MCTS snapshot was searched with different weights; starting fresh:" << filePath;
+        return std::nullopt;
+    }
+
+    // Each node is 22 bytes on disk; guards against a corrupt count
+    if (nodeCount == 0 || qint64(nodeCount) * 22 > file.size()) {
+        qWarning() << "Ignoring corrupted MCTS snapshot:" << filePath;
+        return std::nullopt;
+    }
+    snapshot.nodes.resize(nodeCount);
+    for (TreeSnapshotNode& node : snapshot.nodes) {
+        in >> node.move >> node.visits >> node.wins >> node.firstChild >> node.childCount;
+    }
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "Ignoring corrupted MCTS snapshot:" << filePath;
+        return std::nullopt;
+    }
+
+    // Children must come after their parent and stay in range
+    for (quint32 i = 0; i < nodeCount; ++i) {
+        const TreeSnapshotNode& node = snapshot.nodes[i];
+        if (node.childCount > 0 &&
+            (node.firstChild <= i || quint64(node.firstChild) + node.childCount > nodeCount)) {
+            qWarning() << "Ignoring MCTS snapshot with an invalid tree layout:" << filePath;
+            return std::nullopt;
+        }
+    }
+    return snapshot;
+}
@@ -0,0 +1,55 @@
+#ifndef TREESNAPSHOT_H
+#define TREESNAPSHOT_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+#include <optional>
+#include "DataStructures.h"
+#include "DraftState.h"
+
+class MCTSNode;
+struct MCTSSearchSpace;
+
+// One node of a flattened search tree. Nodes are stored breadth-first, so each node's
+// children are the contiguous range [firstChild, firstChild + childCount).
+struct TreeSnapshotNode {
+    quint16 move = 0;        // Index into TreeSnapshot::roster (unused for the root)
+    quint32 visits = 0;
+    double wins = 0.0;       // From the perspective of the side that made 'move'
+    quint32 firstChild = 0;
+    quint32 childCount = 0;
+};
+
+// Compact, resumable copy of an MCTS tree, keyed by draft position and stats pack version.
+// Only visited nodes are kept; unexpanded moves are rebuilt from the position on restore.
+struct TreeSnapshot {
+    QString positionKey;     // Canonical position text (see keyFor)
+    qint64 packVersion = 0;
+    QString weightsKey;      // Rollout + win model weights the statistics were gathered with
+    QStringList roster;      // Sorted brawler names; moves are indices into it
+    QVector<TreeSnapshotNode> nodes; // nodes[0] is the root
+
+    quint32 rootVisits() const { return nodes.isEmpty() ? 0 : nodes.first().visits; }
+
+    // Position identity: map, mode, bans, both teams' picks (order-free) and side to move
+    static QString keyFor(const DraftState& state);
+    static QString weightsKeyFor(const HeuristicWeights& weights, const EvalWeights& evalWeights);
+    // "<position hash>-<pack version>.snap"
+    static QString fileNameFor(const DraftState& state, qint64 packVersion);
+
+    // Walks a live tree (workers may still be running; each node's children are copied under its lock)
+    static TreeSnapshot capture(const std::shared_ptr<MCTSNode>& root, const QString& weightsKey, qint64 packVersion);
+    // Rebuilds an in-process tree rooted at 'rootState'; saved children outside the search space's
+    // active roster (below the root) are dropped
+    std::shared_ptr<MCTSNode> restore(const DraftState& rootState,
+                                      std::shared_ptr<const MCTSSearchSpace> space = nullptr) const;
+
+    bool save(const QString& filePath) const;
+    // nullopt if missing, corrupt, or for another position / pack version / weights
+    static std::optional<TreeSnapshot> load(const QString& filePath, const DraftState& rootState,
+                                            qint64 packVersion, const QString& weightsKey);
+};
+
+#endif // TREESNAPSHOT_H
@@ -0,0 +1,306 @@
+#include "WeightTuner.h"
+#include "Heuristics.h"
+#include "StatsCalculator.h"
+#include "TaskExecutor.h"
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+constexpr int NUM_FEATURES = 4; // winRateDiff, synergyDiff, counterAvg, peakCounter
+constexpr int CHUNK_SIZE = 2048;
+constexpr int FEATURE_FOLDS = 5; // Out-of-fold stats for the training features
+constexpr double PROB_EPSILON = 1e-12;
+
+using Coefficients = std::array<double, NUM_FEATURES>;
+
+// Flat feature matrix (row-major, NUM_FEATURES per game) and 0/1 labels "team1 won"
+struct FeatureSet {
+    QVector<double> x;
+    QVector<double> y;
+    int size() const { return y.size(); }
+};
+
+struct ChunkRange {
+    int begin = 0;
+    int end = 0;
+};
+
+// Sums over one chunk of games at a given coefficient vector
+struct Moments {
+    double loss = 0.0;
+    int correct = 0;
+    Coefficients gradient{};
+    std::array<Coefficients, NUM_FEATURES> hessian{};
+};
+
+QVector<ChunkRange> chunksOf(int count) {
+    QVector<ChunkRange> chunks;
+    for (int begin = 0; begin < count; begin += CHUNK_SIZE) {
+        chunks.append({begin, std::min(count, begin + CHUNK_SIZE)});
+    }
+    return chunks;
+}
+
+// The win model is sigmoid(slope * w . features), i.e. logistic regression on theta = slope * w
+Coefficients toCoefficients(const EvalWeights& weights) {
+    return {weights.slope * weights.winRate, weights.slope * weights.synergy,
+            weights.slope * weights.counter, weights.slope * weights.peakCounter};
+}
+
+// Splits theta back into weights and slope, keeping the weights on the same scale as the baseline
+EvalWeights fromCoefficients(const Coefficients& theta, const EvalWeights& baseline) {
+    double baselineScale = std::abs(baseline.winRate) + std::abs(baseline.synergy) +
+                           std::abs(baseline.counter) + std::abs(baseline.peakCounter);
+    if (baselineScale <= 0.0) baselineScale = 1.0;
+    double thetaScale = 0.0;
+    for (double t : theta) thetaScale += std::abs(t);
+
+    EvalWeights weights = baseline;
+    if (thetaScale <= 0.0) {
+        weights.slope = 0.0; // Uninformative model, every game is 50%
+        return weights;
+    }
+    weights.slope = thetaScale / baselineScale;
+    weights.winRate = theta[0] / weights.slope;
+    weights.synergy = theta[1] / weights.slope;
+    weights.counter = theta[2] / weights.slope;
+    weights.peakCounter = theta[3] / weights.slope;
+    return weights;
+}
+
+FeatureSet extractFeatures(const GameTable& table, const QVector<int>& rows, const StatsCalculator& stats) {
+    const QVector<ChunkRange> chunks = chunksOf(rows.size());
+    QList<FeatureSet> parts = TaskExecutor::instance().mapped(chunks, [&table, &rows, &stats](const ChunkRange& chunk) {
+        FeatureSet part;
+        part.x.reserve((chunk.end - chunk.begin) * NUM_FEATURES);
+        part.y.reserve(chunk.end - chunk.begin);
+        QVector<QString> winners(GameTable::TEAM_SIZE), losers(GameTable::TEAM_SIZE);
+        for (int i = chunk.begin; i < chunk.end; ++i) {
+            int row = rows[i];
+            for (int p = 0; p < GameTable::TEAM_SIZE; ++p) {
+                winners[p] = table.brawlerNames()[table.winnerBrawlerIds()[row * GameTable::TEAM_SIZE + p]];
+                losers[p] = table.brawlerNames()[table.loserBrawlerIds()[row * GameTable::TEAM_SIZE + p]];
+            }
+            // Alternate which side is "team1" so the labels are balanced and the fit has no intercept to absorb
+            bool winnersFirst = (row % 2) == 0;
+            EvalFeatures f = computeEvalFeatures(winnersFirst ? winners : losers, winnersFirst ? losers : winners,
+                                                 table.mapNames()[table.mapIds()[row]],
+                                                 table.modeNames()[table.modeIds()[row]], stats);
+            part.x << f.winRateDiff << f.synergyDiff << f.counterAvg << f.peakCounter;
+            part.y.append(winnersFirst ? 1.0 : 0.0);
+        }
+        return part;
+    }, TaskPriority::Batch);
+
+    FeatureSet all;
+    all.x.reserve(rows.size() * NUM_FEATURES);
+    all.y.reserve(rows.size());
+    for (const FeatureSet& part : parts) {
+        all.x += part.x;
+        all.y += part.y;
+    }
+    return all;
+}
+
+// Mean log-loss (plus gradient and Hessian when 'withDerivatives') over the whole set, reduced over chunks
+Moments computeMoments(const FeatureSet& set, const Coefficients& theta, bool withDerivatives) {
+    const QVector<ChunkRange> chunks = chunksOf(set.size());
+    QList<Moments> parts = TaskExecutor::instance().mapped(chunks, [&set, &theta, withDerivatives](const ChunkRange& chunk) {
+        Moments m;
+        for (int i = chunk.begin; i < chunk.end; ++i) {
+            const double* x = set.x.constData() + i * NUM_FEATURES;
+            double z = 0.0;
+            for (int k = 0; k < NUM_FEATURES; ++k) z += theta[k] * x[k];
+            double p = 1.0 / (1.0 + std::exp(-z));
+            double y = set.y[i];
+            m.loss -= y * std::log(std::max(p, PROB_EPSILON)) + (1.0 - y) * std::log(std::max(1.0 - p, PROB_EPSILON));
+            if ((p > 0.5) == (y > 0.5)) m.correct++;
+            if (!withDerivatives) continue;
+            double residual = p - y;
+            double curvature = p * (1.0 - p);
+            for (int a = 0; a < NUM_FEATURES; ++a) {
+                m.gradient[a] += residual * x[a];
+                for (int b = 0; b < NUM_FEATURES; ++b) m.hessian[a][b] += curvature * x[a] * x[b];
+            }
+        }
+        return m;
+    }, TaskPriority::Batch);
+
+    // Sequential reduction keeps the result independent of thread scheduling
+    Moments total;
+    for (const Moments& part : parts) {
+        total.loss += part.loss;
+        total.correct += part.correct;
+        for (int a = 0; a < NUM_FEATURES; ++a) {
+            total.gradient[a] += part.gradient[a];
+            for (int b = 0; b < NUM_FEATURES; ++b) total.hessian[a][b] += part.hessian[a][b];
+        }
+    }
+    double n = std::max(1, set.size());
+    total.loss /= n;
+    for (int a = 0; a < NUM_FEATURES; ++a) {
+        total.gradient[a] /= n;
+        for (int b = 0; b < NUM_FEATURES; ++b) total.hessian[a][b] /= n;
+    }
+    return total;
+}
+
+TuneMetrics metricsFor(const FeatureSet& set, const EvalWeights& weights) {
+    Moments m = computeMoments(set, toCoefficients(weights), false);
+    return {m.loss, set.size() > 0 ? static_cast<double>(m.correct) / set.size() : 0.0};
+}
+
+double penalizedLoss(const Moments& m, const Coefficients& theta, double ridge) {
+    double norm = 0.0;
+    for (double t : theta) norm += t * t;
+    return m.loss + 0.5 * ridge * norm;
+}
+
+// Solves H d = g by Gaussian elimination with partial pivoting; false if H is singular
+bool solve(std::array<Coefficients, NUM_FEATURES> h, Coefficients g, Coefficients& d) {
+    for (int col = 0; col < NUM_FEATURES; ++col) {
+        int pivot = col;
+        for (int r = col + 1; r < NUM_FEATURES; ++r) {
+            if (std::abs(h[r][col]) > std::abs(h[pivot][col])) pivot = r;
+        }
+        if (std::abs(h[pivot][col]) < 1e-14) return false;
+        std::swap(h[col], h[pivot]);
+        std::swap(g[col], g[pivot]);
+        for (int r = col + 1; r < NUM_FEATURES; ++r) {
+            double factor = h[r][col] / h[col][col];
+            for (int c = col; c < NUM_FEATURES; ++c) h[r][c] -= factor * h[col][c];
+            g[r] -= factor * g[col];
+        }
+    }
+    for (int r = NUM_FEATURES - 1; r >= 0; --r) {
+        double sum = g[r];
+        for (int c = r + 1; c < NUM_FEATURES; ++c) sum -= h[r][c] * d[c];
+        d[r] = sum / h[r][r];
+    }
+    return true;
+}
+
+} // namespace
+
+
+WeightTuner::WeightTuner(const GameTable& table, const AppConfig& config)
+    : m_table(table),
+      m_config(config)
+{
+}
+
+TuneReport WeightTuner::run(const EvalWeights& baseline, const TuneSettings& settings) const {
+    // --- Validate Settings ---
+    if (settings.validationFraction <= 0.0 || settings.validationFraction >= 1.0) {
+        throw std::invalid_argument("Validation fraction must be between 0 and 1.");
+    }
+    if (settings.maxIterations <= 0 || settings.ridge < 0.0) {
+        throw std::invalid_argument("Tuning needs a positive iteration limit and a non-negative ridge.");
+    }
+
+    QElapsedTimer total;
+    total.start();
+    TuneReport report;
+    report.baseline = baseline;
+
+    // --- Train/Validation Split ---
+    QVector<int> order(m_table.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937 rng(settings.seed);
+    std::shuffle(order.begin(), order.end(), rng);
+    int validationCount = static_cast<int>(order.size() * settings.validationFraction);
+    QVector<int> validationRows = order.mid(0, validationCount);
+    QVector<int> trainRows = order.mid(validationCount);
+    if (validationRows.isEmpty() || trainRows.size() < 10 * NUM_FEATURES) {
+        throw std::invalid_argument(QString("Too few games to tune on: %1").arg(m_table.size()).toStdString());
+    }
+    report.trainGames = trainRows.size();
+    report.validationGames = validationRows.size();
+
+    // --- Stats From Training Games Only ---
+    QElapsedTimer timer;
+    timer.start();
+    StatsCalculator trainStats(m_table.rows(trainRows), m_config);
+    report.statsMs = timer.restart();
+
+    // --- Features ---
+    // Training features are built out-of-fold: each fold is scored against stats from the other
+    // folds, so a game never sees its own result (in-sample stats would inflate the win-rate and
+    // counter features and overfit the slope). Validation uses stats from all training games.
+    FeatureSet train;
+    train.x.reserve(trainRows.size() * NUM_FEATURES);
+    train.y.reserve(trainRows.size());
+    for (int fold = 0; fold < FEATURE_FOLDS; ++fold) {
+        QVector<int> foldRows, otherRows;
+        for (int i = 0; i < trainRows.size(); ++i) {
+            (i % FEATURE_FOLDS == fold ? foldRows : otherRows).append(trainRows[i]);
+        }
+        StatsCalculator foldStats(m_table.rows(otherRows), m_config);
+        FeatureSet part = extractFeatures(m_table, foldRows, foldStats);
+        train.x += part.x;
+        train.y += part.y;
+    }
+    FeatureSet validation = extractFeatures(m_table, validationRows, trainStats);
+    report.featuresMs = timer.restart();
+
+    // --- Newton Iterations On The Penalized Log-Loss ---
+    Coefficients theta = toCoefficients(baseline);
+    Moments current = computeMoments(train, theta, true);
+    double currentLoss = penalizedLoss(current, theta, settings.ridge);
+    for (int iter = 0; iter < settings.maxIterations; ++iter) {
+        report.iterations = iter + 1;
+        Coefficients gradient = current.gradient;
+        std::array<Coefficients, NUM_FEATURES> hessian = current.hessian;
+        for (int a = 0; a < NUM_FEATURES; ++a) {
+            gradient[a] += settings.ridge * theta[a];
+            hessian[a][a] += settings.ridge;
+        }
+        Coefficients step{};
+        if (!solve(hessian, gradient, step)) {
+            qWarning() << "Weight tuning stopped: singular Hessian (features have no variance?).";
+            break;
+        }
+
+        // Backtracking: halve the step until the loss does not increase
+        bool improved = false;
+        double scale = 1.0;
+        for (int halvings = 0; halvings < 20 && !improved; ++halvings, scale *= 0.5) {
+            Coefficients candidate = theta;
+            for (int k = 0; k < NUM_FEATURES; ++k) candidate[k] -= scale * step[k];
+            Moments next = computeMoments(train, candidate, true);
+            double nextLoss = penalizedLoss(next, candidate, settings.ridge);
+            if (nextLoss <= currentLoss) {
+                theta = candidate;
+                current = next;
+                improved = true;
+                report.converged = currentLoss - nextLoss < 1e-10;
+                currentLoss = nextLoss;
+            }
+        }
+        if (!improved || report.converged) {
+            report.converged = true;
+            break;
+        }
+    }
+    report.fitMs = timer.elapsed();
+    report.fitted = fromCoefficients(theta, baseline);
+
+    // --- Metrics ---
+    report.trainBaseline = metricsFor(train, baseline);
+    report.trainFitted = metricsFor(train, report.fitted);
+    report.validationBaseline = metricsFor(validation, baseline);
+    report.validationFitted = metricsFor(validation, report.fitted);
+    report.elapsedMs = total.elapsed();
+
+    qInfo() << "Weight tuning finished in" << report.elapsedMs << "ms after" << report.iterations
+            << "iterations. Validation log-loss" << report.validationBaseline.logLoss
+            << "->" << report.validationFitted.logLoss;
+    return report;
+}
@@ -0,0 +1,54 @@
+#ifndef WEIGHTTUNER_H
+#define WEIGHTTUNER_H
+
+#include <QVector>
+#include "DataStructures.h"
+#include "AppConfig.h"
+#include "GameTable.h"
+
+struct TuneSettings {
+    double validationFraction = 0.2; // Held-out share of games
+    quint32 seed = 1;                // Train/validation split
+    int maxIterations = 25;          // Newton steps
+    double ridge = 1e-4;             // L2 penalty on the fitted coefficients (per game)
+};
+
+struct TuneMetrics {
+    double logLoss = 0.0;
+    double accuracy = 0.0; // Share of games where the favoured side won
+};
+
+struct TuneReport {
+    EvalWeights baseline;
+    EvalWeights fitted;
+    TuneMetrics trainBaseline;
+    TuneMetrics trainFitted;
+    TuneMetrics validationBaseline;
+    TuneMetrics validationFitted;
+    int trainGames = 0;
+    int validationGames = 0;
+    int iterations = 0;
+    bool converged = false;
+    qint64 statsMs = 0;    // Stats on the training split
+    qint64 featuresMs = 0; // Out-of-fold stats and feature extraction over both splits
+    qint64 fitMs = 0;
+    qint64 elapsedMs = 0;
+};
+
+// Fits the win model (EvalWeights, including the logistic slope) to real results by minimizing
+// log-loss. Stats are rebuilt from the training split only, so validation games are truly unseen;
+// training features come from out-of-fold stats so no game is scored against its own result.
+// Feature extraction and the gradient/Hessian sums run in parallel chunks on the global thread pool.
+class WeightTuner {
+public:
+    WeightTuner(const GameTable& table, const AppConfig& config);
+
+    // Throws std::invalid_argument on bad settings or too few games to split
+    TuneReport run(const EvalWeights& baseline, const TuneSettings& settings) const;
+
+private:
+    const GameTable& m_table;
+    const AppConfig& m_config;
+};
+
+#endif // WEIGHTTUNER_H
@@ -0,0 +1,113 @@
+#ifndef GLIZZYDRAFT_C_H
+#define GLIZZYDRAFT_C_H
+
+/*
+ * C interface of the draft engine (libglizzydraft), for tools that cannot link Qt classes.
+ *
+ * Brawlers and map/modes are addressed by dense integer ids resolved once with
+ * gd_brawler_id / gd_map_id. An engine is immutable after gd_engine_open: every function
+ * may be called from any number of threads at once. The query functions (ids, names,
+ * heuristic scores, win probabilities) read flat score tables and never allocate; results
+ * go to caller-provided buffers. gd_search builds a search tree and does allocate.
+ *
+ * Functions returning int return GD_OK or a negative gd_status; gd_last_error() describes
+ * the last failure on the calling thread.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+#  ifdef GLIZZYDRAFT_BUILD
+#    define GD_API __declspec(dllexport)
+#  else
+#    define GD_API __declspec(dllimport)
+#  endif
+#else
+#  define GD_API __attribute__((visibility("default")))
+#endif
+
+#define GD_API_VERSION 1
+
+typedef enum gd_status {
+    GD_OK = 0,
+    GD_ERR_INVALID_ARGUMENT = -1, /* Null pointer, bad id, duplicate brawler, wrong team size */
+    GD_ERR_IO = -2,               /* Pack or config could not be read */
+    GD_ERR_BUFFER_TOO_SMALL = -3, /* Output capacity below what the call needs */
+    GD_ERR_INTERNAL = -4
+} gd_status;
+
+typedef struct gd_engine gd_engine;
+typedef int32_t gd_id;
+
+/* A draft position. Picks are in the order they were made; ids are brawler ids. */
+typedef struct gd_draft {
+    gd_id map;                 /* Map/mode id from gd_map_id */
+    const gd_id* team1;
+    int32_t team1_count;
+    const gd_id* team2;
+    int32_t team2_count;
+    const gd_id* bans;
+    int32_t ban_count;
+} gd_draft;
+
+typedef struct gd_move_result {
+    gd_id brawler;
+    int32_t visits;
+    double win_rate;           /* Win probability of the side to move after this pick */
+} gd_move_result;
+
+/* Called at every report interval of gd_search with the moves so far, most visited first.
+ * 'moves' is the caller's output buffer. Return nonzero to stop the search early. */
+typedef int (*gd_search_callback)(void* user_data, const gd_move_result* moves, int32_t move_count,
+                                  int64_t iterations, double elapsed_seconds);
+
+GD_API int gd_api_version(void);
+GD_API const char* gd_last_error(void);
+
+/* Opens a stats pack or compact pack. A full pack is quantized into the compact tables on open.
+ * 'config_path' may be NULL: draft_config.ini next to the pack (created with defaults if missing).
+ * Returns NULL on failure with the reason in *status (may be NULL) and gd_last_error(). */
+GD_API gd_engine* gd_engine_open(const char* pack_path, const char* config_path, int* status);
+GD_API void gd_engine_close(gd_engine* engine);
+GD_API int64_t gd_pack_version(const gd_engine* engine);
+
+/* --- Names and ids --- */
+GD_API int32_t gd_brawler_count(const gd_engine* engine);
+GD_API gd_id gd_brawler_id(const gd_engine* engine, const char* name);          /* -1 if unknown */
+GD_API const char* gd_brawler_name(const gd_engine* engine, gd_id brawler);       /* UTF-8, owned by the engine */
+GD_API int32_t gd_map_count(const gd_engine* engine);
+GD_API gd_id gd_map_id(const gd_engine* engine, const char* map, const char* mode); /* -1 if unknown */
+GD_API const char* gd_map_name(const gd_engine* engine, gd_id map);
+GD_API const char* gd_map_mode(const gd_engine* engine, gd_id map);
+GD_API int32_t gd_map_team_size(const gd_engine* engine, gd_id map);
+
+/* --- Queries (no allocation) --- */
+
+/* Heuristic pick score of every brawler for the side to move (snake order: 1, 2, 2, 1, 1, 2, ...).
+ * scores[id] for id < gd_brawler_count(); brawlers already
+ * picked or banned get NAN. 'capacity' is the length of 'scores'. */
+GD_API int gd_heuristic_scores(const gd_engine* engine, const gd_draft* draft, float* scores, int32_t capacity);
+
+/* Team 1 win probability of 'count' complete drafts on one map. team1_ids and team2_ids hold
+ * count * gd_map_team_size(map) ids each, one draft after another. */
+GD_API int gd_win_probability_batch(const gd_engine* engine, gd_id map, const gd_id* team1_ids,
+                                    const gd_id* team2_ids, int32_t count, double* probabilities);
+
+/* --- Search --- */
+
+/* MCTS from 'draft' for up to 'seconds' on 'threads' threads (<= 0: every core). Reports every
+ * 'report_seconds' (<= 0: only at the end) through 'callback' (may be NULL). The final moves,
+ * most visited first, are written to 'moves' (up to 'capacity'); *move_count gets how many. */
+GD_API int gd_search(const gd_engine* engine, const gd_draft* draft, double seconds, int32_t threads,
+                     double report_seconds, gd_search_callback callback, void* user_data,
+                     gd_move_result* moves, int32_t capacity, int32_t* move_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GLIZZYDRAFT_C_H */
@@ -4,8 +4,15 @@
 #include "AppConfig.h"
 #include "MCTS.h"
 #include "CacheUtils.h"
+#include "CompactStats.h"
 #include "DataStructures.h"
 #include "DraftState.h"
+#include "Cli.h"
+#include "PolicyTable.h"
+#include "MoveClusters.h"
+#include "LiveIngest.h"
+#include "GameTable.h"
+#include "Bootstrap.h"
 
 #include <QApplication>
 #include <QMetaType>
@@ -25,6 +32,10 @@
 const QString DATA_FILE_NAME = "high_level_ranked_games.jsonl"; // Renamed
 const QString CACHE_FILE_NAME = "stats.pack";            // Renamed
 const QString CONFIG_FILE_NAME = "draft_config.ini";         // Renamed
+const QString POLICY_FILE_NAME = "policy.table";             // Written by the 'distill' command
+const QString SNAPSHOT_DIR_NAME = "mcts_snapshots";          // Saved MCTS trees, resumed per position
+const QString PLAYER_INDEX_FILE_NAME = "players.index";      // Tag -> brawler pool, with BuildPlayerIndex
+const QString LIVE_CHECKPOINT_FILE_NAME = "live.checkpoint"; // Follow-mode offset and games added since the pack
 const QString LOG_FILE_NAME = "draft_log.log";          // Renamed
 
 
@@ -85,6 +96,20 @@ void messageHandler(QtMsgType type, const QMessageLogContext &context, const QSt
 
 
 int main(int argc, char *argv[]) {
+    // --- Headless Commands (no GUI) ---
+    if (Cli::isCliInvocation(argc, argv)) {
+        QCoreApplication cliApp(argc, argv);
+        qInstallMessageHandler(messageHandler);
+        cliApp.setOrganizationName("TexApps");
+        cliApp.setApplicationName("GlizzyDraft");
+
+        const QString cliAppDirPath = QCoreApplication::applicationDirPath();
+        QString cliCacheFilePath = QDir::cleanPath(cliAppDirPath + QDir::separator() + CACHE_FILE_NAME);
+        QString cliConfigFilePath = QDir::cleanPath(cliAppDirPath + QDir::separator() + CONFIG_FILE_NAME);
+        AppConfig cliConfig(cliConfigFilePath);
+        return Cli::run(QCoreApplication::arguments(), cliConfig, cliCacheFilePath);
+    }
+
     // MUST be first Qt object created
     QApplication app(argc, argv);
 
@@ -120,10 +145,26 @@ int main(int argc, char *argv[]) {
     std::optional<StatsCalculator> statsCalculatorOpt;
     QSet<QString> allBrawlers;
     QHash<QString, QSet<QString>> discoveredMapModes;
+    qint64 builtFromBytes = -1;   // Games-file bytes a freshly built pack covers (follow mode starts there)
+    QVector<quint64> builtBattleKeys;
 
     // --- Attempt to Load from Cache ---
     qInfo() << "Attempting to load data from cache...";
-    auto cachedDataOpt = CacheUtils::loadCache(cacheFilePath);
+    std::optional<CacheData> cachedDataOpt;
+    if (CompactStats::isCompactFile(cacheFilePath)) {
+        // A compact pack (see the 'compact' command) is served as-is; it cannot be rebuilt in place
+        std::shared_ptr<const CompactStats> compact = CompactStats::load(cacheFilePath);
+        if (compact) {
+            compact->checkSettings(appConfig);
+            CacheData compactData = compact->cacheData();
+            allBrawlers = compactData.allBrawlers;
+            discoveredMapModes = compactData.discoveredMapModes;
+            statsCalculatorOpt.emplace(appConfig);
+            statsCalculatorOpt->setCompactStats(compact);
+        }
+    } else {
+        cachedDataOpt = CacheUtils::loadCache(cacheFilePath);
+    }
 
     if (cachedDataOpt.has_value()) {
         try {
@@ -132,10 +173,18 @@ int main(int argc, char *argv[]) {
                  qWarning() << "Cache data is incomplete. Forcing recalculation.";
                  cachedDataOpt.reset();
              } else {
+                 if (cachedData.metadata.isApproximate()) {
+                     qWarning() << "Stats pack is approximate: estimated from"
+                                << cachedData.metadata.sampleFraction * 100.0 << "% of the games.";
+                 }
                  allBrawlers = cachedData.allBrawlers;
                  discoveredMapModes = cachedData.discoveredMapModes;
                  statsCalculatorOpt.emplace(appConfig);
                  statsCalculatorOpt->setStatsFromCacheData(cachedData);
+                 if (appConfig.useCompactStats()) {
+                     statsCalculatorOpt->setCompactStats(CompactStats::build(*statsCalculatorOpt, cachedData, appConfig,
+                                                                             appConfig.compactPlaysThreshold()));
+                 }
                  qInfo() << "Successfully initialized components from cache.";
              }
         } catch (const std::exception& e) {
@@ -147,7 +196,7 @@ int main(int argc, char *argv[]) {
              statsCalculatorOpt.reset();
              cachedDataOpt.reset();
         }
-    } else {
+    } else if (!statsCalculatorOpt.has_value()) {
          qInfo() << "Cache not found or invalid.";
     }
 
@@ -155,6 +204,7 @@ int main(int argc, char *argv[]) {
     if (!statsCalculatorOpt.has_value()) {
         qInfo() << "Proceeding with source data loading and processing...";
         DataLoader dataLoader(dataFilePath, appConfig);
+        dataLoader.setBuildPlayerIndex(appConfig.buildPlayerIndex());
 
         if (!dataLoader.loadAndProcess()) {
             qCritical() << "Failed to load and process source data from:" << dataFilePath;
@@ -169,6 +219,11 @@ int main(int argc, char *argv[]) {
         allBrawlers = dataLoader.getAllBrawlers();
         discoveredMapModes = dataLoader.getDiscoveredMapModes();
         const auto& processedGames = dataLoader.getProcessedGames();
+        builtFromBytes = dataLoader.getEndOffset();
+        builtBattleKeys = dataLoader.getBattleKeys();
+        if (appConfig.buildPlayerIndex()) {
+            dataLoader.getPlayerIndex().save(QDir::cleanPath(appDirPath + QDir::separator() + PLAYER_INDEX_FILE_NAME));
+        }
 
         if (allBrawlers.isEmpty() || discoveredMapModes.isEmpty()) {
             qCritical() << "No brawlers or maps/modes identified after processing. Cannot proceed.";
@@ -194,8 +249,18 @@ int main(int argc, char *argv[]) {
              CacheData dataToCache = statsCalculatorOpt->getStatsForCache();
              dataToCache.allBrawlers = allBrawlers;
              dataToCache.discoveredMapModes = discoveredMapModes;
-             dataToCache.metadata.cacheCreationTime = QDateTime::currentMSecsSinceEpoch();
+             if (appConfig.bootstrapReplicas() >= 2) {
+                 dataToCache.errors = Bootstrap::cellErrors(GameTable(processedGames), appConfig,
+                                                            appConfig.bootstrapReplicas());
+                 statsCalculatorOpt->setErrors(dataToCache.errors);
+             }
+             // metadata.cacheCreationTime is the calculator's pack version
              CacheUtils::saveCache(cacheFilePath, dataToCache);
+             cachedDataOpt = dataToCache; // The pack's counts, for follow mode
+             if (appConfig.useCompactStats()) {
+                 statsCalculatorOpt->setCompactStats(CompactStats::build(*statsCalculatorOpt, dataToCache, appConfig,
+                                                                         appConfig.compactPlaysThreshold()));
+             }
         } else {
              qCritical() << "Stats calculator failed to initialize even after data processing.";
               QMessageBox::critical(nullptr, "Fatal Error", "Failed to initialize statistics engine.\nCheck logs.\nApplication cannot start.");
@@ -213,14 +278,52 @@ int main(int argc, char *argv[]) {
      StatsCalculator& calculator = *statsCalculatorOpt;
      MCTSManager mctsManager(calculator, appConfig);
 
+    // --- Optional Distilled Policy ---
+    QString policyFilePath = QDir::cleanPath(appDirPath + QDir::separator() + POLICY_FILE_NAME);
+    std::optional<PolicyTable> policyTableOpt = PolicyTable::load(policyFilePath, calculator.packVersion());
+    if (policyTableOpt.has_value() && appConfig.usePolicyRollouts()) {
+        mctsManager.setRolloutPolicy(&*policyTableOpt);
+    }
+    if (appConfig.mctsClusterSelection()) {
+        mctsManager.setMoveClusters(MoveClusters::build(calculator, allBrawlers, discoveredMapModes,
+                                                        appConfig.mctsClusterCount()));
+    }
+    // Worker processes load the same pack (and policy table) themselves
+    mctsManager.setWorkerProcesses(appConfig.mctsWorkerProcesses(), cacheFilePath);
+    mctsManager.setSnapshotDirectory(QDir::cleanPath(appDirPath + QDir::separator() + SNAPSHOT_DIR_NAME));
+
     // --- Start GUI ---
     qInfo() << "Initializing GUI...";
     MainWindow mainWindow(calculator, allBrawlers, discoveredMapModes, appConfig, &mctsManager);
+    if (policyTableOpt.has_value()) {
+        mainWindow.setPolicyTable(&*policyTableOpt);
+    }
     mainWindow.show();
 
+    // --- Optional Follow Mode ---
+    std::unique_ptr<LiveIngest> liveIngest;
+    if (appConfig.liveIngest()) {
+        if (!cachedDataOpt.has_value()) {
+            qWarning() << "LiveIngest needs a full stats pack; a compact pack cannot be followed.";
+        } else if (cachedDataOpt->metadata.isApproximate()) {
+            qWarning() << "LiveIngest needs an exact stats pack; an approximate (sampled) pack cannot be followed.";
+        } else {
+            liveIngest = std::make_unique<LiveIngest>(
+                dataFilePath, QDir::cleanPath(appDirPath + QDir::separator() + LIVE_CHECKPOINT_FILE_NAME),
+                *cachedDataOpt, appConfig);
+            cachedDataOpt.reset(); // LiveIngest keeps its own copy
+            QObject::connect(liveIngest.get(), &LiveIngest::statsPublished, &mainWindow, [&](qint64 newGames) {
+                mainWindow.setStatsSnapshot(liveIngest->current(), newGames);
+            });
+            liveIngest->start(builtFromBytes, builtBattleKeys);
+        }
+    }
+    cachedDataOpt.reset(); // Only follow mode reads the pack's counts after startup
+
     qInfo() << "Application event loop started.";
     int execResult = app.exec();
     qInfo() << "Application event loop finished.";
+    if (liveIngest) liveIngest->stop(); // Reads the rest and checkpoints
 
     qInfo() << "Application closed.";
     return execResult;